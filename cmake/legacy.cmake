@@ -112,8 +112,17 @@ target_sources(
           src/requesthandler/RequestHandler_MediaInputs.cpp
           src/requesthandler/RequestHandler_Ui.cpp
           src/requesthandler/RequestHandler.h
+          src/requesthandler/ControlStreamHandler.cpp
+          src/requesthandler/ControlStreamHandler.h
           src/requesthandler/RequestBatchHandler.cpp
           src/requesthandler/RequestBatchHandler.h
+          src/requesthandler/RequestBatchScheduler.cpp
+          src/requesthandler/RequestBatchScheduler.h
+          src/requesthandler/RequestCoalescer.cpp
+          src/requesthandler/RequestCoalescer.h
+          src/requesthandler/SlowRequestLog.cpp
+          src/requesthandler/SlowRequestLog.h
+          src/requesthandler/rpc/PreparedRequestBatch.h
           src/requesthandler/rpc/Request.cpp
           src/requesthandler/rpc/Request.h
           src/requesthandler/rpc/RequestBatchRequest.cpp
@@ -124,13 +133,20 @@ target_sources(
           src/requesthandler/types/RequestBatchExecutionType.h
           src/utils/Crypto.cpp
           src/utils/Crypto.h
+          src/utils/FlightRecorder.cpp
+          src/utils/FlightRecorder.h
+          src/utils/FlightRecorderFormat.h
           src/utils/Json.cpp
           src/utils/Json.h
+          src/utils/Metrics.cpp
+          src/utils/Metrics.h
           src/utils/Obs.cpp
           src/utils/Obs_StringHelper.cpp
           src/utils/Obs_NumberHelper.cpp
           src/utils/Obs_ArrayHelper.cpp
           src/utils/Obs_ObjectHelper.cpp
+          src/utils/Obs_OutputStatistics.cpp
+          src/utils/Obs_OutputStatistics.h
           src/utils/Obs_SearchHelper.cpp
           src/utils/Obs_ActionHelper.cpp
           src/utils/Obs.h
@@ -141,6 +157,12 @@ target_sources(
           src/utils/Platform.h
           src/utils/Compat.cpp
           src/utils/Compat.h
+          src/utils/TaskGroup.cpp
+          src/utils/TaskGroup.h
+          src/utils/Tracing.cpp
+          src/utils/Tracing.h
+          src/utils/TrafficCapture.cpp
+          src/utils/TrafficCapture.h
           src/utils/Utils.h)
 
 target_link_libraries(
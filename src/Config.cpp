@@ -41,11 +41,15 @@ with this program. If not, see <https://www.gnu.org/licenses/>
 #define PARAM_ALERTS "alerts_enabled"
 #define PARAM_AUTHREQUIRED "auth_required"
 #define PARAM_PASSWORD "server_password"
+#define PARAM_FRAMETICKBUDGET "frame_tick_budget_us"
+#define PARAM_FLIGHTRECORDERSIZE "flight_recorder_size_mib"
+#define PARAM_METRICSENDPOINT "metrics_endpoint_enabled"
 
 #define CMDLINE_WEBSOCKET_PORT "websocket_port"
 #define CMDLINE_WEBSOCKET_IPV4_ONLY "websocket_ipv4_only"
 #define CMDLINE_WEBSOCKET_PASSWORD "websocket_password"
 #define CMDLINE_WEBSOCKET_DEBUG "websocket_debug"
+#define CMDLINE_WEBSOCKET_CAPTURE "websocket_capture"
 
 void Config::Load(json config)
 {
@@ -72,6 +76,12 @@ void Config::Load(json config)
 		AuthRequired = config[PARAM_AUTHREQUIRED];
 	if (config.contains(PARAM_PASSWORD) && config[PARAM_PASSWORD].is_string())
 		ServerPassword = config[PARAM_PASSWORD];
+	if (config.contains(PARAM_FRAMETICKBUDGET) && config[PARAM_FRAMETICKBUDGET].is_number_unsigned())
+		FrameTickBudgetMicros = config[PARAM_FRAMETICKBUDGET];
+	if (config.contains(PARAM_FLIGHTRECORDERSIZE) && config[PARAM_FLIGHTRECORDERSIZE].is_number_unsigned())
+		FlightRecorderSizeMiB = config[PARAM_FLIGHTRECORDERSIZE];
+	if (config.contains(PARAM_METRICSENDPOINT) && config[PARAM_METRICSENDPOINT].is_boolean())
+		MetricsEndpointEnabled = config[PARAM_METRICSENDPOINT];
 
 	// Set server password and save it to the config before processing overrides,
 	// so that there is always a true configured password regardless of if
@@ -122,6 +132,14 @@ void Config::Load(json config)
 		blog(LOG_INFO, "[Config::Load] --websocket_debug passed. Enabling debug logging.");
 		DebugEnabled = true;
 	}
+
+	// Process `--websocket_capture` override
+	QString captureArgument = Utils::Platform::GetCommandLineArgument(CMDLINE_WEBSOCKET_CAPTURE);
+	if (captureArgument != "") {
+		// Capturing does not persist either, as it is only meant for test setups.
+		blog(LOG_INFO, "[Config::Load] --websocket_capture passed. Capturing WebSocket traffic.");
+		CaptureFilePath = captureArgument.toStdString();
+	}
 }
 
 void Config::Save()
@@ -140,6 +158,9 @@ void Config::Save()
 		config[PARAM_AUTHREQUIRED] = AuthRequired.load();
 		config[PARAM_PASSWORD] = ServerPassword;
 	}
+	config[PARAM_FRAMETICKBUDGET] = FrameTickBudgetMicros.load();
+	config[PARAM_FLIGHTRECORDERSIZE] = FlightRecorderSizeMiB.load();
+	config[PARAM_METRICSENDPOINT] = MetricsEndpointEnabled.load();
 
 	if (!Utils::Json::SetJsonFileContent(configFilePath, config))
 		blog(LOG_ERROR, "[Config::Save] Failed to write config file!");
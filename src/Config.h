@@ -41,6 +41,10 @@ struct Config {
 	std::atomic<bool> AlertsEnabled = false;
 	std::atomic<bool> AuthRequired = true;
 	std::string ServerPassword;
+	std::string CaptureFilePath; // Only set by `--websocket_capture`
+	std::atomic<uint32_t> FrameTickBudgetMicros = 0; // Time SerialFrame batches may use per video frame. 0 == unlimited
+	std::atomic<uint32_t> FlightRecorderSizeMiB = 0; // Size of the flight recorder ring file. 0 == disabled
+	std::atomic<bool> MetricsEndpointEnabled = false; // Serve `/metrics` over plain HTTP on the server port
 };
 
 json MigrateGlobalConfigData();
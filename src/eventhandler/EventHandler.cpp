@@ -93,6 +93,16 @@ void EventHandler::ProcessSubscriptionChange(bool type, uint64_t eventSubscripti
 			_inputShowStateChangedRef++;
 		if ((eventSubscriptions & EventSubscription::SceneItemTransformChanged) != 0)
 			_sceneItemTransformChangedRef++;
+		if ((eventSubscriptions & EventSubscription::OutputStatistics) != 0) {
+			if (_outputStatisticsRef.fetch_add(1) == 0) {
+				if (_outputStatisticsHandler)
+					blog(LOG_WARNING,
+					     "[EventHandler::ProcessSubscription] Output statistics handler already exists!");
+				else
+					_outputStatisticsHandler = std::make_unique<Utils::Obs::OutputStatistics::Handler>(
+						std::bind(&EventHandler::HandleOutputStatistics, this, std::placeholders::_1));
+			}
+		}
 	} else {
 		if ((eventSubscriptions & EventSubscription::InputVolumeMeters) != 0) {
 			if (_inputVolumeMetersRef.fetch_sub(1) == 1)
@@ -104,6 +114,10 @@ void EventHandler::ProcessSubscriptionChange(bool type, uint64_t eventSubscripti
 			_inputShowStateChangedRef--;
 		if ((eventSubscriptions & EventSubscription::SceneItemTransformChanged) != 0)
 			_sceneItemTransformChangedRef--;
+		if ((eventSubscriptions & EventSubscription::OutputStatistics) != 0) {
+			if (_outputStatisticsRef.fetch_sub(1) == 1)
+				_outputStatisticsHandler.reset();
+		}
 	}
 }
 
@@ -116,6 +130,82 @@ void EventHandler::BroadcastEvent(uint64_t requiredIntent, std::string eventType
 	_eventCallback(requiredIntent, eventType, eventData, rpcVersion);
 }
 
+// Sources which have never reported a change share the base version, which is raised whenever all versions are reset
+uint64_t EventHandler::GetResourceVersion(ResourceType type, obs_source_t *source)
+{
+	std::unique_lock<std::mutex> lock(_resourceVersionsMutex);
+	auto it = _resourceVersions.find(obs_source_get_uuid(source));
+	if (it == _resourceVersions.end())
+		return _resourceVersionBase;
+
+	return it->second[type];
+}
+
+void EventHandler::BumpResourceVersion(ResourceType type, obs_source_t *source)
+{
+	if (!source)
+		return;
+
+	std::unique_lock<std::mutex> lock(_resourceVersionsMutex);
+	auto it = _resourceVersions.find(obs_source_get_uuid(source));
+	if (it == _resourceVersions.end()) {
+		std::array<uint64_t, RESOURCE_TYPE_COUNT> versions;
+		versions.fill(_resourceVersionBase);
+		it = _resourceVersions.emplace(obs_source_get_uuid(source), versions).first;
+	}
+
+	it->second[type] = ++_resourceVersionCounter;
+}
+
+// Used on source creation, so that a source reusing the UUID of a previous one never reports a version the client already has
+void EventHandler::BumpResourceVersions(obs_source_t *source)
+{
+	std::unique_lock<std::mutex> lock(_resourceVersionsMutex);
+	std::array<uint64_t, RESOURCE_TYPE_COUNT> versions;
+	versions.fill(++_resourceVersionCounter);
+	_resourceVersions[obs_source_get_uuid(source)] = versions;
+}
+
+void EventHandler::ForgetResourceVersions(obs_source_t *source)
+{
+	std::unique_lock<std::mutex> lock(_resourceVersionsMutex);
+	_resourceVersions.erase(obs_source_get_uuid(source));
+	_sceneItemBlendModeHashes.erase(obs_source_get_uuid(source));
+}
+
+// Invalidates every resource at once, for changes which affect resources of other sources (like renames)
+void EventHandler::ResetResourceVersions()
+{
+	std::unique_lock<std::mutex> lock(_resourceVersionsMutex);
+	_resourceVersions.clear();
+	_resourceVersionBase = ++_resourceVersionCounter;
+}
+
+// The first check only records the blend modes, as the version read after it already covers them
+void EventHandler::CheckSceneItemBlendModes(obs_scene_t *scene)
+{
+	size_t hash = 0;
+	auto cb = [](obs_scene_t *, obs_sceneitem_t *sceneItem, void *param) {
+		auto hash = static_cast<size_t *>(param);
+		size_t itemHash = std::hash<int64_t>()(obs_sceneitem_get_id(sceneItem)) * 31 +
+				  obs_sceneitem_get_blending_mode(sceneItem);
+		*hash ^= itemHash + 0x9e3779b9 + (*hash << 6) + (*hash >> 2);
+		return true;
+	};
+	obs_scene_enum_items(scene, cb, &hash);
+
+	obs_source_t *source = obs_scene_get_source(scene);
+	std::unique_lock<std::mutex> lock(_resourceVersionsMutex);
+	auto [it, inserted] = _sceneItemBlendModeHashes.emplace(obs_source_get_uuid(source), hash);
+	if (inserted || it->second == hash)
+		return;
+
+	it->second = hash;
+	lock.unlock();
+
+	BumpResourceVersion(RESOURCE_SCENE_ITEM_LIST, source);
+}
+
 // Connect source signals for Inputs, Scenes, and Transitions. Filters are automatically connected.
 void EventHandler::ConnectSourceSignals(obs_source_t *source) // Applies to inputs and scenes
 {
@@ -488,6 +578,8 @@ void EventHandler::SourceCreatedMultiHandler(void *param, calldata_t *data)
 
 	eventHandler->ConnectSourceSignals(source);
 
+	eventHandler->BumpResourceVersions(source);
+
 	switch (obs_source_get_type(source)) {
 	case OBS_SOURCE_TYPE_INPUT:
 		eventHandler->HandleInputCreated(source);
@@ -514,6 +606,8 @@ void EventHandler::SourceDestroyedMultiHandler(void *param, calldata_t *data)
 	// Disconnect all signals from the source
 	eventHandler->DisconnectSourceSignals(source);
 
+	eventHandler->ForgetResourceVersions(source);
+
 	switch (obs_source_get_type(source)) {
 	case OBS_SOURCE_TYPE_INPUT:
 		// Only emit removed if the input has not already been removed. This is the case when removing the last scene item of an input.
@@ -565,6 +659,9 @@ void EventHandler::SourceRenamedMultiHandler(void *param, calldata_t *data)
 	if (oldSourceName.empty() || sourceName.empty())
 		return;
 
+	// Source names are embedded in the resources of other sources (scene item lists)
+	eventHandler->ResetResourceVersions();
+
 	switch (obs_source_get_type(source)) {
 	case OBS_SOURCE_TYPE_INPUT:
 		eventHandler->HandleInputNameChanged(source, oldSourceName, sourceName);
@@ -589,9 +686,11 @@ void EventHandler::SourceUpdatedMultiHandler(void *param, calldata_t *data)
 
 	switch (obs_source_get_type(source)) {
 	case OBS_SOURCE_TYPE_INPUT:
+		eventHandler->BumpResourceVersion(RESOURCE_INPUT_SETTINGS, source);
 		eventHandler->HandleInputSettingsChanged(source);
 		break;
 	case OBS_SOURCE_TYPE_FILTER:
+		eventHandler->BumpResourceVersion(RESOURCE_SOURCE_FILTER_LIST, obs_filter_get_parent(source));
 		eventHandler->HandleSourceFilterSettingsChanged(source);
 		break;
 	default:
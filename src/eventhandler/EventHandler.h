@@ -20,6 +20,9 @@ with this program. If not, see <https://www.gnu.org/licenses/>
 #pragma once
 
 #include <atomic>
+#include <array>
+#include <mutex>
+#include <unordered_map>
 #include <obs.hpp>
 #include <obs-frontend-api.h>
 
@@ -27,6 +30,7 @@ with this program. If not, see <https://www.gnu.org/licenses/>
 #include "../obs-websocket.h"
 #include "../utils/Obs.h"
 #include "../utils/Obs_VolumeMeter.h"
+#include "../utils/Obs_OutputStatistics.h"
 #include "plugin-macros.generated.h"
 
 class EventHandler {
@@ -45,6 +49,18 @@ public:
 	typedef std::function<void(bool)> ObsReadyCallback; // bool ready
 	inline void SetObsReadyCallback(ObsReadyCallback cb) { _obsReadyCallback = cb; }
 
+	// Monotonically increasing versions of cacheable resources, bumped whenever a signal reports a change
+	enum ResourceType {
+		RESOURCE_INPUT_SETTINGS,
+		RESOURCE_SCENE_ITEM_LIST,
+		RESOURCE_SOURCE_FILTER_LIST,
+		RESOURCE_TYPE_COUNT,
+	};
+	uint64_t GetResourceVersion(ResourceType type, obs_source_t *source);
+	void BumpResourceVersion(ResourceType type, obs_source_t *source);
+	// libobs has no signal for blend mode changes, so they are detected whenever the scene item list is read
+	void CheckSceneItemBlendModes(obs_scene_t *scene);
+
 private:
 	EventCallback _eventCallback;
 	ObsReadyCallback _obsReadyCallback;
@@ -56,12 +72,24 @@ private:
 	std::atomic<uint64_t> _inputActiveStateChangedRef = 0;
 	std::atomic<uint64_t> _inputShowStateChangedRef = 0;
 	std::atomic<uint64_t> _sceneItemTransformChangedRef = 0;
+	std::unique_ptr<Utils::Obs::OutputStatistics::Handler> _outputStatisticsHandler;
+	std::atomic<uint64_t> _outputStatisticsRef = 0;
+
+	std::mutex _resourceVersionsMutex;
+	std::unordered_map<std::string, std::array<uint64_t, RESOURCE_TYPE_COUNT>> _resourceVersions; // Keyed by source UUID
+	uint64_t _resourceVersionCounter = 0;
+	uint64_t _resourceVersionBase = 0;
+	std::unordered_map<std::string, size_t> _sceneItemBlendModeHashes; // Keyed by scene UUID
 
 	void ConnectSourceSignals(obs_source_t *source);
 	void DisconnectSourceSignals(obs_source_t *source);
 
 	void BroadcastEvent(uint64_t requiredIntent, std::string eventType, json eventData = nullptr, uint8_t rpcVersion = 0);
 
+	void BumpResourceVersions(obs_source_t *source);
+	void ForgetResourceVersions(obs_source_t *source);
+	void ResetResourceVersions();
+
 	// Signal handler: frontend
 	static void OnFrontendEvent(enum obs_frontend_event event, void *private_data);
 	void FrontendFinishedLoadingMultiHandler();
@@ -158,6 +186,7 @@ private:
 	void HandleReplayBufferStateChanged(ObsOutputState state);
 	void HandleVirtualcamStateChanged(ObsOutputState state);
 	void HandleReplayBufferSaved();
+	void HandleOutputStatistics(std::vector<json> outputs); // OutputStatistics::Handler callback
 
 	// Scene Items
 	static void HandleSceneItemCreated(void *param,
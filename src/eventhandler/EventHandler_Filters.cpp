@@ -31,6 +31,8 @@ void EventHandler::FilterAddMultiHandler(void *param, calldata_t *data)
 
 	eventHandler->ConnectSourceSignals(filter);
 
+	eventHandler->BumpResourceVersion(RESOURCE_SOURCE_FILTER_LIST, source);
+
 	eventHandler->HandleSourceFilterCreated(source, filter);
 }
 
@@ -46,6 +48,8 @@ void EventHandler::FilterRemoveMultiHandler(void *param, calldata_t *data)
 
 	eventHandler->DisconnectSourceSignals(filter);
 
+	eventHandler->BumpResourceVersion(RESOURCE_SOURCE_FILTER_LIST, source);
+
 	eventHandler->HandleSourceFilterRemoved(source, filter);
 }
 
@@ -71,6 +75,8 @@ void EventHandler::HandleSourceFilterListReindexed(void *param, calldata_t *data
 	if (!source)
 		return;
 
+	eventHandler->BumpResourceVersion(RESOURCE_SOURCE_FILTER_LIST, source);
+
 	json eventData;
 	eventData["sourceName"] = obs_source_get_name(source);
 	eventData["filters"] = Utils::Obs::ArrayHelper::GetSourceFilterList(source);
@@ -156,6 +162,8 @@ void EventHandler::HandleSourceFilterNameChanged(void *param, calldata_t *data)
 	if (!filter)
 		return;
 
+	eventHandler->BumpResourceVersion(RESOURCE_SOURCE_FILTER_LIST, obs_filter_get_parent(filter));
+
 	json eventData;
 	eventData["sourceName"] = obs_source_get_name(obs_filter_get_parent(filter));
 	eventData["oldFilterName"] = calldata_string(data, "prev_name");
@@ -217,6 +225,8 @@ void EventHandler::HandleSourceFilterEnableStateChanged(void *param, calldata_t
 	if (!source)
 		return;
 
+	eventHandler->BumpResourceVersion(RESOURCE_SOURCE_FILTER_LIST, source);
+
 	bool filterEnabled = calldata_bool(data, "enabled");
 
 	json eventData;
@@ -150,3 +150,30 @@ void EventHandler::HandleReplayBufferSaved()
 	eventData["savedReplayPath"] = Utils::Obs::StringHelper::GetLastReplayBufferFileName();
 	BroadcastEvent(EventSubscription::Outputs, "ReplayBufferSaved", eventData);
 }
+
+/**
+ * A high-volume event providing statistics of the stream, record, replay buffer and virtualcam outputs every second.
+ *
+ * The outputs are sampled once for all subscribers, so this can replace polling `GetStreamStatus`, `GetRecordStatus` and
+ * `GetOutputStatus`.
+ *
+ * Each output object contains `outputType` (`stream`, `record`, `replayBuffer` or `virtualcam`), `outputName`, `outputActive`,
+ * `outputReconnecting`, `outputTimecode`, `outputDuration`, `outputCongestion`, `outputBytes`, `outputBitrate` (kbps, over the
+ * last second), `outputSkippedFrames` and `outputTotalFrames`. Outputs which the frontend has not created are omitted.
+ *
+ * @dataField outputs | Array<Object> | Array of frontend outputs with their associated statistics
+ *
+ * @eventType OutputStatistics
+ * @eventSubscription OutputStatistics
+ * @complexity 3
+ * @rpcVersion -1
+ * @initialVersion 5.5.0
+ * @api events
+ * @category outputs
+ */
+void EventHandler::HandleOutputStatistics(std::vector<json> outputs)
+{
+	json eventData;
+	eventData["outputs"] = outputs;
+	BroadcastEvent(EventSubscription::OutputStatistics, "OutputStatistics", eventData);
+}
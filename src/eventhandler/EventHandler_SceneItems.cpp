@@ -45,6 +45,8 @@ void EventHandler::HandleSceneItemCreated(void *param, calldata_t *data)
 	if (!scene)
 		return;
 
+	eventHandler->BumpResourceVersion(RESOURCE_SCENE_ITEM_LIST, obs_scene_get_source(scene));
+
 	obs_sceneitem_t *sceneItem = GetCalldataPointer<obs_sceneitem_t>(data, "item");
 	if (!sceneItem)
 		return;
@@ -86,6 +88,8 @@ void EventHandler::HandleSceneItemRemoved(void *param, calldata_t *data)
 	if (!scene)
 		return;
 
+	eventHandler->BumpResourceVersion(RESOURCE_SCENE_ITEM_LIST, obs_scene_get_source(scene));
+
 	obs_sceneitem_t *sceneItem = GetCalldataPointer<obs_sceneitem_t>(data, "item");
 	if (!sceneItem)
 		return;
@@ -122,6 +126,8 @@ void EventHandler::HandleSceneItemListReindexed(void *param, calldata_t *data)
 	if (!scene)
 		return;
 
+	eventHandler->BumpResourceVersion(RESOURCE_SCENE_ITEM_LIST, obs_scene_get_source(scene));
+
 	json eventData;
 	eventData["sceneName"] = obs_source_get_name(obs_scene_get_source(scene));
 	eventData["sceneUuid"] = obs_source_get_uuid(obs_scene_get_source(scene));
@@ -153,6 +159,8 @@ void EventHandler::HandleSceneItemEnableStateChanged(void *param, calldata_t *da
 	if (!scene)
 		return;
 
+	eventHandler->BumpResourceVersion(RESOURCE_SCENE_ITEM_LIST, obs_scene_get_source(scene));
+
 	obs_sceneitem_t *sceneItem = GetCalldataPointer<obs_sceneitem_t>(data, "item");
 	if (!sceneItem)
 		return;
@@ -191,6 +199,8 @@ void EventHandler::HandleSceneItemLockStateChanged(void *param, calldata_t *data
 	if (!scene)
 		return;
 
+	eventHandler->BumpResourceVersion(RESOURCE_SCENE_ITEM_LIST, obs_scene_get_source(scene));
+
 	obs_sceneitem_t *sceneItem = GetCalldataPointer<obs_sceneitem_t>(data, "item");
 	if (!sceneItem)
 		return;
@@ -259,13 +269,16 @@ void EventHandler::HandleSceneItemTransformChanged(void *param, calldata_t *data
 {
 	auto eventHandler = static_cast<EventHandler *>(param);
 
-	if (!eventHandler->_sceneItemTransformChangedRef.load())
-		return;
-
 	obs_scene_t *scene = GetCalldataPointer<obs_scene_t>(data, "scene");
 	if (!scene)
 		return;
 
+	// Versions must be tracked even when nobody is subscribed to the event itself
+	eventHandler->BumpResourceVersion(RESOURCE_SCENE_ITEM_LIST, obs_scene_get_source(scene));
+
+	if (!eventHandler->_sceneItemTransformChangedRef.load())
+		return;
+
 	obs_sceneitem_t *sceneItem = GetCalldataPointer<obs_sceneitem_t>(data, "item");
 	if (!sceneItem)
 		return;
@@ -209,5 +209,16 @@ namespace EventSubscription {
 		* @api enums
 		*/
 		SceneItemTransformChanged = (1 << 19),
+		/**
+		* Subscription value to receive the `OutputStatistics` high-volume event.
+		*
+		* @enumIdentifier OutputStatistics
+		* @enumValue (1 << 20)
+		* @enumType EventSubscription
+		* @rpcVersion -1
+		* @initialVersion 5.5.0
+		* @api enums
+		*/
+		OutputStatistics = (1 << 20),
 	};
 }
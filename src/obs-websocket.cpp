@@ -28,6 +28,8 @@ with this program. If not, see <https://www.gnu.org/licenses/>
 #include "websocketserver/WebSocketServer.h"
 #include "eventhandler/EventHandler.h"
 #include "forms/SettingsDialog.h"
+#include "utils/FlightRecorder.h"
+#include "utils/TrafficCapture.h"
 
 OBS_DECLARE_MODULE()
 OBS_MODULE_USE_DEFAULT_LOCALE("obs-websocket", "en-US")
@@ -73,6 +75,13 @@ bool obs_module_load(void)
 	_config = std::make_shared<Config>();
 	_config->Load(migratedConfig);
 
+	// Start the flight recorder and traffic capture before anything can be recorded
+	if (_config->FlightRecorderSizeMiB)
+		Utils::FlightRecorder::Start(Utils::Obs::StringHelper::GetModuleConfigPath("flight_recorder.bin"),
+					     (uint64_t)_config->FlightRecorderSizeMiB * 1024 * 1024);
+	if (!_config->CaptureFilePath.empty())
+		Utils::TrafficCapture::Start(_config->CaptureFilePath);
+
 	// Initialize the event handler
 	_eventHandler = std::make_shared<EventHandler>();
 	_eventHandler->SetEventCallback(OnEvent);
@@ -145,6 +154,10 @@ void obs_module_unload(void)
 	_eventHandler->SetEventCallback(nullptr);
 	_eventHandler = nullptr;
 
+	// Stop the flight recorder and traffic capture once nothing is left to record
+	Utils::FlightRecorder::Stop();
+	Utils::TrafficCapture::Stop();
+
 	// Release the config manager
 	_config = nullptr;
 
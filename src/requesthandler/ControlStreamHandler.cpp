@@ -0,0 +1,215 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <unordered_map>
+#include <vector>
+
+#include "ControlStreamHandler.h"
+#include "../obs-websocket.h"
+
+// Limits the memory a single session can use, as a control stream never waits for anything
+static const size_t MaxPendingControlUpdates = 1024;
+
+struct ControlDefinition {
+	std::vector<std::string> valueFields; // Everything else in the request data identifies the target
+	bool mergeValues;                     // Whether object values are merged with those of pending updates
+};
+
+static const std::unordered_map<std::string, ControlDefinition> controlDefinitions{
+	{"SetTBarPosition", {{"position", "release"}, false}},
+	{"SetInputVolume", {{"inputVolumeMul", "inputVolumeDb"}, false}},
+	{"SetInputAudioBalance", {{"inputAudioBalance"}, false}},
+	{"SetInputMute", {{"inputMuted"}, false}},
+	{"SetSceneItemTransform", {{"sceneItemTransform"}, true}},
+};
+
+// Sources can be targeted by name or by UUID, which has to result in the same key. Like in request validation, the name
+// takes precedence. A name which does not resolve is left as is, as its updates fail anyway.
+static void ResolveControlTarget(json &target, const std::string &nameField, const std::string &uuidField)
+{
+	if (!target.contains(nameField) || !target[nameField].is_string())
+		return;
+
+	std::string sourceName = target[nameField];
+	OBSSourceAutoRelease source = obs_get_source_by_name(sourceName.c_str());
+	if (!source)
+		return;
+
+	target.erase(nameField);
+	target[uuidField] = obs_source_get_uuid(source);
+}
+
+static std::string GetControlKey(const std::string &requestType, const ControlDefinition &definition,
+				 const json &requestData)
+{
+	json target = requestData;
+	for (auto &valueField : definition.valueFields)
+		target.erase(valueField);
+
+	ResolveControlTarget(target, "inputName", "inputUuid");
+	ResolveControlTarget(target, "sceneName", "sceneUuid");
+
+	// Object keys are sorted, so the same target always results in the same key
+	return requestType + "\n" + target.dump();
+}
+
+static void MergeControlUpdate(const ControlDefinition &definition, json &pendingData, json &&requestData)
+{
+	for (auto &valueField : definition.valueFields) {
+		if (!requestData.contains(valueField)) {
+			// Fields like `inputVolumeMul` and `inputVolumeDb` replace each other
+			if (!definition.mergeValues)
+				pendingData.erase(valueField);
+			continue;
+		}
+
+		json &value = requestData[valueField];
+		if (definition.mergeValues && value.is_object() && pendingData[valueField].is_object())
+			pendingData[valueField].update(value);
+		else
+			pendingData[valueField] = std::move(value);
+	}
+}
+
+// Must be called with the control stream mutex locked
+static void ClearControlUpdates(WebSocketSession &session)
+{
+	session.ControlStreamStats.dropped += session.PendingControlUpdates.size();
+	session.PendingControlUpdates.clear();
+	session.PendingControlUpdateIndex.clear();
+}
+
+// Runs on the graphics thread. Updates which do not fit into the tick budget are applied first on the next tick, so that
+// no target is starved by targets which are updated more often.
+static bool ApplyControlUpdates(SessionPtr session, const RequestBatchScheduler::FrameTick &tick)
+{
+	std::unique_lock<std::mutex> lock(session->ControlStreamMutex);
+	auto pendingUpdates = std::move(session->PendingControlUpdates);
+	session->PendingControlUpdates.clear();
+	session->PendingControlUpdateIndex.clear();
+	lock.unlock();
+
+	RequestHandler requestHandler(session);
+	auto &stats = session->ControlStreamStats;
+	auto it = pendingUpdates.begin();
+	for (; it != pendingUpdates.end(); ++it) {
+		if (it != pendingUpdates.begin() && RequestBatchScheduler::Clock::now() >= tick.deadline)
+			break;
+
+		Request request(it->requestType, std::move(it->requestData), RequestBatchExecutionType::SerialFrame);
+		RequestResult requestResult = requestHandler.ProcessRequest(request);
+		if (requestResult.Succeeded()) {
+			stats.applied++;
+		} else {
+			stats.failed++;
+			blog_debug("[ControlStreamHandler::ApplyControlUpdates] Control update `%s` failed: %s",
+				   request.RequestType.c_str(), requestResult.Comment.c_str());
+		}
+	}
+
+	lock.lock();
+	// Newer updates for the same target, which arrived during the tick, are merged into the carried over ones
+	auto &index = session->PendingControlUpdateIndex;
+	for (auto carriedUpdate = it; carriedUpdate != pendingUpdates.end(); ++carriedUpdate) {
+		auto newerUpdate = index.find(carriedUpdate->key);
+		if (newerUpdate != index.end()) {
+			auto &definition = controlDefinitions.at(carriedUpdate->requestType);
+			MergeControlUpdate(definition, carriedUpdate->requestData, std::move(newerUpdate->second->requestData));
+			session->PendingControlUpdates.erase(newerUpdate->second);
+			stats.superseded++;
+		}
+
+		// Iterators stay valid when the update is spliced into the pending updates of the session
+		index[carriedUpdate->key] = carriedUpdate;
+	}
+	session->PendingControlUpdates.splice(session->PendingControlUpdates.begin(), pendingUpdates, it, pendingUpdates.end());
+
+	// The control stream has been closed during the tick
+	if (!session->ControlStreamEnabled())
+		ClearControlUpdates(*session);
+
+	session->ControlStreamTaskScheduled = !session->PendingControlUpdates.empty();
+	return session->ControlStreamTaskScheduled;
+}
+
+void ControlStreamHandler::DropControlUpdates(SessionPtr session)
+{
+	std::lock_guard<std::mutex> lock(session->ControlStreamMutex);
+	ClearControlUpdates(*session);
+	session->ControlStreamTaskScheduled = false;
+}
+
+void ControlStreamHandler::CloseControlStream(SessionPtr session)
+{
+	session->SetControlStreamEnabled(false);
+
+	// An in-progress tick drops the updates it carries over, as the control stream is no longer enabled
+	std::lock_guard<std::mutex> lock(session->ControlStreamMutex);
+	ClearControlUpdates(*session);
+}
+
+void ControlStreamHandler::SubmitControlUpdate(RequestBatchScheduler &scheduler, SessionPtr session,
+					       const std::string &requestType, json &&requestData)
+{
+	auto &stats = session->ControlStreamStats;
+	stats.received++;
+
+	auto definition = controlDefinitions.find(requestType);
+	if (definition == controlDefinitions.end() || !requestData.is_object()) {
+		stats.dropped++;
+		return;
+	}
+
+	std::string key = GetControlKey(requestType, definition->second, requestData);
+
+	std::lock_guard<std::mutex> lock(session->ControlStreamMutex);
+	auto &pendingUpdates = session->PendingControlUpdates;
+	auto &index = session->PendingControlUpdateIndex;
+	auto pendingUpdate = index.find(key);
+	if (pendingUpdate != index.end()) {
+		MergeControlUpdate(definition->second, pendingUpdate->second->requestData, std::move(requestData));
+		stats.superseded++;
+	} else if (pendingUpdates.size() >= MaxPendingControlUpdates) {
+		stats.dropped++;
+		return;
+	} else {
+		pendingUpdates.push_back(WebSocketSession::ControlUpdate{key, requestType, std::move(requestData)});
+		index.emplace(std::move(key), std::prev(pendingUpdates.end()));
+	}
+
+	// A single frame task per session applies all of its pending updates, and stops once there are none left
+	if (!session->ControlStreamTaskScheduled) {
+		session->ControlStreamTaskScheduled = true;
+		scheduler.AddFrameTask(
+			[session](const RequestBatchScheduler::FrameTick &tick) { return ApplyControlUpdates(session, tick); },
+			[session]() { ControlStreamHandler::DropControlUpdates(session); });
+	}
+}
+
+json ControlStreamHandler::GetStatistics(SessionPtr session)
+{
+	auto &stats = session->ControlStreamStats;
+
+	json ret;
+	ret["received"] = stats.received.load();
+	ret["applied"] = stats.applied.load();
+	ret["failed"] = stats.failed.load();
+	ret["superseded"] = stats.superseded.load();
+	ret["dropped"] = stats.dropped.load();
+	return ret;
+}
@@ -0,0 +1,37 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include "RequestBatchScheduler.h"
+#include "RequestHandler.h"
+
+// Applies high-frequency control updates, like fader moves, without a request and response for each of them.
+// Only the latest update of each control and target is kept, and all pending updates are applied once per video frame.
+namespace ControlStreamHandler {
+	// Never sends a response. Updates which are not accepted are only counted as dropped.
+	void SubmitControlUpdate(RequestBatchScheduler &scheduler, SessionPtr session, const std::string &requestType,
+				 json &&requestData);
+
+	// Once the frame task of the session has been cancelled
+	void DropControlUpdates(SessionPtr session);
+	// Once the session has disconnected. Pending updates are dropped, and no more are accepted.
+	void CloseControlStream(SessionPtr session);
+
+	json GetStatistics(SessionPtr session);
+}
@@ -16,42 +16,172 @@ You should have received a copy of the GNU General Public License along
 with this program. If not, see <https://www.gnu.org/licenses/>
 */
 
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <queue>
-#include <condition_variable>
-#include <util/profiler.hpp>
+#include <unordered_map>
+
+#include <obs-frontend-api.h>
 
 #include "RequestBatchHandler.h"
-#include "../utils/Compat.h"
 #include "../obs-websocket.h"
 
-struct SerialFrameBatch {
-	RequestHandler &requestHandler;
-	std::queue<RequestBatchRequest> requests;
-	std::vector<RequestResult> results;
-	json &variables;
+struct RequestBatch : std::enable_shared_from_this<RequestBatch> {
+	RequestBatchScheduler &scheduler;
+	RequestHandler requestHandler;
+	std::vector<RequestBatchRequest> requests;
+	json variables;
 	bool haltOnFailure;
+	RequestBatchHandler::ResultsCallback callback;
+	RequestBatchHandler::ResultCallback resultCallback; // Only set if results are streamed
+	std::vector<RequestResult> results;
+	json statistics;
+	uint64_t startedAt; // SerialFrame batches start on their first tick
+
+	// Streamed results and the final response are sent in order on the thread pool, so that they are never sent from the
+	// graphics thread or with a lock of the batch held
+	std::mutex sendMutex;
+	std::queue<std::function<void()>> pendingSends;
+	bool sending = false;
+
+	RequestBatch(RequestBatchScheduler &scheduler, SessionPtr session, std::vector<RequestBatchRequest> &&requests,
+		     json &&variables, bool haltOnFailure, RequestBatchHandler::ResultsCallback &&callback,
+		     RequestBatchHandler::ResultCallback &&resultCallback)
+		: scheduler(scheduler),
+		  requestHandler(session),
+		  requests(std::move(requests)),
+		  variables(std::move(variables)),
+		  haltOnFailure(haltOnFailure),
+		  callback(std::move(callback)),
+		  resultCallback(std::move(resultCallback)),
+		  results(this->requests.size()),
+		  startedAt(os_gettime_ns())
+	{
+	}
+
+	// Streamed results are sent right away instead of being kept for the final response, unless `keep` is set
+	inline void AddResult(size_t index, RequestResult &&requestResult, bool keep = false)
+	{
+		if (!resultCallback) {
+			results[index] = std::move(requestResult);
+			return;
+		}
+
+		if (keep)
+			results[index] = requestResult;
+
+		PostSend([this, index, requestResult = std::move(requestResult)]() mutable {
+			resultCallback(index, std::move(requestResult));
+		});
+	}
+
+	inline void Finish(size_t resultCount)
+	{
+		if (!resultCallback) {
+			callback(std::move(results), resultCount, std::move(statistics), startedAt);
+			return;
+		}
+
+		PostSend([this, resultCount]() {
+			callback(std::vector<RequestResult>(), resultCount, std::move(statistics), startedAt);
+		});
+	}
+
+	void PostSend(std::function<void()> send)
+	{
+		std::unique_lock<std::mutex> lock(sendMutex);
+		pendingSends.push(std::move(send));
+		if (sending)
+			return;
 
-	size_t frameCount = 0;
-	size_t sleepUntilFrame = 0;
-	std::mutex conditionMutex;
-	std::condition_variable condition;
+		sending = true;
+		lock.unlock();
+
+		scheduler.Run([batch = shared_from_this()]() { batch->ProcessSends(); });
+	}
 
-	SerialFrameBatch(RequestHandler &requestHandler, json &variables, bool haltOnFailure)
-		: requestHandler(requestHandler),
-		  variables(variables),
-		  haltOnFailure(haltOnFailure)
+	void ProcessSends()
 	{
+		std::unique_lock<std::mutex> lock(sendMutex);
+		while (!pendingSends.empty()) {
+			auto send = std::move(pendingSends.front());
+			pendingSends.pop();
+			lock.unlock();
+
+			send();
+
+			lock.lock();
+		}
+		sending = false;
 	}
 };
 
-struct ParallelBatchResults {
-	RequestHandler &requestHandler;
-	std::vector<RequestResult> results;
+struct SerialBatch : RequestBatch {
+	using RequestBatch::RequestBatch;
+
+	size_t nextRequest = 0;
+	size_t resultCount = 0;
+
+	// SerialFrame only
+	uint64_t firstTick = 0;
+	uint64_t sleepUntilTick = 0;
+	uint64_t laggedFrames = 0; // Ticks in which processing the batch took longer than a frame
+
+	inline bool IsFinished() const { return nextRequest == requests.size(); }
+};
+
+struct ParallelBatch : RequestBatch {
+	using RequestBatch::RequestBatch;
+
+	std::atomic<size_t> remainingCount = 0;
+};
+
+struct DataflowInput {
+	std::string requestField;
+	std::string variableName;
+	size_t producer; // Index of the request which outputs the variable, or the request count for a batch variable
+};
+
+struct DataflowBatch : RequestBatch {
+	using RequestBatch::RequestBatch;
+
+	std::vector<std::vector<DataflowInput>> inputs;
+	std::vector<std::vector<size_t>> dependents;
+	std::vector<size_t> pendingDependencies;
+
+	std::mutex mutex;
+	std::queue<size_t> readyRequests;
+	size_t runningCount = 0;
+	size_t finishedCount = 0;
+	size_t helperCount = 0;
+	size_t haltIndex = 0; // Index of the first failed request if `haltOnFailure` is set
+};
 
-	std::mutex conditionMutex;
-	std::condition_variable condition;
+struct FrameAtomicBatch : RequestBatch {
+	using RequestBatch::RequestBatch;
 
-	ParallelBatchResults(RequestHandler &requestHandler) : requestHandler(requestHandler) {}
+	std::vector<RequestResult> pendingResults; // Held back until the changes are applied
+};
+
+struct ScheduledRequestBatch {
+	SessionPtr session;
+	std::string requestId;
+	uint64_t cueId = 0;
+	RequestBatchHandler::Schedule schedule;
+	RequestBatchExecutionType::RequestBatchExecutionType executionType;
+	std::vector<RequestBatchRequest> requests;
+	json variables;
+	bool haltOnFailure;
+	RequestBatchHandler::ResultsCallback callback;
+	RequestBatchHandler::ResultCallback resultCallback;
+	std::shared_ptr<FrameAtomicBatch> frameAtomicBatch; // Validated when the batch is scheduled
+
+	// Only touched by the graphics thread
+	int64_t frameDelta = 0;
+	bool transitionStarted = false;
+	bool mediaInputRemoved = false;
 };
 
 // `{"inputName": "inputNameVariable"}` is essentially `inputName = inputNameVariable`
@@ -109,126 +239,700 @@ static void PostProcessVariables(json &variables, const RequestBatchRequest &req
 	}
 }
 
-static void ObsTickCallback(void *param, float)
+// A request depends on the last request before it which outputs any of its input variables. Since inputs are read from
+// the results of their producers rather than from a shared variable map, later writers of a variable never race with
+// earlier readers.
+static void BuildDataflowGraph(DataflowBatch &batch)
+{
+	size_t requestCount = batch.requests.size();
+	batch.inputs.resize(requestCount);
+	batch.dependents.resize(requestCount);
+	batch.pendingDependencies.resize(requestCount, 0);
+	batch.haltIndex = requestCount;
+
+	std::unordered_map<std::string, size_t> producers;
+
+	for (size_t i = 0; i < requestCount; i++) {
+		auto &request = batch.requests[i];
+
+		if (request.InputVariables.is_object()) {
+			for (auto &[key, value] : request.InputVariables.items()) {
+				if (!value.is_string()) {
+					blog_debug(
+						"[WebSocketServer::ProcessRequestBatch] Value of field `%s` in `inputVariables `is not a string. Skipping!",
+						key.c_str());
+					continue;
+				}
+
+				std::string variableName = value;
+				auto producer = producers.find(variableName);
+				if (producer == producers.end()) {
+					batch.inputs[i].push_back({key, variableName, requestCount});
+					continue;
+				}
+
+				batch.inputs[i].push_back({key, variableName, producer->second});
+
+				// Dependencies of a request are added consecutively, so a duplicate can only be the last entry
+				auto &dependents = batch.dependents[producer->second];
+				if (dependents.empty() || dependents.back() != i) {
+					dependents.push_back(i);
+					batch.pendingDependencies[i]++;
+				}
+			}
+		}
+
+		if (request.OutputVariables.is_object()) {
+			for (auto &[key, value] : request.OutputVariables.items()) {
+				if (value.is_string())
+					producers[key] = i;
+			}
+		}
+
+		if (!batch.pendingDependencies[i])
+			batch.readyRequests.push(i);
+	}
+}
+
+static void PreProcessDataflowVariables(DataflowBatch &batch, size_t index)
 {
-	ScopeProfiler prof{"obs_websocket_request_batch_frame_tick"};
+	if (batch.inputs[index].empty())
+		return;
 
-	auto serialFrameBatch = static_cast<SerialFrameBatch *>(param);
+	RequestBatchRequest &request = batch.requests[index];
+	const json &variables = batch.variables;
 
-	// Increment frame count
-	serialFrameBatch->frameCount++;
+	for (auto &input : batch.inputs[index]) {
+		if (input.producer == batch.requests.size()) {
+			if (!variables.is_object() || !variables.contains(input.variableName)) {
+				blog_debug(
+					"[WebSocketServer::ProcessRequestBatch] `inputVariables` requested variable `%s`, but it does not exist. Skipping!",
+					input.variableName.c_str());
+				continue;
+			}
 
-	if (serialFrameBatch->sleepUntilFrame) {
-		if (serialFrameBatch->frameCount < serialFrameBatch->sleepUntilFrame)
-			// Do not process any requests if in "sleep mode"
-			return;
-		else
-			// Reset frame sleep until counter if not being used
-			serialFrameBatch->sleepUntilFrame = 0;
+			request.RequestData[input.requestField] = variables[input.variableName];
+			continue;
+		}
+
+		// Producers are finished before their dependents start, so their results are no longer written to
+		const json &responseData = batch.results[input.producer].ResponseData;
+		const json &outputVariables = batch.requests[input.producer].OutputVariables;
+		std::string responseField = outputVariables[input.variableName];
+		if (!responseData.is_object() || !responseData.contains(responseField)) {
+			blog_debug(
+				"[WebSocketServer::ProcessRequestBatch] `outputVariables` requested responseData field `%s`, but it does not exist. Skipping!",
+				responseField.c_str());
+			continue;
+		}
+
+		request.RequestData[input.requestField] = responseData[responseField];
 	}
 
-	// Begin recursing any unprocessed requests
-	while (!serialFrameBatch->requests.empty()) {
-		// Fetch first in queue
-		RequestBatchRequest request = serialFrameBatch->requests.front();
-		// Pre-process batch variables
-		PreProcessVariables(serialFrameBatch->variables, request);
-		// Process request and get result
-		RequestResult requestResult = serialFrameBatch->requestHandler.ProcessRequest(request);
-		// Post-process batch variables
-		PostProcessVariables(serialFrameBatch->variables, request, requestResult);
-		// Add to results vector
-		serialFrameBatch->results.push_back(requestResult);
-		// Remove from front of queue
-		serialFrameBatch->requests.pop();
-
-		// If haltOnFailure and the request failed, clear the queue to make the batch return early.
-		if (serialFrameBatch->haltOnFailure && requestResult.StatusCode != RequestStatus::Success) {
-			serialFrameBatch->requests = std::queue<RequestBatchRequest>();
-			break;
+	request.HasRequestData = !request.RequestData.empty();
+}
+
+static void ProcessDataflowRequests(RequestBatchScheduler &scheduler, std::shared_ptr<DataflowBatch> batch);
+
+// Must be called with the batch mutex locked
+static void StartDataflowHelpers(RequestBatchScheduler &scheduler, const std::shared_ptr<DataflowBatch> &batch)
+{
+	size_t maxHelperCount = std::max(scheduler.GetThreadPool().maxThreadCount(), 1);
+
+	// Helpers which are not running a request will pick up the next ready ones
+	while (batch->helperCount < maxHelperCount && batch->helperCount - batch->runningCount < batch->readyRequests.size()) {
+		batch->helperCount++;
+		scheduler.Run([&scheduler, batch]() { ProcessDataflowRequests(scheduler, batch); });
+	}
+}
+
+// Helpers return once no request is ready. The last one to return finishes the batch.
+static void ProcessDataflowRequests(RequestBatchScheduler &scheduler, std::shared_ptr<DataflowBatch> batch)
+{
+	std::unique_lock<std::mutex> lock(batch->mutex);
+	while (!batch->readyRequests.empty()) {
+		size_t index = batch->readyRequests.front();
+		batch->readyRequests.pop();
+
+		// With `haltOnFailure`, requests before the first failure still complete, but none after it are started
+		if (index > batch->haltIndex)
+			continue;
+
+		batch->runningCount++;
+		lock.unlock();
+
+		PreProcessDataflowVariables(*batch, index);
+		RequestResult requestResult = batch->requestHandler.ProcessRequest(batch->requests[index]);
+		bool succeeded = requestResult.Succeeded();
+
+		// Dependents read their inputs from the result, so it has to be kept even if streamed.
+		// Streamed results are only copied under the lock, and sent on the thread pool before the batch finishes.
+		bool keepResult = !batch->dependents[index].empty();
+		if (!keepResult)
+			batch->AddResult(index, std::move(requestResult));
+
+		lock.lock();
+		batch->runningCount--;
+		batch->finishedCount++;
+
+		if (batch->haltOnFailure && !succeeded && index < batch->haltIndex)
+			batch->haltIndex = index;
+
+		if (keepResult)
+			batch->AddResult(index, std::move(requestResult), true);
+
+		for (size_t dependent : batch->dependents[index]) {
+			if (--batch->pendingDependencies[dependent] == 0)
+				batch->readyRequests.push(dependent);
 		}
 
+		StartDataflowHelpers(scheduler, batch);
+	}
+
+	// A request is only ever running inside of a helper, so no helper means no more work
+	bool finished = --batch->helperCount == 0;
+	lock.unlock();
+
+	if (!finished)
+		return;
+
+	// Requests after the first failure which were already running still finish. Their results are left out of the
+	// response, but streamed ones have already been sent, so every one of those is counted.
+	if (batch->resultCallback)
+		batch->Finish(batch->finishedCount);
+	else
+		batch->Finish(std::min(batch->haltIndex + 1, batch->requests.size()));
+}
+
+// Processes the next request of a serial batch, skipping the remaining ones on failure if `haltOnFailure` is set.
+// Returns the sleep duration requested by the request, in frames or milliseconds depending on the execution type.
+static size_t ProcessNextSerialRequest(SerialBatch &batch)
+{
+	size_t index = batch.nextRequest++;
+	RequestBatchRequest &request = batch.requests[index];
+	// Pre-process batch variables
+	PreProcessVariables(batch.variables, request);
+	// Process request and get result
+	RequestResult requestResult = batch.requestHandler.ProcessRequest(request);
+	// Post-process batch variables
+	PostProcessVariables(batch.variables, request, requestResult);
+
+	if (batch.haltOnFailure && !requestResult.Succeeded())
+		batch.nextRequest = batch.requests.size();
+
+	size_t sleep = request.ExecutionType == RequestBatchExecutionType::SerialFrame ? requestResult.SleepFrames
+										       : requestResult.SleepMillis;
+
+	// Add to results
+	batch.AddResult(index, std::move(requestResult));
+	batch.resultCount++;
+
+	return sleep;
+}
+
+// Finishes a suspended batch with the results it has so far, once the scheduler has cancelled it
+static void CancelSerialBatch(SerialBatch &batch)
+{
+	batch.statistics["cancelled"] = true;
+	batch.Finish(batch.resultCount);
+}
+
+static void ResumeSerialRealtimeBatch(RequestBatchScheduler &scheduler, std::shared_ptr<SerialBatch> batch)
+{
+	while (!batch->IsFinished()) {
+		size_t sleepMillis = ProcessNextSerialRequest(*batch);
+
+		// Suspend the batch instead of blocking the worker thread. It is resumed on the thread pool once the time is up.
+		if (sleepMillis) {
+			scheduler.RunAfter(
+				std::chrono::milliseconds(sleepMillis),
+				[&scheduler, batch]() { ResumeSerialRealtimeBatch(scheduler, batch); },
+				[batch]() { CancelSerialBatch(*batch); });
+			return;
+		}
+	}
+
+	batch->Finish(batch->resultCount);
+}
+
+// Runs on the graphics thread once per frame. Returns `false` once the batch is finished.
+static bool TickSerialFrameBatch(RequestBatchScheduler &scheduler, std::shared_ptr<SerialBatch> batch,
+				 const RequestBatchScheduler::FrameTick &tick)
+{
+	if (!batch->firstTick) {
+		batch->firstTick = tick.tickCount;
+		batch->startedAt = os_gettime_ns();
+	}
+
+	// Do not process any requests if in "sleep mode"
+	if (tick.tickCount < batch->sleepUntilTick)
+		return true;
+
+	// Process at least one request, then carry the remaining ones over to the next tick once the budget is used up
+	uint64_t tickStartedAt = os_gettime_ns();
+	while (!batch->IsFinished()) {
+		size_t sleepFrames = ProcessNextSerialRequest(*batch);
+
 		// If the processed request tells us to sleep, do so accordingly
-		if (requestResult.SleepFrames) {
-			serialFrameBatch->sleepUntilFrame = serialFrameBatch->frameCount + requestResult.SleepFrames;
+		if (sleepFrames) {
+			batch->sleepUntilTick = tick.tickCount + sleepFrames;
 			break;
 		}
+
+		if (RequestBatchScheduler::Clock::now() >= tick.deadline)
+			break;
 	}
 
-	// If request queue is empty, we can notify the paused worker thread
-	if (serialFrameBatch->requests.empty())
-		serialFrameBatch->condition.notify_one();
+	// The lagged frames of OBS are counted globally, and would include those caused by anything else
+	if (os_gettime_ns() - tickStartedAt > video_output_get_frame_time(obs_get_video()))
+		batch->laggedFrames++;
+
+	if (!batch->IsFinished())
+		return true;
+
+	batch->statistics["tickCount"] = tick.tickCount - batch->firstTick + 1;
+	batch->statistics["laggedFrames"] = batch->laggedFrames;
+
+	// Avoid building and sending the response in the graphics thread
+	scheduler.Run([batch]() { batch->Finish(batch->resultCount); });
+	return false;
 }
 
-std::vector<RequestResult>
-RequestBatchHandler::ProcessRequestBatch(QThreadPool &threadPool, SessionPtr session,
-					 RequestBatchExecutionType::RequestBatchExecutionType executionType,
-					 std::vector<RequestBatchRequest> &requests, json &variables, bool haltOnFailure)
+static void AtomicUpdateCallback(void *data, obs_scene_t *)
 {
-	RequestHandler requestHandler(session);
-	if (executionType == RequestBatchExecutionType::SerialRealtime) {
-		std::vector<RequestResult> ret;
+	auto updates = static_cast<std::vector<std::function<void()>> *>(data);
+	for (auto &update : *updates)
+		update();
+}
+
+// Runs on the graphics thread. Applies the changes of all requests within one atomic update per affected scene.
+static void ApplyFrameAtomicBatch(FrameAtomicBatch &batch, const RequestBatchScheduler::FrameTick &tick)
+{
+	// Scenes are updated in the order of the first request which changes them
+	std::vector<std::pair<OBSScene, std::vector<std::function<void()>>>> sceneUpdates;
+	for (auto &result : batch.pendingResults) {
+		auto it = std::find_if(sceneUpdates.begin(), sceneUpdates.end(),
+				       [&result](const auto &sceneUpdate) { return sceneUpdate.first == result.UpdateScene; });
+		if (it == sceneUpdates.end())
+			it = sceneUpdates.insert(sceneUpdates.end(), {result.UpdateScene, {}});
+		it->second.push_back(std::move(result.ApplyUpdate));
+		result.UpdateScene = nullptr;
+	}
+
+	for (auto &sceneUpdate : sceneUpdates)
+		obs_scene_atomic_update(sceneUpdate.first, AtomicUpdateCallback, &sceneUpdate.second);
+
+	batch.statistics["appliedFrame"] = tick.frame;
+}
+
+static void FinishFrameAtomicBatch(FrameAtomicBatch &batch, bool applied)
+{
+	size_t resultCount = batch.pendingResults.size();
+
+	// None of the changes of a batch which was not applied took effect, so none of its requests may report success
+	if (!applied) {
+		std::string comment = "The request batch was not applied, because it was cancelled.";
+		if (resultCount && !batch.pendingResults.back().Succeeded())
+			comment = "The request batch was not applied, because the request at index " +
+				  std::to_string(resultCount - 1) + " failed.";
+
+		for (auto &result : batch.pendingResults) {
+			if (result.Succeeded())
+				result = RequestResult::Error(RequestStatus::CannotAct, comment);
+		}
+	}
 
-		// Recurse all requests in batch serially, processing the request then moving to the next one
-		for (auto &request : requests) {
-			PreProcessVariables(variables, request);
+	for (size_t i = 0; i < resultCount; i++)
+		batch.AddResult(i, std::move(batch.pendingResults[i]));
 
-			RequestResult requestResult = requestHandler.ProcessRequest(request);
+	batch.statistics["applied"] = applied;
+	batch.Finish(resultCount);
+}
 
-			PostProcessVariables(variables, request, requestResult);
+// Validates every request on the calling thread. Returns false if one failed, in which case the batch is finished.
+static bool ValidateFrameAtomicBatch(FrameAtomicBatch &batch)
+{
+	for (size_t i = 0; i < batch.requests.size(); i++) {
+		RequestBatchRequest &request = batch.requests[i];
+		// Pre-process batch variables
+		PreProcessVariables(batch.variables, request);
+		// Validate request and get its change
+		RequestResult requestResult = batch.requestHandler.ProcessRequest(request);
+		// Post-process batch variables
+		PostProcessVariables(batch.variables, request, requestResult);
 
-			ret.push_back(requestResult);
+		bool failed = !requestResult.Succeeded();
+		batch.pendingResults.push_back(std::move(requestResult));
 
-			if (haltOnFailure && requestResult.StatusCode != RequestStatus::Success)
-				break;
+		// A single failure discards the changes of the whole batch
+		if (failed) {
+			FinishFrameAtomicBatch(batch, false);
+			return false;
 		}
+	}
 
-		return ret;
-	} else if (executionType == RequestBatchExecutionType::SerialFrame) {
-		SerialFrameBatch serialFrameBatch(requestHandler, variables, haltOnFailure);
+	return true;
+}
 
-		// Create Request objects in the worker thread (avoid unnecessary processing in graphics thread)
-		for (auto &request : requests)
-			serialFrameBatch.requests.push(request);
+// Validates every request on the calling thread, then applies all changes in the next graphics tick if none failed
+static void ProcessFrameAtomicBatch(RequestBatchScheduler &scheduler, std::shared_ptr<FrameAtomicBatch> batch)
+{
+	if (!ValidateFrameAtomicBatch(*batch))
+		return;
+
+	scheduler.AddFrameTask(
+		[&scheduler, batch](const RequestBatchScheduler::FrameTick &tick) {
+			ApplyFrameAtomicBatch(*batch, tick);
 
-		// Create a callback entry for the graphics thread to execute on each video frame
-		obs_add_tick_callback(ObsTickCallback, &serialFrameBatch);
+			// Avoid building and sending the response in the graphics thread
+			scheduler.Run([batch]() { FinishFrameAtomicBatch(*batch, true); });
+			return false;
+		},
+		[batch]() { FinishFrameAtomicBatch(*batch, false); });
+}
 
-		// Wait until the graphics thread processes the last request in the queue
-		std::unique_lock<std::mutex> lock(serialFrameBatch.conditionMutex);
-		serialFrameBatch.condition.wait(lock, [&serialFrameBatch] { return serialFrameBatch.requests.empty(); });
+void RequestBatchHandler::ProcessRequestBatch(RequestBatchScheduler &scheduler, SessionPtr session,
+					      RequestBatchExecutionType::RequestBatchExecutionType executionType,
+					      std::vector<RequestBatchRequest> &&requests, json variables, bool haltOnFailure,
+					      ResultsCallback callback, ResultCallback resultCallback)
+{
+	if (requests.empty()) {
+		callback(std::vector<RequestResult>(), 0, nullptr, 0);
+		return;
+	}
 
-		// Remove the created callback entry since we don't need it anymore
-		obs_remove_tick_callback(ObsTickCallback, &serialFrameBatch);
+	if (executionType == RequestBatchExecutionType::SerialRealtime) {
+		auto batch = std::make_shared<SerialBatch>(scheduler, session, std::move(requests), std::move(variables),
+							   haltOnFailure, std::move(callback), std::move(resultCallback));
 
-		return serialFrameBatch.results;
+		// Recurse all requests in batch serially, starting on the calling thread
+		ResumeSerialRealtimeBatch(scheduler, batch);
+	} else if (executionType == RequestBatchExecutionType::SerialFrame) {
+		auto batch = std::make_shared<SerialBatch>(scheduler, session, std::move(requests), std::move(variables),
+							   haltOnFailure, std::move(callback), std::move(resultCallback));
+		batch->startedAt = 0;
+
+		// Create a task for the graphics thread to execute on each video frame
+		scheduler.AddFrameTask(
+			[&scheduler, batch](const RequestBatchScheduler::FrameTick &tick) {
+				return TickSerialFrameBatch(scheduler, batch, tick);
+			},
+			[batch]() { CancelSerialBatch(*batch); });
 	} else if (executionType == RequestBatchExecutionType::Parallel) {
-		ParallelBatchResults parallelResults(requestHandler);
-
-		// Acquire the lock early to prevent the batch from finishing before we're ready
-		std::unique_lock<std::mutex> lock(parallelResults.conditionMutex);
+		auto batch = std::make_shared<ParallelBatch>(scheduler, session, std::move(requests), std::move(variables),
+							     haltOnFailure, std::move(callback), std::move(resultCallback));
 
 		// Submit each request as a task to the thread pool to be processed ASAP
-		for (auto &request : requests) {
-			threadPool.start(Utils::Compat::CreateFunctionRunnable([&parallelResults, &request]() {
-				RequestResult requestResult = parallelResults.requestHandler.ProcessRequest(request);
+		batch->remainingCount = batch->requests.size();
+		for (size_t i = 0; i < batch->requests.size(); i++) {
+			scheduler.Run([batch, i]() {
+				// Results are stored by index, as they have to be returned in request order
+				batch->AddResult(i, batch->requestHandler.ProcessRequest(batch->requests[i]));
+
+				// The last request to finish completes the batch
+				if (--batch->remainingCount == 0)
+					batch->Finish(batch->requests.size());
+			});
+		}
+	} else if (executionType == RequestBatchExecutionType::Dataflow) {
+		auto batch = std::make_shared<DataflowBatch>(scheduler, session, std::move(requests), std::move(variables),
+							     haltOnFailure, std::move(callback), std::move(resultCallback));
+
+		// Graph construction is O(n) in the number of requests and variables
+		BuildDataflowGraph(*batch);
+
+		std::unique_lock<std::mutex> lock(batch->mutex);
+		StartDataflowHelpers(scheduler, batch);
+	} else if (executionType == RequestBatchExecutionType::FrameAtomic) {
+		auto batch = std::make_shared<FrameAtomicBatch>(scheduler, session, std::move(requests), std::move(variables),
+							        haltOnFailure, std::move(callback), std::move(resultCallback));
+
+		ProcessFrameAtomicBatch(scheduler, batch);
+	} else {
+		// Return empty vector if not a batch somehow
+		callback(std::vector<RequestResult>(), 0, nullptr, 0);
+	}
+}
 
-				std::unique_lock<std::mutex> lock(parallelResults.conditionMutex);
-				parallelResults.results.push_back(requestResult);
-				lock.unlock();
-				parallelResults.condition.notify_one();
-			}));
+static double GetFrameIntervalMillis()
+{
+	return video_output_get_frame_time(obs_get_video()) / 1000000.0;
+}
+
+// Returns 0 once the cue is due, or the frame to check it again on. Cues based on a time are due on the frame closest
+// to it, and set how many frames after it that is.
+static uint64_t CheckScheduleCue(ScheduledRequestBatch &batch, const RequestBatchScheduler::FrameTick &tick)
+{
+	const RequestBatchHandler::Schedule &schedule = batch.schedule;
+	double frameIntervalMillis = GetFrameIntervalMillis();
+	double lateMillis = 0;
+
+	switch (schedule.cue) {
+	case RequestBatchHandler::Schedule::Frame:
+		// Only checked once the frame has been reached
+		batch.frameDelta = (int64_t)(tick.frame - schedule.frame);
+		return 0;
+	case RequestBatchHandler::Schedule::Timestamp: {
+		auto now = std::chrono::system_clock::now().time_since_epoch();
+		lateMillis = std::chrono::duration<double, std::milli>(now).count() - schedule.timestamp;
+
+		// Skip ahead to about a frame before the time, rather than checking on every frame
+		if (lateMillis < -frameIntervalMillis / 2) {
+			uint64_t remainingFrames = (uint64_t)(-lateMillis / frameIntervalMillis);
+			return tick.frame + (remainingFrames > 1 ? remainingFrames - 1 : 1);
+		}
+		break;
+	}
+	case RequestBatchHandler::Schedule::MediaCursor: {
+		OBSSourceAutoRelease mediaInput = obs_weak_source_get_source(schedule.mediaInput);
+		if (!mediaInput) {
+			batch.mediaInputRemoved = true;
+			return 0;
 		}
 
-		// Wait for the last request to finish processing
-		size_t requestCount = requests.size();
-		parallelResults.condition.wait(lock, [&parallelResults, requestCount] {
-			return parallelResults.results.size() == requestCount;
+		// The cursor can be moved at any time, so it is checked on every frame
+		if (obs_source_media_get_state(mediaInput) != OBS_MEDIA_STATE_PLAYING)
+			return tick.frame + 1;
+
+		lateMillis = (double)(obs_source_media_get_time(mediaInput) - schedule.cursor);
+		if (lateMillis < -frameIntervalMillis / 2)
+			return tick.frame + 1;
+		break;
+	}
+	case RequestBatchHandler::Schedule::TransitionCursor: {
+		OBSSourceAutoRelease transition = obs_frontend_get_current_transition();
+		float transitionTime = transition ? obs_transition_get_time(transition) : 1.0f;
+
+		// An idle transition is at its end, so only transitions which are seen in progress count
+		if (transitionTime < 1.0f)
+			batch.transitionStarted = true;
+		if (!batch.transitionStarted)
+			return tick.frame + 1;
+
+		lateMillis = transitionTime * obs_frontend_get_transition_duration() - schedule.cursor;
+		if (transitionTime < 1.0f && lateMillis < -frameIntervalMillis / 2)
+			return tick.frame + 1;
+		break;
+	}
+	}
+
+	batch.frameDelta = std::llround(lateMillis / frameIntervalMillis);
+	return 0;
+}
+
+// Once the cue of the batch is due or cancelled. The request ID may already be in use by a newer batch.
+static void RemoveScheduledRequestBatch(ScheduledRequestBatch &batch)
+{
+	std::lock_guard<std::mutex> lock(batch.session->ScheduledBatchesMutex);
+	auto &scheduledBatches = batch.session->ScheduledBatches;
+	auto it = scheduledBatches.find(batch.requestId);
+	if (it != scheduledBatches.end() && it->second == batch.cueId)
+		scheduledBatches.erase(it);
+}
+
+// A validated `FrameAtomic` batch still owes results for its requests
+static void CancelScheduledBatch(ScheduledRequestBatch &batch)
+{
+	if (batch.frameAtomicBatch) {
+		batch.frameAtomicBatch->statistics["cancelled"] = true;
+		FinishFrameAtomicBatch(*batch.frameAtomicBatch, false);
+		return;
+	}
+
+	batch.callback(std::vector<RequestResult>(), 0, {{"cancelled", true}}, 0);
+}
+
+// Adds the statistics of the schedule to those of the batch. `frame` is the frame in which the batch started executing.
+static RequestBatchHandler::ResultsCallback GetScheduledCallback(ScheduledRequestBatch &batch, uint64_t frame,
+								 int64_t frameDelta)
+{
+	json scheduleStatistics = {{"cancelled", false}, {"frame", frame}, {"frameDelta", frameDelta}};
+	return [callback = std::move(batch.callback), scheduleStatistics](std::vector<RequestResult> &&results,
+									   size_t resultCount, json &&statistics,
+									   uint64_t startedAt) {
+		if (statistics.is_null())
+			statistics = json::object();
+		statistics.update(scheduleStatistics);
+		callback(std::move(results), resultCount, std::move(statistics), startedAt);
+	};
+}
+
+// Runs on the graphics thread in the tick in which the cue of the batch is due
+static void StartScheduledRequestBatch(RequestBatchScheduler &scheduler, std::shared_ptr<ScheduledRequestBatch> batch,
+				       const RequestBatchScheduler::FrameTick &tick)
+{
+	RemoveScheduledRequestBatch(*batch);
+
+	if (batch->mediaInputRemoved) {
+		scheduler.Run([batch]() { CancelScheduledBatch(*batch); });
+		return;
+	}
+
+	// Already validated, so all of its changes land in the frame of the cue
+	if (batch->frameAtomicBatch) {
+		auto frameAtomicBatch = batch->frameAtomicBatch;
+		frameAtomicBatch->statistics.update({{"frame", tick.frame}, {"frameDelta", batch->frameDelta}});
+		frameAtomicBatch->startedAt = os_gettime_ns();
+		ApplyFrameAtomicBatch(*frameAtomicBatch, tick);
+
+		// Avoid building and sending the response in the graphics thread
+		scheduler.Run([frameAtomicBatch]() { FinishFrameAtomicBatch(*frameAtomicBatch, true); });
+		return;
+	}
+
+	// Other types of batches are not processed on the graphics thread, so they are only started from it. They report the
+	// frame in which they actually started, which may be later than that of the cue.
+	if (batch->executionType != RequestBatchExecutionType::SerialFrame || batch->requests.empty()) {
+		scheduler.Run([&scheduler, batch, cueFrame = tick.frame]() {
+			uint64_t frame = std::max((uint64_t)obs_get_total_frames(), cueFrame);
+			int64_t frameDelta = batch->frameDelta + (int64_t)(frame - cueFrame);
+			RequestBatchHandler::ProcessRequestBatch(scheduler, batch->session, batch->executionType,
+								 std::move(batch->requests), std::move(batch->variables),
+								 batch->haltOnFailure,
+								 GetScheduledCallback(*batch, frame, frameDelta),
+								 std::move(batch->resultCallback));
 		});
+		return;
+	}
+
+	auto scheduledCallback = GetScheduledCallback(*batch, tick.frame, batch->frameDelta);
+	auto serialBatch = std::make_shared<SerialBatch>(scheduler, batch->session, std::move(batch->requests),
+							 std::move(batch->variables), batch->haltOnFailure,
+							 std::move(scheduledCallback), std::move(batch->resultCallback));
+
+	// Process the first requests within the frame of the cue, and the rest on the following ones
+	if (TickSerialFrameBatch(scheduler, serialBatch, tick)) {
+		scheduler.AddFrameTask(
+			[&scheduler, serialBatch](const RequestBatchScheduler::FrameTick &tick) {
+				return TickSerialFrameBatch(scheduler, serialBatch, tick);
+			},
+			[serialBatch]() { CancelSerialBatch(*serialBatch); });
+	}
+}
+
+void RequestBatchHandler::ScheduleRequestBatch(RequestBatchScheduler &scheduler, SessionPtr session, const std::string &requestId,
+					       Schedule &&schedule,
+					       RequestBatchExecutionType::RequestBatchExecutionType executionType,
+					       std::vector<RequestBatchRequest> &&requests, json variables, bool haltOnFailure,
+					       ResultsCallback callback, ResultCallback resultCallback)
+{
+	auto batch = std::make_shared<ScheduledRequestBatch>();
+	batch->session = session;
+	batch->requestId = requestId;
+	batch->schedule = std::move(schedule);
+	batch->executionType = executionType;
+	batch->requests = std::move(requests);
+	batch->variables = std::move(variables);
+	batch->haltOnFailure = haltOnFailure;
+	batch->callback = std::move(callback);
+	batch->resultCallback = std::move(resultCallback);
+	size_t requestCount = batch->requests.size();
+
+	// Its requests are validated now, so that only their changes are left to apply within the tick of the cue
+	if (executionType == RequestBatchExecutionType::FrameAtomic && requestCount) {
+		batch->frameAtomicBatch = std::make_shared<FrameAtomicBatch>(scheduler, session, std::move(batch->requests),
+									     std::move(batch->variables), haltOnFailure,
+									     ResultsCallback(batch->callback),
+									     ResultCallback(batch->resultCallback));
+		batch->frameAtomicBatch->startedAt = 0;
+		batch->frameAtomicBatch->statistics["cancelled"] = false;
+		if (!ValidateFrameAtomicBatch(*batch->frameAtomicBatch))
+			return;
+	}
+
+	// Frame cues are first checked on their frame. The others are checked from the next frame on.
+	uint64_t frame = batch->schedule.cue == Schedule::Frame ? batch->schedule.frame : 0;
 
-		return parallelResults.results;
+	// Held until the cue ID is stored, which the cue task also takes the lock for
+	std::unique_lock<std::mutex> lock(session->ScheduledBatchesMutex);
+	if (session->ScheduledBatches.count(requestId)) {
+		lock.unlock();
+
+		RequestResult requestResult = RequestResult::Error(RequestStatus::ResourceAlreadyExists,
+								   "A request batch with your `requestId` is already scheduled.");
+		batch->callback(std::vector<RequestResult>(requestCount, requestResult), requestCount, nullptr, 0);
+		return;
+	}
+
+	batch->cueId = scheduler.AddCue(
+		frame, [batch](const RequestBatchScheduler::FrameTick &tick) { return CheckScheduleCue(*batch, tick); },
+		[&scheduler, batch](const RequestBatchScheduler::FrameTick &tick) {
+			StartScheduledRequestBatch(scheduler, batch, tick);
+		},
+		[batch]() {
+			RemoveScheduledRequestBatch(*batch);
+			CancelScheduledBatch(*batch);
+		});
+	session->ScheduledBatches[requestId] = batch->cueId;
+}
+
+bool RequestBatchHandler::CancelScheduledRequestBatch(RequestBatchScheduler &scheduler, SessionPtr session,
+						      const std::string &requestId)
+{
+	std::unique_lock<std::mutex> lock(session->ScheduledBatchesMutex);
+	auto it = session->ScheduledBatches.find(requestId);
+	if (it == session->ScheduledBatches.end())
+		return false;
+
+	uint64_t cueId = it->second;
+	session->ScheduledBatches.erase(it);
+	lock.unlock();
+
+	// The cue may have become due in the meantime
+	return scheduler.CancelCue(cueId);
+}
+
+void RequestBatchHandler::CancelScheduledRequestBatches(RequestBatchScheduler &scheduler, SessionPtr session)
+{
+	std::unique_lock<std::mutex> lock(session->ScheduledBatchesMutex);
+	auto scheduledBatches = std::move(session->ScheduledBatches);
+	session->ScheduledBatches.clear();
+	lock.unlock();
+
+	for (auto &[requestId, cueId] : scheduledBatches)
+		scheduler.CancelCue(cueId);
+}
+
+json RequestBatchHandler::ConstructRequestResult(RequestResult requestResult, const json &requestJson)
+{
+	json ret;
+
+	ret["requestType"] = requestJson["requestType"];
+
+	if (requestJson.contains("requestId") && !requestJson["requestId"].is_null())
+		ret["requestId"] = requestJson["requestId"];
+
+	ret["requestStatus"] = {{"result", requestResult.Succeeded()}, {"code", requestResult.StatusCode}};
+
+	if (!requestResult.Comment.empty())
+		ret["requestStatus"]["comment"] = requestResult.Comment;
+
+	if (requestResult.ResponseData.is_object())
+		ret["responseData"] = std::move(requestResult.ResponseData);
+
+	return ret;
+}
+
+std::vector<RequestResult> RequestBatchHandler::ProcessPreparedRequestBatch(SessionPtr session, const PreparedRequestBatch &batch,
+									    json variables)
+{
+	RequestHandler requestHandler(session);
+
+	std::vector<RequestResult> results;
+	results.reserve(batch.Requests.size());
+	for (auto &preparedRequest : batch.Requests) {
+		// The prepared batch is shared by every execution, so the variables are applied to a copy of the request
+		RequestBatchRequest request = preparedRequest.BatchRequest;
+		PreProcessVariables(variables, request);
+		RequestResult requestResult = requestHandler.ProcessPreparedRequest(*preparedRequest.Entry, request);
+		PostProcessVariables(variables, request, requestResult);
+
+		bool succeeded = requestResult.Succeeded();
+		results.push_back(std::move(requestResult));
+
+		if (batch.HaltOnFailure && !succeeded)
+			break;
 	}
 
-	// Return empty vector if not a batch somehow
-	return std::vector<RequestResult>();
+	return results;
 }
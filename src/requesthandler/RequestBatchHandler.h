@@ -18,14 +18,58 @@ with this program. If not, see <https://www.gnu.org/licenses/>
 
 #pragma once
 
-#include <QThreadPool>
-
+#include "RequestBatchScheduler.h"
 #include "RequestHandler.h"
 #include "rpc/RequestBatchRequest.h"
 
 namespace RequestBatchHandler {
-	std::vector<RequestResult> ProcessRequestBatch(QThreadPool &threadPool, SessionPtr session,
-						       RequestBatchExecutionType::RequestBatchExecutionType executionType,
-						       std::vector<RequestBatchRequest> &requests, json &variables,
-						       bool haltOnFailure);
+	// Called once the batch has finished, from whichever thread finished it. The results are in request order.
+	// If results are streamed, `results` is empty and `resultCount` is the number of results which were streamed.
+	// Statistics are only provided by SerialFrame batches, and are null otherwise.
+	// `startedAt` is the server monotonic time at which the batch started executing, or 0 if it never did.
+	typedef std::function<void(std::vector<RequestResult> &&, size_t, json &&, uint64_t)>
+		ResultsCallback; // std::vector<RequestResult> &&results, size_t resultCount, json &&statistics, uint64_t startedAt
+
+	// Called for each result as soon as its request has finished, instead of keeping it for the final callback
+	typedef std::function<void(size_t, RequestResult &&)> ResultCallback; // size_t index, RequestResult &&result
+
+	// Returns right away. Suspended batches (sleeping, or waiting for the next frame) do not hold any thread.
+	void ProcessRequestBatch(RequestBatchScheduler &scheduler, SessionPtr session,
+				 RequestBatchExecutionType::RequestBatchExecutionType executionType,
+				 std::vector<RequestBatchRequest> &&requests, json variables, bool haltOnFailure,
+				 ResultsCallback callback, ResultCallback resultCallback = nullptr);
+
+	// When a scheduled batch is started. Frames are counted like `renderTotalFrames` of `GetStats`.
+	struct Schedule {
+		enum CueType {
+			Frame,            // Once `frame` has been reached
+			Timestamp,        // On the frame closest to `timestamp`, in Unix milliseconds
+			MediaCursor,      // On the frame closest to `cursor` milliseconds into the playback of `mediaInput`
+			TransitionCursor, // On the frame closest to `cursor` milliseconds into the next scene transition
+		};
+
+		CueType cue;
+		uint64_t frame = 0;
+		int64_t timestamp = 0;
+		OBSWeakSourceAutoRelease mediaInput;
+		int64_t cursor = 0;
+	};
+
+	// Starts the batch on the graphics thread within the frame of its cue, instead of right away. The statistics of the
+	// batch report the frame it was started on, and how many frames that is after the cue.
+	// If a batch with the same request ID is already waiting for its cue, every request of the batch fails right away.
+	void ScheduleRequestBatch(RequestBatchScheduler &scheduler, SessionPtr session, const std::string &requestId,
+				  Schedule &&schedule, RequestBatchExecutionType::RequestBatchExecutionType executionType,
+				  std::vector<RequestBatchRequest> &&requests, json variables, bool haltOnFailure,
+				  ResultsCallback callback, ResultCallback resultCallback = nullptr);
+	// Returns `false` if no batch with that request ID is waiting for its cue
+	bool CancelScheduledRequestBatch(RequestBatchScheduler &scheduler, SessionPtr session, const std::string &requestId);
+	void CancelScheduledRequestBatches(RequestBatchScheduler &scheduler, SessionPtr session);
+
+	// Constructs the object of a result in a `RequestBatchResponse`, from the request as it was sent
+	json ConstructRequestResult(RequestResult requestResult, const json &requestJson);
+
+	// Runs a prepared batch serially on the calling thread. The results are in request order.
+	std::vector<RequestResult> ProcessPreparedRequestBatch(SessionPtr session, const PreparedRequestBatch &batch,
+								json variables);
 }
@@ -0,0 +1,308 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <algorithm>
+#include <obs.h>
+#include <util/profiler.hpp>
+
+#include "RequestBatchScheduler.h"
+#include "../obs-websocket.h"
+#include "../Config.h"
+#include "../utils/Compat.h"
+
+RequestBatchScheduler::RequestBatchScheduler(QThreadPool &threadPool) : _threadPool(threadPool)
+{
+	_timerThread = std::thread(&RequestBatchScheduler::TimerThread, this);
+	obs_add_tick_callback(ObsTickCallback, this);
+}
+
+RequestBatchScheduler::~RequestBatchScheduler()
+{
+	obs_remove_tick_callback(ObsTickCallback, this);
+
+	std::unique_lock<std::mutex> lock(_timerMutex);
+	_timerThreadStopping = true;
+	lock.unlock();
+	_timerCondition.notify_one();
+	_timerThread.join();
+}
+
+void RequestBatchScheduler::Run(Task task)
+{
+	_threadPool.start(Utils::Compat::CreateFunctionRunnable(std::move(task)));
+}
+
+void RequestBatchScheduler::RunAfter(std::chrono::milliseconds delay, Task task, Task cancelTask)
+{
+	std::unique_lock<std::mutex> lock(_timerMutex);
+	_timerTasks.push({Clock::now() + delay, _timerSequence++, std::move(task), std::move(cancelTask)});
+	lock.unlock();
+	_timerCondition.notify_one();
+}
+
+void RequestBatchScheduler::AddFrameTask(FrameTask task, Task cancelTask)
+{
+	std::unique_lock<std::mutex> lock(_frameMutex);
+	_frameTasks.push_back({std::move(task), std::move(cancelTask)});
+}
+
+uint64_t RequestBatchScheduler::AddCue(uint64_t frame, CueCondition condition, CueTask task, Task cancelTask)
+{
+	auto cue = std::make_shared<Cue>();
+	cue->frame = frame;
+	cue->condition = std::move(condition);
+	cue->task = std::move(task);
+	cue->cancelTask = std::move(cancelTask);
+
+	std::unique_lock<std::mutex> lock(_frameMutex);
+	// The wheel is only advanced while there are cues
+	if (_cues.empty())
+		_cueWheelFrame = obs_get_total_frames();
+
+	uint64_t cueId = _nextCueId++;
+	_cues[cueId] = cue;
+	AddCueToWheel(cueId, *cue);
+
+	return cueId;
+}
+
+bool RequestBatchScheduler::CancelCue(uint64_t cueId)
+{
+	std::unique_lock<std::mutex> lock(_frameMutex);
+	auto it = _cues.find(cueId);
+	if (it == _cues.end())
+		return false;
+
+	// The ID is dropped from the wheel once its slot comes up
+	std::shared_ptr<Cue> cue = it->second;
+	_cues.erase(it);
+	cue->cancelled = true;
+
+	// A cue whose condition is being checked is cancelled by the tick once the check is done
+	bool checking = cue->checking;
+	lock.unlock();
+
+	if (!checking)
+		Run(std::move(cue->cancelTask));
+
+	return true;
+}
+
+// Cancels every pending task. Tasks which are already running are not interrupted, but frame tasks of an in-progress tick
+// are cancelled once it is over, unless they have finished.
+void RequestBatchScheduler::CancelAll()
+{
+	std::vector<Task> cancelTasks;
+
+	std::unique_lock<std::mutex> timerLock(_timerMutex);
+	while (!_timerTasks.empty()) {
+		cancelTasks.push_back(_timerTasks.top().cancelTask);
+		_timerTasks.pop();
+	}
+	timerLock.unlock();
+
+	std::unique_lock<std::mutex> frameLock(_frameMutex);
+	for (auto &frameTask : _frameTasks)
+		cancelTasks.push_back(std::move(frameTask.cancelTask));
+	_frameTasks.clear();
+	// Cues whose condition is being checked are dropped by the tick, as the generation has changed
+	for (auto &[cueId, cue] : _cues)
+		cancelTasks.push_back(std::move(cue->cancelTask));
+	_cues.clear();
+	for (auto &slot : _cueWheel)
+		slot.clear();
+	_frameTaskGeneration++;
+	frameLock.unlock();
+
+	RunCancelTasks(std::move(cancelTasks));
+}
+
+void RequestBatchScheduler::RunCancelTasks(std::vector<Task> &&cancelTasks)
+{
+	for (auto &cancelTask : cancelTasks) {
+		if (cancelTask)
+			Run(std::move(cancelTask));
+	}
+}
+
+// Must be called with the frame mutex locked. Cues for frames which have already been processed are due on the next one.
+void RequestBatchScheduler::AddCueToWheel(uint64_t cueId, Cue &cue)
+{
+	cue.frame = std::max(cue.frame, _cueWheelFrame + 1);
+	_cueWheel[cue.frame % CueWheelSize].push_back(cueId);
+}
+
+// Checks the cues in the slots of every frame since the previous tick, or in all slots if more frames than there are
+// slots have passed. Conditions are checked and tasks are run outside of the lock.
+void RequestBatchScheduler::ProcessCues(const FrameTick &tick)
+{
+	std::unique_lock<std::mutex> lock(_frameMutex);
+	if (_cues.empty() || tick.frame <= _cueWheelFrame)
+		return;
+
+	std::vector<std::pair<uint64_t, std::shared_ptr<Cue>>> dueCues;
+	uint64_t frameCount = std::min<uint64_t>(tick.frame - _cueWheelFrame, CueWheelSize);
+	for (uint64_t frame = tick.frame - frameCount + 1; frame <= tick.frame; frame++) {
+		auto &slot = _cueWheel[frame % CueWheelSize];
+		size_t keptCount = 0;
+		for (size_t i = 0; i < slot.size(); i++) {
+			auto it = _cues.find(slot[i]);
+			if (it == _cues.end())
+				continue;
+
+			// Due on a later revolution of the wheel
+			if (it->second->frame > tick.frame) {
+				slot[keptCount++] = slot[i];
+				continue;
+			}
+
+			it->second->checking = true;
+			dueCues.emplace_back(slot[i], it->second);
+		}
+		slot.resize(keptCount);
+	}
+	_cueWheelFrame = tick.frame;
+	uint64_t frameTaskGeneration = _frameTaskGeneration;
+	lock.unlock();
+
+	if (dueCues.empty())
+		return;
+
+	std::vector<uint64_t> nextFrames;
+	nextFrames.reserve(dueCues.size());
+	for (auto &dueCue : dueCues)
+		nextFrames.push_back(dueCue.second->condition(tick));
+
+	std::vector<std::shared_ptr<Cue>> firedCues;
+	std::vector<std::shared_ptr<Cue>> cancelledCues;
+
+	lock.lock();
+	if (frameTaskGeneration != _frameTaskGeneration)
+		return;
+
+	for (size_t i = 0; i < dueCues.size(); i++) {
+		auto &[cueId, cue] = dueCues[i];
+		cue->checking = false;
+
+		if (cue->cancelled) {
+			cancelledCues.push_back(cue);
+		} else if (!nextFrames[i]) {
+			_cues.erase(cueId);
+			firedCues.push_back(cue);
+		} else {
+			cue->frame = nextFrames[i];
+			AddCueToWheel(cueId, *cue);
+		}
+	}
+	lock.unlock();
+
+	for (auto &cue : cancelledCues)
+		Run(std::move(cue->cancelTask));
+
+	for (auto &cue : firedCues)
+		cue->task(tick);
+}
+
+void RequestBatchScheduler::ObsTickCallback(void *param, float)
+{
+	auto scheduler = static_cast<RequestBatchScheduler *>(param);
+
+	// Run the tasks outside of the lock, so that new tasks can be added without waiting for the tick
+	std::unique_lock<std::mutex> lock(scheduler->_frameMutex);
+	if (scheduler->_frameTasks.empty() && scheduler->_cues.empty())
+		return;
+
+	ScopeProfiler prof{"obs_websocket_request_batch_frame_tick"};
+
+	std::vector<PendingFrameTask> frameTasks;
+	frameTasks.swap(scheduler->_frameTasks);
+	uint64_t frameTaskGeneration = scheduler->_frameTaskGeneration;
+
+	FrameTick tick;
+	tick.tickCount = ++scheduler->_tickCount;
+	tick.frame = obs_get_total_frames();
+	lock.unlock();
+
+	auto conf = GetConfig();
+	uint32_t tickBudgetMicros = conf ? conf->FrameTickBudgetMicros.load() : 0;
+	if (tickBudgetMicros)
+		tick.deadline = Clock::now() + std::chrono::microseconds(tickBudgetMicros);
+	else
+		tick.deadline = Clock::time_point::max();
+
+	// Cues go first, so that their tasks run within the frame they are due on. Frame tasks which those add are run
+	// from the next tick on.
+	scheduler->ProcessCues(tick);
+
+	std::vector<PendingFrameTask> pendingTasks;
+	size_t i = 0;
+	for (; i < frameTasks.size(); i++) {
+		if (i && Clock::now() >= tick.deadline)
+			break;
+
+		if (frameTasks[i].task(tick))
+			pendingTasks.push_back(std::move(frameTasks[i]));
+	}
+
+	// Tasks which did not get to run this tick go first on the next one, so that no batch is starved by the budget.
+	// The others keep their order ahead of any added during this tick.
+	std::vector<PendingFrameTask> nextTasks(std::make_move_iterator(frameTasks.begin() + i),
+						std::make_move_iterator(frameTasks.end()));
+	nextTasks.insert(nextTasks.end(), std::make_move_iterator(pendingTasks.begin()),
+			 std::make_move_iterator(pendingTasks.end()));
+
+	lock.lock();
+	if (frameTaskGeneration != scheduler->_frameTaskGeneration) {
+		lock.unlock();
+
+		std::vector<Task> cancelTasks;
+		for (auto &frameTask : nextTasks)
+			cancelTasks.push_back(std::move(frameTask.cancelTask));
+		scheduler->RunCancelTasks(std::move(cancelTasks));
+		return;
+	}
+
+	nextTasks.insert(nextTasks.end(), std::make_move_iterator(scheduler->_frameTasks.begin()),
+			 std::make_move_iterator(scheduler->_frameTasks.end()));
+	scheduler->_frameTasks.swap(nextTasks);
+}
+
+void RequestBatchScheduler::TimerThread()
+{
+	std::unique_lock<std::mutex> lock(_timerMutex);
+	while (!_timerThreadStopping) {
+		if (_timerTasks.empty()) {
+			_timerCondition.wait(lock);
+			continue;
+		}
+
+		Clock::time_point deadline = _timerTasks.top().deadline;
+		if (Clock::now() < deadline) {
+			_timerCondition.wait_until(lock, deadline);
+			continue;
+		}
+
+		Task task = _timerTasks.top().task;
+		_timerTasks.pop();
+		lock.unlock();
+
+		Run(std::move(task));
+
+		lock.lock();
+	}
+}
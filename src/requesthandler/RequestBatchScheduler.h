@@ -0,0 +1,122 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <QThreadPool>
+
+// Drives suspended request batches without holding a thread for each of them.
+// Timer tasks are started on the thread pool once their delay has elapsed, using a single timer thread for all batches.
+// Frame tasks are run on the graphics thread once per video frame, until they return `false`.
+// Cues run a task on the graphics thread in the first tick where their condition is met. Conditions are only checked
+// from the frame they ask for on, using a timer wheel indexed by frame number.
+// Every kind of task may come with a cancel task, which is run on the thread pool instead if it is cancelled.
+class RequestBatchScheduler {
+public:
+	typedef std::chrono::steady_clock Clock;
+	typedef std::function<void()> Task;
+
+	struct FrameTick {
+		uint64_t tickCount;
+		uint64_t frame; // `obs_get_total_frames()` during the tick
+		// Once passed, frame tasks should yield until the next tick. The first task of a tick always gets to run.
+		Clock::time_point deadline;
+	};
+	typedef std::function<bool(const FrameTick &)> FrameTask;
+	// Returns 0 once the cue is due, or the frame to check it again on
+	typedef std::function<uint64_t(const FrameTick &)> CueCondition;
+	typedef std::function<void(const FrameTick &)> CueTask;
+
+	RequestBatchScheduler(QThreadPool &threadPool);
+	~RequestBatchScheduler();
+
+	inline QThreadPool &GetThreadPool() { return _threadPool; }
+
+	void Run(Task task);
+	void RunAfter(std::chrono::milliseconds delay, Task task, Task cancelTask = nullptr);
+	void AddFrameTask(FrameTask task, Task cancelTask = nullptr);
+	// Returns the ID of the cue
+	uint64_t AddCue(uint64_t frame, CueCondition condition, CueTask task, Task cancelTask);
+	bool CancelCue(uint64_t cueId);
+	void CancelAll();
+
+private:
+	struct TimerTask {
+		Clock::time_point deadline;
+		uint64_t sequence; // Keeps tasks with the same deadline in submission order
+		Task task;
+		Task cancelTask;
+
+		inline bool operator>(const TimerTask &other) const
+		{
+			return deadline != other.deadline ? deadline > other.deadline : sequence > other.sequence;
+		}
+	};
+
+	struct PendingFrameTask {
+		FrameTask task;
+		Task cancelTask;
+	};
+
+	struct Cue {
+		uint64_t frame;
+		CueCondition condition;
+		CueTask task;
+		Task cancelTask;
+		bool checking = false;
+		bool cancelled = false;
+	};
+
+	static const size_t CueWheelSize = 256;
+
+	static void ObsTickCallback(void *param, float);
+	void ProcessCues(const FrameTick &tick);
+	void AddCueToWheel(uint64_t cueId, Cue &cue);
+	void TimerThread();
+	void RunCancelTasks(std::vector<Task> &&cancelTasks);
+
+	QThreadPool &_threadPool;
+
+	std::mutex _timerMutex;
+	std::condition_variable _timerCondition;
+	std::priority_queue<TimerTask, std::vector<TimerTask>, std::greater<TimerTask>> _timerTasks;
+	uint64_t _timerSequence = 0;
+	bool _timerThreadStopping = false;
+	std::thread _timerThread;
+
+	std::mutex _frameMutex;
+	std::vector<PendingFrameTask> _frameTasks;
+	uint64_t _tickCount = 0;
+	uint64_t _frameTaskGeneration = 0; // Incremented by `CancelAll()` to cancel the tasks of an in-progress tick
+
+	// Also guarded by `_frameMutex`
+	std::unordered_map<uint64_t, std::shared_ptr<Cue>> _cues;
+	std::array<std::vector<uint64_t>, CueWheelSize> _cueWheel; // Cue IDs by `frame % CueWheelSize`
+	uint64_t _cueWheelFrame = 0;                               // Last frame whose slot has been processed
+	uint64_t _nextCueId = 1;
+};
@@ -0,0 +1,67 @@
+/*
+obs-websocket
+Copyright (C) 2016-2021 Stephane Lepin <stephane.lepin@gmail.com>
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include "RequestCoalescer.h"
+
+// nlohmann::json stores object members in sorted order, so dumping yields a canonical form of the request data
+std::string RequestCoalescer::GetRequestKey(const Request &request)
+{
+	std::string ret = request.RequestType;
+	ret += '\n';
+	ret += request.RequestData.dump();
+	return ret;
+}
+
+RequestResult RequestCoalescer::Process(const Request &request, ExecuteCallback executeCallback)
+{
+	std::string requestKey = GetRequestKey(request);
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	auto it = _inFlightRequests.find(requestKey);
+	if (it != _inFlightRequests.end()) {
+		// An identical request is already being executed. Wait for its result instead of running our own.
+		std::shared_future<RequestResult> inFlightResult = it->second;
+		lock.unlock();
+		return inFlightResult.get();
+	}
+
+	std::promise<RequestResult> resultPromise;
+	_inFlightRequests.emplace(requestKey, resultPromise.get_future().share());
+	lock.unlock();
+
+	RequestResult requestResult;
+	try {
+		requestResult = executeCallback();
+	} catch (...) {
+		lock.lock();
+		_inFlightRequests.erase(requestKey);
+		lock.unlock();
+		resultPromise.set_exception(std::current_exception());
+		throw;
+	}
+
+	// Remove the entry before publishing the result so that requests arriving from now on observe fresh state
+	lock.lock();
+	_inFlightRequests.erase(requestKey);
+	lock.unlock();
+
+	resultPromise.set_value(requestResult);
+
+	return requestResult;
+}
@@ -0,0 +1,45 @@
+/*
+obs-websocket
+Copyright (C) 2016-2021 Stephane Lepin <stephane.lepin@gmail.com>
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "rpc/Request.h"
+#include "rpc/RequestResult.h"
+
+// Single-flight execution of identical in-flight requests.
+// The first caller for a given request type and request data executes the request, while every caller which arrives
+// before it finishes waits for and receives a copy of the same result.
+class RequestCoalescer {
+public:
+	typedef std::function<RequestResult()> ExecuteCallback;
+
+	RequestResult Process(const Request &request, ExecuteCallback executeCallback);
+
+private:
+	static std::string GetRequestKey(const Request &request);
+
+	std::mutex _mutex;
+	std::unordered_map<std::string, std::shared_future<RequestResult>> _inFlightRequests;
+};
@@ -17,30 +17,52 @@ You should have received a copy of the GNU General Public License along
 with this program. If not, see <https://www.gnu.org/licenses/>
 */
 
-#ifdef PLUGIN_TESTS
-#include <util/profiler.hpp>
-#endif
-
 #include "RequestHandler.h"
+#include "../utils/Metrics.h"
+#include "../utils/Tracing.h"
+
+static std::unordered_map<std::string, RequestHandlerEntry>
+ResolveRequestMetrics(std::unordered_map<std::string, RequestHandlerEntry> handlerMap)
+{
+	for (auto &[requestType, entry] : handlerMap)
+		entry.Metrics = &Utils::Metrics::GetRegistry().requests.Get(requestType);
 
-const std::unordered_map<std::string, RequestMethodHandler> RequestHandler::_handlerMap{
+	return handlerMap;
+}
+
+// Requests flagged with `REQUEST_COALESCE` are read-only and their result depends only on their request data. Identical
+// in-flight requests of these types share a single execution, and the result is handed to every waiting client.
+const std::unordered_map<std::string, RequestHandlerEntry> RequestHandler::_handlerMap = ResolveRequestMetrics({
 	// General
 	{"GetVersion", &RequestHandler::GetVersion},
 	{"GetStats", &RequestHandler::GetStats},
+	{"GetServerMetrics", &RequestHandler::GetServerMetrics},
+	{"GetTracingEnabled", &RequestHandler::GetTracingEnabled},
+	{"SetTracingEnabled", &RequestHandler::SetTracingEnabled},
+	{"GetTrace", &RequestHandler::GetTrace},
+	{"SaveTrace", &RequestHandler::SaveTrace},
+	{"GetSlowRequestLog", &RequestHandler::GetSlowRequestLog},
+	{"GetSlowRequestThresholds", &RequestHandler::GetSlowRequestThresholds},
+	{"SetSlowRequestThresholds", &RequestHandler::SetSlowRequestThresholds},
 	{"BroadcastCustomEvent", &RequestHandler::BroadcastCustomEvent},
 	{"CallVendorRequest", &RequestHandler::CallVendorRequest},
-	{"GetHotkeyList", &RequestHandler::GetHotkeyList},
+	{"GetHotkeyList", {&RequestHandler::GetHotkeyList, REQUEST_COALESCE}},
 	{"TriggerHotkeyByName", &RequestHandler::TriggerHotkeyByName},
 	{"TriggerHotkeyByKeySequence", &RequestHandler::TriggerHotkeyByKeySequence},
 	{"Sleep", &RequestHandler::Sleep},
+	{"GetFullState", &RequestHandler::GetFullState},
+	{"PrepareRequestBatch", &RequestHandler::PrepareRequestBatch},
+	{"ExecutePreparedBatch", &RequestHandler::ExecutePreparedBatch},
+	{"RemovePreparedBatch", &RequestHandler::RemovePreparedBatch},
+	{"CancelScheduledRequestBatch", &RequestHandler::CancelScheduledRequestBatch},
 
 	// Config
 	{"GetPersistentData", &RequestHandler::GetPersistentData},
 	{"SetPersistentData", &RequestHandler::SetPersistentData},
-	{"GetSceneCollectionList", &RequestHandler::GetSceneCollectionList},
+	{"GetSceneCollectionList", {&RequestHandler::GetSceneCollectionList, REQUEST_COALESCE}},
 	{"SetCurrentSceneCollection", &RequestHandler::SetCurrentSceneCollection},
 	{"CreateSceneCollection", &RequestHandler::CreateSceneCollection},
-	{"GetProfileList", &RequestHandler::GetProfileList},
+	{"GetProfileList", {&RequestHandler::GetProfileList, REQUEST_COALESCE}},
 	{"SetCurrentProfile", &RequestHandler::SetCurrentProfile},
 	{"CreateProfile", &RequestHandler::CreateProfile},
 	{"RemoveProfile", &RequestHandler::RemoveProfile},
@@ -55,14 +77,14 @@ const std::unordered_map<std::string, RequestMethodHandler> RequestHandler::_han
 
 	// Sources
 	{"GetSourceActive", &RequestHandler::GetSourceActive},
-	{"GetSourceScreenshot", &RequestHandler::GetSourceScreenshot},
+	{"GetSourceScreenshot", {&RequestHandler::GetSourceScreenshot, REQUEST_COALESCE}},
 	{"SaveSourceScreenshot", &RequestHandler::SaveSourceScreenshot},
 	{"GetSourcePrivateSettings", &RequestHandler::GetSourcePrivateSettings},
 	{"SetSourcePrivateSettings", &RequestHandler::SetSourcePrivateSettings},
 
 	// Scenes
-	{"GetSceneList", &RequestHandler::GetSceneList},
-	{"GetGroupList", &RequestHandler::GetGroupList},
+	{"GetSceneList", {&RequestHandler::GetSceneList, REQUEST_COALESCE}},
+	{"GetGroupList", {&RequestHandler::GetGroupList, REQUEST_COALESCE}},
 	{"GetCurrentProgramScene", &RequestHandler::GetCurrentProgramScene},
 	{"SetCurrentProgramScene", &RequestHandler::SetCurrentProgramScene},
 	{"GetCurrentPreviewScene", &RequestHandler::GetCurrentPreviewScene},
@@ -74,22 +96,25 @@ const std::unordered_map<std::string, RequestMethodHandler> RequestHandler::_han
 	{"SetSceneSceneTransitionOverride", &RequestHandler::SetSceneSceneTransitionOverride},
 
 	// Inputs
-	{"GetInputList", &RequestHandler::GetInputList},
-	{"GetInputKindList", &RequestHandler::GetInputKindList},
+	{"GetInputList", {&RequestHandler::GetInputList, REQUEST_COALESCE}},
+	{"GetInputKindList", {&RequestHandler::GetInputKindList, REQUEST_COALESCE}},
 	{"GetSpecialInputs", &RequestHandler::GetSpecialInputs},
 	{"CreateInput", &RequestHandler::CreateInput},
 	{"RemoveInput", &RequestHandler::RemoveInput},
 	{"SetInputName", &RequestHandler::SetInputName},
 	{"GetInputDefaultSettings", &RequestHandler::GetInputDefaultSettings},
-	{"GetInputSettings", &RequestHandler::GetInputSettings},
+	{"GetInputSettings", {&RequestHandler::GetInputSettings, REQUEST_COALESCE}},
 	{"SetInputSettings", &RequestHandler::SetInputSettings},
 	{"GetInputMute", &RequestHandler::GetInputMute},
 	{"SetInputMute", &RequestHandler::SetInputMute},
+	{"SetInputsMute", &RequestHandler::SetInputsMute},
 	{"ToggleInputMute", &RequestHandler::ToggleInputMute},
 	{"GetInputVolume", &RequestHandler::GetInputVolume},
 	{"SetInputVolume", &RequestHandler::SetInputVolume},
+	{"SetInputsVolume", &RequestHandler::SetInputsVolume},
 	{"GetInputAudioBalance", &RequestHandler::GetInputAudioBalance},
 	{"SetInputAudioBalance", &RequestHandler::SetInputAudioBalance},
+	{"SetInputsAudioBalance", &RequestHandler::SetInputsAudioBalance},
 	{"GetInputAudioSyncOffset", &RequestHandler::GetInputAudioSyncOffset},
 	{"SetInputAudioSyncOffset", &RequestHandler::SetInputAudioSyncOffset},
 	{"GetInputAudioMonitorType", &RequestHandler::GetInputAudioMonitorType},
@@ -100,8 +125,8 @@ const std::unordered_map<std::string, RequestMethodHandler> RequestHandler::_han
 	{"PressInputPropertiesButton", &RequestHandler::PressInputPropertiesButton},
 
 	// Transitions
-	{"GetTransitionKindList", &RequestHandler::GetTransitionKindList},
-	{"GetSceneTransitionList", &RequestHandler::GetSceneTransitionList},
+	{"GetTransitionKindList", {&RequestHandler::GetTransitionKindList, REQUEST_COALESCE}},
+	{"GetSceneTransitionList", {&RequestHandler::GetSceneTransitionList, REQUEST_COALESCE}},
 	{"GetCurrentSceneTransition", &RequestHandler::GetCurrentSceneTransition},
 	{"SetCurrentSceneTransition", &RequestHandler::SetCurrentSceneTransition},
 	{"SetCurrentSceneTransitionDuration", &RequestHandler::SetCurrentSceneTransitionDuration},
@@ -111,8 +136,8 @@ const std::unordered_map<std::string, RequestMethodHandler> RequestHandler::_han
 	{"SetTBarPosition", &RequestHandler::SetTBarPosition},
 
 	// Filters
-	{"GetSourceFilterKindList", &RequestHandler::GetSourceFilterKindList},
-	{"GetSourceFilterList", &RequestHandler::GetSourceFilterList},
+	{"GetSourceFilterKindList", {&RequestHandler::GetSourceFilterKindList, REQUEST_COALESCE}},
+	{"GetSourceFilterList", {&RequestHandler::GetSourceFilterList, REQUEST_COALESCE}},
 	{"GetSourceFilterDefaultSettings", &RequestHandler::GetSourceFilterDefaultSettings},
 	{"CreateSourceFilter", &RequestHandler::CreateSourceFilter},
 	{"RemoveSourceFilter", &RequestHandler::RemoveSourceFilter},
@@ -123,8 +148,8 @@ const std::unordered_map<std::string, RequestMethodHandler> RequestHandler::_han
 	{"SetSourceFilterEnabled", &RequestHandler::SetSourceFilterEnabled},
 
 	// Scene Items
-	{"GetSceneItemList", &RequestHandler::GetSceneItemList},
-	{"GetGroupSceneItemList", &RequestHandler::GetGroupSceneItemList},
+	{"GetSceneItemList", {&RequestHandler::GetSceneItemList, REQUEST_COALESCE}},
+	{"GetGroupSceneItemList", {&RequestHandler::GetGroupSceneItemList, REQUEST_COALESCE}},
 	{"GetSceneItemId", &RequestHandler::GetSceneItemId},
 	{"GetSceneItemSource", &RequestHandler::GetSceneItemSource},
 	{"CreateSceneItem", &RequestHandler::CreateSceneItem},
@@ -132,8 +157,11 @@ const std::unordered_map<std::string, RequestMethodHandler> RequestHandler::_han
 	{"DuplicateSceneItem", &RequestHandler::DuplicateSceneItem},
 	{"GetSceneItemTransform", &RequestHandler::GetSceneItemTransform},
 	{"SetSceneItemTransform", &RequestHandler::SetSceneItemTransform},
+	{"GetSceneItemTransforms", &RequestHandler::GetSceneItemTransforms},
+	{"SetSceneItemTransforms", &RequestHandler::SetSceneItemTransforms},
 	{"GetSceneItemEnabled", &RequestHandler::GetSceneItemEnabled},
 	{"SetSceneItemEnabled", &RequestHandler::SetSceneItemEnabled},
+	{"SetSceneItemsEnabled", &RequestHandler::SetSceneItemsEnabled},
 	{"GetSceneItemLocked", &RequestHandler::GetSceneItemLocked},
 	{"SetSceneItemLocked", &RequestHandler::SetSceneItemLocked},
 	{"GetSceneItemIndex", &RequestHandler::GetSceneItemIndex},
@@ -154,7 +182,7 @@ const std::unordered_map<std::string, RequestMethodHandler> RequestHandler::_han
 	{"StopReplayBuffer", &RequestHandler::StopReplayBuffer},
 	{"SaveReplayBuffer", &RequestHandler::SaveReplayBuffer},
 	{"GetLastReplayBufferReplay", &RequestHandler::GetLastReplayBufferReplay},
-	{"GetOutputList", &RequestHandler::GetOutputList},
+	{"GetOutputList", {&RequestHandler::GetOutputList, REQUEST_COALESCE}},
 	{"GetOutputStatus", &RequestHandler::GetOutputStatus},
 	{"ToggleOutput", &RequestHandler::ToggleOutput},
 	{"StartOutput", &RequestHandler::StartOutput},
@@ -193,15 +221,27 @@ const std::unordered_map<std::string, RequestMethodHandler> RequestHandler::_han
 	{"GetMonitorList", &RequestHandler::GetMonitorList},
 	{"OpenVideoMixProjector", &RequestHandler::OpenVideoMixProjector},
 	{"OpenSourceProjector", &RequestHandler::OpenSourceProjector},
+});
+
+// Requests which hand their validated change to the batch in `FrameAtomic` batches, instead of applying it themselves
+const std::unordered_set<std::string> RequestHandler::_frameAtomicRequests{
+	// Scene Items
+	"SetSceneItemTransform",
+	"SetSceneItemTransforms",
+	"SetSceneItemEnabled",
+	"SetSceneItemsEnabled",
+	"SetSceneItemLocked",
+	"SetSceneItemIndex",
+	"SetSceneItemBlendMode",
 };
 
+RequestCoalescer RequestHandler::_requestCoalescer;
+
 RequestHandler::RequestHandler(SessionPtr session) : _session(session) {}
 
 RequestResult RequestHandler::ProcessRequest(const Request &request)
 {
-#ifdef PLUGIN_TESTS
-	ScopeProfiler prof{"obs_websocket_request_processing"};
-#endif
+	Utils::Tracing::Span span("obs_websocket_request_processing");
 
 	if (!request.RequestData.is_object() && !request.RequestData.is_null())
 		return RequestResult::Error(RequestStatus::InvalidRequestFieldType, "Your request data is not an object.");
@@ -209,15 +249,122 @@ RequestResult RequestHandler::ProcessRequest(const Request &request)
 	if (request.RequestType.empty())
 		return RequestResult::Error(RequestStatus::MissingRequestType, "Your request's `requestType` may not be empty.");
 
-	RequestMethodHandler handler;
+	const RequestHandlerEntry *entry;
 	try {
-		handler = _handlerMap.at(request.RequestType);
+		entry = &_handlerMap.at(request.RequestType);
 	} catch (const std::out_of_range &oor) {
 		UNUSED_PARAMETER(oor);
 		return RequestResult::Error(RequestStatus::UnknownRequestType, "Your request type is not valid.");
 	}
 
-	return std::bind(handler, this, std::placeholders::_1)(request);
+	if (request.ExecutionType == RequestBatchExecutionType::FrameAtomic && !_frameAtomicRequests.count(request.RequestType))
+		return RequestResult::Error(RequestStatus::UnsupportedRequestBatchExecutionType,
+					    "Your request type is not supported in `FrameAtomic` batches.");
+
+	// Never make the graphics thread wait on another thread's execution. Streamed parts cannot be shared either.
+	bool coalesce = request.ExecutionType != RequestBatchExecutionType::SerialFrame && !IsStreamingRequested(request) &&
+			(entry->Flags & REQUEST_COALESCE);
+
+	return ExecuteHandler(*entry, request, coalesce);
+}
+
+RequestResult RequestHandler::ProcessPreparedRequest(const RequestHandlerEntry &entry, const Request &request)
+{
+	Utils::Tracing::Span span("obs_websocket_request_processing");
+
+	return ExecuteHandler(entry, request, entry.Flags & REQUEST_COALESCE);
+}
+
+RequestResult RequestHandler::ExecuteHandler(const RequestHandlerEntry &entry, const Request &request, bool coalesce)
+{
+	RequestMethodHandler handler = entry.Handler;
+	Utils::Tracing::Span span("obs_websocket_request_execution", request.RequestType);
+	auto start = Utils::Metrics::Clock::now();
+
+	RequestResult result;
+	if (coalesce)
+		result = _requestCoalescer.Process(request, [this, handler, &request]() { return (this->*handler)(request); });
+	else
+		result = (this->*handler)(request);
+
+	entry.Metrics->Record(start, result.Succeeded());
+
+	return result;
+}
+
+// Streaming is only possible where a chunk callback exists (not in request batches or vendor API calls)
+bool RequestHandler::IsStreamingRequested(const Request &request)
+{
+	return _responseChunkCallback && request.Contains("streamChunks") && request.RequestData["streamChunks"].is_boolean() &&
+	       request.RequestData["streamChunks"];
+}
+
+// Thread-safe
+void RequestHandler::SendResponseChunk(const json &chunkData)
+{
+	_responseChunkCallback(_responseChunkCount++, chunkData);
+}
+
+// Shared request fields of paginated list requests:
+// - `cursor`: Opaque cursor from `nextCursor` of the previous page. Omit to start at the beginning
+// - `limit`: Maximum number of items in the page, up to 10000. Omit for no limit
+// - `streamChunks`: Send the items in `RequestResponse` parts of up to `chunkSize` items as they are built
+// - `chunkSize`: Number of items per streamed part. Defaults to 100
+bool RequestHandler::ValidateListPager(const Request &request, const std::string &listKey, Utils::Obs::ListPager &pager,
+				       RequestStatus::RequestStatus &statusCode, std::string &comment)
+{
+	if (request.Contains("cursor")) {
+		if (!request.ValidateOptionalString("cursor", statusCode, comment))
+			return false;
+
+		if (!pager.SetCursor(request.RequestData["cursor"])) {
+			statusCode = RequestStatus::InvalidRequestField;
+			comment = "The field value of `cursor` is not a valid cursor.";
+			return false;
+		}
+	}
+
+	if (request.Contains("limit")) {
+		if (!request.ValidateOptionalNumber("limit", statusCode, comment, 1, 10000))
+			return false;
+		pager.SetLimit(request.RequestData["limit"].get<size_t>());
+	}
+
+	if (request.Contains("streamChunks") && !request.ValidateOptionalBoolean("streamChunks", statusCode, comment))
+		return false;
+
+	if (!IsStreamingRequested(request))
+		return true;
+
+	size_t chunkSize = 100;
+	if (request.Contains("chunkSize")) {
+		if (!request.ValidateOptionalNumber("chunkSize", statusCode, comment, 1, 10000))
+			return false;
+		chunkSize = request.RequestData["chunkSize"];
+	}
+
+	pager.SetChunkCallback(chunkSize, [this, listKey](std::vector<json> &&items) {
+		json chunkData;
+		chunkData[listKey] = std::move(items);
+		SendResponseChunk(chunkData);
+	});
+
+	return true;
+}
+
+// Streamed lists only carry the page information in their final response
+void RequestHandler::AddListPageInfo(const Request &request, const std::string &listKey, const Utils::Obs::ListPager &pager,
+				     json &responseData)
+{
+	if (pager.HasMore())
+		responseData["nextCursor"] = pager.NextCursor();
+	else
+		responseData["nextCursor"] = nullptr;
+
+	if (IsStreamingRequested(request)) {
+		responseData.erase(listKey);
+		responseData["chunkCount"] = _responseChunkCount.load();
+	}
 }
 
 std::vector<std::string> RequestHandler::GetRequestList()
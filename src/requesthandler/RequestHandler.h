@@ -19,10 +19,16 @@ with this program. If not, see <https://www.gnu.org/licenses/>
 
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <unordered_set>
 #include <obs.hpp>
 #include <obs-frontend-api.h>
 
+#include "RequestCoalescer.h"
+#include "rpc/PreparedRequestBatch.h"
 #include "rpc/Request.h"
 #include "rpc/RequestResult.h"
 #include "types/RequestStatus.h"
@@ -30,28 +36,70 @@ with this program. If not, see <https://www.gnu.org/licenses/>
 #include "../websocketserver/rpc/WebSocketSession.h"
 #include "../obs-websocket.h"
 #include "../utils/Obs.h"
+#include "../utils/Metrics.h"
 #include "plugin-macros.generated.h"
 
-class RequestHandler;
-typedef RequestResult (RequestHandler::*RequestMethodHandler)(const Request &);
+enum RequestHandlerFlags : uint32_t {
+	REQUEST_COALESCE = 1 << 0, // Identical in-flight requests may share a single execution
+};
+
+// Entry of the handler map, with everything about a request type that is looked up before it executes
+struct RequestHandlerEntry {
+	RequestHandlerEntry(RequestMethodHandler handler, uint32_t flags = 0) : Handler(handler), Flags(flags), Metrics(nullptr) {}
+
+	RequestMethodHandler Handler;
+	uint32_t Flags;
+	// Resolved once when the handler map is built, so recording a request does not hash its type again
+	Utils::Metrics::OperationMetrics *Metrics;
+};
 
 class RequestHandler {
 public:
 	RequestHandler(SessionPtr session = nullptr);
 
 	RequestResult ProcessRequest(const Request &request);
+	// Skips the checks of `ProcessRequest()`, which were already done when the request was prepared
+	RequestResult ProcessPreparedRequest(const RequestHandlerEntry &entry, const Request &request);
 	std::vector<std::string> GetRequestList();
 
+	// Callback for requests which can send parts of their response before they complete. Must be thread-safe.
+	typedef std::function<void(size_t, const json &)> ResponseChunkCallback; // size_t chunkIndex, json chunkData
+	inline void SetResponseChunkCallback(ResponseChunkCallback cb) { _responseChunkCallback = cb; }
+
 private:
 	// General
 	RequestResult GetVersion(const Request &);
 	RequestResult GetStats(const Request &);
+	RequestResult GetServerMetrics(const Request &);
+	RequestResult GetTracingEnabled(const Request &);
+	RequestResult SetTracingEnabled(const Request &);
+	RequestResult GetTrace(const Request &);
+	RequestResult SaveTrace(const Request &);
+	RequestResult GetSlowRequestLog(const Request &);
+	RequestResult GetSlowRequestThresholds(const Request &);
+	RequestResult SetSlowRequestThresholds(const Request &);
 	RequestResult BroadcastCustomEvent(const Request &);
 	RequestResult CallVendorRequest(const Request &);
 	RequestResult GetHotkeyList(const Request &);
 	RequestResult TriggerHotkeyByName(const Request &);
 	RequestResult TriggerHotkeyByKeySequence(const Request &);
 	RequestResult Sleep(const Request &);
+	RequestResult GetFullState(const Request &);
+	RequestResult PrepareRequestBatch(const Request &);
+	RequestResult ExecutePreparedBatch(const Request &);
+	RequestResult RemovePreparedBatch(const Request &);
+	RequestResult CancelScheduledRequestBatch(const Request &);
+
+	// Runs the handler and records its latency in the server metrics
+	RequestResult ExecuteHandler(const RequestHandlerEntry &entry, const Request &request, bool coalesce);
+
+	// Response streaming and list pagination
+	bool IsStreamingRequested(const Request &request);
+	void SendResponseChunk(const json &chunkData);
+	bool ValidateListPager(const Request &request, const std::string &listKey, Utils::Obs::ListPager &pager,
+			       RequestStatus::RequestStatus &statusCode, std::string &comment);
+	void AddListPageInfo(const Request &request, const std::string &listKey, const Utils::Obs::ListPager &pager,
+			     json &responseData);
 
 	// Config
 	RequestResult GetPersistentData(const Request &);
@@ -104,11 +152,14 @@ private:
 	RequestResult SetInputSettings(const Request &);
 	RequestResult GetInputMute(const Request &);
 	RequestResult SetInputMute(const Request &);
+	RequestResult SetInputsMute(const Request &);
 	RequestResult ToggleInputMute(const Request &);
 	RequestResult GetInputVolume(const Request &);
 	RequestResult SetInputVolume(const Request &);
+	RequestResult SetInputsVolume(const Request &);
 	RequestResult GetInputAudioBalance(const Request &);
 	RequestResult SetInputAudioBalance(const Request &);
+	RequestResult SetInputsAudioBalance(const Request &);
 	RequestResult GetInputAudioSyncOffset(const Request &);
 	RequestResult SetInputAudioSyncOffset(const Request &);
 	RequestResult GetInputAudioMonitorType(const Request &);
@@ -151,8 +202,11 @@ private:
 	RequestResult DuplicateSceneItem(const Request &);
 	RequestResult GetSceneItemTransform(const Request &);
 	RequestResult SetSceneItemTransform(const Request &);
+	RequestResult GetSceneItemTransforms(const Request &);
+	RequestResult SetSceneItemTransforms(const Request &);
 	RequestResult GetSceneItemEnabled(const Request &);
 	RequestResult SetSceneItemEnabled(const Request &);
+	RequestResult SetSceneItemsEnabled(const Request &);
 	RequestResult GetSceneItemLocked(const Request &);
 	RequestResult SetSceneItemLocked(const Request &);
 	RequestResult GetSceneItemIndex(const Request &);
@@ -214,5 +268,9 @@ private:
 	RequestResult OpenSourceProjector(const Request &);
 
 	SessionPtr _session;
-	static const std::unordered_map<std::string, RequestMethodHandler> _handlerMap;
+	ResponseChunkCallback _responseChunkCallback;
+	std::atomic<size_t> _responseChunkCount = 0;
+	static const std::unordered_map<std::string, RequestHandlerEntry> _handlerMap;
+	static const std::unordered_set<std::string> _frameAtomicRequests;
+	static RequestCoalescer _requestCoalescer;
 };
@@ -18,6 +18,7 @@ with this program. If not, see <https://www.gnu.org/licenses/>
 */
 
 #include "RequestHandler.h"
+#include "../eventhandler/EventHandler.h"
 
 /**
  * Gets an array of all available source filter kinds.
@@ -43,10 +44,16 @@ RequestResult RequestHandler::GetSourceFilterKindList(const Request &)
 /**
  * Gets an array of all of a source's filters.
  *
- * @requestField ?sourceName | String | Name of the source
- * @requestField ?sourceUuid | String | UUID of the source
+ * If `ifVersionNot` matches the current `resourceVersion` of the source's filter list, the request returns with the `NotModified` status and only `resourceVersion` is provided.
+ * The version changes whenever a filter is added, removed, reordered, renamed, enabled or disabled, or has its settings updated, and whenever any source is renamed.
+ *
+ * @requestField ?sourceName   | String        | Name of the source
+ * @requestField ?sourceUuid   | String        | UUID of the source
+ * @requestField ?ifVersionNot | Number        | `resourceVersion` of a previous response to compare against
+ * @requestField ?fields       | Array<String> | Fields of each filter to return, besides `filterName` | All fields
  *
- * @responseField filters | Array<Object> | Array of filters
+ * @responseField filters         | Array<Object> | Array of filters
+ * @responseField resourceVersion | Number        | Version of the source's filter list, incremented whenever it changes
  *
  * @requestType GetSourceFilterList
  * @complexity 2
@@ -59,12 +66,22 @@ RequestResult RequestHandler::GetSourceFilterList(const Request &request)
 {
 	RequestStatus::RequestStatus statusCode;
 	std::string comment;
+	Utils::Obs::FieldSelector fields;
 	OBSSourceAutoRelease source = request.ValidateSource("sourceName", "sourceUuid", statusCode, comment);
-	if (!source)
+	if (!(source && request.ValidateOptionalFieldSelector("fields", statusCode, comment, fields,
+							      Utils::Obs::SelectableFields::Filter)))
 		return RequestResult::Error(statusCode, comment);
 
+	if (request.Contains("ifVersionNot") && !request.ValidateOptionalNumber("ifVersionNot", statusCode, comment, 0))
+		return RequestResult::Error(statusCode, comment);
+
+	uint64_t resourceVersion = GetEventHandler()->GetResourceVersion(EventHandler::RESOURCE_SOURCE_FILTER_LIST, source);
+	if (request.Contains("ifVersionNot") && request.RequestData["ifVersionNot"] == resourceVersion)
+		return RequestResult::NotModified(resourceVersion);
+
 	json responseData;
-	responseData["filters"] = Utils::Obs::ArrayHelper::GetSourceFilterList(source);
+	responseData["filters"] = Utils::Obs::ArrayHelper::GetSourceFilterList(source, fields);
+	responseData["resourceVersion"] = resourceVersion;
 
 	return RequestResult::Success(responseData);
 }
@@ -17,15 +17,26 @@ You should have received a copy of the GNU General Public License along
 with this program. If not, see <https://www.gnu.org/licenses/>
 */
 
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
 #include <QImageWriter>
 #include <QSysInfo>
 
 #include "RequestHandler.h"
+#include "RequestBatchHandler.h"
+#include "ControlStreamHandler.h"
+#include "SlowRequestLog.h"
 #include "../websocketserver/WebSocketServer.h"
+#include "../utils/Metrics.h"
+#include "../utils/TaskGroup.h"
+#include "../utils/Tracing.h"
 #include "../eventhandler/types/EventSubscription.h"
 #include "../WebSocketApi.h"
 #include "../obs-websocket.h"
 
+static const size_t MaxPreparedBatches = 64; // Per session
+
 /**
  * Gets data about the current plugin and RPC version.
  *
@@ -79,6 +90,7 @@ RequestResult RequestHandler::GetVersion(const Request &)
  * @responseField outputTotalFrames                | Number | Total number of frames outputted by the output thread
  * @responseField webSocketSessionIncomingMessages | Number | Total number of messages received by obs-websocket from the client
  * @responseField webSocketSessionOutgoingMessages | Number | Total number of messages sent by obs-websocket to the client
+ * @responseField webSocketSessionControlStream    | Object | Numbers of `received`, `applied`, `failed`, `superseded` and `dropped` control updates of the session
  *
  * @requestType GetStats
  * @complexity 2
@@ -94,14 +106,259 @@ RequestResult RequestHandler::GetStats(const Request &)
 	if (_session) {
 		responseData["webSocketSessionIncomingMessages"] = _session->IncomingMessages();
 		responseData["webSocketSessionOutgoingMessages"] = _session->OutgoingMessages();
+		responseData["webSocketSessionControlStream"] = ControlStreamHandler::GetStatistics(_session);
 	} else {
 		responseData["webSocketSessionIncomingMessages"] = nullptr;
 		responseData["webSocketSessionOutgoingMessages"] = nullptr;
+		responseData["webSocketSessionControlStream"] = nullptr;
 	}
 
 	return RequestResult::Success(responseData);
 }
 
+/**
+ * Gets the metrics which obs-websocket collects across all sessions since it was started.
+ *
+ * Every request and event type has a `total` count, a `failed` count (requests only), and its latency in microseconds as
+ * `latencySum` and the `latencyP50`, `latencyP90`, `latencyP99` and `latencyP999` quantiles. Event latency is measured from
+ * the event being emitted until it has been sent to all sessions.
+ *
+ * The same metrics are served in the Prometheus text format by HTTP `GET` requests to `/metrics` on the WebSocket server port.
+ *
+ * @requestField ?format | String | Format of the metrics, `json` or `prometheus` | `json`
+ *
+ * @responseField metrics     | Object | Metrics as an object of `requests` and `events` by type, `messagesReceived`, `bytesReceived`, `messagesSent`, `bytesSent`, `failedSends`, `messageQueueDepth` and `sessions`. Only with the `json` format
+ * @responseField metricsText | String | Metrics in the Prometheus text exposition format. Only with the `prometheus` format
+ *
+ * @requestType GetServerMetrics
+ * @complexity 3
+ * @rpcVersion -1
+ * @initialVersion 5.5.0
+ * @category general
+ * @api requests
+ */
+RequestResult RequestHandler::GetServerMetrics(const Request &request)
+{
+	RequestStatus::RequestStatus statusCode;
+	std::string comment;
+	std::string format = "json";
+	if (request.Contains("format")) {
+		if (!request.ValidateOptionalString("format", statusCode, comment))
+			return RequestResult::Error(statusCode, comment);
+		format = request.RequestData["format"];
+	}
+
+	json responseData;
+	if (format == "json")
+		responseData["metrics"] = Utils::Metrics::ToJson();
+	else if (format == "prometheus")
+		responseData["metricsText"] = Utils::Metrics::ToPrometheusText();
+	else
+		return RequestResult::Error(RequestStatus::InvalidRequestField,
+					    "The field `format` must be one of `json` or `prometheus`.");
+
+	return RequestResult::Success(responseData);
+}
+
+/**
+ * Gets whether request tracing is enabled.
+ *
+ * @responseField tracingEnabled | Boolean | Whether request tracing is enabled
+ *
+ * @requestType GetTracingEnabled
+ * @complexity 2
+ * @rpcVersion -1
+ * @initialVersion 5.5.0
+ * @category general
+ * @api requests
+ */
+RequestResult RequestHandler::GetTracingEnabled(const Request &)
+{
+	json responseData;
+	responseData["tracingEnabled"] = Utils::Tracing::IsEnabled();
+	return RequestResult::Success(responseData);
+}
+
+/**
+ * Enables or disables request tracing.
+ *
+ * While enabled, obs-websocket records spans for the stages of handling messages (queueing, decoding, request validation and
+ * execution, serialization and sending) and broadcasting events into ring buffers of the threads they run on. The spans also
+ * show up in the OBS profiler. Enabling tracing starts a new trace.
+ *
+ * @requestField tracingEnabled | Boolean | Whether to enable request tracing
+ *
+ * @requestType SetTracingEnabled
+ * @complexity 3
+ * @rpcVersion -1
+ * @initialVersion 5.5.0
+ * @category general
+ * @api requests
+ */
+RequestResult RequestHandler::SetTracingEnabled(const Request &request)
+{
+	RequestStatus::RequestStatus statusCode;
+	std::string comment;
+	if (!request.ValidateBoolean("tracingEnabled", statusCode, comment))
+		return RequestResult::Error(statusCode, comment);
+
+	Utils::Tracing::SetEnabled(request.RequestData["tracingEnabled"]);
+
+	return RequestResult::Success();
+}
+
+/**
+ * Gets the spans recorded since request tracing was last enabled.
+ *
+ * Only the latest spans of every thread are kept.
+ *
+ * @responseField trace | Object | Trace in the Chrome trace event format, which can be opened in Perfetto or `chrome://tracing`
+ *
+ * @requestType GetTrace
+ * @complexity 3
+ * @rpcVersion -1
+ * @initialVersion 5.5.0
+ * @category general
+ * @api requests
+ */
+RequestResult RequestHandler::GetTrace(const Request &)
+{
+	json responseData;
+	responseData["trace"] = Utils::Tracing::GetTrace();
+	return RequestResult::Success(responseData);
+}
+
+/**
+ * Saves the spans recorded since request tracing was last enabled to a file.
+ *
+ * Only the latest spans of every thread are kept.
+ *
+ * @requestField traceFilePath | String | Path to save the trace file to, in the Chrome trace event format. Eg. `C:\Users\user\Desktop\trace.json`
+ *
+ * @requestType SaveTrace
+ * @complexity 3
+ * @rpcVersion -1
+ * @initialVersion 5.5.0
+ * @category general
+ * @api requests
+ */
+RequestResult RequestHandler::SaveTrace(const Request &request)
+{
+	RequestStatus::RequestStatus statusCode;
+	std::string comment;
+	if (!request.ValidateString("traceFilePath", statusCode, comment))
+		return RequestResult::Error(statusCode, comment);
+
+	std::string traceFilePath = request.RequestData["traceFilePath"];
+
+	QFileInfo filePathInfo(QString::fromStdString(traceFilePath));
+	if (!filePathInfo.absoluteDir().exists())
+		return RequestResult::Error(RequestStatus::ResourceNotFound, "The directory for your file path does not exist.");
+
+	QFile traceFile(filePathInfo.absoluteFilePath());
+	if (!traceFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		return RequestResult::Error(RequestStatus::RequestProcessingFailed, "Failed to open the trace file for writing.");
+
+	std::string traceData = Utils::Tracing::GetTrace().dump();
+	if (traceFile.write(traceData.data(), traceData.size()) != (qint64)traceData.size())
+		return RequestResult::Error(RequestStatus::RequestProcessingFailed, "Failed to save the trace.");
+
+	return RequestResult::Success();
+}
+
+/**
+ * Gets the most recent requests which took longer than the slow request threshold of their request type.
+ *
+ * Up to 100 slow requests are kept, oldest first. Slow requests are also logged. Only requests sent with the `Request`
+ * OpCode are checked.
+ *
+ * @responseField slowRequests | Array<Object> | Slow requests, each with `requestType`, `remoteAddress` and `sessionConnectedAt` of the session, `requestDataSize` in bytes, `queueTime` and `executionTime` in milliseconds, `laggedFrames` of the OBS render thread during execution, `requestStatus` and `timestamp` (milliseconds since the epoch)
+ *
+ * @requestType GetSlowRequestLog
+ * @complexity 3
+ * @rpcVersion -1
+ * @initialVersion 5.5.0
+ * @category general
+ * @api requests
+ */
+RequestResult RequestHandler::GetSlowRequestLog(const Request &)
+{
+	json responseData;
+	responseData["slowRequests"] = SlowRequestLog::GetEntries();
+	return RequestResult::Success(responseData);
+}
+
+/**
+ * Gets the latency thresholds above which requests are reported as slow.
+ *
+ * @responseField defaultThreshold  | Number | Threshold in milliseconds of request types without their own threshold
+ * @responseField requestThresholds | Object | Thresholds in milliseconds by request type
+ *
+ * @requestType GetSlowRequestThresholds
+ * @complexity 3
+ * @rpcVersion -1
+ * @initialVersion 5.5.0
+ * @category general
+ * @api requests
+ */
+RequestResult RequestHandler::GetSlowRequestThresholds(const Request &)
+{
+	return RequestResult::Success(SlowRequestLog::GetThresholds());
+}
+
+/**
+ * Sets the latency thresholds above which requests are reported as slow. The latency of a request includes the time it was
+ * queued for.
+ *
+ * The thresholds are reset when OBS is restarted.
+ *
+ * @requestField ?defaultThreshold  | Number | Threshold in milliseconds of request types without their own threshold | >= 0 | Unchanged, initially 250
+ * @requestField ?requestThresholds | Object | Thresholds in milliseconds by request type to change. A threshold of `null` reverts the request type to the default threshold | None | Unchanged
+ *
+ * @requestType SetSlowRequestThresholds
+ * @complexity 3
+ * @rpcVersion -1
+ * @initialVersion 5.5.0
+ * @category general
+ * @api requests
+ */
+RequestResult RequestHandler::SetSlowRequestThresholds(const Request &request)
+{
+	RequestStatus::RequestStatus statusCode;
+	std::string comment;
+	bool hasDefaultThreshold = request.Contains("defaultThreshold");
+	if (hasDefaultThreshold && !request.ValidateOptionalNumber("defaultThreshold", statusCode, comment, 0))
+		return RequestResult::Error(statusCode, comment);
+
+	bool hasRequestThresholds = request.Contains("requestThresholds");
+	if (hasRequestThresholds) {
+		if (!request.ValidateOptionalObject("requestThresholds", statusCode, comment, true))
+			return RequestResult::Error(statusCode, comment);
+
+		for (auto &[requestType, threshold] : request.RequestData["requestThresholds"].items()) {
+			if (!_handlerMap.count(requestType))
+				return RequestResult::Error(RequestStatus::InvalidRequestField,
+							    "The request type `" + requestType + "` is not valid.");
+
+			if (!threshold.is_null() && !(threshold.is_number() && threshold >= 0))
+				return RequestResult::Error(RequestStatus::InvalidRequestFieldType,
+							    "The threshold of `" + requestType +
+								    "` must be a number of at least 0 or null.");
+		}
+	}
+
+	if (!hasDefaultThreshold && !hasRequestThresholds)
+		return RequestResult::Error(RequestStatus::MissingRequestField,
+					    "You must specify at least one of `defaultThreshold` or `requestThresholds`.");
+
+	if (hasDefaultThreshold)
+		SlowRequestLog::SetDefaultThreshold(request.RequestData["defaultThreshold"]);
+	if (hasRequestThresholds)
+		SlowRequestLog::SetThresholds(request.RequestData["requestThresholds"]);
+
+	return RequestResult::Success();
+}
+
 /**
  * Custom event emitted by `BroadcastCustomEvent`.
  * 
@@ -215,7 +472,16 @@ RequestResult RequestHandler::CallVendorRequest(const Request &request)
  *
  * Note: Hotkey functionality in obs-websocket comes as-is, and we do not guarantee support if things are broken. In 9/10 usages of hotkey requests, there exists a better, more reliable method via other requests.
  *
- * @responseField hotkeys | Array<String> | Array of hotkey names
+ * Supports pagination and streaming of the `hotkeys` array through the `cursor`, `limit`, `streamChunks` and `chunkSize` fields.
+ *
+ * @requestField ?cursor       | String  | `nextCursor` of the previous page                                     | Start of the list
+ * @requestField ?limit        | Number  | Maximum number of hotkeys to return                                   | No limit
+ * @requestField ?streamChunks | Boolean | Whether to send the hotkeys in `RequestResponse` parts of `chunkSize` | false
+ * @requestField ?chunkSize    | Number  | Number of hotkeys per streamed part                                   | 100
+ *
+ * @responseField hotkeys    | Array<String> | Array of hotkey names. Not present if streamed
+ * @responseField nextCursor | String        | Cursor of the next page. `null` if this is the last page
+ * @responseField chunkCount | Number        | Number of streamed parts. Only present if streamed
  *
  * @requestType GetHotkeyList
  * @complexity 4
@@ -224,10 +490,17 @@ RequestResult RequestHandler::CallVendorRequest(const Request &request)
  * @category general
  * @api requests
  */
-RequestResult RequestHandler::GetHotkeyList(const Request &)
+RequestResult RequestHandler::GetHotkeyList(const Request &request)
 {
+	RequestStatus::RequestStatus statusCode;
+	std::string comment;
+	Utils::Obs::ListPager pager;
+	if (!ValidateListPager(request, "hotkeys", pager, statusCode, comment))
+		return RequestResult::Error(statusCode, comment);
+
 	json responseData;
-	responseData["hotkeys"] = Utils::Obs::ArrayHelper::GetHotkeyNameList();
+	responseData["hotkeys"] = pager.Paginate(Utils::Obs::ArrayHelper::GetHotkeyNameList());
+	AddListPageInfo(request, "hotkeys", pager, responseData);
 	return RequestResult::Success(responseData);
 }
 
@@ -359,9 +632,10 @@ RequestResult RequestHandler::Sleep(const Request &request)
 	if (request.ExecutionType == RequestBatchExecutionType::SerialRealtime) {
 		if (!request.ValidateNumber("sleepMillis", statusCode, comment, 0, 50000))
 			return RequestResult::Error(statusCode, comment);
-		int64_t sleepMillis = request.RequestData["sleepMillis"];
-		std::this_thread::sleep_for(std::chrono::milliseconds(sleepMillis));
-		return RequestResult::Success();
+		// The batch is suspended by the batch handler, so that sleeping does not block a thread
+		RequestResult ret = RequestResult::Success();
+		ret.SleepMillis = request.RequestData["sleepMillis"];
+		return ret;
 	} else if (request.ExecutionType == RequestBatchExecutionType::SerialFrame) {
 		if (!request.ValidateNumber("sleepFrames", statusCode, comment, 0, 10000))
 			return RequestResult::Error(statusCode, comment);
@@ -372,3 +646,472 @@ RequestResult RequestHandler::Sleep(const Request &request)
 		return RequestResult::Error(RequestStatus::UnsupportedRequestBatchExecutionType);
 	}
 }
+
+static json GetFullStateScene(const json &sceneInfo)
+{
+	json ret = sceneInfo;
+
+	std::string sceneUuid = sceneInfo["sceneUuid"];
+	OBSSourceAutoRelease scene = obs_get_source_by_uuid(sceneUuid.c_str());
+	if (!scene)
+		return ret;
+
+	ret["sceneItems"] = Utils::Obs::ArrayHelper::GetSceneItemList(obs_scene_from_source(scene));
+	ret["filters"] = Utils::Obs::ArrayHelper::GetSourceFilterList(scene);
+
+	return ret;
+}
+
+static json GetFullStateInput(const json &inputInfo)
+{
+	json ret = inputInfo;
+
+	std::string inputUuid = inputInfo["inputUuid"];
+	OBSSourceAutoRelease input = obs_get_source_by_uuid(inputUuid.c_str());
+	if (!input)
+		return ret;
+
+	OBSDataAutoRelease inputSettings = obs_source_get_settings(input);
+	ret["inputSettings"] = Utils::Json::ObsDataToJson(inputSettings);
+
+	if (obs_source_get_output_flags(input) & OBS_SOURCE_AUDIO) {
+		float inputVolumeMul = obs_source_get_volume(input);
+		float inputVolumeDb = obs_mul_to_db(inputVolumeMul);
+		if (inputVolumeDb == -INFINITY)
+			inputVolumeDb = -100.0;
+
+		long long tracks = obs_source_get_audio_mixers(input);
+		json inputAudioTracks;
+		for (long long i = 0; i < MAX_AUDIO_MIXES; i++) {
+			inputAudioTracks[std::to_string(i + 1)] = (bool)((tracks >> i) & 1);
+		}
+
+		json inputAudio;
+		inputAudio["inputMuted"] = obs_source_muted(input);
+		inputAudio["inputVolumeMul"] = inputVolumeMul;
+		inputAudio["inputVolumeDb"] = inputVolumeDb;
+		inputAudio["inputAudioBalance"] = obs_source_get_balance_value(input);
+		inputAudio["inputAudioSyncOffset"] = obs_source_get_sync_offset(input) / 1000000;
+		inputAudio["monitorType"] = obs_source_get_monitoring_type(input);
+		inputAudio["inputAudioTracks"] = inputAudioTracks;
+		ret["inputAudio"] = inputAudio;
+	} else {
+		ret["inputAudio"] = nullptr;
+	}
+
+	ret["filters"] = Utils::Obs::ArrayHelper::GetSourceFilterList(input);
+
+	return ret;
+}
+
+/**
+ * Gets a snapshot of the entire state of OBS in a single request.
+ *
+ * This replaces the round trips of `GetSceneList`, `GetSceneItemList`, `GetInputList`, `GetInputSettings`, the input audio requests, `GetSourceFilterList`, `GetSceneTransitionList` and `GetOutputList`. Independent parts of the snapshot are built concurrently.
+ *
+ * If `streamChunks` is `true`, every part is sent as its own `RequestResponse` as soon as it is ready. Each of those messages carries the `requestId` of the request, a `responseChunk` index, the `ResponseChunk` request status (with `result` set to `false`, as the request has not completed yet), and one of the response fields below in its `responseData` (`scenes` and `inputs` are sent as one `scene`/`input` object per chunk). The final `RequestResponse` without `responseChunk` carries the actual result of the request, and contains only `chunkCount` if it succeeded. Streaming is not available in request batches, where the field is ignored.
+ *
+ * Inputs which do not support audio have `inputAudio` set to `null`.
+ *
+ * @requestField ?streamChunks | Boolean | Whether to stream the snapshot in parts as they complete | false
+ *
+ * @responseField currentProgramSceneName    | String        | Current program scene name. Can be `null` if internal state desync
+ * @responseField currentProgramSceneUuid    | String        | Current program scene UUID. Can be `null` if internal state desync
+ * @responseField currentPreviewSceneName    | String        | Current preview scene name. `null` if not in studio mode
+ * @responseField currentPreviewSceneUuid    | String        | Current preview scene UUID. `null` if not in studio mode
+ * @responseField currentSceneTransitionName | String        | Name of the current scene transition. Can be null
+ * @responseField currentSceneTransitionUuid | String        | UUID of the current scene transition. Can be null
+ * @responseField scenes                     | Array<Object> | Array of scenes, each with its `sceneItems` and `filters`
+ * @responseField inputs                     | Array<Object> | Array of inputs, each with its `inputSettings`, `inputAudio` and `filters`
+ * @responseField transitions                | Array<Object> | Array of scene transitions
+ * @responseField outputs                    | Array<Object> | Array of outputs
+ *
+ * @requestType GetFullState
+ * @complexity 4
+ * @rpcVersion -1
+ * @initialVersion 5.5.0
+ * @category general
+ * @api requests
+ */
+RequestResult RequestHandler::GetFullState(const Request &request)
+{
+	RequestStatus::RequestStatus statusCode;
+	std::string comment;
+	if (request.Contains("streamChunks") && !request.ValidateOptionalBoolean("streamChunks", statusCode, comment))
+		return RequestResult::Error(statusCode, comment);
+
+	bool streamChunks = IsStreamingRequested(request);
+
+	json state;
+
+	OBSSourceAutoRelease currentProgramScene = obs_frontend_get_current_scene();
+	if (currentProgramScene) {
+		state["currentProgramSceneName"] = obs_source_get_name(currentProgramScene);
+		state["currentProgramSceneUuid"] = obs_source_get_uuid(currentProgramScene);
+	} else {
+		state["currentProgramSceneName"] = nullptr;
+		state["currentProgramSceneUuid"] = nullptr;
+	}
+
+	OBSSourceAutoRelease currentPreviewScene = obs_frontend_get_current_preview_scene();
+	if (currentPreviewScene) {
+		state["currentPreviewSceneName"] = obs_source_get_name(currentPreviewScene);
+		state["currentPreviewSceneUuid"] = obs_source_get_uuid(currentPreviewScene);
+	} else {
+		state["currentPreviewSceneName"] = nullptr;
+		state["currentPreviewSceneUuid"] = nullptr;
+	}
+
+	OBSSourceAutoRelease currentTransition = obs_frontend_get_current_transition();
+	if (currentTransition) {
+		state["currentSceneTransitionName"] = obs_source_get_name(currentTransition);
+		state["currentSceneTransitionUuid"] = obs_source_get_uuid(currentTransition);
+	} else {
+		state["currentSceneTransitionName"] = nullptr;
+		state["currentSceneTransitionUuid"] = nullptr;
+	}
+
+	if (streamChunks)
+		SendResponseChunk(state);
+
+	std::vector<json> scenes = Utils::Obs::ArrayHelper::GetSceneList();
+	std::vector<json> inputs = Utils::Obs::ArrayHelper::GetInputList();
+	std::vector<json> transitions;
+	std::vector<json> outputs;
+
+	// Every task only writes to its own slot, so no locking is needed around the results
+	{
+		Utils::TaskGroup taskGroup(GetWebSocketServer() ? GetWebSocketServer()->GetThreadPool() : nullptr);
+
+		for (auto &scene : scenes) {
+			taskGroup.Run([this, &scene, streamChunks]() {
+				scene = GetFullStateScene(scene);
+				if (streamChunks)
+					SendResponseChunk({{"scene", scene}});
+			});
+		}
+
+		for (auto &input : inputs) {
+			taskGroup.Run([this, &input, streamChunks]() {
+				input = GetFullStateInput(input);
+				if (streamChunks)
+					SendResponseChunk({{"input", input}});
+			});
+		}
+
+		taskGroup.Run([this, &transitions, streamChunks]() {
+			transitions = Utils::Obs::ArrayHelper::GetSceneTransitionList();
+			if (streamChunks)
+				SendResponseChunk({{"transitions", transitions}});
+		});
+
+		taskGroup.Run([this, &outputs, streamChunks]() {
+			outputs = Utils::Obs::ArrayHelper::GetOutputList();
+			if (streamChunks)
+				SendResponseChunk({{"outputs", outputs}});
+		});
+
+		try {
+			taskGroup.Wait();
+		} catch (const std::exception &e) {
+			return RequestResult::Error(RequestStatus::RequestProcessingFailed,
+						    std::string("Failed to build the state snapshot: ") + e.what());
+		} catch (...) {
+			return RequestResult::Error(RequestStatus::RequestProcessingFailed, "Failed to build the state snapshot.");
+		}
+	}
+
+	json responseData;
+	if (streamChunks) {
+		responseData["chunkCount"] = _responseChunkCount.load();
+		return RequestResult::Success(responseData);
+	}
+
+	responseData = state;
+	responseData["scenes"] = scenes;
+	responseData["inputs"] = inputs;
+	responseData["transitions"] = transitions;
+	responseData["outputs"] = outputs;
+	return RequestResult::Success(responseData);
+}
+
+static bool ValidatePreparedRequestVariables(const json &requestJson, const std::string &keyName,
+					     RequestStatus::RequestStatus &statusCode, std::string &comment)
+{
+	if (!requestJson.contains(keyName) || requestJson[keyName].is_null())
+		return true;
+
+	if (!requestJson[keyName].is_object()) {
+		statusCode = RequestStatus::InvalidRequestFieldType;
+		comment = std::string("The field `") + keyName + "` is not an object.";
+		return false;
+	}
+
+	for (auto &[key, value] : requestJson[keyName].items()) {
+		if (!value.is_string()) {
+			statusCode = RequestStatus::InvalidRequestFieldType;
+			comment = std::string("The value of `") + key + "` in `" + keyName + "` is not a string.";
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Validates a request batch once and stores it under an ID, so that it can be executed any number of times with `ExecutePreparedBatch`.
+ *
+ * Requests have the same form as in a `RequestBatch` message. Values which change between executions are declared in `parameters`, and are filled into the requests through their `inputVariables`. Request types and the form of each request are checked once here instead of on every execution.
+ *
+ * Prepared batches belong to the client which prepared them, and are kept until they are removed or the client disconnects. A client can have up to 64 prepared batches. Preparing a batch with an existing ID replaces it. `Sleep` and the prepared batch requests themselves cannot be part of a prepared batch.
+ *
+ * @requestField preparedBatchId | String        | ID to store the prepared batch under
+ * @requestField requests        | Array<Object> | Requests of the batch
+ * @requestField ?parameters     | Array<String> | Names of the batch variables which have to be supplied on every execution | No parameters
+ * @requestField ?haltOnFailure  | Boolean       | Whether to stop executing the batch once a request fails                  | false
+ *
+ * @requestType PrepareRequestBatch
+ * @complexity 3
+ * @rpcVersion -1
+ * @initialVersion 5.5.0
+ * @category general
+ * @api requests
+ */
+RequestResult RequestHandler::PrepareRequestBatch(const Request &request)
+{
+	RequestStatus::RequestStatus statusCode;
+	std::string comment;
+	if (!request.ValidateString("preparedBatchId", statusCode, comment) ||
+	    !request.ValidateArray("requests", statusCode, comment, true))
+		return RequestResult::Error(statusCode, comment);
+
+	if (!_session)
+		return RequestResult::Error(RequestStatus::RequestProcessingFailed,
+					    "Prepared request batches are only available to WebSocket clients.");
+
+	auto batch = std::make_shared<PreparedRequestBatch>();
+
+	batch->HaltOnFailure = false;
+	if (request.Contains("haltOnFailure")) {
+		if (!request.ValidateOptionalBoolean("haltOnFailure", statusCode, comment))
+			return RequestResult::Error(statusCode, comment);
+
+		batch->HaltOnFailure = request.RequestData["haltOnFailure"];
+	}
+
+	if (request.Contains("parameters")) {
+		if (!request.ValidateOptionalArray("parameters", statusCode, comment, true))
+			return RequestResult::Error(statusCode, comment);
+
+		for (auto &parameter : request.RequestData["parameters"]) {
+			if (!parameter.is_string())
+				return RequestResult::Error(RequestStatus::InvalidRequestFieldType,
+							    "The field `parameters` must only contain strings.");
+
+			batch->Parameters.push_back(parameter);
+		}
+	}
+
+	const json &requests = request.RequestData["requests"];
+	batch->Requests.reserve(requests.size());
+	for (size_t i = 0; i < requests.size(); i++) {
+		const json &requestJson = requests[i];
+		std::string commentPrefix = "Request at index " + std::to_string(i) + ": ";
+
+		if (!requestJson.is_object())
+			return RequestResult::Error(RequestStatus::InvalidRequestFieldType,
+						    commentPrefix + "The request is not an object.");
+
+		if (!requestJson.contains("requestType") || !requestJson["requestType"].is_string() ||
+		    requestJson["requestType"].get<std::string>().empty())
+			return RequestResult::Error(RequestStatus::MissingRequestType,
+						    commentPrefix + "The request's `requestType` is missing or empty.");
+
+		std::string requestType = requestJson["requestType"];
+		auto handler = _handlerMap.find(requestType);
+		if (handler == _handlerMap.end())
+			return RequestResult::Error(RequestStatus::UnknownRequestType,
+						    commentPrefix + "The request type is not valid.");
+
+		RequestMethodHandler method = handler->second.Handler;
+		if (method == &RequestHandler::Sleep || method == &RequestHandler::PrepareRequestBatch ||
+		    method == &RequestHandler::ExecutePreparedBatch || method == &RequestHandler::RemovePreparedBatch)
+			return RequestResult::Error(RequestStatus::InvalidRequestField,
+						    commentPrefix + "The request type cannot be part of a prepared batch.");
+
+		json requestData;
+		if (requestJson.contains("requestData") && !requestJson["requestData"].is_null()) {
+			if (!requestJson["requestData"].is_object())
+				return RequestResult::Error(RequestStatus::InvalidRequestFieldType,
+							    commentPrefix + "The request's `requestData` is not an object.");
+
+			requestData = requestJson["requestData"];
+		}
+
+		if (!ValidatePreparedRequestVariables(requestJson, "inputVariables", statusCode, comment) ||
+		    !ValidatePreparedRequestVariables(requestJson, "outputVariables", statusCode, comment))
+			return RequestResult::Error(statusCode, commentPrefix + comment);
+
+		json inputVariables = requestJson.contains("inputVariables") ? requestJson["inputVariables"] : json();
+		json outputVariables = requestJson.contains("outputVariables") ? requestJson["outputVariables"] : json();
+		json requestId = requestJson.contains("requestId") ? requestJson["requestId"] : json();
+
+		batch->Requests.push_back({&handler->second,
+					   RequestBatchRequest(requestType, std::move(requestData),
+							       RequestBatchExecutionType::SerialRealtime, std::move(inputVariables),
+							       std::move(outputVariables)),
+					   {{"requestType", requestType}, {"requestId", std::move(requestId)}}});
+	}
+
+	std::string preparedBatchId = request.RequestData["preparedBatchId"];
+
+	std::lock_guard<std::mutex> lock(_session->PreparedBatchesMutex);
+	auto &preparedBatches = _session->PreparedBatches;
+	if (preparedBatches.size() >= MaxPreparedBatches && !preparedBatches.count(preparedBatchId))
+		return RequestResult::Error(RequestStatus::ResourceCreationFailed,
+					    "The maximum number of prepared batches has been reached. Remove one first.");
+
+	preparedBatches[preparedBatchId] = batch;
+
+	return RequestResult::Success();
+}
+
+/**
+ * Executes a batch which was prepared with `PrepareRequestBatch`.
+ *
+ * The requests are executed one after another, like in a `SERIAL_REALTIME` request batch. Not available in `SERIAL_FRAME` request batches. Every parameter of the prepared batch has to be supplied, and is available to the requests as a batch variable.
+ *
+ * Each result has the same form as in a `RequestBatchResponse`. If the batch was prepared with `haltOnFailure`, there are no results for the requests after the first failed one.
+ *
+ * @requestField preparedBatchId | String | ID of the prepared batch
+ * @requestField ?parameters     | Object | Values of the parameters of the prepared batch | No parameters
+ *
+ * @responseField results | Array<Object> | Results of the requests, in request order
+ *
+ * @requestType ExecutePreparedBatch
+ * @complexity 3
+ * @rpcVersion -1
+ * @initialVersion 5.5.0
+ * @category general
+ * @api requests
+ */
+RequestResult RequestHandler::ExecutePreparedBatch(const Request &request)
+{
+	RequestStatus::RequestStatus statusCode;
+	std::string comment;
+	if (!request.ValidateString("preparedBatchId", statusCode, comment))
+		return RequestResult::Error(statusCode, comment);
+
+	bool hasParameters = request.Contains("parameters");
+	if (hasParameters && !request.ValidateOptionalObject("parameters", statusCode, comment, true))
+		return RequestResult::Error(statusCode, comment);
+
+	// The whole batch would run within a single tick of the graphics thread
+	if (request.ExecutionType == RequestBatchExecutionType::SerialFrame)
+		return RequestResult::Error(RequestStatus::UnsupportedRequestBatchExecutionType,
+					    "Prepared batches cannot be executed in `SerialFrame` batches.");
+
+	if (!_session)
+		return RequestResult::Error(RequestStatus::ResourceNotFound, "No prepared batch was found by that ID.");
+
+	std::string preparedBatchId = request.RequestData["preparedBatchId"];
+
+	std::shared_ptr<const PreparedRequestBatch> batch;
+	{
+		std::lock_guard<std::mutex> lock(_session->PreparedBatchesMutex);
+		auto it = _session->PreparedBatches.find(preparedBatchId);
+		if (it == _session->PreparedBatches.end())
+			return RequestResult::Error(RequestStatus::ResourceNotFound, "No prepared batch was found by that ID.");
+
+		batch = it->second;
+	}
+
+	json variables = json::object();
+	for (auto &parameter : batch->Parameters) {
+		if (!hasParameters || !request.RequestData["parameters"].contains(parameter))
+			return RequestResult::Error(RequestStatus::MissingRequestField,
+						    "Your `parameters` is missing the parameter `" + parameter + "`.");
+
+		variables[parameter] = request.RequestData["parameters"][parameter];
+	}
+
+	std::vector<RequestResult> results =
+		RequestBatchHandler::ProcessPreparedRequestBatch(_session, *batch, std::move(variables));
+
+	json responseData;
+	json &resultsJson = responseData["results"] = json::array();
+	for (size_t i = 0; i < results.size(); i++)
+		resultsJson.push_back(
+			RequestBatchHandler::ConstructRequestResult(std::move(results[i]), batch->Requests[i].RequestJson));
+
+	return RequestResult::Success(responseData);
+}
+
+/**
+ * Removes a batch which was prepared with `PrepareRequestBatch`.
+ *
+ * @requestField preparedBatchId | String | ID of the prepared batch
+ *
+ * @requestType RemovePreparedBatch
+ * @complexity 2
+ * @rpcVersion -1
+ * @initialVersion 5.5.0
+ * @category general
+ * @api requests
+ */
+RequestResult RequestHandler::RemovePreparedBatch(const Request &request)
+{
+	RequestStatus::RequestStatus statusCode;
+	std::string comment;
+	if (!request.ValidateString("preparedBatchId", statusCode, comment))
+		return RequestResult::Error(statusCode, comment);
+
+	if (!_session)
+		return RequestResult::Error(RequestStatus::ResourceNotFound, "No prepared batch was found by that ID.");
+
+	std::string preparedBatchId = request.RequestData["preparedBatchId"];
+
+	std::lock_guard<std::mutex> lock(_session->PreparedBatchesMutex);
+	if (!_session->PreparedBatches.erase(preparedBatchId))
+		return RequestResult::Error(RequestStatus::ResourceNotFound, "No prepared batch was found by that ID.");
+
+	return RequestResult::Success();
+}
+
+/**
+ * Cancels a request batch which was sent with a `schedule`, and is still waiting for its cue.
+ *
+ * The batch is answered with a `RequestBatchResponse` without results, whose `statistics` have `cancelled` set to `true`.
+ *
+ * @requestField requestId | String | `requestId` of the scheduled request batch
+ *
+ * @requestType CancelScheduledRequestBatch
+ * @complexity 2
+ * @rpcVersion -1
+ * @initialVersion 5.5.0
+ * @category general
+ * @api requests
+ */
+RequestResult RequestHandler::CancelScheduledRequestBatch(const Request &request)
+{
+	RequestStatus::RequestStatus statusCode;
+	std::string comment;
+	if (!request.ValidateString("requestId", statusCode, comment))
+		return RequestResult::Error(statusCode, comment);
+
+	if (!_session)
+		return RequestResult::Error(RequestStatus::RequestProcessingFailed,
+					    "Scheduled request batches are only available to WebSocket clients.");
+
+	auto webSocketServer = GetWebSocketServer();
+	if (!webSocketServer)
+		return RequestResult::Error(RequestStatus::RequestProcessingFailed,
+					    "Unable to cancel the request batch due to internal error.");
+
+	std::string requestId = request.RequestData["requestId"];
+	if (!RequestBatchHandler::CancelScheduledRequestBatch(webSocketServer->GetBatchScheduler(), _session, requestId))
+		return RequestResult::Error(RequestStatus::ResourceNotFound,
+					    "No scheduled request batch with that `requestId` is waiting for its cue.");
+
+	return RequestResult::Success();
+}
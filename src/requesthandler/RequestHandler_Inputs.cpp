@@ -18,13 +18,23 @@ with this program. If not, see <https://www.gnu.org/licenses/>
 */
 
 #include "RequestHandler.h"
+#include "../eventhandler/EventHandler.h"
 
 /**
  * Gets an array of all inputs in OBS.
  *
- * @requestField ?inputKind | String | Restrict the array to only inputs of the specified kind | All kinds included
+ * Supports pagination and streaming of the `inputs` array through the `cursor`, `limit`, `streamChunks` and `chunkSize` fields.
  *
- * @responseField inputs | Array<Object> | Array of inputs
+ * @requestField ?inputKind    | String        | Restrict the array to only inputs of the specified kind              | All kinds included
+ * @requestField ?fields       | Array<String> | Fields of each input to return, besides `inputName` and `inputUuid`  | All fields
+ * @requestField ?cursor       | String        | `nextCursor` of the previous page                                    | Start of the list
+ * @requestField ?limit        | Number        | Maximum number of inputs to return                                   | No limit
+ * @requestField ?streamChunks | Boolean       | Whether to send the inputs in `RequestResponse` parts of `chunkSize` | false
+ * @requestField ?chunkSize    | Number        | Number of inputs per streamed part                                   | 100
+ *
+ * @responseField inputs     | Array<Object> | Array of inputs. Not present if streamed
+ * @responseField nextCursor | String        | Cursor of the next page. `null` if this is the last page
+ * @responseField chunkCount | Number        | Number of streamed parts. Only present if streamed
  *
  * @requestType GetInputList
  * @complexity 2
@@ -35,28 +45,52 @@ with this program. If not, see <https://www.gnu.org/licenses/>
  */
 RequestResult RequestHandler::GetInputList(const Request &request)
 {
+	RequestStatus::RequestStatus statusCode;
+	std::string comment;
 	std::string inputKind;
 
 	if (request.Contains("inputKind")) {
-		RequestStatus::RequestStatus statusCode;
-		std::string comment;
 		if (!request.ValidateOptionalString("inputKind", statusCode, comment))
 			return RequestResult::Error(statusCode, comment);
 
 		inputKind = request.RequestData["inputKind"];
 	}
 
+	Utils::Obs::FieldSelector fields;
+	Utils::Obs::ListPager pager;
+	if (!(request.ValidateOptionalFieldSelector("fields", statusCode, comment, fields,
+						    Utils::Obs::SelectableFields::Input) &&
+	      ValidateListPager(request, "inputs", pager, statusCode, comment)))
+		return RequestResult::Error(statusCode, comment);
+
+	// Only the inputs of the page are built
+	std::vector<OBSSource> inputs = Utils::Obs::ArrayHelper::GetInputRefs(inputKind);
+	std::vector<std::string> keys;
+	keys.reserve(inputs.size());
+	for (auto &input : inputs)
+		keys.push_back(obs_source_get_uuid(input));
+
 	json responseData;
-	responseData["inputs"] = Utils::Obs::ArrayHelper::GetInputList(inputKind);
+	responseData["inputs"] = pager.Paginate(
+		keys, [&inputs, &fields](size_t index) { return Utils::Obs::ObjectHelper::GetInput(inputs[index], fields); });
+	AddListPageInfo(request, "inputs", pager, responseData);
 	return RequestResult::Success(responseData);
 }
 
 /**
  * Gets an array of all available input kinds in OBS.
  *
- * @requestField ?unversioned | Boolean | True == Return all kinds as unversioned, False == Return with version suffixes (if available) | false
+ * Supports pagination and streaming of the `inputKinds` array through the `cursor`, `limit`, `streamChunks` and `chunkSize` fields.
  *
- * @responseField inputKinds | Array<String> | Array of input kinds
+ * @requestField ?unversioned  | Boolean | True == Return all kinds as unversioned, False == Return with version suffixes (if available) | false
+ * @requestField ?cursor       | String  | `nextCursor` of the previous page                                                             | Start of the list
+ * @requestField ?limit        | Number  | Maximum number of input kinds to return                                                       | No limit
+ * @requestField ?streamChunks | Boolean | Whether to send the input kinds in `RequestResponse` parts of `chunkSize`                     | false
+ * @requestField ?chunkSize    | Number  | Number of input kinds per streamed part                                                       | 100
+ *
+ * @responseField inputKinds | Array<String> | Array of input kinds. Not present if streamed
+ * @responseField nextCursor | String        | Cursor of the next page. `null` if this is the last page
+ * @responseField chunkCount | Number        | Number of streamed parts. Only present if streamed
  *
  * @requestType GetInputKindList
  * @complexity 2
@@ -67,19 +101,24 @@ RequestResult RequestHandler::GetInputList(const Request &request)
  */
 RequestResult RequestHandler::GetInputKindList(const Request &request)
 {
+	RequestStatus::RequestStatus statusCode;
+	std::string comment;
 	bool unversioned = false;
 
 	if (request.Contains("unversioned")) {
-		RequestStatus::RequestStatus statusCode;
-		std::string comment;
 		if (!request.ValidateOptionalBoolean("unversioned", statusCode, comment))
 			return RequestResult::Error(statusCode, comment);
 
 		unversioned = request.RequestData["unversioned"];
 	}
 
+	Utils::Obs::ListPager pager;
+	if (!ValidateListPager(request, "inputKinds", pager, statusCode, comment))
+		return RequestResult::Error(statusCode, comment);
+
 	json responseData;
-	responseData["inputKinds"] = Utils::Obs::ArrayHelper::GetInputKindList(unversioned);
+	responseData["inputKinds"] = pager.Paginate(Utils::Obs::ArrayHelper::GetInputKindList(unversioned));
+	AddListPageInfo(request, "inputKinds", pager, responseData);
 	return RequestResult::Success(responseData);
 }
 
@@ -297,11 +336,16 @@ RequestResult RequestHandler::GetInputDefaultSettings(const Request &request)
  *
  * Note: Does not include defaults. To create the entire settings object, overlay `inputSettings` over the `defaultInputSettings` provided by `GetInputDefaultSettings`.
  *
- * @requestField ?inputName | String | Name of the input to get the settings of
- * @requestField ?inputUuid | String | UUID of the input to get the settings of
+ * If `ifVersionNot` matches the current `resourceVersion` of the input's settings, the request returns with the `NotModified` status and only `resourceVersion` is provided.
+ * The version changes whenever the settings of the input are updated, and whenever any source is renamed.
+ *
+ * @requestField ?inputName    | String | Name of the input to get the settings of
+ * @requestField ?inputUuid    | String | UUID of the input to get the settings of
+ * @requestField ?ifVersionNot | Number | `resourceVersion` of a previous response to compare against
  *
- * @responseField inputSettings | Object | Object of settings for the input
- * @responseField inputKind     | String | The kind of the input
+ * @responseField inputSettings   | Object | Object of settings for the input
+ * @responseField inputKind       | String | The kind of the input
+ * @responseField resourceVersion | Number | Version of the input's settings, incremented whenever they change
  *
  * @requestType GetInputSettings
  * @complexity 3
@@ -318,11 +362,20 @@ RequestResult RequestHandler::GetInputSettings(const Request &request)
 	if (!input)
 		return RequestResult::Error(statusCode, comment);
 
+	if (request.Contains("ifVersionNot") && !request.ValidateOptionalNumber("ifVersionNot", statusCode, comment, 0))
+		return RequestResult::Error(statusCode, comment);
+
+	// Read the version before the data, so that a concurrent change can only ever make the version look older
+	uint64_t resourceVersion = GetEventHandler()->GetResourceVersion(EventHandler::RESOURCE_INPUT_SETTINGS, input);
+	if (request.Contains("ifVersionNot") && request.RequestData["ifVersionNot"] == resourceVersion)
+		return RequestResult::NotModified(resourceVersion);
+
 	OBSDataAutoRelease inputSettings = obs_source_get_settings(input);
 
 	json responseData;
 	responseData["inputSettings"] = Utils::Json::ObsDataToJson(inputSettings);
 	responseData["inputKind"] = obs_source_get_id(input);
+	responseData["resourceVersion"] = resourceVersion;
 	return RequestResult::Success(responseData);
 }
 
@@ -408,6 +461,94 @@ RequestResult RequestHandler::GetInputMute(const Request &request)
 	return RequestResult::Success(responseData);
 }
 
+struct InputTarget {
+	OBSSource input;
+	Request request; // The entry of the target, to validate its value with
+};
+
+struct InputTargetLookup {
+	std::unordered_map<std::string, OBSSource> inputsByName;
+	std::unordered_map<std::string, OBSSource> inputsByUuid;
+};
+
+// Resolves the audio inputs of all entries of `inputs` with a single pass over the sources
+static bool ValidateInputTargets(const Request &request, std::vector<InputTarget> &targets,
+				 RequestStatus::RequestStatus &statusCode, std::string &comment)
+{
+	if (!request.ValidateArray("inputs", statusCode, comment))
+		return false;
+
+	InputTargetLookup lookup;
+	const json &entries = request.RequestData["inputs"];
+	for (size_t i = 0; i < entries.size(); i++) {
+		std::string commentPrefix = "Entry at index " + std::to_string(i) + ": ";
+		if (!entries[i].is_object()) {
+			statusCode = RequestStatus::InvalidRequestFieldType;
+			comment = commentPrefix + "The entry is not an object.";
+			return false;
+		}
+
+		Request r("", entries[i]);
+		if (r.Contains("inputName")) {
+			if (!r.ValidateString("inputName", statusCode, comment)) {
+				comment = commentPrefix + comment;
+				return false;
+			}
+			lookup.inputsByName.emplace(r.RequestData["inputName"].get<std::string>(), nullptr);
+		} else if (r.Contains("inputUuid")) {
+			if (!r.ValidateString("inputUuid", statusCode, comment)) {
+				comment = commentPrefix + comment;
+				return false;
+			}
+			lookup.inputsByUuid.emplace(r.RequestData["inputUuid"].get<std::string>(), nullptr);
+		} else {
+			statusCode = RequestStatus::MissingRequestField;
+			comment = commentPrefix +
+				  "The entry must contain at least one of the following fields: `inputName` or `inputUuid`.";
+			return false;
+		}
+		targets.push_back({nullptr, std::move(r)});
+	}
+
+	auto cb = [](void *param, obs_source_t *source) {
+		auto lookup = static_cast<InputTargetLookup *>(param);
+
+		auto byName = lookup->inputsByName.find(obs_source_get_name(source));
+		if (byName != lookup->inputsByName.end())
+			byName->second = source;
+
+		auto byUuid = lookup->inputsByUuid.find(obs_source_get_uuid(source));
+		if (byUuid != lookup->inputsByUuid.end())
+			byUuid->second = source;
+
+		return true;
+	};
+	obs_enum_sources(cb, &lookup);
+
+	for (size_t i = 0; i < targets.size(); i++) {
+		std::string commentPrefix = "Entry at index " + std::to_string(i) + ": ";
+		const json &entry = targets[i].request.RequestData;
+		if (entry.contains("inputName"))
+			targets[i].input = lookup.inputsByName[entry["inputName"].get<std::string>()];
+		else
+			targets[i].input = lookup.inputsByUuid[entry["inputUuid"].get<std::string>()];
+
+		if (!targets[i].input) {
+			statusCode = RequestStatus::ResourceNotFound;
+			comment = commentPrefix + "No input was found by the specified name or UUID.";
+			return false;
+		}
+
+		if (!(obs_source_get_output_flags(targets[i].input) & OBS_SOURCE_AUDIO)) {
+			statusCode = RequestStatus::InvalidResourceState;
+			comment = commentPrefix + "The specified input does not support audio.";
+			return false;
+		}
+	}
+
+	return true;
+}
+
 /**
  * Sets the audio mute state of an input.
  *
@@ -438,6 +579,39 @@ RequestResult RequestHandler::SetInputMute(const Request &request)
 	return RequestResult::Success();
 }
 
+/**
+ * Sets the audio mute state of multiple inputs at once.
+ *
+ * All inputs are resolved in a single pass, and every entry is validated before any input is changed.
+ *
+ * @requestField inputs | Array<Object> | Entries containing `inputName` or `inputUuid`, and `inputMuted`
+ *
+ * @requestType SetInputsMute
+ * @complexity 3
+ * @rpcVersion -1
+ * @initialVersion 5.5.0
+ * @api requests
+ * @category inputs
+ */
+RequestResult RequestHandler::SetInputsMute(const Request &request)
+{
+	RequestStatus::RequestStatus statusCode;
+	std::string comment;
+	std::vector<InputTarget> targets;
+	if (!ValidateInputTargets(request, targets, statusCode, comment))
+		return RequestResult::Error(statusCode, comment);
+
+	for (size_t i = 0; i < targets.size(); i++) {
+		if (!targets[i].request.ValidateBoolean("inputMuted", statusCode, comment))
+			return RequestResult::Error(statusCode, "Entry at index " + std::to_string(i) + ": " + comment);
+	}
+
+	for (auto &target : targets)
+		obs_source_set_muted(target.input, target.request.RequestData["inputMuted"]);
+
+	return RequestResult::Success();
+}
+
 /**
  * Toggles the audio mute state of an input.
  *
@@ -561,6 +735,62 @@ RequestResult RequestHandler::SetInputVolume(const Request &request)
 	return RequestResult::Success();
 }
 
+/**
+ * Sets the volume setting of multiple inputs at once.
+ *
+ * All inputs are resolved in a single pass, and every entry is validated before any input is changed.
+ *
+ * @requestField inputs | Array<Object> | Entries containing `inputName` or `inputUuid`, and either `inputVolumeMul` or `inputVolumeDb`
+ *
+ * @requestType SetInputsVolume
+ * @complexity 3
+ * @rpcVersion -1
+ * @initialVersion 5.5.0
+ * @api requests
+ * @category inputs
+ */
+RequestResult RequestHandler::SetInputsVolume(const Request &request)
+{
+	RequestStatus::RequestStatus statusCode;
+	std::string comment;
+	std::vector<InputTarget> targets;
+	if (!ValidateInputTargets(request, targets, statusCode, comment))
+		return RequestResult::Error(statusCode, comment);
+
+	std::vector<float> inputVolumes;
+	inputVolumes.reserve(targets.size());
+	for (size_t i = 0; i < targets.size(); i++) {
+		const Request &r = targets[i].request;
+		std::string commentPrefix = "Entry at index " + std::to_string(i) + ": ";
+
+		bool hasMul = r.Contains("inputVolumeMul");
+		if (hasMul && !r.ValidateOptionalNumber("inputVolumeMul", statusCode, comment, 0, 20))
+			return RequestResult::Error(statusCode, commentPrefix + comment);
+
+		bool hasDb = r.Contains("inputVolumeDb");
+		if (hasDb && !r.ValidateOptionalNumber("inputVolumeDb", statusCode, comment, -100, 26))
+			return RequestResult::Error(statusCode, commentPrefix + comment);
+
+		if (hasMul && hasDb)
+			return RequestResult::Error(RequestStatus::TooManyRequestFields,
+						    commentPrefix + "You may only specify one volume field.");
+
+		if (!hasMul && !hasDb)
+			return RequestResult::Error(RequestStatus::MissingRequestField,
+						    commentPrefix + "You must specify one volume field.");
+
+		if (hasMul)
+			inputVolumes.push_back(r.RequestData["inputVolumeMul"]);
+		else
+			inputVolumes.push_back(obs_db_to_mul(r.RequestData["inputVolumeDb"]));
+	}
+
+	for (size_t i = 0; i < targets.size(); i++)
+		obs_source_set_volume(targets[i].input, inputVolumes[i]);
+
+	return RequestResult::Success();
+}
+
 /**
  * Gets the audio balance of an input.
  *
@@ -624,6 +854,39 @@ RequestResult RequestHandler::SetInputAudioBalance(const Request &request)
 	return RequestResult::Success();
 }
 
+/**
+ * Sets the audio balance of multiple inputs at once.
+ *
+ * All inputs are resolved in a single pass, and every entry is validated before any input is changed.
+ *
+ * @requestField inputs | Array<Object> | Entries containing `inputName` or `inputUuid`, and `inputAudioBalance`
+ *
+ * @requestType SetInputsAudioBalance
+ * @complexity 3
+ * @rpcVersion -1
+ * @initialVersion 5.5.0
+ * @api requests
+ * @category inputs
+ */
+RequestResult RequestHandler::SetInputsAudioBalance(const Request &request)
+{
+	RequestStatus::RequestStatus statusCode;
+	std::string comment;
+	std::vector<InputTarget> targets;
+	if (!ValidateInputTargets(request, targets, statusCode, comment))
+		return RequestResult::Error(statusCode, comment);
+
+	for (size_t i = 0; i < targets.size(); i++) {
+		if (!targets[i].request.ValidateNumber("inputAudioBalance", statusCode, comment, 0.0, 1.0))
+			return RequestResult::Error(statusCode, "Entry at index " + std::to_string(i) + ": " + comment);
+	}
+
+	for (auto &target : targets)
+		obs_source_set_balance_value(target.input, target.request.RequestData["inputAudioBalance"]);
+
+	return RequestResult::Success();
+}
+
 /**
  * Gets the audio sync offset of an input.
  *
@@ -279,6 +279,8 @@ RequestResult RequestHandler::GetLastReplayBufferReplay(const Request &)
 /**
  * Gets the list of available outputs.
  * 
+ * @requestField ?fields | Array<String> | Fields of each output to return, besides `outputName` | All fields
+ *
  * @responseField outputs | Array<Object> | Array of outputs
  *
  * @requestType GetOutputList
@@ -288,10 +290,17 @@ RequestResult RequestHandler::GetLastReplayBufferReplay(const Request &)
  * @api requests
  * @category outputs
  */
-RequestResult RequestHandler::GetOutputList(const Request &)
+RequestResult RequestHandler::GetOutputList(const Request &request)
 {
+	RequestStatus::RequestStatus statusCode;
+	std::string comment;
+	Utils::Obs::FieldSelector fields;
+	if (!request.ValidateOptionalFieldSelector("fields", statusCode, comment, fields,
+						   Utils::Obs::SelectableFields::Output))
+		return RequestResult::Error(statusCode, comment);
+
 	json responseData;
-	responseData["outputs"] = Utils::Obs::ArrayHelper::GetOutputList();
+	responseData["outputs"] = Utils::Obs::ArrayHelper::GetOutputList(fields);
 	return RequestResult::Success(responseData);
 }
 
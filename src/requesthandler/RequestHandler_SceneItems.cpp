@@ -17,17 +17,34 @@ You should have received a copy of the GNU General Public License along
 with this program. If not, see <https://www.gnu.org/licenses/>
 */
 
+#include <optional>
+
 #include "RequestHandler.h"
+#include "../eventhandler/EventHandler.h"
 
 /**
  * Gets a list of all scene items in a scene.
  *
  * Scenes only
  *
- * @requestField ?sceneName | String | Name of the scene to get the items of
- * @requestField ?sceneUuid | String | UUID of the scene to get the items of
+ * If `ifVersionNot` matches the current `resourceVersion` of the scene's item list, the request returns with the `NotModified` status and only `resourceVersion` is provided.
+ * The version changes whenever a scene item is added, removed, reordered, shown or hidden, locked or unlocked, transformed, or has its blend mode changed, and whenever any source is renamed.
+ *
+ * Supports pagination and streaming of the `sceneItems` array through the `cursor`, `limit`, `streamChunks` and `chunkSize` fields.
  *
- * @responseField sceneItems | Array<Object> | Array of scene items in the scene
+ * @requestField ?sceneName    | String        | Name of the scene to get the items of
+ * @requestField ?sceneUuid    | String        | UUID of the scene to get the items of
+ * @requestField ?ifVersionNot | Number        | `resourceVersion` of a previous response to compare against
+ * @requestField ?fields       | Array<String> | Fields of each scene item to return, besides `sceneItemId`, `sourceName` and `sourceUuid` | All fields
+ * @requestField ?cursor       | String        | `nextCursor` of the previous page                                                         | Start of the list
+ * @requestField ?limit        | Number        | Maximum number of scene items to return                                                   | No limit
+ * @requestField ?streamChunks | Boolean       | Whether to send the scene items in `RequestResponse` parts of `chunkSize`                 | false
+ * @requestField ?chunkSize    | Number        | Number of scene items per streamed part                                                   | 100
+ *
+ * @responseField sceneItems      | Array<Object> | Array of scene items in the scene. Not present if streamed
+ * @responseField resourceVersion | Number        | Version of the scene's item list, incremented whenever it changes
+ * @responseField nextCursor      | String        | Cursor of the next page. `null` if this is the last page
+ * @responseField chunkCount      | Number        | Number of streamed parts. Only present if streamed
  *
  * @requestType GetSceneItemList
  * @complexity 3
@@ -40,12 +57,37 @@ RequestResult RequestHandler::GetSceneItemList(const Request &request)
 {
 	RequestStatus::RequestStatus statusCode;
 	std::string comment;
+	Utils::Obs::FieldSelector fields;
 	OBSSourceAutoRelease scene = request.ValidateScene(statusCode, comment);
-	if (!scene)
+	if (!(scene && request.ValidateOptionalFieldSelector("fields", statusCode, comment, fields,
+							     Utils::Obs::SelectableFields::SceneItem)))
+		return RequestResult::Error(statusCode, comment);
+
+	if (request.Contains("ifVersionNot") && !request.ValidateOptionalNumber("ifVersionNot", statusCode, comment, 0))
+		return RequestResult::Error(statusCode, comment);
+
+	Utils::Obs::ListPager pager;
+	if (!ValidateListPager(request, "sceneItems", pager, statusCode, comment))
 		return RequestResult::Error(statusCode, comment);
 
+	GetEventHandler()->CheckSceneItemBlendModes(obs_scene_from_source(scene));
+	uint64_t resourceVersion = GetEventHandler()->GetResourceVersion(EventHandler::RESOURCE_SCENE_ITEM_LIST, scene);
+	if (request.Contains("ifVersionNot") && request.RequestData["ifVersionNot"] == resourceVersion)
+		return RequestResult::NotModified(resourceVersion);
+
+	// Only the scene items of the page are built
+	std::vector<OBSSceneItem> sceneItems = Utils::Obs::ArrayHelper::GetSceneItemRefs(obs_scene_from_source(scene));
+	std::vector<std::string> keys;
+	keys.reserve(sceneItems.size());
+	for (auto &sceneItem : sceneItems)
+		keys.push_back(std::to_string(obs_sceneitem_get_id(sceneItem)));
+
 	json responseData;
-	responseData["sceneItems"] = Utils::Obs::ArrayHelper::GetSceneItemList(obs_scene_from_source(scene));
+	responseData["sceneItems"] = pager.Paginate(keys, [&sceneItems, &fields](size_t index) {
+		return Utils::Obs::ObjectHelper::GetSceneItem(sceneItems[index], index, false, fields);
+	});
+	responseData["resourceVersion"] = resourceVersion;
+	AddListPageInfo(request, "sceneItems", pager, responseData);
 
 	return RequestResult::Success(responseData);
 }
@@ -57,8 +99,9 @@ RequestResult RequestHandler::GetSceneItemList(const Request &request)
  *
  * Groups only
  *
- * @requestField ?sceneName | String | Name of the group to get the items of
- * @requestField ?sceneUuid | String | UUID of the group to get the items of
+ * @requestField ?sceneName | String        | Name of the group to get the items of
+ * @requestField ?sceneUuid | String        | UUID of the group to get the items of
+ * @requestField ?fields    | Array<String> | Fields of each scene item to return, besides `sceneItemId`, `sourceName` and `sourceUuid` | All fields
  *
  * @responseField sceneItems | Array<Object> | Array of scene items in the group
  *
@@ -73,12 +116,14 @@ RequestResult RequestHandler::GetGroupSceneItemList(const Request &request)
 {
 	RequestStatus::RequestStatus statusCode;
 	std::string comment;
+	Utils::Obs::FieldSelector fields;
 	OBSSourceAutoRelease scene = request.ValidateScene(statusCode, comment, OBS_WEBSOCKET_SCENE_FILTER_GROUP_ONLY);
-	if (!scene)
+	if (!(scene && request.ValidateOptionalFieldSelector("fields", statusCode, comment, fields,
+							     Utils::Obs::SelectableFields::SceneItem)))
 		return RequestResult::Error(statusCode, comment);
 
 	json responseData;
-	responseData["sceneItems"] = Utils::Obs::ArrayHelper::GetSceneItemList(obs_group_from_source(scene));
+	responseData["sceneItems"] = Utils::Obs::ArrayHelper::GetSceneItemList(obs_group_from_source(scene), false, fields);
 
 	return RequestResult::Success(responseData);
 }
@@ -358,39 +403,38 @@ RequestResult RequestHandler::GetSceneItemTransform(const Request &request)
 	return RequestResult::Success(responseData);
 }
 
-/**
- * Sets the transform and crop info of a scene item.
- *
- * @requestField ?sceneName         | String | Name of the scene the item is in
- * @requestField ?sceneUuid         | String | UUID of the scene the item is in
- * @requestField sceneItemId        | Number | Numeric ID of the scene item | >= 0
- * @requestField sceneItemTransform | Object | Object containing scene item transform info to update
- *
- * @requestType SetSceneItemTransform
- * @complexity 3
- * @rpcVersion -1
- * @initialVersion 5.0.0
- * @api requests
- * @category scene items
- */
-RequestResult RequestHandler::SetSceneItemTransform(const Request &request)
-{
-	RequestStatus::RequestStatus statusCode;
-	std::string comment;
-	OBSSceneItemAutoRelease sceneItem =
-		request.ValidateSceneItem(statusCode, comment, OBS_WEBSOCKET_SCENE_FILTER_SCENE_OR_GROUP);
-	if (!(sceneItem && request.ValidateObject("sceneItemTransform", statusCode, comment)))
-		return RequestResult::Error(statusCode, comment);
+// Validated fields of a transform object. Only the fields which were provided are changed when it is applied.
+struct SceneItemTransformChange {
+	std::optional<float> positionX;
+	std::optional<float> positionY;
+	std::optional<float> rotation;
+	std::optional<float> scaleX;
+	std::optional<float> scaleY;
+	std::optional<uint32_t> alignment;
+	std::optional<obs_bounds_type> boundsType;
+	std::optional<uint32_t> boundsAlignment;
+	std::optional<float> boundsWidth;
+	std::optional<float> boundsHeight;
+	std::optional<int> cropLeft;
+	std::optional<int> cropRight;
+	std::optional<int> cropTop;
+	std::optional<int> cropBottom;
+	std::optional<bool> cropToBounds;
+
+	inline bool ChangesTransform() const
+	{
+		return positionX || positionY || rotation || scaleX || scaleY || alignment || boundsType || boundsAlignment ||
+		       boundsWidth || boundsHeight || cropToBounds;
+	}
+	inline bool ChangesCrop() const { return cropLeft || cropRight || cropTop || cropBottom; }
+};
 
+// Validates `transformJson` into `change`. Shared by all requests which change transforms.
+static bool ParseSceneItemTransform(obs_sceneitem_t *sceneItem, const json &transformJson, SceneItemTransformChange &change,
+				    RequestStatus::RequestStatus &statusCode, std::string &comment)
+{
 	// Create a fake request to use checks on the sub object
-	Request r("", request.RequestData["sceneItemTransform"]);
-
-	bool transformChanged = false;
-	bool cropChanged = false;
-	obs_transform_info sceneItemTransform;
-	obs_sceneitem_crop sceneItemCrop;
-	obs_sceneitem_get_info2(sceneItem, &sceneItemTransform);
-	obs_sceneitem_get_crop(sceneItem, &sceneItemCrop);
+	Request r("", transformJson);
 
 	OBSSource source = obs_sceneitem_get_source(sceneItem);
 	float sourceWidth = float(obs_source_get_width(source));
@@ -398,129 +442,492 @@ RequestResult RequestHandler::SetSceneItemTransform(const Request &request)
 
 	if (r.Contains("positionX")) {
 		if (!r.ValidateOptionalNumber("positionX", statusCode, comment, -90001.0, 90001.0))
-			return RequestResult::Error(statusCode, comment);
-		sceneItemTransform.pos.x = r.RequestData["positionX"];
-		transformChanged = true;
+			return false;
+		change.positionX = r.RequestData["positionX"];
 	}
 	if (r.Contains("positionY")) {
 		if (!r.ValidateOptionalNumber("positionY", statusCode, comment, -90001.0, 90001.0))
-			return RequestResult::Error(statusCode, comment);
-		sceneItemTransform.pos.y = r.RequestData["positionY"];
-		transformChanged = true;
+			return false;
+		change.positionY = r.RequestData["positionY"];
 	}
 
 	if (r.Contains("rotation")) {
 		if (!r.ValidateOptionalNumber("rotation", statusCode, comment, -360.0, 360.0))
-			return RequestResult::Error(statusCode, comment);
-		sceneItemTransform.rot = r.RequestData["rotation"];
-		transformChanged = true;
+			return false;
+		change.rotation = r.RequestData["rotation"];
 	}
 
 	if (r.Contains("scaleX")) {
 		if (!r.ValidateOptionalNumber("scaleX", statusCode, comment))
-			return RequestResult::Error(statusCode, comment);
+			return false;
 		float scaleX = r.RequestData["scaleX"];
 		float finalWidth = scaleX * sourceWidth;
-		if (!(finalWidth > -90001.0 && finalWidth < 90001.0))
-			return RequestResult::Error(RequestStatus::RequestFieldOutOfRange,
-						    "The field `scaleX` is too small or large for the current source resolution.");
-		sceneItemTransform.scale.x = scaleX;
-		transformChanged = true;
+		if (!(finalWidth > -90001.0 && finalWidth < 90001.0)) {
+			statusCode = RequestStatus::RequestFieldOutOfRange;
+			comment = "The field `scaleX` is too small or large for the current source resolution.";
+			return false;
+		}
+		change.scaleX = scaleX;
 	}
 	if (r.Contains("scaleY")) {
 		if (!r.ValidateOptionalNumber("scaleY", statusCode, comment, -90001.0, 90001.0))
-			return RequestResult::Error(statusCode, comment);
+			return false;
 		float scaleY = r.RequestData["scaleY"];
 		float finalHeight = scaleY * sourceHeight;
-		if (!(finalHeight > -90001.0 && finalHeight < 90001.0))
-			return RequestResult::Error(RequestStatus::RequestFieldOutOfRange,
-						    "The field `scaleY` is too small or large for the current source resolution.");
-		sceneItemTransform.scale.y = scaleY;
-		transformChanged = true;
+		if (!(finalHeight > -90001.0 && finalHeight < 90001.0)) {
+			statusCode = RequestStatus::RequestFieldOutOfRange;
+			comment = "The field `scaleY` is too small or large for the current source resolution.";
+			return false;
+		}
+		change.scaleY = scaleY;
 	}
 
 	if (r.Contains("alignment")) {
 		if (!r.ValidateOptionalNumber("alignment", statusCode, comment, 0, std::numeric_limits<uint32_t>::max()))
-			return RequestResult::Error(statusCode, comment);
-		sceneItemTransform.alignment = r.RequestData["alignment"];
-		transformChanged = true;
+			return false;
+		change.alignment = r.RequestData["alignment"];
 	}
 
 	if (r.Contains("boundsType")) {
 		if (!r.ValidateOptionalString("boundsType", statusCode, comment))
-			return RequestResult::Error(statusCode, comment);
+			return false;
 		enum obs_bounds_type boundsType = r.RequestData["boundsType"];
-		if (boundsType == OBS_BOUNDS_NONE && r.RequestData["boundsType"] != "OBS_BOUNDS_NONE")
-			return RequestResult::Error(RequestStatus::InvalidRequestField,
-						    "The field `boundsType` has an invalid value.");
-		sceneItemTransform.bounds_type = boundsType;
-		transformChanged = true;
+		if (boundsType == OBS_BOUNDS_NONE && r.RequestData["boundsType"] != "OBS_BOUNDS_NONE") {
+			statusCode = RequestStatus::InvalidRequestField;
+			comment = "The field `boundsType` has an invalid value.";
+			return false;
+		}
+		change.boundsType = boundsType;
 	}
 
 	if (r.Contains("boundsAlignment")) {
 		if (!r.ValidateOptionalNumber("boundsAlignment", statusCode, comment, 0, std::numeric_limits<uint32_t>::max()))
-			return RequestResult::Error(statusCode, comment);
-		sceneItemTransform.bounds_alignment = r.RequestData["boundsAlignment"];
-		transformChanged = true;
+			return false;
+		change.boundsAlignment = r.RequestData["boundsAlignment"];
 	}
 
 	if (r.Contains("boundsWidth")) {
 		if (!r.ValidateOptionalNumber("boundsWidth", statusCode, comment, 1.0, 90001.0))
-			return RequestResult::Error(statusCode, comment);
-		sceneItemTransform.bounds.x = r.RequestData["boundsWidth"];
-		transformChanged = true;
+			return false;
+		change.boundsWidth = r.RequestData["boundsWidth"];
 	}
 	if (r.Contains("boundsHeight")) {
 		if (!r.ValidateOptionalNumber("boundsHeight", statusCode, comment, 1.0, 90001.0))
-			return RequestResult::Error(statusCode, comment);
-		sceneItemTransform.bounds.y = r.RequestData["boundsHeight"];
-		transformChanged = true;
+			return false;
+		change.boundsHeight = r.RequestData["boundsHeight"];
 	}
 
 	if (r.Contains("cropLeft")) {
 		if (!r.ValidateOptionalNumber("cropLeft", statusCode, comment, 0.0, 100000.0))
-			return RequestResult::Error(statusCode, comment);
-		sceneItemCrop.left = r.RequestData["cropLeft"];
-		cropChanged = true;
+			return false;
+		change.cropLeft = r.RequestData["cropLeft"];
 	}
 	if (r.Contains("cropRight")) {
 		if (!r.ValidateOptionalNumber("cropRight", statusCode, comment, 0.0, 100000.0))
-			return RequestResult::Error(statusCode, comment);
-		sceneItemCrop.right = r.RequestData["cropRight"];
-		cropChanged = true;
+			return false;
+		change.cropRight = r.RequestData["cropRight"];
 	}
 	if (r.Contains("cropTop")) {
 		if (!r.ValidateOptionalNumber("cropTop", statusCode, comment, 0.0, 100000.0))
-			return RequestResult::Error(statusCode, comment);
-		sceneItemCrop.top = r.RequestData["cropTop"];
-		cropChanged = true;
+			return false;
+		change.cropTop = r.RequestData["cropTop"];
 	}
 	if (r.Contains("cropBottom")) {
 		if (!r.ValidateOptionalNumber("cropBottom", statusCode, comment, 0.0, 100000.0))
-			return RequestResult::Error(statusCode, comment);
-		sceneItemCrop.bottom = r.RequestData["cropBottom"];
-		cropChanged = true;
+			return false;
+		change.cropBottom = r.RequestData["cropBottom"];
 	}
 
 	if (r.Contains("cropToBounds")) {
 		if (!r.ValidateOptionalBoolean("cropToBounds", statusCode, comment))
-			return RequestResult::Error(statusCode, comment);
-		sceneItemTransform.crop_to_bounds = r.RequestData["cropToBounds"];
-		transformChanged = true;
+			return false;
+		change.cropToBounds = r.RequestData["cropToBounds"];
 	}
 
-	if (!transformChanged && !cropChanged)
-		return RequestResult::Error(RequestStatus::CannotAct, "You have not provided any valid transform changes.");
+	return true;
+}
+
+// Reads the current transform when it is applied, so that changes of earlier requests in the same atomic update are kept
+static void ApplySceneItemTransform(obs_sceneitem_t *sceneItem, const SceneItemTransformChange &change)
+{
+	if (change.ChangesTransform()) {
+		obs_transform_info sceneItemTransform;
+		obs_sceneitem_get_info2(sceneItem, &sceneItemTransform);
+
+		if (change.positionX)
+			sceneItemTransform.pos.x = *change.positionX;
+		if (change.positionY)
+			sceneItemTransform.pos.y = *change.positionY;
+		if (change.rotation)
+			sceneItemTransform.rot = *change.rotation;
+		if (change.scaleX)
+			sceneItemTransform.scale.x = *change.scaleX;
+		if (change.scaleY)
+			sceneItemTransform.scale.y = *change.scaleY;
+		if (change.alignment)
+			sceneItemTransform.alignment = *change.alignment;
+		if (change.boundsType)
+			sceneItemTransform.bounds_type = *change.boundsType;
+		if (change.boundsAlignment)
+			sceneItemTransform.bounds_alignment = *change.boundsAlignment;
+		if (change.boundsWidth)
+			sceneItemTransform.bounds.x = *change.boundsWidth;
+		if (change.boundsHeight)
+			sceneItemTransform.bounds.y = *change.boundsHeight;
+		if (change.cropToBounds)
+			sceneItemTransform.crop_to_bounds = *change.cropToBounds;
 
-	if (transformChanged)
 		obs_sceneitem_set_info2(sceneItem, &sceneItemTransform);
+	}
+
+	if (change.ChangesCrop()) {
+		obs_sceneitem_crop sceneItemCrop;
+		obs_sceneitem_get_crop(sceneItem, &sceneItemCrop);
+
+		if (change.cropLeft)
+			sceneItemCrop.left = *change.cropLeft;
+		if (change.cropRight)
+			sceneItemCrop.right = *change.cropRight;
+		if (change.cropTop)
+			sceneItemCrop.top = *change.cropTop;
+		if (change.cropBottom)
+			sceneItemCrop.bottom = *change.cropBottom;
 
-	if (cropChanged)
 		obs_sceneitem_set_crop(sceneItem, &sceneItemCrop);
+	}
+}
+
+// In `FrameAtomic` batches, the change is handed to the batch, which applies it within the same frame as the others
+static RequestResult ApplySceneItemChange(const Request &request, obs_sceneitem_t *sceneItem,
+					  std::function<void(obs_sceneitem_t *)> change)
+{
+	if (request.ExecutionType != RequestBatchExecutionType::FrameAtomic) {
+		change(sceneItem);
+		return RequestResult::Success();
+	}
+
+	OBSSceneItem item = sceneItem;
+	return RequestResult::SceneUpdate(obs_sceneitem_get_scene(sceneItem), [item, change]() { change(item); });
+}
+
+// Changes multiple items of a scene within a single atomic update, or hands the update to `FrameAtomic` batches
+static RequestResult ApplySceneUpdate(const Request &request, obs_scene_t *scene, std::function<void()> applyUpdate)
+{
+	if (request.ExecutionType == RequestBatchExecutionType::FrameAtomic)
+		return RequestResult::SceneUpdate(scene, std::move(applyUpdate));
+
+	auto cb = [](void *param, obs_scene_t *) {
+		(*static_cast<std::function<void()> *>(param))();
+	};
+	obs_scene_atomic_update(scene, cb, &applyUpdate);
 
 	return RequestResult::Success();
 }
 
+/**
+ * Sets the transform and crop info of a scene item.
+ *
+ * @requestField ?sceneName         | String | Name of the scene the item is in
+ * @requestField ?sceneUuid         | String | UUID of the scene the item is in
+ * @requestField sceneItemId        | Number | Numeric ID of the scene item | >= 0
+ * @requestField sceneItemTransform | Object | Object containing scene item transform info to update
+ *
+ * @requestType SetSceneItemTransform
+ * @complexity 3
+ * @rpcVersion -1
+ * @initialVersion 5.0.0
+ * @api requests
+ * @category scene items
+ */
+RequestResult RequestHandler::SetSceneItemTransform(const Request &request)
+{
+	RequestStatus::RequestStatus statusCode;
+	std::string comment;
+	OBSSceneItemAutoRelease sceneItem =
+		request.ValidateSceneItem(statusCode, comment, OBS_WEBSOCKET_SCENE_FILTER_SCENE_OR_GROUP);
+	if (!(sceneItem && request.ValidateObject("sceneItemTransform", statusCode, comment)))
+		return RequestResult::Error(statusCode, comment);
+
+	SceneItemTransformChange change;
+	if (!ParseSceneItemTransform(sceneItem, request.RequestData["sceneItemTransform"], change, statusCode, comment))
+		return RequestResult::Error(statusCode, comment);
+
+	if (!change.ChangesTransform() && !change.ChangesCrop())
+		return RequestResult::Error(RequestStatus::CannotAct, "You have not provided any valid transform changes.");
+
+	return ApplySceneItemChange(request, sceneItem,
+				    [change](obs_sceneitem_t *item) { ApplySceneItemTransform(item, change); });
+}
+
+// Layout of a compact transform: `[sceneItemId, positionX, positionY, rotation, scaleX, scaleY]`
+static constexpr size_t CompactTransformSize = 6;
+
+struct CompactSceneItemTransform {
+	OBSSceneItem sceneItem;
+	std::optional<float> values[CompactTransformSize - 1];
+};
+
+// Resolves all IDs of `sceneItemIds` with a single pass over the items of the scene. `fieldName` is the request field
+// which the IDs were taken from.
+static bool ValidateSceneItemIds(obs_scene_t *scene, const json &sceneItemIds, const std::string &fieldName,
+				 std::vector<OBSSceneItem> &sceneItems, RequestStatus::RequestStatus &statusCode,
+				 std::string &comment)
+{
+	std::unordered_map<int64_t, OBSSceneItem> sceneItemMap;
+	auto cb = [](obs_scene_t *, obs_sceneitem_t *sceneItem, void *param) {
+		auto sceneItemMap = static_cast<std::unordered_map<int64_t, OBSSceneItem> *>(param);
+		sceneItemMap->emplace(obs_sceneitem_get_id(sceneItem), sceneItem);
+		return true;
+	};
+	obs_scene_enum_items(scene, cb, &sceneItemMap);
+
+	sceneItems.reserve(sceneItemIds.size());
+	for (auto &sceneItemId : sceneItemIds) {
+		if (!sceneItemId.is_number_integer() || sceneItemId < 0) {
+			statusCode = RequestStatus::InvalidRequestField;
+			comment = "The field `" + fieldName + "` contains an invalid scene item ID.";
+			return false;
+		}
+
+		auto it = sceneItemMap.find(sceneItemId.get<int64_t>());
+		if (it == sceneItemMap.end()) {
+			std::string sceneName = obs_source_get_name(obs_scene_get_source(scene));
+			statusCode = RequestStatus::ResourceNotFound;
+			comment = std::string("No scene items were found in scene `") + sceneName + "` with the ID `" +
+				  sceneItemId.dump() + "`.";
+			return false;
+		}
+
+		sceneItems.push_back(it->second);
+	}
+
+	return true;
+}
+
+static bool ParseCompactSceneItemTransform(obs_sceneitem_t *sceneItem, const json &compactTransform,
+					   CompactSceneItemTransform &transform, RequestStatus::RequestStatus &statusCode,
+					   std::string &comment)
+{
+	// Valid ranges of the values, matching those of `SetSceneItemTransform`. Scales are checked against the final size.
+	static const std::pair<double, double> ranges[] = {
+		{-90001.0, 90001.0}, {-90001.0, 90001.0}, {-360.0, 360.0}, {-90001.0, 90001.0}, {-90001.0, 90001.0}};
+
+	OBSSource source = obs_sceneitem_get_source(sceneItem);
+	double sizes[] = {1.0, 1.0, 1.0, double(obs_source_get_width(source)), double(obs_source_get_height(source))};
+
+	transform.sceneItem = sceneItem;
+	for (size_t i = 1; i < CompactTransformSize; i++) {
+		const json &value = compactTransform[i];
+		// `null` leaves the value unchanged
+		if (value.is_null())
+			continue;
+
+		if (!value.is_number()) {
+			statusCode = RequestStatus::InvalidRequestFieldType;
+			comment = "Compact transforms must only contain numbers or `null`.";
+			return false;
+		}
+
+		double finalValue = value.get<double>() * sizes[i - 1];
+		if (finalValue < ranges[i - 1].first || finalValue > ranges[i - 1].second) {
+			statusCode = RequestStatus::RequestFieldOutOfRange;
+			comment = "The value at index " + std::to_string(i) + " of a compact transform is out of range.";
+			return false;
+		}
+
+		transform.values[i - 1] = value.get<float>();
+	}
+
+	return true;
+}
+
+// Reads the current transform when it is applied, so that only the values which were provided are changed
+static void ApplyCompactSceneItemTransform(const CompactSceneItemTransform &transform)
+{
+	obs_transform_info sceneItemTransform;
+	obs_sceneitem_get_info2(transform.sceneItem, &sceneItemTransform);
+
+	float *targets[] = {&sceneItemTransform.pos.x, &sceneItemTransform.pos.y, &sceneItemTransform.rot,
+			    &sceneItemTransform.scale.x, &sceneItemTransform.scale.y};
+	for (size_t i = 0; i < CompactTransformSize - 1; i++) {
+		if (transform.values[i])
+			*targets[i] = *transform.values[i];
+	}
+
+	obs_sceneitem_set_info2(transform.sceneItem, &sceneItemTransform);
+}
+
+/**
+ * Gets the transform and crop info of multiple scene items of a scene, in one pass.
+ *
+ * Scenes and Groups
+ *
+ * With `compact`, each transform is an array of `[sceneItemId, positionX, positionY, rotation, scaleX, scaleY]`, the same layout `SetSceneItemTransforms` accepts in `compactTransforms`.
+ *
+ * @requestField ?sceneName    | String        | Name of the scene the items are in
+ * @requestField ?sceneUuid    | String        | UUID of the scene the items are in
+ * @requestField ?sceneItemIds | Array<Number> | Numeric IDs of the scene items to get the transforms of | All scene items of the scene
+ * @requestField ?compact      | Boolean       | Whether to return the transforms as compact arrays     | false
+ *
+ * @responseField sceneItemTransforms | Array<Object> | Objects containing `sceneItemId` and `sceneItemTransform`, or compact transforms, in the order of `sceneItemIds`
+ *
+ * @requestType GetSceneItemTransforms
+ * @complexity 3
+ * @rpcVersion -1
+ * @initialVersion 5.5.0
+ * @api requests
+ * @category scene items
+ */
+RequestResult RequestHandler::GetSceneItemTransforms(const Request &request)
+{
+	RequestStatus::RequestStatus statusCode;
+	std::string comment;
+	OBSSceneAutoRelease scene = request.ValidateScene2(statusCode, comment, OBS_WEBSOCKET_SCENE_FILTER_SCENE_OR_GROUP);
+	if (!scene)
+		return RequestResult::Error(statusCode, comment);
+
+	bool compact = false;
+	if (request.Contains("compact")) {
+		if (!request.ValidateOptionalBoolean("compact", statusCode, comment))
+			return RequestResult::Error(statusCode, comment);
+
+		compact = request.RequestData["compact"];
+	}
+
+	std::vector<OBSSceneItem> sceneItems;
+	if (request.Contains("sceneItemIds")) {
+		if (!(request.ValidateOptionalArray("sceneItemIds", statusCode, comment, true) &&
+		      ValidateSceneItemIds(scene, request.RequestData["sceneItemIds"], "sceneItemIds", sceneItems, statusCode,
+					   comment)))
+			return RequestResult::Error(statusCode, comment);
+	} else {
+		auto cb = [](obs_scene_t *, obs_sceneitem_t *sceneItem, void *param) {
+			static_cast<std::vector<OBSSceneItem> *>(param)->emplace_back(sceneItem);
+			return true;
+		};
+		obs_scene_enum_items(scene, cb, &sceneItems);
+	}
+
+	json sceneItemTransforms = json::array();
+	for (auto &sceneItem : sceneItems) {
+		int64_t sceneItemId = obs_sceneitem_get_id(sceneItem);
+		if (compact) {
+			obs_transform_info osi;
+			obs_sceneitem_get_info2(sceneItem, &osi);
+			sceneItemTransforms.push_back({sceneItemId, osi.pos.x, osi.pos.y, osi.rot, osi.scale.x, osi.scale.y});
+		} else {
+			json sceneItemTransform = Utils::Obs::ObjectHelper::GetSceneItemTransform(sceneItem);
+			sceneItemTransforms.push_back({{"sceneItemId", sceneItemId}, {"sceneItemTransform", sceneItemTransform}});
+		}
+	}
+
+	json responseData;
+	responseData["sceneItemTransforms"] = sceneItemTransforms;
+
+	return RequestResult::Success(responseData);
+}
+
+/**
+ * Sets the transform and crop info of multiple scene items of a scene, in one pass.
+ *
+ * Scenes and Groups
+ *
+ * Either `sceneItemIds` and `sceneItemTransforms`, or `compactTransforms` must be provided. Each compact transform is an array of `[sceneItemId, positionX, positionY, rotation, scaleX, scaleY]`, where `null` leaves a value unchanged. Like with `SetSceneItemTransform`, every transform object has to change something.
+ *
+ * All transforms are validated before any of them are applied. They are then applied within a single atomic update of the scene.
+ *
+ * @requestField ?sceneName           | String               | Name of the scene the items are in
+ * @requestField ?sceneUuid           | String               | UUID of the scene the items are in
+ * @requestField ?sceneItemIds        | Array<Number>        | Numeric IDs of the scene items to update
+ * @requestField ?sceneItemTransforms | Array<Object>        | Partial transforms to apply, one for each item of `sceneItemIds`
+ * @requestField ?compactTransforms   | Array<Array<Number>> | Compact transforms to apply
+ *
+ * @requestType SetSceneItemTransforms
+ * @complexity 3
+ * @rpcVersion -1
+ * @initialVersion 5.5.0
+ * @api requests
+ * @category scene items
+ */
+RequestResult RequestHandler::SetSceneItemTransforms(const Request &request)
+{
+	RequestStatus::RequestStatus statusCode;
+	std::string comment;
+	OBSSceneAutoRelease scene = request.ValidateScene2(statusCode, comment, OBS_WEBSOCKET_SCENE_FILTER_SCENE_OR_GROUP);
+	if (!scene)
+		return RequestResult::Error(statusCode, comment);
+
+	std::function<void()> applyUpdate;
+	if (request.Contains("compactTransforms")) {
+		if (!request.ValidateOptionalArray("compactTransforms", statusCode, comment))
+			return RequestResult::Error(statusCode, comment);
+
+		const json &compactTransforms = request.RequestData["compactTransforms"];
+		json sceneItemIds = json::array();
+		for (auto &compactTransform : compactTransforms) {
+			if (!compactTransform.is_array() || compactTransform.size() != CompactTransformSize)
+				return RequestResult::Error(RequestStatus::InvalidRequestField,
+							    "The field `compactTransforms` must only contain arrays of " +
+								    std::to_string(CompactTransformSize) + " values.");
+
+			sceneItemIds.push_back(compactTransform[0]);
+		}
+
+		std::vector<OBSSceneItem> sceneItems;
+		if (!ValidateSceneItemIds(scene, sceneItemIds, "compactTransforms", sceneItems, statusCode, comment))
+			return RequestResult::Error(statusCode, comment);
+
+		std::vector<CompactSceneItemTransform> transforms(sceneItems.size());
+		for (size_t i = 0; i < sceneItems.size(); i++) {
+			if (!ParseCompactSceneItemTransform(sceneItems[i], compactTransforms[i], transforms[i], statusCode,
+							    comment))
+				return RequestResult::Error(statusCode, comment);
+		}
+
+		applyUpdate = [transforms = std::move(transforms)]() {
+			for (auto &transform : transforms)
+				ApplyCompactSceneItemTransform(transform);
+		};
+	} else {
+		if (!(request.ValidateArray("sceneItemIds", statusCode, comment) &&
+		      request.ValidateArray("sceneItemTransforms", statusCode, comment)))
+			return RequestResult::Error(statusCode, comment);
+
+		const json &sceneItemTransforms = request.RequestData["sceneItemTransforms"];
+		if (sceneItemTransforms.size() != request.RequestData["sceneItemIds"].size())
+			return RequestResult::Error(
+				RequestStatus::InvalidRequestField,
+				"The fields `sceneItemIds` and `sceneItemTransforms` must be of the same length.");
+
+		std::vector<OBSSceneItem> sceneItems;
+		if (!ValidateSceneItemIds(scene, request.RequestData["sceneItemIds"], "sceneItemIds", sceneItems, statusCode,
+					  comment))
+			return RequestResult::Error(statusCode, comment);
+
+		std::vector<SceneItemTransformChange> changes(sceneItems.size());
+		for (size_t i = 0; i < sceneItems.size(); i++) {
+			if (!sceneItemTransforms[i].is_object())
+				return RequestResult::Error(RequestStatus::InvalidRequestFieldType,
+							    "The field `sceneItemTransforms` must only contain objects.");
+
+			if (!ParseSceneItemTransform(sceneItems[i], sceneItemTransforms[i], changes[i], statusCode, comment))
+				return RequestResult::Error(statusCode, comment);
+
+			if (!changes[i].ChangesTransform() && !changes[i].ChangesCrop())
+				return RequestResult::Error(RequestStatus::CannotAct,
+							    "The transform at index " + std::to_string(i) +
+								    " does not contain any valid transform changes.");
+		}
+
+		applyUpdate = [sceneItems = std::move(sceneItems), changes = std::move(changes)]() {
+			for (size_t i = 0; i < sceneItems.size(); i++)
+				ApplySceneItemTransform(sceneItems[i], changes[i]);
+		};
+	}
+
+	return ApplySceneUpdate(request, scene, std::move(applyUpdate));
+}
+
 /**
  * Gets the enable state of a scene item.
  *
@@ -582,9 +989,60 @@ RequestResult RequestHandler::SetSceneItemEnabled(const Request &request)
 
 	bool sceneItemEnabled = request.RequestData["sceneItemEnabled"];
 
-	obs_sceneitem_set_visible(sceneItem, sceneItemEnabled);
+	return ApplySceneItemChange(request, sceneItem, [sceneItemEnabled](obs_sceneitem_t *item) {
+		obs_sceneitem_set_visible(item, sceneItemEnabled);
+	});
+}
 
-	return RequestResult::Success();
+/**
+ * Sets the enable state of multiple scene items of a scene at once.
+ *
+ * Scenes and Groups
+ *
+ * All scene items are resolved in a single pass, and every entry is validated before any item is changed. The items are then changed within a single atomic update of the scene.
+ *
+ * @requestField ?sceneName | String        | Name of the scene the items are in
+ * @requestField ?sceneUuid | String        | UUID of the scene the items are in
+ * @requestField sceneItems | Array<Object> | Entries containing `sceneItemId` and `sceneItemEnabled`
+ *
+ * @requestType SetSceneItemsEnabled
+ * @complexity 3
+ * @rpcVersion -1
+ * @initialVersion 5.5.0
+ * @api requests
+ * @category scene items
+ */
+RequestResult RequestHandler::SetSceneItemsEnabled(const Request &request)
+{
+	RequestStatus::RequestStatus statusCode;
+	std::string comment;
+	OBSSceneAutoRelease scene = request.ValidateScene2(statusCode, comment, OBS_WEBSOCKET_SCENE_FILTER_SCENE_OR_GROUP);
+	if (!(scene && request.ValidateArray("sceneItems", statusCode, comment)))
+		return RequestResult::Error(statusCode, comment);
+
+	json sceneItemIds = json::array();
+	std::vector<bool> sceneItemsEnabled;
+	for (auto &entry : request.RequestData["sceneItems"]) {
+		if (!(entry.is_object() && entry.contains("sceneItemId") && entry.contains("sceneItemEnabled") &&
+		      entry["sceneItemEnabled"].is_boolean()))
+			return RequestResult::Error(
+				RequestStatus::InvalidRequestField,
+				"The field `sceneItems` must only contain objects with `sceneItemId` and `sceneItemEnabled`.");
+
+		sceneItemIds.push_back(entry["sceneItemId"]);
+		sceneItemsEnabled.push_back(entry["sceneItemEnabled"]);
+	}
+
+	std::vector<OBSSceneItem> sceneItems;
+	if (!ValidateSceneItemIds(scene, sceneItemIds, "sceneItems", sceneItems, statusCode, comment))
+		return RequestResult::Error(statusCode, comment);
+
+	std::function<void()> applyUpdate = [sceneItems = std::move(sceneItems), sceneItemsEnabled]() {
+		for (size_t i = 0; i < sceneItems.size(); i++)
+			obs_sceneitem_set_visible(sceneItems[i], sceneItemsEnabled[i]);
+	};
+
+	return ApplySceneUpdate(request, scene, std::move(applyUpdate));
 }
 
 /**
@@ -648,9 +1106,9 @@ RequestResult RequestHandler::SetSceneItemLocked(const Request &request)
 
 	bool sceneItemLocked = request.RequestData["sceneItemLocked"];
 
-	obs_sceneitem_set_locked(sceneItem, sceneItemLocked);
-
-	return RequestResult::Success();
+	return ApplySceneItemChange(request, sceneItem, [sceneItemLocked](obs_sceneitem_t *item) {
+		obs_sceneitem_set_locked(item, sceneItemLocked);
+	});
 }
 
 /**
@@ -716,9 +1174,9 @@ RequestResult RequestHandler::SetSceneItemIndex(const Request &request)
 
 	int sceneItemIndex = request.RequestData["sceneItemIndex"];
 
-	obs_sceneitem_set_order_position(sceneItem, sceneItemIndex);
-
-	return RequestResult::Success();
+	return ApplySceneItemChange(request, sceneItem, [sceneItemIndex](obs_sceneitem_t *item) {
+		obs_sceneitem_set_order_position(item, sceneItemIndex);
+	});
 }
 
 /**
@@ -797,9 +1255,13 @@ RequestResult RequestHandler::SetSceneItemBlendMode(const Request &request)
 		return RequestResult::Error(RequestStatus::InvalidRequestField,
 					    "The field sceneItemBlendMode has an invalid value.");
 
-	obs_sceneitem_set_blending_mode(sceneItem, blendMode);
+	return ApplySceneItemChange(request, sceneItem, [blendMode](obs_sceneitem_t *item) {
+		obs_sceneitem_set_blending_mode(item, blendMode);
 
-	return RequestResult::Success();
+		// libobs does not emit a signal for blend mode changes
+		GetEventHandler()->BumpResourceVersion(EventHandler::RESOURCE_SCENE_ITEM_LIST,
+						       obs_scene_get_source(obs_sceneitem_get_scene(item)));
+	});
 }
 
 // Intentionally undocumented
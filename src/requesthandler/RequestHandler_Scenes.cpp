@@ -22,6 +22,8 @@ with this program. If not, see <https://www.gnu.org/licenses/>
 /**
  * Gets an array of all scenes in OBS.
  *
+ * @requestField ?fields | Array<String> | Fields of each scene to return, besides `sceneName` and `sceneUuid` | All fields
+ *
  * @responseField currentProgramSceneName | String        | Current program scene name. Can be `null` if internal state desync
  * @responseField currentProgramSceneUuid | String        | Current program scene UUID. Can be `null` if internal state desync
  * @responseField currentPreviewSceneName | String        | Current preview scene name. `null` if not in studio mode
@@ -35,8 +37,15 @@ with this program. If not, see <https://www.gnu.org/licenses/>
  * @api requests
  * @category scenes
  */
-RequestResult RequestHandler::GetSceneList(const Request &)
+RequestResult RequestHandler::GetSceneList(const Request &request)
 {
+	RequestStatus::RequestStatus statusCode;
+	std::string comment;
+	Utils::Obs::FieldSelector fields;
+	if (!request.ValidateOptionalFieldSelector("fields", statusCode, comment, fields,
+						   Utils::Obs::SelectableFields::Scene))
+		return RequestResult::Error(statusCode, comment);
+
 	json responseData;
 
 	OBSSourceAutoRelease currentProgramScene = obs_frontend_get_current_scene();
@@ -57,7 +66,7 @@ RequestResult RequestHandler::GetSceneList(const Request &)
 		responseData["currentPreviewSceneUuid"] = nullptr;
 	}
 
-	responseData["scenes"] = Utils::Obs::ArrayHelper::GetSceneList();
+	responseData["scenes"] = Utils::Obs::ArrayHelper::GetSceneList(fields);
 
 	return RequestResult::Success(responseData);
 }
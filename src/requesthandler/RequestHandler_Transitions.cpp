@@ -45,6 +45,8 @@ RequestResult RequestHandler::GetTransitionKindList(const Request &)
 /**
  * Gets an array of all scene transitions in OBS.
  *
+ * @requestField ?fields | Array<String> | Fields of each transition to return, besides `transitionName` and `transitionUuid` | All fields
+ *
  * @responseField currentSceneTransitionName | String         | Name of the current scene transition. Can be null
  * @responseField currentSceneTransitionUuid | String         | UUID of the current scene transition. Can be null
  * @responseField currentSceneTransitionKind | String         | Kind of the current scene transition. Can be null
@@ -57,8 +59,15 @@ RequestResult RequestHandler::GetTransitionKindList(const Request &)
  * @api requests
  * @category transitions
  */
-RequestResult RequestHandler::GetSceneTransitionList(const Request &)
+RequestResult RequestHandler::GetSceneTransitionList(const Request &request)
 {
+	RequestStatus::RequestStatus statusCode;
+	std::string comment;
+	Utils::Obs::FieldSelector fields;
+	if (!request.ValidateOptionalFieldSelector("fields", statusCode, comment, fields,
+						   Utils::Obs::SelectableFields::Transition))
+		return RequestResult::Error(statusCode, comment);
+
 	json responseData;
 
 	OBSSourceAutoRelease transition = obs_frontend_get_current_transition();
@@ -72,7 +81,7 @@ RequestResult RequestHandler::GetSceneTransitionList(const Request &)
 		responseData["currentSceneTransitionKind"] = nullptr;
 	}
 
-	responseData["transitions"] = Utils::Obs::ArrayHelper::GetSceneTransitionList();
+	responseData["transitions"] = Utils::Obs::ArrayHelper::GetSceneTransitionList(fields);
 
 	return RequestResult::Success(responseData);
 }
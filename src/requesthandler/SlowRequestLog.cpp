@@ -0,0 +1,153 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <QDateTime>
+
+#include "SlowRequestLog.h"
+#include "../obs-websocket.h"
+
+static const size_t MaxSlowRequestEntries = 100;
+
+struct SlowRequestEntry {
+	std::string requestType;
+	std::string remoteAddress;
+	uint64_t sessionConnectedAt;
+	size_t requestDataSize;
+	double queueTime;
+	double executionTime;
+	uint32_t laggedFrames;
+	RequestStatus::RequestStatus statusCode;
+	uint64_t timestamp;
+};
+
+// Thresholds are written under the mutex. Requests faster than `lowestThreshold` are skipped without taking it.
+static std::mutex slowRequestMutex;
+static std::atomic<double> defaultThreshold = 250.0;
+static std::atomic<double> lowestThreshold = 250.0;
+static std::unordered_map<std::string, double> thresholds;
+static std::deque<SlowRequestEntry> entries;
+
+static double ThresholdFor(const std::string &requestType)
+{
+	auto it = thresholds.find(requestType);
+	return it == thresholds.end() ? defaultThreshold.load() : it->second;
+}
+
+static void UpdateLowestThreshold()
+{
+	double lowest = defaultThreshold;
+	for (auto &threshold : thresholds)
+		lowest = std::min(lowest, threshold.second);
+
+	lowestThreshold = lowest;
+}
+
+void SlowRequestLog::Report(SessionPtr session, const Request &request, const RequestResult &result,
+			    const RequestTiming &timing)
+{
+	double queueTime = (timing.startedAt - timing.receivedAt) / 1000000.0;
+	double executionTime = (timing.finishedAt - timing.startedAt) / 1000000.0;
+
+	if (queueTime + executionTime < lowestThreshold.load(std::memory_order_relaxed))
+		return;
+
+	// Only requests slower than the lowest threshold look up their own threshold, which needs the mutex
+	std::unique_lock<std::mutex> lock(slowRequestMutex);
+	if (queueTime + executionTime < ThresholdFor(request.RequestType))
+		return;
+	lock.unlock();
+
+	SlowRequestEntry entry;
+	entry.requestType = request.RequestType;
+	entry.remoteAddress = session->RemoteAddress();
+	entry.sessionConnectedAt = session->ConnectedAt();
+	// Serializing again is only worth it for the rare slow request
+	entry.requestDataSize = request.HasRequestData ? request.RequestData.dump().size() : 0;
+	entry.queueTime = queueTime;
+	entry.executionTime = executionTime;
+	entry.laggedFrames = timing.laggedFrames;
+	entry.statusCode = result.StatusCode;
+	entry.timestamp = QDateTime::currentMSecsSinceEpoch();
+
+	blog(LOG_WARNING,
+	     "[SlowRequestLog::Report] Request `%s` from %s took %.1f ms "
+	     "(%.1f ms queued, %.1f ms executing, %zu bytes of request data, %u frames lagged).",
+	     entry.requestType.c_str(), entry.remoteAddress.c_str(), queueTime + executionTime, queueTime, executionTime,
+	     entry.requestDataSize, entry.laggedFrames);
+
+	lock.lock();
+	entries.push_back(std::move(entry));
+	if (entries.size() > MaxSlowRequestEntries)
+		entries.pop_front();
+}
+
+json SlowRequestLog::GetEntries()
+{
+	std::lock_guard<std::mutex> lock(slowRequestMutex);
+	json ret = json::array();
+	for (auto &entry : entries) {
+		json entryJson;
+		entryJson["requestType"] = entry.requestType;
+		entryJson["remoteAddress"] = entry.remoteAddress;
+		entryJson["sessionConnectedAt"] = entry.sessionConnectedAt;
+		entryJson["requestDataSize"] = entry.requestDataSize;
+		entryJson["queueTime"] = entry.queueTime;
+		entryJson["executionTime"] = entry.executionTime;
+		entryJson["laggedFrames"] = entry.laggedFrames;
+		entryJson["requestStatus"] = entry.statusCode;
+		entryJson["timestamp"] = entry.timestamp;
+		ret.push_back(entryJson);
+	}
+
+	return ret;
+}
+
+json SlowRequestLog::GetThresholds()
+{
+	std::lock_guard<std::mutex> lock(slowRequestMutex);
+	json ret;
+	ret["defaultThreshold"] = defaultThreshold.load();
+	ret["requestThresholds"] = json::object();
+	for (auto &threshold : thresholds)
+		ret["requestThresholds"][threshold.first] = threshold.second;
+
+	return ret;
+}
+
+void SlowRequestLog::SetDefaultThreshold(double threshold)
+{
+	std::lock_guard<std::mutex> lock(slowRequestMutex);
+	defaultThreshold = threshold;
+	UpdateLowestThreshold();
+}
+
+void SlowRequestLog::SetThresholds(const json &requestThresholds)
+{
+	std::lock_guard<std::mutex> lock(slowRequestMutex);
+	for (auto &[requestType, threshold] : requestThresholds.items()) {
+		if (threshold.is_null())
+			thresholds.erase(requestType);
+		else
+			thresholds[requestType] = threshold;
+	}
+	UpdateLowestThreshold();
+}
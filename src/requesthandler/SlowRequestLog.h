@@ -0,0 +1,40 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include "RequestHandler.h"
+
+// Keeps the most recent requests which took longer than the latency threshold of their request type, and logs them.
+namespace SlowRequestLog {
+	struct RequestTiming {
+		uint64_t receivedAt; // When the message containing the request was received
+		uint64_t startedAt;
+		uint64_t finishedAt;
+		uint32_t laggedFrames; // Frames the OBS render thread lagged while the request was executed
+	};
+
+	// Cheap unless the request exceeded its threshold
+	void Report(SessionPtr session, const Request &request, const RequestResult &result, const RequestTiming &timing);
+
+	json GetEntries();
+	json GetThresholds();
+	// Milliseconds. A threshold of `null` for a request type reverts it to the default threshold.
+	void SetDefaultThreshold(double threshold);
+	void SetThresholds(const json &thresholds);
+}
@@ -0,0 +1,42 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <vector>
+
+#include "RequestBatchRequest.h"
+#include "RequestResult.h"
+
+class RequestHandler;
+typedef RequestResult (RequestHandler::*RequestMethodHandler)(const Request &);
+struct RequestHandlerEntry;
+
+// A request of a prepared batch, with its handler already looked up
+struct PreparedRequest {
+	const RequestHandlerEntry *Entry; // Owned by the handler map
+	RequestBatchRequest BatchRequest;
+	json RequestJson; // `requestType` and `requestId` of the request, which its result is constructed from
+};
+
+// A request batch template which has been validated once by `PrepareRequestBatch`, and can be executed any number of times
+struct PreparedRequestBatch {
+	std::vector<PreparedRequest> Requests;
+	std::vector<std::string> Parameters; // Batch variables which have to be supplied on every execution
+	bool HaltOnFailure;
+};
@@ -38,6 +38,16 @@ Request::Request(const std::string &requestType, const json &requestData,
 {
 }
 
+// Takes over the request data instead of copying it
+Request::Request(const std::string &requestType, json &&requestData,
+		 const RequestBatchExecutionType::RequestBatchExecutionType executionType)
+	: RequestType(requestType),
+	  HasRequestData(requestData.is_object()),
+	  RequestData(requestData.is_object() ? std::move(requestData) : json::object()),
+	  ExecutionType(executionType)
+{
+}
+
 bool Request::Contains(const std::string &keyName) const
 {
 	return (RequestData.contains(keyName) && !RequestData[keyName].is_null());
@@ -211,6 +221,39 @@ bool Request::ValidateArray(const std::string &keyName, RequestStatus::RequestSt
 	return true;
 }
 
+// Leaves `fields` untouched (selecting every field) if the key is not present
+bool Request::ValidateOptionalFieldSelector(const std::string &keyName, RequestStatus::RequestStatus &statusCode,
+					    std::string &comment, Utils::Obs::FieldSelector &fields,
+					    const std::vector<std::string> &selectableFields) const
+{
+	if (!Contains(keyName))
+		return true;
+
+	// An empty array is valid, and selects only the identifying fields
+	if (!ValidateOptionalArray(keyName, statusCode, comment, true))
+		return false;
+
+	for (auto &field : RequestData[keyName]) {
+		if (!field.is_string()) {
+			statusCode = RequestStatus::InvalidRequestFieldType;
+			comment = std::string("The field value of `") + keyName + "` must only contain strings.";
+			return false;
+		}
+
+		// A misspelled field would otherwise silently be left out of every item
+		if (std::find(selectableFields.begin(), selectableFields.end(), field) == selectableFields.end()) {
+			statusCode = RequestStatus::InvalidRequestField;
+			comment = std::string("The field value of `") + keyName + "` contains `" + field.get<std::string>() +
+				  "`, which is not a selectable field.";
+			return false;
+		}
+	}
+
+	fields = Utils::Obs::FieldSelector(RequestData[keyName].get<std::vector<std::string>>());
+
+	return true;
+}
+
 obs_source_t *Request::ValidateSource(const std::string &nameKeyName, const std::string &uuidKeyName,
 				      RequestStatus::RequestStatus &statusCode, std::string &comment) const
 {
@@ -22,6 +22,7 @@ with this program. If not, see <https://www.gnu.org/licenses/>
 #include "../types/RequestStatus.h"
 #include "../types/RequestBatchExecutionType.h"
 #include "../../utils/Json.h"
+#include "../../utils/Obs.h"
 
 enum ObsWebSocketSceneFilter {
 	OBS_WEBSOCKET_SCENE_FILTER_SCENE_ONLY,
@@ -38,6 +39,8 @@ struct FilterPair {
 struct Request {
 	Request(const std::string &requestType, const json &requestData = nullptr,
 		const RequestBatchExecutionType::RequestBatchExecutionType executionType = RequestBatchExecutionType::None);
+	Request(const std::string &requestType, json &&requestData,
+		const RequestBatchExecutionType::RequestBatchExecutionType executionType = RequestBatchExecutionType::None);
 
 	// Contains the key and is not null
 	bool Contains(const std::string &keyName) const;
@@ -62,6 +65,9 @@ struct Request {
 				   const bool allowEmpty = false) const;
 	bool ValidateArray(const std::string &keyName, RequestStatus::RequestStatus &statusCode, std::string &comment,
 			   const bool allowEmpty = false) const;
+	bool ValidateOptionalFieldSelector(const std::string &keyName, RequestStatus::RequestStatus &statusCode,
+					   std::string &comment, Utils::Obs::FieldSelector &fields,
+					   const std::vector<std::string> &selectableFields) const;
 
 	// All return values have incremented refcounts
 	obs_source_t *ValidateSource(const std::string &nameKeyName, const std::string &uuidKeyName,
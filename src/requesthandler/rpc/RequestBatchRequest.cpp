@@ -18,11 +18,11 @@ with this program. If not, see <https://www.gnu.org/licenses/>
 
 #include "RequestBatchRequest.h"
 
-RequestBatchRequest::RequestBatchRequest(const std::string &requestType, const json &requestData,
-					 RequestBatchExecutionType::RequestBatchExecutionType executionType,
-					 const json &inputVariables, const json &outputVariables)
-	: Request(requestType, requestData, executionType),
-	  InputVariables(inputVariables),
-	  OutputVariables(outputVariables)
+RequestBatchRequest::RequestBatchRequest(const std::string &requestType, json requestData,
+					 RequestBatchExecutionType::RequestBatchExecutionType executionType, json inputVariables,
+					 json outputVariables)
+	: Request(requestType, std::move(requestData), executionType),
+	  InputVariables(std::move(inputVariables)),
+	  OutputVariables(std::move(outputVariables))
 {
 }
@@ -23,7 +23,8 @@ RequestResult::RequestResult(RequestStatus::RequestStatus statusCode, json respo
 	: StatusCode(statusCode),
 	  ResponseData(responseData),
 	  Comment(comment),
-	  SleepFrames(0)
+	  SleepFrames(0),
+	  SleepMillis(0)
 {
 }
 
@@ -32,7 +33,22 @@ RequestResult RequestResult::Success(json responseData)
 	return RequestResult(RequestStatus::Success, responseData, "");
 }
 
+RequestResult RequestResult::NotModified(uint64_t resourceVersion)
+{
+	json responseData;
+	responseData["resourceVersion"] = resourceVersion;
+	return RequestResult(RequestStatus::NotModified, responseData, "");
+}
+
 RequestResult RequestResult::Error(RequestStatus::RequestStatus statusCode, std::string comment)
 {
 	return RequestResult(statusCode, nullptr, comment);
 }
+
+RequestResult RequestResult::SceneUpdate(obs_scene_t *scene, std::function<void()> applyUpdate)
+{
+	RequestResult ret = RequestResult::Success();
+	ret.UpdateScene = scene;
+	ret.ApplyUpdate = std::move(applyUpdate);
+	return ret;
+}
@@ -19,6 +19,9 @@ with this program. If not, see <https://www.gnu.org/licenses/>
 
 #pragma once
 
+#include <functional>
+#include <obs.hpp>
+
 #include "../types/RequestStatus.h"
 #include "../../utils/Json.h"
 
@@ -26,9 +29,18 @@ struct RequestResult {
 	RequestResult(RequestStatus::RequestStatus statusCode = RequestStatus::Success, json responseData = nullptr,
 		      std::string comment = "");
 	static RequestResult Success(json responseData = nullptr);
+	static RequestResult NotModified(uint64_t resourceVersion);
 	static RequestResult Error(RequestStatus::RequestStatus statusCode, std::string comment = "");
+	static RequestResult SceneUpdate(obs_scene_t *scene, std::function<void()> applyUpdate);
 	RequestStatus::RequestStatus StatusCode;
 	json ResponseData;
 	std::string Comment;
 	size_t SleepFrames;
+	size_t SleepMillis;
+	// `FrameAtomic` batches only. The validated change of the request, applied by the batch inside of an atomic update
+	// of `UpdateScene`.
+	OBSScene UpdateScene;
+	std::function<void()> ApplyUpdate;
+
+	inline bool Succeeded() const { return StatusCode == RequestStatus::Success || StatusCode == RequestStatus::NotModified; }
 };
@@ -75,10 +75,43 @@ namespace RequestBatchExecutionType {
 		* @api enums
 		*/
 		Parallel = 2,
+		/**
+		* A request batch type which processes requests in parallel while respecting the data dependencies between them.
+		*
+		* A request depends on every earlier request which produces one of the variables in its `inputVariables`, and
+		* only runs once those have finished. Requests without a dependency between them may run in any order, but
+		* results are always returned in request order.
+		*
+		* @enumIdentifier Dataflow
+		* @enumValue 3
+		* @enumType RequestBatchExecutionType
+		* @rpcVersion -1
+		* @initialVersion 5.5.0
+		* @api enums
+		*/
+		Dataflow = 3,
+		/**
+		* A request batch type which applies the changes of all requests within a single rendered frame.
+		*
+		* All requests are validated up front, off of the graphics thread. Their changes are then applied in one
+		* graphics tick, inside of one atomic update per affected scene, so that no intermediate state is ever
+		* rendered. If a request fails, processing stops there and none of the changes are applied.
+		*
+		* Only `SetSceneItemTransform`, `SetSceneItemTransforms`, `SetSceneItemEnabled`, `SetSceneItemsEnabled`,
+		* `SetSceneItemLocked`, `SetSceneItemIndex` and `SetSceneItemBlendMode` are supported.
+		*
+		* @enumIdentifier FrameAtomic
+		* @enumValue 4
+		* @enumType RequestBatchExecutionType
+		* @rpcVersion -1
+		* @initialVersion 5.5.0
+		* @api enums
+		*/
+		FrameAtomic = 4,
 	};
 
 	inline bool IsValid(int8_t executionType)
 	{
-		return executionType >= None && executionType <= Parallel;
+		return executionType >= None && executionType <= FrameAtomic;
 	}
 }
@@ -56,6 +56,32 @@ namespace RequestStatus {
 		* @api enums
 		*/
 		Success = 100,
+		/**
+		* The request has succeeded, but the requested resource has not changed since the version given in `ifVersionNot`.
+		*
+		* Note: No response data other than `resourceVersion` is provided with this code.
+		*
+		* @enumIdentifier NotModified
+		* @enumValue 101
+		* @enumType RequestStatus
+		* @rpcVersion -1
+		* @initialVersion 5.5.0
+		* @api enums
+		*/
+		NotModified = 101,
+		/**
+		* The message is a streamed part of a response, and the request has not completed yet.
+		*
+		* Note: `result` is always `false` with this code. The result of the request is only reported by the final `RequestResponse`, which has no `responseChunk` field.
+		*
+		* @enumIdentifier ResponseChunk
+		* @enumValue 102
+		* @enumType RequestStatus
+		* @rpcVersion -1
+		* @initialVersion 5.5.0
+		* @api enums
+		*/
+		ResponseChunk = 102,
 
 		/**
 		* The `requestType` field is missing from the request data.
@@ -71,6 +71,20 @@ bool Utils::Crypto::CheckAuthenticationString(std::string secret, std::string ch
 	return (authenticationString == expectedAuthenticationString);
 }
 
+// Takes the same time wherever the first difference is, so that a guess cannot be refined byte by byte. Both sides are
+// hashed first, which also hides the length of the secret.
+bool Utils::Crypto::ConstantTimeEquals(const std::string &a, const std::string &b)
+{
+	QByteArray hashA = QCryptographicHash::hash(QByteArray(a.data(), (int)a.size()), QCryptographicHash::Algorithm::Sha256);
+	QByteArray hashB = QCryptographicHash::hash(QByteArray(b.data(), (int)b.size()), QCryptographicHash::Algorithm::Sha256);
+
+	unsigned char difference = 0;
+	for (int i = 0; i < hashA.size(); i++)
+		difference |= (unsigned char)(hashA[i] ^ hashB[i]);
+
+	return difference == 0;
+}
+
 std::string Utils::Crypto::GeneratePassword(size_t length)
 {
 	// Get OS random number generator
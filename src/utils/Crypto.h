@@ -27,6 +27,7 @@ namespace Utils {
 		std::string GenerateSalt();
 		std::string GenerateSecret(std::string password, std::string salt);
 		bool CheckAuthenticationString(std::string secret, std::string challenge, std::string authenticationString);
+		bool ConstantTimeEquals(const std::string &a, const std::string &b);
 		std::string GeneratePassword(size_t length = 16);
 	}
 }
@@ -0,0 +1,182 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <QDateTime>
+#include <QFile>
+
+#include "FlightRecorder.h"
+#include "Obs.h"
+#include "../obs-websocket.h"
+
+using namespace FlightRecorderFormat;
+
+static const auto StatsSampleInterval = std::chrono::seconds(5);
+
+std::atomic<bool> Utils::FlightRecorder::Detail::active = false;
+
+static std::unique_ptr<QFile> recorderFile;
+static uchar *ring = nullptr;
+static uint64_t ringSize = 0;
+static std::atomic<uint64_t> writeOffset = 0;
+static std::atomic<uint32_t> activeWriters = 0;
+
+static std::thread statsThread;
+static std::mutex statsMutex;
+static std::condition_variable statsCondition;
+static bool statsStopping = false;
+
+// Copies to a stream offset, wrapping around the end of the ring
+static void CopyToRing(uint64_t offset, const void *data, size_t size)
+{
+	size_t position = offset % ringSize;
+	size_t firstPart = std::min<uint64_t>(size, ringSize - position);
+	memcpy(ring + position, data, firstPart);
+	memcpy(ring, (const uint8_t *)data + firstPart, size - firstPart);
+}
+
+static void SampleStats()
+{
+	// The first sample is only taken after an interval, as the recorder is started while OBS is still loading
+	std::unique_lock<std::mutex> lock(statsMutex);
+	while (!statsCondition.wait_for(lock, StatsSampleInterval, [] { return statsStopping; })) {
+		lock.unlock();
+		Utils::FlightRecorder::Record(Stats, Utils::Obs::ObjectHelper::GetStats());
+		lock.lock();
+	}
+}
+
+bool Utils::FlightRecorder::Start(const std::string &filePath, uint64_t size)
+{
+	if (IsActive())
+		return false;
+
+	size = size / RecordAlignment * RecordAlignment;
+
+	QString path = QString::fromStdString(filePath);
+	if (QFile::exists(path)) {
+		QString previousPath = path + ".previous";
+		QFile::remove(previousPath);
+		if (!QFile::rename(path, previousPath)) {
+			blog(LOG_WARNING,
+			     "[Utils::FlightRecorder::Start] Unable to move the previous recording aside. Not recording.");
+			return false;
+		}
+	}
+
+	auto file = std::make_unique<QFile>(path);
+	if (!file->open(QIODevice::ReadWrite) || !file->resize(sizeof(FileHeader) + size)) {
+		blog(LOG_WARNING, "[Utils::FlightRecorder::Start] Unable to create the recording file: %s",
+		     file->errorString().toUtf8().constData());
+		return false;
+	}
+
+	// The new file is zero-filled, so it does not contain any valid records yet
+	uchar *map = file->map(0, sizeof(FileHeader) + size);
+	if (!map) {
+		blog(LOG_WARNING, "[Utils::FlightRecorder::Start] Unable to map the recording file: %s",
+		     file->errorString().toUtf8().constData());
+		return false;
+	}
+
+	FileHeader header = {};
+	memcpy(header.magic, FileMagic, sizeof(FileMagic));
+	header.version = FileVersion;
+	header.headerSize = sizeof(FileHeader);
+	header.ringSize = size;
+	header.createdAt = QDateTime::currentMSecsSinceEpoch();
+	memcpy(map, &header, sizeof(header));
+
+	recorderFile = std::move(file);
+	ring = map + sizeof(FileHeader);
+	ringSize = size;
+	writeOffset = 0;
+	statsStopping = false;
+	Detail::active = true;
+	statsThread = std::thread(SampleStats);
+
+	blog(LOG_INFO, "[Utils::FlightRecorder::Start] Recording to `%s` (%llu bytes).", filePath.c_str(),
+	     (unsigned long long)size);
+	return true;
+}
+
+void Utils::FlightRecorder::Stop()
+{
+	if (!IsActive())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(statsMutex);
+		statsStopping = true;
+	}
+	statsCondition.notify_all();
+	statsThread.join();
+
+	Detail::active = false;
+	// Writers which still saw the recorder as active finish copying before the ring is unmapped
+	while (activeWriters)
+		std::this_thread::yield();
+
+	recorderFile->unmap(ring - sizeof(FileHeader));
+	recorderFile->close();
+	recorderFile.reset();
+	ring = nullptr;
+
+	blog(LOG_INFO, "[Utils::FlightRecorder::Stop] Recording stopped.");
+}
+
+void Utils::FlightRecorder::Record(RecordType type, const json &data)
+{
+	// Serialized before reserving space, so `Stop()` never waits for it. The buffer is reused to save an allocation.
+	static thread_local std::vector<uint8_t> payload;
+	payload.clear();
+	json::to_msgpack(data, payload);
+	uint64_t recordSize = GetRecordSize(payload.size());
+
+	// Sequentially consistent with `Stop()`
+	activeWriters++;
+	if (!Detail::active || recordSize > ringSize / 4) {
+		activeWriters--;
+		return;
+	}
+
+	uint64_t offset = writeOffset.fetch_add(recordSize, std::memory_order_relaxed);
+
+	RecordHeader header = {};
+	header.offset = offset;
+	header.payloadSize = payload.size();
+	header.type = type;
+	header.magic = RecordMagic;
+	header.timestamp = std::chrono::duration_cast<std::chrono::microseconds>(
+				   std::chrono::system_clock::now().time_since_epoch())
+				   .count();
+
+	const size_t offsetSize = sizeof(header.offset);
+	CopyToRing(offset + offsetSize, (const uint8_t *)&header + offsetSize, sizeof(header) - offsetSize);
+	CopyToRing(offset + sizeof(header), payload.data(), payload.size());
+	std::atomic_thread_fence(std::memory_order_release);
+	CopyToRing(offset, &header.offset, offsetSize);
+
+	activeWriters--;
+}
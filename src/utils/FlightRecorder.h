@@ -0,0 +1,47 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <atomic>
+#include <string>
+
+#include "FlightRecorderFormat.h"
+#include "Json.h"
+
+// Optional binary recording of requests, responses, events and stats samples into a fixed-size memory-mapped ring file, for
+// reconstructing what happened after the fact. Writers reserve their space with an atomic add and never block.
+namespace Utils {
+	namespace FlightRecorder {
+		namespace Detail {
+			extern std::atomic<bool> active;
+		}
+
+		// Moves an existing file at `filePath` aside to `<filePath>.previous`, so the recording of the last run survives
+		// a restart of OBS.
+		bool Start(const std::string &filePath, uint64_t ringSize);
+		void Stop();
+
+		// Check before building the data of a record
+		inline bool IsActive()
+		{
+			return Detail::active.load(std::memory_order_relaxed);
+		}
+		void Record(FlightRecorderFormat::RecordType type, const json &data);
+	}
+}
@@ -0,0 +1,89 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Layout of the flight recorder ring file. Shared with the decoder in `tools/`, so this may not depend on anything else.
+//
+// The file is a `FileHeader` followed by the ring. Records are 8 byte aligned and may wrap around the end of the ring. They
+// are never linked to each other: a record is valid if the offset in its header matches its position in the ring, which
+// also tells records of the current lap apart from older data.
+namespace FlightRecorderFormat {
+	static const char FileMagic[8] = {'O', 'B', 'S', 'W', 'S', 'F', 'R', 'C'};
+	static const uint32_t FileVersion = 1;
+	static const uint16_t RecordMagic = 0x5246;
+	static const size_t RecordAlignment = 8;
+
+	struct FileHeader {
+		char magic[8];
+		uint32_t version;
+		uint32_t headerSize;
+		uint64_t ringSize;
+		uint64_t createdAt; // Milliseconds since the epoch
+		uint8_t reserved[32];
+	};
+
+	struct RecordHeader {
+		// Position of the record in the stream of everything written since the file was created. Written last, so
+		// records which were being written during a crash are not valid.
+		uint64_t offset;
+		uint32_t payloadSize; // MessagePack, followed by padding up to the alignment
+		uint16_t type;
+		uint16_t magic;
+		uint64_t timestamp; // Microseconds since the epoch
+	};
+
+	// The record types of messages use the same values as their OpCodes
+	enum RecordType : uint16_t {
+		Event = 5,
+		Request = 6,
+		RequestResponse = 7,
+		RequestBatch = 8,
+		RequestBatchResponse = 9,
+		Stats = 128,
+	};
+
+	inline const char *GetRecordTypeName(uint16_t type)
+	{
+		switch (type) {
+		case Event:
+			return "Event";
+		case Request:
+			return "Request";
+		case RequestResponse:
+			return "RequestResponse";
+		case RequestBatch:
+			return "RequestBatch";
+		case RequestBatchResponse:
+			return "RequestBatchResponse";
+		case Stats:
+			return "Stats";
+		default:
+			return "Unknown";
+		}
+	}
+
+	inline uint64_t GetRecordSize(uint32_t payloadSize)
+	{
+		uint64_t size = sizeof(RecordHeader) + payloadSize;
+		return (size + RecordAlignment - 1) / RecordAlignment * RecordAlignment;
+	}
+}
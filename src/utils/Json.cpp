@@ -18,6 +18,7 @@ with this program. If not, see <https://www.gnu.org/licenses/>
 */
 
 #include <fstream>
+#include <unordered_set>
 
 #include "Json.h"
 #include "plugin-macros.generated.h"
@@ -218,3 +219,37 @@ bool Utils::Json::SetJsonFileContent(std::string fileName, const json &content,
 
 	return true;
 }
+
+// Request types whose request or response data may contain credentials
+static const std::unordered_set<std::string> redactedRequestTypes{
+	"GetStreamServiceSettings",
+	"SetStreamServiceSettings",
+};
+
+// Request types like `PrepareRequestBatch` carry whole requests in their data, and batches carry them in `requests`,
+// `results` or `result`. So every nested object with a `requestType` is checked, wherever it is.
+static void RedactNestedSecrets(json &data)
+{
+	if (!data.is_structured())
+		return;
+
+	if (data.is_object() && data.contains("requestType") && data["requestType"].is_string() &&
+	    redactedRequestTypes.count(data["requestType"])) {
+		if (data.contains("requestData"))
+			data["requestData"] = "[redacted]";
+		if (data.contains("responseData"))
+			data["responseData"] = "[redacted]";
+	}
+
+	for (auto &item : data)
+		RedactNestedSecrets(item);
+}
+
+void Utils::Json::RedactSecrets(json &messageData)
+{
+	if (!messageData.is_object())
+		return;
+
+	messageData.erase("authentication");
+	RedactNestedSecrets(messageData);
+}
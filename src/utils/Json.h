@@ -77,6 +77,10 @@ namespace Utils {
 		json ObsDataToJson(obs_data_t *d, bool includeDefault = false);
 		bool GetJsonFileContent(std::string fileName, json &content);
 		bool SetJsonFileContent(std::string fileName, const json &content, bool makeDirs = true);
+		// Removes secrets from the data (`d`) of a protocol message before it is written to disk: the authentication
+		// string, and the request and response data of request types which carry credentials (stream keys, passwords).
+		// Works on records of the same shape, and on requests nested anywhere in them (batches, prepared batches).
+		void RedactSecrets(json &messageData);
 		static inline bool Contains(const json &j, std::string key)
 		{
 			return j.contains(key) && !j[key].is_null();
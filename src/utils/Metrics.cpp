@@ -0,0 +1,205 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <algorithm>
+#include <functional>
+
+#include "Metrics.h"
+
+static const struct {
+	double quantile;
+	const char *jsonKey;
+	const char *label;
+} Quantiles[] = {
+	{0.5, "latencyP50", "0.5"},
+	{0.9, "latencyP90", "0.9"},
+	{0.99, "latencyP99", "0.99"},
+	{0.999, "latencyP999", "0.999"},
+};
+
+uint64_t Utils::Metrics::Histogram::BucketUpperBound(size_t index)
+{
+	if (index < SubBucketCount)
+		return index;
+
+	size_t exponent = index / SubBucketCount + SubBucketBits - 1;
+	uint64_t subBucket = index % SubBucketCount;
+	uint64_t lowerBound = (SubBucketCount + subBucket) << (exponent - SubBucketBits);
+	return lowerBound + (uint64_t(1) << (exponent - SubBucketBits)) - 1;
+}
+
+uint64_t Utils::Metrics::Histogram::Count() const
+{
+	uint64_t count = 0;
+	for (auto &bucket : _buckets)
+		count += bucket.load(std::memory_order_relaxed);
+	return count;
+}
+
+uint64_t Utils::Metrics::Histogram::ValueAtQuantile(double quantile) const
+{
+	uint64_t count = Count();
+	if (!count)
+		return 0;
+
+	// Values recorded in the meantime may move the result by a bucket, which is fine for a quantile
+	uint64_t rank = std::max<uint64_t>(1, uint64_t(quantile * count + 0.5));
+	uint64_t seen = 0;
+	for (size_t i = 0; i < BucketCount; i++) {
+		seen += _buckets[i].load(std::memory_order_relaxed);
+		if (seen >= rank)
+			return BucketUpperBound(i);
+	}
+
+	return BucketUpperBound(BucketCount - 1);
+}
+
+Utils::Metrics::OperationMetricsFamily::~OperationMetricsFamily()
+{
+	for (auto &entry : _entries)
+		delete entry.load();
+}
+
+Utils::Metrics::OperationMetrics &Utils::Metrics::OperationMetricsFamily::Get(const std::string &name)
+{
+	size_t index = std::hash<std::string>()(name) % Capacity;
+	Entry *newEntry = nullptr;
+	for (size_t probe = 0; probe < MaxProbes; probe++, index = (index + 1) % Capacity) {
+		Entry *entry = _entries[index].load(std::memory_order_acquire);
+		if (!entry) {
+			if (!newEntry)
+				newEntry = new Entry{name, {}};
+
+			// Another thread may have claimed the slot in the meantime, possibly for the same name
+			if (_entries[index].compare_exchange_strong(entry, newEntry, std::memory_order_acq_rel))
+				return newEntry->metrics;
+		}
+
+		if (entry->name == name) {
+			delete newEntry;
+			return entry->metrics;
+		}
+	}
+
+	delete newEntry;
+	return _overflow;
+}
+
+static json OperationMetricsToJson(const Utils::Metrics::OperationMetrics &metrics)
+{
+	json ret;
+	ret["total"] = metrics.total.load();
+	ret["failed"] = metrics.failed.load();
+	ret["latencySum"] = metrics.latency.Sum();
+	for (auto &quantile : Quantiles)
+		ret[quantile.jsonKey] = metrics.latency.ValueAtQuantile(quantile.quantile);
+	return ret;
+}
+
+json Utils::Metrics::OperationMetricsFamily::ToJson() const
+{
+	json ret = json::object();
+	for (auto &slot : _entries) {
+		Entry *entry = slot.load(std::memory_order_acquire);
+		if (entry)
+			ret[entry->name] = OperationMetricsToJson(entry->metrics);
+	}
+
+	if (_overflow.total)
+		ret["(other)"] = OperationMetricsToJson(_overflow);
+
+	return ret;
+}
+
+static void WriteOperationMetrics(std::string &out, const std::string &metricName, const std::string &labels,
+				  const Utils::Metrics::OperationMetrics &metrics)
+{
+	out += metricName + "_total{" + labels + "} " + std::to_string(metrics.total.load()) + "\n";
+	out += metricName + "_failed_total{" + labels + "} " + std::to_string(metrics.failed.load()) + "\n";
+
+	for (auto &quantile : Quantiles) {
+		double seconds = metrics.latency.ValueAtQuantile(quantile.quantile) / 1e6;
+		out += metricName + "_duration_seconds{" + labels + ",quantile=\"" + quantile.label + "\"} " +
+		       std::to_string(seconds) + "\n";
+	}
+	out += metricName + "_duration_seconds_sum{" + labels + "} " + std::to_string(metrics.latency.Sum() / 1e6) + "\n";
+	out += metricName + "_duration_seconds_count{" + labels + "} " + std::to_string(metrics.latency.Count()) + "\n";
+}
+
+void Utils::Metrics::OperationMetricsFamily::WritePrometheusText(std::string &out, const std::string &metricName,
+								  const std::string &label) const
+{
+	out += "# TYPE " + metricName + "_total counter\n";
+	out += "# TYPE " + metricName + "_failed_total counter\n";
+	out += "# TYPE " + metricName + "_duration_seconds summary\n";
+
+	// Names are request and event types, which never need escaping
+	for (auto &slot : _entries) {
+		Entry *entry = slot.load(std::memory_order_acquire);
+		if (entry)
+			WriteOperationMetrics(out, metricName, label + "=\"" + entry->name + "\"", entry->metrics);
+	}
+
+	if (_overflow.total)
+		WriteOperationMetrics(out, metricName, label + "=\"(other)\"", _overflow);
+}
+
+Utils::Metrics::Registry &Utils::Metrics::GetRegistry()
+{
+	static Registry registry;
+	return registry;
+}
+
+json Utils::Metrics::ToJson()
+{
+	Registry &registry = GetRegistry();
+
+	json ret;
+	ret["requests"] = registry.requests.ToJson();
+	ret["events"] = registry.events.ToJson();
+	ret["messagesReceived"] = registry.messagesReceived.load();
+	ret["bytesReceived"] = registry.bytesReceived.load();
+	ret["messagesSent"] = registry.messagesSent.load();
+	ret["bytesSent"] = registry.bytesSent.load();
+	ret["failedSends"] = registry.failedSends.load();
+	ret["messageQueueDepth"] = registry.messageQueueDepth.load();
+	ret["sessions"] = registry.sessions.load();
+	return ret;
+}
+
+std::string Utils::Metrics::ToPrometheusText()
+{
+	Registry &registry = GetRegistry();
+
+	std::string ret;
+	registry.requests.WritePrometheusText(ret, "obs_websocket_requests", "request_type");
+	registry.events.WritePrometheusText(ret, "obs_websocket_events", "event_type");
+
+	auto writeMetric = [&ret](const char *type, const std::string &name, int64_t value) {
+		ret += std::string("# TYPE ") + name + " " + type + "\n" + name + " " + std::to_string(value) + "\n";
+	};
+	writeMetric("counter", "obs_websocket_messages_received_total", registry.messagesReceived);
+	writeMetric("counter", "obs_websocket_received_bytes_total", registry.bytesReceived);
+	writeMetric("counter", "obs_websocket_messages_sent_total", registry.messagesSent);
+	writeMetric("counter", "obs_websocket_sent_bytes_total", registry.bytesSent);
+	writeMetric("counter", "obs_websocket_failed_sends_total", registry.failedSends);
+	writeMetric("gauge", "obs_websocket_message_queue_depth", registry.messageQueueDepth);
+	writeMetric("gauge", "obs_websocket_sessions", registry.sessions);
+
+	return ret;
+}
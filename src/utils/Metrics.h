@@ -0,0 +1,134 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include "Json.h"
+
+namespace Utils {
+	namespace Metrics {
+		typedef std::chrono::steady_clock Clock;
+
+		// Log-linear histogram in the style of HDR histograms. Every power of two is split into 8 sub-buckets, so
+		// recorded values are off by at most 12.5%. Recording is two relaxed atomic increments, and the count is only
+		// summed up when read.
+		class Histogram {
+		public:
+			inline void Record(uint64_t value)
+			{
+				_buckets[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+				_sum.fetch_add(value, std::memory_order_relaxed);
+			}
+
+			uint64_t Count() const;
+			inline uint64_t Sum() const { return _sum.load(std::memory_order_relaxed); }
+			// Upper bound of the bucket containing the value at `quantile`, or 0 if nothing was recorded
+			uint64_t ValueAtQuantile(double quantile) const;
+
+		private:
+			static const size_t SubBucketBits = 3;
+			static const size_t SubBucketCount = 1 << SubBucketBits;
+			static const size_t BucketCount = 512;
+
+			static inline size_t BucketIndex(uint64_t value)
+			{
+				if (value < SubBucketCount)
+					return value;
+
+#ifdef _MSC_VER
+				unsigned long exponent;
+				_BitScanReverse64(&exponent, value);
+#else
+				size_t exponent = 63 - __builtin_clzll(value);
+#endif
+				size_t subBucket = (value >> (exponent - SubBucketBits)) & (SubBucketCount - 1);
+				return (exponent - SubBucketBits + 1) * SubBucketCount + subBucket;
+			}
+			static uint64_t BucketUpperBound(size_t index);
+
+			std::array<std::atomic<uint64_t>, BucketCount> _buckets = {};
+			std::atomic<uint64_t> _sum = 0;
+		};
+
+		// Metrics of one kind of operation, like a request type. Latencies are in microseconds.
+		struct OperationMetrics {
+			std::atomic<uint64_t> total = 0;
+			std::atomic<uint64_t> failed = 0;
+			Histogram latency;
+
+			inline void Record(Clock::time_point start, bool succeeded = true)
+			{
+				auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+				total.fetch_add(1, std::memory_order_relaxed);
+				if (!succeeded)
+					failed.fetch_add(1, std::memory_order_relaxed);
+				latency.Record(elapsed.count());
+			}
+		};
+
+		// Insert-only hash table of operation metrics by name, using open addressing. Neither lookups nor inserts
+		// take a lock. Names which do not fit anymore share a single overflow entry.
+		class OperationMetricsFamily {
+		public:
+			~OperationMetricsFamily();
+
+			OperationMetrics &Get(const std::string &name);
+			json ToJson() const;
+			void WritePrometheusText(std::string &out, const std::string &metricName, const std::string &label) const;
+
+		private:
+			struct Entry {
+				std::string name;
+				OperationMetrics metrics;
+			};
+
+			static const size_t Capacity = 1024;
+			static const size_t MaxProbes = 64;
+
+			std::array<std::atomic<Entry *>, Capacity> _entries = {};
+			OperationMetrics _overflow;
+		};
+
+		struct Registry {
+			OperationMetricsFamily requests;
+			OperationMetricsFamily events;
+
+			std::atomic<uint64_t> messagesReceived = 0;
+			std::atomic<uint64_t> bytesReceived = 0;
+			std::atomic<uint64_t> messagesSent = 0;
+			std::atomic<uint64_t> bytesSent = 0;
+			std::atomic<uint64_t> failedSends = 0;
+			std::atomic<int64_t> messageQueueDepth = 0; // Received messages which are waiting for a thread
+			std::atomic<int64_t> sessions = 0;
+		};
+
+		Registry &GetRegistry();
+
+		json ToJson();
+		// Prometheus text exposition format, version 0.0.4
+		std::string ToPrometheusText();
+	}
+}
@@ -20,6 +20,8 @@ with this program. If not, see <https://www.gnu.org/licenses/>
 #pragma once
 
 #include <string>
+#include <functional>
+#include <unordered_set>
 #include <obs.hpp>
 #include <obs-frontend-api.h>
 
@@ -225,6 +227,66 @@ NLOHMANN_JSON_SERIALIZE_ENUM(ObsMediaInputAction,
 
 namespace Utils {
 	namespace Obs {
+		// Set of optional fields a client asked for. A default-constructed selector selects every field, while an empty
+		// field list selects none. Identifying fields (names, UUIDs, IDs) are always returned, and not part of the selector.
+		class FieldSelector {
+		public:
+			FieldSelector() = default;
+			FieldSelector(const std::vector<std::string> &fields) : _all(false), _fields(fields.begin(), fields.end()) {}
+
+			inline bool Has(const std::string &field) const { return _all || _fields.count(field); }
+
+		private:
+			bool _all = true;
+			std::unordered_set<std::string> _fields;
+		};
+
+		// Optional fields of the items of each list, which are all that a selector for it may contain
+		namespace SelectableFields {
+			inline const std::vector<std::string> Scene = {"sceneIndex"};
+			inline const std::vector<std::string> SceneItem = {
+				"sceneItemIndex", "sceneItemEnabled", "sceneItemLocked", "sceneItemTransform",
+				"sceneItemBlendMode", "sourceType", "inputKind", "isGroup"};
+			inline const std::vector<std::string> Input = {"inputKind", "unversionedInputKind"};
+			inline const std::vector<std::string> Transition = {"transitionKind", "transitionFixed",
+									    "transitionConfigurable"};
+			inline const std::vector<std::string> Filter = {"filterEnabled", "filterIndex", "filterKind",
+									"filterSettings"};
+			inline const std::vector<std::string> Output = {"outputKind", "outputWidth", "outputHeight", "outputActive",
+									"outputFlags"};
+		}
+
+		// Pagination and incremental streaming of enumerated lists. Lists are enumerated into lightweight references and
+		// the keys of their items first, so that no chunk is sent from within a libobs enumeration. Only the items of the
+		// page are then built, one chunk at a time. Cursors hold the index and key of the last item of their page.
+		class ListPager {
+		public:
+			typedef std::function<void(std::vector<json> &&)> ChunkCallback;
+			typedef std::function<json(size_t)> ItemCallback; // Builds the item at an index of the keys
+
+			bool SetCursor(const std::string &cursor); // Returns false if the cursor is malformed
+			inline void SetLimit(size_t limit) { _limit = limit; }
+			void SetChunkCallback(size_t chunkSize, ChunkCallback cb);
+
+			// Items of the page which were not emitted through the chunk callback
+			std::vector<json> Paginate(const std::vector<std::string> &keys, ItemCallback item);
+			std::vector<json> Paginate(const std::vector<std::string> &items); // Keyed by the strings themselves
+
+			inline bool HasMore() const { return !_nextCursor.empty(); }
+			inline const std::string &NextCursor() const { return _nextCursor; }
+
+		private:
+			size_t FindStart(const std::vector<std::string> &keys) const;
+
+			bool _hasCursor = false;
+			size_t _cursorIndex = 0;
+			std::string _cursorKey;
+			size_t _limit = 0; // 0 == unlimited
+			size_t _chunkSize = 0;
+			ChunkCallback _chunkCallback;
+			std::string _nextCursor;
+		};
+
 		namespace StringHelper {
 			std::string GetObsVersion();
 			std::string GetModuleConfigPath(std::string fileName);
@@ -249,22 +311,27 @@ namespace Utils {
 			std::vector<std::string> GetProfileList();
 			std::vector<obs_hotkey_t *> GetHotkeyList();
 			std::vector<std::string> GetHotkeyNameList();
-			std::vector<json> GetSceneList();
+			std::vector<json> GetSceneList(const FieldSelector &fields = {});
 			std::vector<std::string> GetGroupList();
-			std::vector<json> GetSceneItemList(obs_scene_t *scene, bool basic = false);
-			std::vector<json> GetInputList(std::string inputKind = "");
+			std::vector<json> GetSceneItemList(obs_scene_t *scene, bool basic = false, const FieldSelector &fields = {});
+			std::vector<OBSSceneItem> GetSceneItemRefs(obs_scene_t *scene); // In the order of GetSceneItemList()
+			std::vector<json> GetInputList(std::string inputKind = "", const FieldSelector &fields = {});
+			std::vector<OBSSource> GetInputRefs(std::string inputKind = ""); // In the order of GetInputList()
 			std::vector<std::string> GetInputKindList(bool unversioned = false, bool includeDisabled = false);
 			std::vector<json> GetListPropertyItems(obs_property_t *property);
 			std::vector<std::string> GetTransitionKindList();
-			std::vector<json> GetSceneTransitionList();
-			std::vector<json> GetSourceFilterList(obs_source_t *source);
+			std::vector<json> GetSceneTransitionList(const FieldSelector &fields = {});
+			std::vector<json> GetSourceFilterList(obs_source_t *source, const FieldSelector &fields = {});
 			std::vector<std::string> GetFilterKindList();
-			std::vector<json> GetOutputList();
+			std::vector<json> GetOutputList(const FieldSelector &fields = {});
 		}
 
 		namespace ObjectHelper {
 			json GetStats();
 			json GetSceneItemTransform(obs_sceneitem_t *item);
+			// `index` is the position of the item in its scene
+			json GetSceneItem(obs_sceneitem_t *item, size_t index, bool basic = false, const FieldSelector &fields = {});
+			json GetInput(obs_source_t *input, const FieldSelector &fields = {});
 		}
 
 		namespace SearchHelper {
@@ -40,6 +40,82 @@ static std::vector<std::string> ConvertStringArray(char **array)
 	return ret;
 }
 
+bool Utils::Obs::ListPager::SetCursor(const std::string &cursor)
+{
+	size_t separator = cursor.find(':');
+	if (separator == 0 || separator == std::string::npos || separator > 18)
+		return false;
+
+	std::string index = cursor.substr(0, separator);
+	if (index.find_first_not_of("0123456789") != std::string::npos)
+		return false;
+
+	_cursorIndex = std::stoull(index);
+	_cursorKey = cursor.substr(separator + 1);
+	_hasCursor = true;
+
+	return true;
+}
+
+void Utils::Obs::ListPager::SetChunkCallback(size_t chunkSize, ChunkCallback cb)
+{
+	_chunkSize = chunkSize;
+	_chunkCallback = cb;
+}
+
+size_t Utils::Obs::ListPager::FindStart(const std::vector<std::string> &keys) const
+{
+	if (!_hasCursor)
+		return 0;
+
+	// Items may have been added or removed since the previous page, and keys like hotkey names are not unique.
+	// Resume after the occurrence of the last returned item which is closest to where it was.
+	size_t distanceLimit = std::max(_cursorIndex + 1, keys.size());
+	for (size_t distance = 0; distance < distanceLimit; distance++) {
+		if (distance <= _cursorIndex) {
+			size_t index = _cursorIndex - distance;
+			if (index < keys.size() && keys[index] == _cursorKey)
+				return index + 1;
+		}
+
+		size_t index = _cursorIndex + distance;
+		if (distance && index < keys.size() && keys[index] == _cursorKey)
+			return index + 1;
+	}
+
+	// The last returned item was removed, so the next one has moved into its position
+	return std::min(_cursorIndex, keys.size());
+}
+
+std::vector<json> Utils::Obs::ListPager::Paginate(const std::vector<std::string> &keys, ItemCallback item)
+{
+	size_t start = FindStart(keys);
+	size_t end = keys.size();
+	if (_limit && end - start > _limit)
+		end = start + _limit;
+
+	if (end < keys.size())
+		_nextCursor = std::to_string(end - 1) + ":" + keys[end - 1];
+
+	// Streamed pages only ever hold one chunk
+	std::vector<json> ret;
+	ret.reserve(_chunkCallback ? std::min(_chunkSize, end - start) : end - start);
+	for (size_t i = start; i < end; i++) {
+		ret.push_back(item(i));
+		if (_chunkCallback && (ret.size() == _chunkSize || i + 1 == end)) {
+			_chunkCallback(std::move(ret));
+			ret.clear();
+		}
+	}
+
+	return ret;
+}
+
+std::vector<json> Utils::Obs::ListPager::Paginate(const std::vector<std::string> &items)
+{
+	return Paginate(items, [&items](size_t index) { return json(items[index]); });
+}
+
 std::vector<std::string> Utils::Obs::ArrayHelper::GetSceneCollectionList()
 {
 	char **sceneCollections = obs_frontend_get_scene_collections();
@@ -84,7 +160,7 @@ std::vector<std::string> Utils::Obs::ArrayHelper::GetHotkeyNameList()
 	return ret;
 }
 
-std::vector<json> Utils::Obs::ArrayHelper::GetSceneList()
+std::vector<json> Utils::Obs::ArrayHelper::GetSceneList(const FieldSelector &fields)
 {
 	obs_frontend_source_list sceneList = {};
 	obs_frontend_get_scenes(&sceneList);
@@ -97,7 +173,8 @@ std::vector<json> Utils::Obs::ArrayHelper::GetSceneList()
 		json sceneJson;
 		sceneJson["sceneName"] = obs_source_get_name(scene);
 		sceneJson["sceneUuid"] = obs_source_get_uuid(scene);
-		sceneJson["sceneIndex"] = sceneList.sources.num - i - 1;
+		if (fields.Has("sceneIndex"))
+			sceneJson["sceneIndex"] = sceneList.sources.num - i - 1;
 
 		ret.push_back(sceneJson);
 	}
@@ -130,55 +207,64 @@ std::vector<std::string> Utils::Obs::ArrayHelper::GetGroupList()
 	return ret;
 }
 
-std::vector<json> Utils::Obs::ArrayHelper::GetSceneItemList(obs_scene_t *scene, bool basic)
+struct EnumSceneItemInfo {
+	bool basic;
+	const Utils::Obs::FieldSelector *fields;
+	std::vector<json> sceneItems;
+};
+
+std::vector<json> Utils::Obs::ArrayHelper::GetSceneItemList(obs_scene_t *scene, bool basic, const FieldSelector &fields)
 {
-	std::pair<std::vector<json>, bool> enumData;
-	enumData.second = basic;
+	EnumSceneItemInfo enumData;
+	enumData.basic = basic;
+	enumData.fields = &fields;
 
 	auto cb = [](obs_scene_t *, obs_sceneitem_t *sceneItem, void *param) {
-		auto enumData = static_cast<std::pair<std::vector<json>, bool> *>(param);
-
-		// TODO: Make ObjectHelper util for scene items
-
-		json item;
-		item["sceneItemId"] = obs_sceneitem_get_id(sceneItem);
-		item["sceneItemIndex"] =
-			enumData->first.size(); // Should be slightly faster than calling obs_sceneitem_get_order_position()
-		if (!enumData->second) {
-			item["sceneItemEnabled"] = obs_sceneitem_visible(sceneItem);
-			item["sceneItemLocked"] = obs_sceneitem_locked(sceneItem);
-			item["sceneItemTransform"] = ObjectHelper::GetSceneItemTransform(sceneItem);
-			item["sceneItemBlendMode"] = obs_sceneitem_get_blending_mode(sceneItem);
-			OBSSource itemSource = obs_sceneitem_get_source(sceneItem);
-			item["sourceName"] = obs_source_get_name(itemSource);
-			item["sourceUuid"] = obs_source_get_uuid(itemSource);
-			item["sourceType"] = obs_source_get_type(itemSource);
-			if (obs_source_get_type(itemSource) == OBS_SOURCE_TYPE_INPUT)
-				item["inputKind"] = obs_source_get_id(itemSource);
-			else
-				item["inputKind"] = nullptr;
-			if (obs_source_get_type(itemSource) == OBS_SOURCE_TYPE_SCENE)
-				item["isGroup"] = obs_source_is_group(itemSource);
-			else
-				item["isGroup"] = nullptr;
-		}
+		auto enumData = static_cast<EnumSceneItemInfo *>(param);
 
-		enumData->first.push_back(item);
+		enumData->sceneItems.push_back(
+			ObjectHelper::GetSceneItem(sceneItem, enumData->sceneItems.size(), enumData->basic, *enumData->fields));
 
 		return true;
 	};
 
 	obs_scene_enum_items(scene, cb, &enumData);
 
-	return enumData.first;
+	return enumData.sceneItems;
+}
+
+std::vector<OBSSceneItem> Utils::Obs::ArrayHelper::GetSceneItemRefs(obs_scene_t *scene)
+{
+	std::vector<OBSSceneItem> ret;
+
+	auto cb = [](obs_scene_t *, obs_sceneitem_t *sceneItem, void *param) {
+		auto ret = static_cast<std::vector<OBSSceneItem> *>(param);
+
+		ret->emplace_back(sceneItem);
+
+		return true;
+	};
+
+	obs_scene_enum_items(scene, cb, &ret);
+
+	return ret;
 }
 
 struct EnumInputInfo {
 	std::string inputKind; // For searching by input kind
-	std::vector<json> inputs;
+	std::vector<OBSSource> inputs;
 };
 
-std::vector<json> Utils::Obs::ArrayHelper::GetInputList(std::string inputKind)
+std::vector<json> Utils::Obs::ArrayHelper::GetInputList(std::string inputKind, const FieldSelector &fields)
+{
+	std::vector<json> ret;
+	for (auto &input : GetInputRefs(inputKind))
+		ret.push_back(ObjectHelper::GetInput(input, fields));
+
+	return ret;
+}
+
+std::vector<OBSSource> Utils::Obs::ArrayHelper::GetInputRefs(std::string inputKind)
 {
 	EnumInputInfo inputInfo;
 	inputInfo.inputKind = inputKind;
@@ -190,18 +276,10 @@ std::vector<json> Utils::Obs::ArrayHelper::GetInputList(std::string inputKind)
 
 		auto inputInfo = static_cast<EnumInputInfo *>(param);
 
-		std::string inputKind = obs_source_get_id(input);
-
-		if (!inputInfo->inputKind.empty() && inputInfo->inputKind != inputKind)
+		if (!inputInfo->inputKind.empty() && inputInfo->inputKind != obs_source_get_id(input))
 			return true;
 
-		json inputJson;
-		inputJson["inputName"] = obs_source_get_name(input);
-		inputJson["inputUuid"] = obs_source_get_uuid(input);
-		inputJson["inputKind"] = inputKind;
-		inputJson["unversionedInputKind"] = obs_source_get_unversioned_id(input);
-
-		inputInfo->inputs.push_back(inputJson);
+		inputInfo->inputs.emplace_back(input);
 		return true;
 	};
 
@@ -273,7 +351,7 @@ std::vector<std::string> Utils::Obs::ArrayHelper::GetTransitionKindList()
 	return ret;
 }
 
-std::vector<json> Utils::Obs::ArrayHelper::GetSceneTransitionList()
+std::vector<json> Utils::Obs::ArrayHelper::GetSceneTransitionList(const FieldSelector &fields)
 {
 	obs_frontend_source_list transitionList = {};
 	obs_frontend_get_transitions(&transitionList);
@@ -285,9 +363,12 @@ std::vector<json> Utils::Obs::ArrayHelper::GetSceneTransitionList()
 		json transitionJson;
 		transitionJson["transitionName"] = obs_source_get_name(transition);
 		transitionJson["transitionUuid"] = obs_source_get_uuid(transition);
-		transitionJson["transitionKind"] = obs_source_get_id(transition);
-		transitionJson["transitionFixed"] = obs_transition_fixed(transition);
-		transitionJson["transitionConfigurable"] = obs_source_configurable(transition);
+		if (fields.Has("transitionKind"))
+			transitionJson["transitionKind"] = obs_source_get_id(transition);
+		if (fields.Has("transitionFixed"))
+			transitionJson["transitionFixed"] = obs_transition_fixed(transition);
+		if (fields.Has("transitionConfigurable"))
+			transitionJson["transitionConfigurable"] = obs_source_configurable(transition);
 		ret.push_back(transitionJson);
 	}
 
@@ -308,58 +389,82 @@ std::vector<std::string> Utils::Obs::ArrayHelper::GetFilterKindList()
 	return ret;
 }
 
-std::vector<json> Utils::Obs::ArrayHelper::GetSourceFilterList(obs_source_t *source)
-{
+struct EnumFilterInfo {
+	const Utils::Obs::FieldSelector *fields;
 	std::vector<json> filters;
+};
+
+std::vector<json> Utils::Obs::ArrayHelper::GetSourceFilterList(obs_source_t *source, const FieldSelector &fields)
+{
+	EnumFilterInfo filterInfo;
+	filterInfo.fields = &fields;
 
 	auto cb = [](obs_source_t *, obs_source_t *filter, void *param) {
-		auto filters = reinterpret_cast<std::vector<json> *>(param);
+		auto filterInfo = reinterpret_cast<EnumFilterInfo *>(param);
+		const FieldSelector &fields = *filterInfo->fields;
 
 		json filterJson;
-		filterJson["filterEnabled"] = obs_source_enabled(filter);
-		filterJson["filterIndex"] = filters->size();
-		filterJson["filterKind"] = obs_source_get_id(filter);
+		if (fields.Has("filterEnabled"))
+			filterJson["filterEnabled"] = obs_source_enabled(filter);
+		if (fields.Has("filterIndex"))
+			filterJson["filterIndex"] = filterInfo->filters.size();
+		if (fields.Has("filterKind"))
+			filterJson["filterKind"] = obs_source_get_id(filter);
 		filterJson["filterName"] = obs_source_get_name(filter);
 
-		OBSDataAutoRelease filterSettings = obs_source_get_settings(filter);
-		filterJson["filterSettings"] = Utils::Json::ObsDataToJson(filterSettings);
+		if (fields.Has("filterSettings")) {
+			OBSDataAutoRelease filterSettings = obs_source_get_settings(filter);
+			filterJson["filterSettings"] = Utils::Json::ObsDataToJson(filterSettings);
+		}
 
-		filters->push_back(filterJson);
+		filterInfo->filters.push_back(filterJson);
 	};
 
-	obs_source_enum_filters(source, cb, &filters);
+	obs_source_enum_filters(source, cb, &filterInfo);
 
-	return filters;
+	return filterInfo.filters;
 }
 
-std::vector<json> Utils::Obs::ArrayHelper::GetOutputList()
-{
+struct EnumOutputInfo {
+	const Utils::Obs::FieldSelector *fields;
 	std::vector<json> outputs;
+};
 
-	auto cb = [](void *param, obs_output_t *output) {
-		auto outputs = reinterpret_cast<std::vector<json> *>(param);
+std::vector<json> Utils::Obs::ArrayHelper::GetOutputList(const FieldSelector &fields)
+{
+	EnumOutputInfo outputInfo;
+	outputInfo.fields = &fields;
 
-		auto rawFlags = obs_output_get_flags(output);
-		json flags;
-		flags["OBS_OUTPUT_AUDIO"] = !!(rawFlags & OBS_OUTPUT_AUDIO);
-		flags["OBS_OUTPUT_VIDEO"] = !!(rawFlags & OBS_OUTPUT_VIDEO);
-		flags["OBS_OUTPUT_ENCODED"] = !!(rawFlags & OBS_OUTPUT_ENCODED);
-		flags["OBS_OUTPUT_MULTI_TRACK"] = !!(rawFlags & OBS_OUTPUT_MULTI_TRACK);
-		flags["OBS_OUTPUT_SERVICE"] = !!(rawFlags & OBS_OUTPUT_SERVICE);
+	auto cb = [](void *param, obs_output_t *output) {
+		auto outputInfo = reinterpret_cast<EnumOutputInfo *>(param);
+		const FieldSelector &fields = *outputInfo->fields;
 
 		json outputJson;
 		outputJson["outputName"] = obs_output_get_name(output);
-		outputJson["outputKind"] = obs_output_get_id(output);
-		outputJson["outputWidth"] = obs_output_get_width(output);
-		outputJson["outputHeight"] = obs_output_get_height(output);
-		outputJson["outputActive"] = obs_output_active(output);
-		outputJson["outputFlags"] = flags;
+		if (fields.Has("outputKind"))
+			outputJson["outputKind"] = obs_output_get_id(output);
+		if (fields.Has("outputWidth"))
+			outputJson["outputWidth"] = obs_output_get_width(output);
+		if (fields.Has("outputHeight"))
+			outputJson["outputHeight"] = obs_output_get_height(output);
+		if (fields.Has("outputActive"))
+			outputJson["outputActive"] = obs_output_active(output);
+		if (fields.Has("outputFlags")) {
+			auto rawFlags = obs_output_get_flags(output);
+			json flags;
+			flags["OBS_OUTPUT_AUDIO"] = !!(rawFlags & OBS_OUTPUT_AUDIO);
+			flags["OBS_OUTPUT_VIDEO"] = !!(rawFlags & OBS_OUTPUT_VIDEO);
+			flags["OBS_OUTPUT_ENCODED"] = !!(rawFlags & OBS_OUTPUT_ENCODED);
+			flags["OBS_OUTPUT_MULTI_TRACK"] = !!(rawFlags & OBS_OUTPUT_MULTI_TRACK);
+			flags["OBS_OUTPUT_SERVICE"] = !!(rawFlags & OBS_OUTPUT_SERVICE);
+			outputJson["outputFlags"] = flags;
+		}
 
-		outputs->push_back(outputJson);
+		outputInfo->outputs.push_back(outputJson);
 		return true;
 	};
 
-	obs_enum_outputs(cb, &outputs);
+	obs_enum_outputs(cb, &outputInfo);
 
-	return outputs;
+	return outputInfo.outputs;
 }
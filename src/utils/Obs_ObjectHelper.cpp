@@ -87,3 +87,55 @@ json Utils::Obs::ObjectHelper::GetSceneItemTransform(obs_sceneitem_t *item)
 
 	return ret;
 }
+
+json Utils::Obs::ObjectHelper::GetSceneItem(obs_sceneitem_t *item, size_t index, bool basic, const FieldSelector &fields)
+{
+	json ret;
+	ret["sceneItemId"] = obs_sceneitem_get_id(item);
+	// Should be slightly faster than calling obs_sceneitem_get_order_position()
+	if (fields.Has("sceneItemIndex"))
+		ret["sceneItemIndex"] = index;
+	if (basic)
+		return ret;
+
+	if (fields.Has("sceneItemEnabled"))
+		ret["sceneItemEnabled"] = obs_sceneitem_visible(item);
+	if (fields.Has("sceneItemLocked"))
+		ret["sceneItemLocked"] = obs_sceneitem_locked(item);
+	if (fields.Has("sceneItemTransform"))
+		ret["sceneItemTransform"] = GetSceneItemTransform(item);
+	if (fields.Has("sceneItemBlendMode"))
+		ret["sceneItemBlendMode"] = obs_sceneitem_get_blending_mode(item);
+	OBSSource itemSource = obs_sceneitem_get_source(item);
+	ret["sourceName"] = obs_source_get_name(itemSource);
+	ret["sourceUuid"] = obs_source_get_uuid(itemSource);
+	if (fields.Has("sourceType"))
+		ret["sourceType"] = obs_source_get_type(itemSource);
+	if (fields.Has("inputKind")) {
+		if (obs_source_get_type(itemSource) == OBS_SOURCE_TYPE_INPUT)
+			ret["inputKind"] = obs_source_get_id(itemSource);
+		else
+			ret["inputKind"] = nullptr;
+	}
+	if (fields.Has("isGroup")) {
+		if (obs_source_get_type(itemSource) == OBS_SOURCE_TYPE_SCENE)
+			ret["isGroup"] = obs_source_is_group(itemSource);
+		else
+			ret["isGroup"] = nullptr;
+	}
+
+	return ret;
+}
+
+json Utils::Obs::ObjectHelper::GetInput(obs_source_t *input, const FieldSelector &fields)
+{
+	json ret;
+	ret["inputName"] = obs_source_get_name(input);
+	ret["inputUuid"] = obs_source_get_uuid(input);
+	if (fields.Has("inputKind"))
+		ret["inputKind"] = obs_source_get_id(input);
+	if (fields.Has("unversionedInputKind"))
+		ret["unversionedInputKind"] = obs_source_get_unversioned_id(input);
+
+	return ret;
+}
@@ -0,0 +1,119 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <cmath>
+
+#include "Obs.h"
+#include "Obs_OutputStatistics.h"
+#include "../obs-websocket.h"
+
+Utils::Obs::OutputStatistics::Handler::Handler(UpdateCallback cb, uint64_t updatePeriod)
+	: _updateCallback(cb),
+	  _updatePeriod(updatePeriod),
+	  _running(false)
+{
+	_running = true;
+	_updateThread = std::thread(&Handler::UpdateThread, this);
+
+	blog_debug("[Utils::Obs::OutputStatistics::Handler::Handler] Handler created.");
+}
+
+Utils::Obs::OutputStatistics::Handler::~Handler()
+{
+	// Under the mutex, so the thread cannot miss the notification between checking `_running` and starting to wait
+	{
+		std::lock_guard<std::mutex> l(_mutex);
+		_running = false;
+		_cond.notify_all();
+	}
+
+	if (_updateThread.joinable())
+		_updateThread.join();
+
+	blog_debug("[Utils::Obs::OutputStatistics::Handler::~Handler] Handler destroyed.");
+}
+
+void Utils::Obs::OutputStatistics::Handler::UpdateThread()
+{
+	blog_debug("[Utils::Obs::OutputStatistics::Handler::UpdateThread] Thread started.");
+	while (_running) {
+		{
+			std::unique_lock<std::mutex> l(_mutex);
+			if (_cond.wait_for(l, std::chrono::milliseconds(_updatePeriod), [this] { return !_running; }))
+				break;
+		}
+
+		// The frontend can swap its outputs (profile change, settings change), so they are fetched again every sample
+		OBSOutputAutoRelease outputs[OUTPUT_SLOT_COUNT] = {
+			obs_frontend_get_streaming_output(),
+			obs_frontend_get_recording_output(),
+			obs_frontend_get_replay_buffer_output(),
+			obs_frontend_get_virtualcam_output(),
+		};
+
+		uint64_t now = os_gettime_ns();
+		std::vector<json> ret;
+		for (int i = 0; i < OUTPUT_SLOT_COUNT; i++) {
+			if (!outputs[i]) {
+				_samples[i] = Sample();
+				continue;
+			}
+
+			ret.push_back(SampleOutput((OutputSlot)i, outputs[i], now));
+		}
+
+		if (_updateCallback)
+			_updateCallback(ret);
+	}
+	blog_debug("[Utils::Obs::OutputStatistics::Handler::UpdateThread] Thread stopped.");
+}
+
+json Utils::Obs::OutputStatistics::Handler::SampleOutput(OutputSlot slot, obs_output_t *output, uint64_t now)
+{
+	static const char *outputTypes[OUTPUT_SLOT_COUNT] = {"stream", "record", "replayBuffer", "virtualcam"};
+
+	bool outputActive = obs_output_active(output);
+	uint64_t outputBytes = outputActive ? obs_output_get_total_bytes(output) : 0;
+	uint64_t outputDuration = outputActive ? NumberHelper::GetOutputDuration(output) : 0;
+
+	float outputCongestion = obs_output_get_congestion(output);
+	if (std::isnan(outputCongestion)) // libobs does not handle NaN, so we're handling it here
+		outputCongestion = 0.0f;
+
+	// Bitrate over the last period, in kbps. The first sample after (re)starting has nothing to compare against
+	Sample &previous = _samples[slot];
+	uint64_t outputBitrate = 0;
+	if (outputActive && previous.timestamp && outputBytes >= previous.bytes && now > previous.timestamp)
+		outputBitrate = (outputBytes - previous.bytes) * 8 * 1000000 / (now - previous.timestamp);
+	previous.bytes = outputBytes;
+	previous.timestamp = outputActive ? now : 0;
+
+	json ret;
+	ret["outputType"] = outputTypes[slot];
+	ret["outputName"] = obs_output_get_name(output);
+	ret["outputActive"] = outputActive;
+	ret["outputReconnecting"] = obs_output_reconnecting(output);
+	ret["outputTimecode"] = StringHelper::DurationToTimecode(outputDuration);
+	ret["outputDuration"] = outputDuration;
+	ret["outputCongestion"] = outputCongestion;
+	ret["outputBytes"] = outputBytes;
+	ret["outputBitrate"] = outputBitrate;
+	ret["outputSkippedFrames"] = obs_output_get_frames_dropped(output);
+	ret["outputTotalFrames"] = obs_output_get_total_frames(output);
+	return ret;
+}
@@ -0,0 +1,72 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <obs.hpp>
+
+#include "Obs.h"
+#include "Json.h"
+
+namespace Utils {
+	namespace Obs {
+		namespace OutputStatistics {
+			// Samples the frontend's stream, record, replay buffer and virtualcam outputs on a single thread
+			class Handler {
+				typedef std::function<void(std::vector<json>)> UpdateCallback;
+
+			public:
+				Handler(UpdateCallback cb, uint64_t updatePeriod = 1000);
+				~Handler();
+
+			private:
+				enum OutputSlot {
+					OUTPUT_SLOT_STREAM,
+					OUTPUT_SLOT_RECORD,
+					OUTPUT_SLOT_REPLAY_BUFFER,
+					OUTPUT_SLOT_VIRTUALCAM,
+					OUTPUT_SLOT_COUNT,
+				};
+
+				// Previous sample of an output, to derive the bitrate from
+				struct Sample {
+					uint64_t bytes = 0;
+					uint64_t timestamp = 0;
+				};
+
+				UpdateCallback _updateCallback;
+				uint64_t _updatePeriod;
+				std::array<Sample, OUTPUT_SLOT_COUNT> _samples;
+
+				std::mutex _mutex;
+				std::condition_variable _cond;
+				std::atomic<bool> _running;
+				std::thread _updateThread;
+
+				void UpdateThread();
+				json SampleOutput(OutputSlot slot, obs_output_t *output, uint64_t now);
+			};
+		}
+	}
+}
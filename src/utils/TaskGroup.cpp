@@ -0,0 +1,84 @@
+/*
+obs-websocket
+Copyright (C) 2016-2021 Stephane Lepin <stephane.lepin@gmail.com>
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include "TaskGroup.h"
+#include "Compat.h"
+
+Utils::TaskGroup::TaskGroup(QThreadPool *threadPool) : _threadPool(threadPool), _pendingTasks(0) {}
+
+Utils::TaskGroup::~TaskGroup()
+{
+	// Running tasks reference this object. Exceptions were already handed to `Wait()`, or are dropped with the group
+	WaitForTasks();
+}
+
+void Utils::TaskGroup::Run(std::function<void()> task)
+{
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_pendingTasks++;
+	}
+
+	QRunnable *runnable = Utils::Compat::CreateFunctionRunnable([this, task]() {
+		// The task has to be counted as finished even if it throws, otherwise the group can never be waited on
+		std::exception_ptr exception;
+		try {
+			task();
+		} catch (...) {
+			exception = std::current_exception();
+		}
+		TaskFinished(exception);
+	});
+
+	if (_threadPool && _threadPool->tryStart(runnable))
+		return;
+
+	// `tryStart()` does not take ownership on failure
+	runnable->run();
+	delete runnable;
+}
+
+void Utils::TaskGroup::Wait()
+{
+	WaitForTasks();
+
+	std::exception_ptr exception;
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		std::swap(exception, _exception);
+	}
+
+	if (exception)
+		std::rethrow_exception(exception);
+}
+
+void Utils::TaskGroup::WaitForTasks()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_cv.wait(lock, [this] { return _pendingTasks == 0; });
+}
+
+void Utils::TaskGroup::TaskFinished(std::exception_ptr exception)
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	if (exception && !_exception)
+		_exception = exception;
+	if (--_pendingTasks == 0)
+		_cv.notify_all();
+}
@@ -0,0 +1,51 @@
+/*
+obs-websocket
+Copyright (C) 2016-2021 Stephane Lepin <stephane.lepin@gmail.com>
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <QThreadPool>
+
+namespace Utils {
+	// Runs a group of independent tasks on a thread pool and waits for all of them.
+	// Tasks which cannot get a free thread right away run inline on the calling thread, so waiting on the group can
+	// never deadlock, even when called from a thread of the same (saturated) pool.
+	// If a task throws, the other tasks still run to completion, and `Wait()` rethrows the first exception.
+	class TaskGroup {
+	public:
+		TaskGroup(QThreadPool *threadPool);
+		~TaskGroup();
+
+		void Run(std::function<void()> task);
+		void Wait();
+
+	private:
+		void WaitForTasks();
+		void TaskFinished(std::exception_ptr exception);
+
+		QThreadPool *_threadPool;
+		std::mutex _mutex;
+		std::condition_variable _cv;
+		size_t _pendingTasks;
+		std::exception_ptr _exception;
+	};
+}
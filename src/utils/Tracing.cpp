@@ -0,0 +1,203 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "Tracing.h"
+
+// Per thread. At 48 bytes per span, this is about 384KB for every thread which has recorded spans.
+static constexpr size_t RingBufferSize = 8192;
+
+// Written by the owning thread and read by `GetTrace()` as a seqlock. The sequence is odd while the span is written.
+struct TraceSpan {
+	std::atomic<uint64_t> sequence = 0;
+	std::atomic<const char *> name = nullptr;
+	std::atomic<const char *> detail = nullptr;
+	std::atomic<uint64_t> start = 0;
+	std::atomic<uint64_t> end = 0;
+	std::atomic<uint64_t> threadIndex = 0; // Spans of the previous owners of a reused buffer keep their thread
+};
+
+struct ThreadBuffer {
+	std::atomic<uint64_t> threadIndex = 0; // Assigned anew whenever the buffer is handed to a thread
+	uint64_t writeIndex = 0;
+	std::array<TraceSpan, RingBufferSize> spans;
+};
+
+std::atomic<bool> Utils::Tracing::Detail::enabled = false;
+static std::atomic<uint64_t> tracingStartedAt = 0;
+
+static std::mutex buffersMutex;
+static std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+// Buffers of exited threads, which are reused as the thread pool replaces its expired threads
+static std::vector<ThreadBuffer *> freeBuffers;
+static uint64_t nextThreadIndex = 0;
+
+static std::mutex internedMutex;
+static std::unordered_set<std::string> interned;
+
+struct ThreadBufferHandle {
+	ThreadBuffer *buffer = nullptr;
+
+	~ThreadBufferHandle()
+	{
+		if (!buffer)
+			return;
+
+		std::lock_guard<std::mutex> lock(buffersMutex);
+		freeBuffers.push_back(buffer);
+	}
+};
+
+static ThreadBuffer *GetThreadBuffer()
+{
+	static thread_local ThreadBufferHandle handle;
+	if (handle.buffer)
+		return handle.buffer;
+
+	std::lock_guard<std::mutex> lock(buffersMutex);
+	if (!freeBuffers.empty()) {
+		handle.buffer = freeBuffers.back();
+		freeBuffers.pop_back();
+	} else {
+		buffers.push_back(std::make_unique<ThreadBuffer>());
+		handle.buffer = buffers.back().get();
+	}
+	handle.buffer->threadIndex = ++nextThreadIndex;
+
+	return handle.buffer;
+}
+
+void Utils::Tracing::SetEnabled(bool enabled)
+{
+	// Spans of earlier traces are left in the ring buffers and filtered out by their start time
+	if (enabled && !IsEnabled())
+		tracingStartedAt = os_gettime_ns();
+
+	Detail::enabled = enabled;
+}
+
+void Utils::Tracing::End(const char *name, uint64_t start, const char *detail)
+{
+	if (!start)
+		return;
+
+	uint64_t end = os_gettime_ns();
+	ThreadBuffer *buffer = GetThreadBuffer();
+	TraceSpan &span = buffer->spans[buffer->writeIndex++ % RingBufferSize];
+
+	uint64_t sequence = span.sequence.load(std::memory_order_relaxed);
+	span.sequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	span.name.store(name, std::memory_order_relaxed);
+	span.detail.store(detail, std::memory_order_relaxed);
+	span.start.store(start, std::memory_order_relaxed);
+	span.end.store(end, std::memory_order_relaxed);
+	span.threadIndex.store(buffer->threadIndex.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	span.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+const char *Utils::Tracing::Intern(const std::string &detail)
+{
+	// Interned strings are never freed, so each thread may keep its own copy of the lookup to skip the mutex
+	static thread_local std::unordered_map<std::string, const char *> threadInterned;
+	auto it = threadInterned.find(detail);
+	if (it != threadInterned.end())
+		return it->second;
+
+	const char *ret;
+	{
+		std::lock_guard<std::mutex> lock(internedMutex);
+		ret = interned.insert(detail).first->c_str();
+	}
+
+	threadInterned.emplace(detail, ret);
+	return ret;
+}
+
+json Utils::Tracing::GetTrace()
+{
+	uint64_t startedAt = tracingStartedAt;
+
+	// Buffers are never freed, and their spans are read as a seqlock, so only the list of buffers needs the mutex
+	std::vector<ThreadBuffer *> bufferList;
+	{
+		std::lock_guard<std::mutex> lock(buffersMutex);
+		bufferList.reserve(buffers.size());
+		for (auto &buffer : buffers)
+			bufferList.push_back(buffer.get());
+	}
+
+	json traceEvents = json::array();
+	std::set<uint64_t> threadIndexes;
+	for (auto buffer : bufferList) {
+		threadIndexes.insert(buffer->threadIndex.load());
+
+		for (auto &span : buffer->spans) {
+			uint64_t sequence = span.sequence.load(std::memory_order_acquire);
+			if (!sequence || sequence % 2)
+				continue;
+
+			const char *name = span.name.load(std::memory_order_relaxed);
+			const char *detail = span.detail.load(std::memory_order_relaxed);
+			uint64_t start = span.start.load(std::memory_order_relaxed);
+			uint64_t end = span.end.load(std::memory_order_relaxed);
+			uint64_t threadIndex = span.threadIndex.load(std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			// Overwritten while being read
+			if (span.sequence.load(std::memory_order_relaxed) != sequence || start < startedAt)
+				continue;
+
+			json traceEvent;
+			traceEvent["name"] = name;
+			traceEvent["cat"] = "obs-websocket";
+			traceEvent["ph"] = "X";
+			traceEvent["pid"] = 1;
+			traceEvent["tid"] = threadIndex;
+			// Microseconds since tracing was enabled
+			traceEvent["ts"] = (start - startedAt) / 1000.0;
+			traceEvent["dur"] = (end - start) / 1000.0;
+			if (detail)
+				traceEvent["args"]["detail"] = detail;
+			traceEvents.push_back(traceEvent);
+			threadIndexes.insert(threadIndex);
+		}
+	}
+
+	for (uint64_t threadIndex : threadIndexes) {
+		json threadName;
+		threadName["name"] = "thread_name";
+		threadName["ph"] = "M";
+		threadName["pid"] = 1;
+		threadName["tid"] = threadIndex;
+		threadName["args"]["name"] = "obs-websocket thread " + std::to_string(threadIndex);
+		traceEvents.push_back(threadName);
+	}
+
+	json ret;
+	ret["traceEvents"] = traceEvents;
+	ret["displayTimeUnit"] = "ms";
+	return ret;
+}
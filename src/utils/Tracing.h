@@ -0,0 +1,84 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <util/platform.h>
+#include <util/profiler.h>
+
+#include "Json.h"
+
+namespace Utils {
+	namespace Tracing {
+		namespace Detail {
+			extern std::atomic<bool> enabled;
+		}
+
+		inline bool IsEnabled()
+		{
+			return Detail::enabled.load(std::memory_order_relaxed);
+		}
+		void SetEnabled(bool enabled);
+
+		// Returns the start time of a span, or 0 while tracing is disabled
+		inline uint64_t Begin()
+		{
+			return IsEnabled() ? os_gettime_ns() : 0;
+		}
+		// Records a span from `start` until now into the ring buffer of the calling thread. Spans only store pointers,
+		// so `name` must be a string literal and `detail` either a string literal or interned.
+		void End(const char *name, uint64_t start, const char *detail = nullptr);
+		const char *Intern(const std::string &detail);
+
+		// Records a span for its scope, which also shows up under `name` in the snapshots of the OBS profiler
+		class Span {
+		public:
+			inline Span(const char *name, const char *detail = nullptr) : _name(name), _detail(detail), _start(Begin())
+			{
+				if (_start)
+					profile_start(_name);
+			}
+			inline Span(const char *name, const std::string &detail)
+				: Span(name, IsEnabled() ? Intern(detail) : nullptr)
+			{
+			}
+			inline ~Span()
+			{
+				if (!_start)
+					return;
+
+				profile_end(_name);
+				End(_name, _start, _detail);
+			}
+
+			Span(const Span &) = delete;
+			Span &operator=(const Span &) = delete;
+
+		private:
+			const char *_name;
+			const char *_detail;
+			uint64_t _start;
+		};
+
+		// Spans recorded since tracing was last enabled, in the Chrome trace event format (also read by Perfetto)
+		json GetTrace();
+	}
+}
@@ -0,0 +1,118 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include <QDateTime>
+#include <util/platform.h>
+
+#include "TrafficCapture.h"
+#include "../obs-websocket.h"
+
+static const uint32_t CaptureVersion = 1;
+
+std::atomic<bool> Utils::TrafficCapture::Detail::active = false;
+
+static std::mutex captureMutex;
+static std::ofstream captureFile;
+static uint64_t captureStartedAt = 0;
+static uint64_t nextSessionId = 1;
+static std::unordered_map<const void *, uint64_t> sessionIds;
+
+// Must be called with `captureMutex` held
+static void WriteLine(uint64_t sessionId, const char *kind, json &&line)
+{
+	line["time"] = (os_gettime_ns() - captureStartedAt) / 1000;
+	line["session"] = sessionId;
+	line["kind"] = kind;
+	captureFile << line.dump() << '\n';
+}
+
+bool Utils::TrafficCapture::Start(const std::string &filePath)
+{
+	std::lock_guard<std::mutex> lock(captureMutex);
+	if (IsActive())
+		return false;
+
+	captureFile.open(filePath, std::ios::out | std::ios::trunc);
+	if (!captureFile.is_open()) {
+		blog(LOG_WARNING, "[Utils::TrafficCapture::Start] Failed to open `%s` for writing.", filePath.c_str());
+		return false;
+	}
+
+	json header;
+	header["captureVersion"] = CaptureVersion;
+	header["startedAt"] = QDateTime::currentMSecsSinceEpoch();
+	captureFile << header.dump() << '\n';
+
+	captureStartedAt = os_gettime_ns();
+	Detail::active = true;
+
+	blog(LOG_INFO, "[Utils::TrafficCapture::Start] Capturing WebSocket traffic to `%s`.", filePath.c_str());
+	return true;
+}
+
+void Utils::TrafficCapture::Stop()
+{
+	std::lock_guard<std::mutex> lock(captureMutex);
+	if (!IsActive())
+		return;
+
+	Detail::active = false;
+	captureFile.close();
+	sessionIds.clear();
+}
+
+void Utils::TrafficCapture::RecordOpen(const void *session, const std::string &remoteAddress)
+{
+	std::lock_guard<std::mutex> lock(captureMutex);
+	if (!IsActive())
+		return;
+
+	uint64_t sessionId = nextSessionId++;
+	sessionIds[session] = sessionId;
+	WriteLine(sessionId, "open", {{"remoteAddress", remoteAddress}});
+}
+
+void Utils::TrafficCapture::RecordMessage(const void *session, Direction direction, const json &message)
+{
+	json line;
+	line["message"] = message;
+	// The replay tool authenticates by itself, and credentials of the capture have no business in the file
+	if (message.is_object() && message.contains("d"))
+		Utils::Json::RedactSecrets(line["message"]["d"]);
+
+	std::lock_guard<std::mutex> lock(captureMutex);
+	auto it = sessionIds.find(session);
+	if (!IsActive() || it == sessionIds.end())
+		return;
+
+	WriteLine(it->second, direction == Inbound ? "inbound" : "outbound", std::move(line));
+}
+
+void Utils::TrafficCapture::RecordClose(const void *session)
+{
+	std::lock_guard<std::mutex> lock(captureMutex);
+	auto it = sessionIds.find(session);
+	if (!IsActive() || it == sessionIds.end())
+		return;
+
+	WriteLine(it->second, "close", json::object());
+	sessionIds.erase(it);
+}
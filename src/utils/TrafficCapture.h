@@ -0,0 +1,51 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <atomic>
+#include <string>
+
+#include "Json.h"
+
+// Captures the messages of all WebSocket sessions into a JSON lines file, for replaying them with the replay tool in `tools/`.
+// Meant for test setups: every message is serialized and written while holding a lock.
+namespace Utils {
+	namespace TrafficCapture {
+		namespace Detail {
+			extern std::atomic<bool> active;
+		}
+
+		enum Direction {
+			Inbound,
+			Outbound,
+		};
+
+		bool Start(const std::string &filePath);
+		void Stop();
+
+		inline bool IsActive()
+		{
+			return Detail::active.load(std::memory_order_relaxed);
+		}
+		// `session` only identifies the session, and may be reused once it has been closed
+		void RecordOpen(const void *session, const std::string &remoteAddress);
+		void RecordMessage(const void *session, Direction direction, const json &message);
+		void RecordClose(const void *session);
+	}
+}
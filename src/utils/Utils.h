@@ -25,3 +25,4 @@ with this program. If not, see <https://www.gnu.org/licenses/>
 #include "Obs_VolumeMeter.h"
 #include "Platform.h"
 #include "Compat.h"
+#include "TaskGroup.h"
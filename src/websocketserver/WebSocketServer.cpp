@@ -24,13 +24,18 @@ with this program. If not, see <https://www.gnu.org/licenses/>
 #include <obs-frontend-api.h>
 
 #include "WebSocketServer.h"
+#include "../requesthandler/RequestBatchHandler.h"
+#include "../requesthandler/ControlStreamHandler.h"
 #include "../obs-websocket.h"
 #include "../Config.h"
 #include "../utils/Crypto.h"
 #include "../utils/Platform.h"
 #include "../utils/Compat.h"
+#include "../utils/Metrics.h"
+#include "../utils/Tracing.h"
+#include "../utils/TrafficCapture.h"
 
-WebSocketServer::WebSocketServer() : QObject(nullptr)
+WebSocketServer::WebSocketServer() : QObject(nullptr), _batchScheduler(_threadPool)
 {
 	_server.get_alog().clear_channels(websocketpp::log::alevel::all);
 	_server.get_elog().clear_channels(websocketpp::log::elevel::all);
@@ -46,6 +51,7 @@ WebSocketServer::WebSocketServer() : QObject(nullptr)
 	_server.set_close_handler(websocketpp::lib::bind(&WebSocketServer::onClose, this, websocketpp::lib::placeholders::_1));
 	_server.set_message_handler(websocketpp::lib::bind(&WebSocketServer::onMessage, this, websocketpp::lib::placeholders::_1,
 							   websocketpp::lib::placeholders::_2));
+	_server.set_http_handler(websocketpp::lib::bind(&WebSocketServer::onHttp, this, websocketpp::lib::placeholders::_1));
 }
 
 WebSocketServer::~WebSocketServer()
@@ -152,6 +158,9 @@ void WebSocketServer::Stop()
 	}
 	lock.unlock();
 
+	// Suspended request batches would otherwise resume after the server has stopped
+	_batchScheduler.CancelAll();
+
 	_threadPool.waitForDone();
 
 	// This can delay the thread that it is running on. Bad but kinda required.
@@ -278,18 +287,13 @@ void WebSocketServer::onOpen(websocketpp::connection_hdl hdl)
 
 	blog_debug("[WebSocketServer::onOpen] Sending Op 0 (Hello) message:\n%s", helloMessage.dump(2).c_str());
 
+	Utils::Metrics::GetRegistry().sessions++;
+
+	if (Utils::TrafficCapture::IsActive())
+		Utils::TrafficCapture::RecordOpen(session.get(), session->RemoteAddress());
+
 	// Send object to client
-	websocketpp::lib::error_code errorCode;
-	auto sessionEncoding = session->Encoding();
-	if (sessionEncoding == WebSocketEncoding::Json) {
-		std::string helloMessageJson = helloMessage.dump();
-		_server.send(hdl, helloMessageJson, websocketpp::frame::opcode::text, errorCode);
-	} else if (sessionEncoding == WebSocketEncoding::MsgPack) {
-		auto msgPackData = json::to_msgpack(helloMessage);
-		std::string messageMsgPack(msgPackData.begin(), msgPackData.end());
-		_server.send(hdl, messageMsgPack, websocketpp::frame::opcode::binary, errorCode);
-	}
-	session->IncrementOutgoingMessages();
+	SendSessionMessage(hdl, session, helloMessage);
 }
 
 void WebSocketServer::onClose(websocketpp::connection_hdl hdl)
@@ -308,6 +312,21 @@ void WebSocketServer::onClose(websocketpp::connection_hdl hdl)
 	_sessions.erase(hdl);
 	lock.unlock();
 
+	Utils::Metrics::GetRegistry().sessions--;
+
+	if (Utils::TrafficCapture::IsActive())
+		Utils::TrafficCapture::RecordClose(session.get());
+
+	// Nobody is left to receive the results of the batches which are still waiting for their cue
+	RequestBatchHandler::CancelScheduledRequestBatches(_batchScheduler, session);
+
+	ControlStreamHandler::CloseControlStream(session);
+
+	// Executions which are still running hold their own reference to the prepared batch
+	std::unique_lock<std::mutex> preparedBatchesLock(session->PreparedBatchesMutex);
+	session->PreparedBatches.clear();
+	preparedBatchesLock.unlock();
+
 	// If client was identified, announce unsubscription
 	if (isIdentified && _clientSubscriptionCallback)
 		_clientSubscriptionCallback(false, eventSubscriptions);
@@ -348,7 +367,19 @@ void WebSocketServer::onMessage(websocketpp::connection_hdl hdl,
 {
 	auto opCode = message->get_opcode();
 	std::string payload = message->get_payload();
+
+	auto &metrics = Utils::Metrics::GetRegistry();
+	metrics.messagesReceived++;
+	metrics.bytesReceived += payload.size();
+	metrics.messageQueueDepth++;
+
+	uint64_t receivedAt = os_gettime_ns();
 	_threadPool.start(Utils::Compat::CreateFunctionRunnable([=]() {
+		Utils::Metrics::GetRegistry().messageQueueDepth--;
+		if (Utils::Tracing::IsEnabled())
+			Utils::Tracing::End("obs_websocket_message_queued", receivedAt);
+		Utils::Tracing::Span span("obs_websocket_message_processing");
+
 		std::unique_lock<std::mutex> lock(_sessionMutex);
 		SessionPtr session;
 		try {
@@ -364,6 +395,7 @@ void WebSocketServer::onMessage(websocketpp::connection_hdl hdl,
 		json incomingMessage;
 
 		// Check for invalid opcode and decode
+		uint64_t decodeStart = Utils::Tracing::Begin();
 		websocketpp::lib::error_code errorCode;
 		uint8_t sessionEncoding = session->Encoding();
 		if (sessionEncoding == WebSocketEncoding::Json) {
@@ -398,6 +430,11 @@ void WebSocketServer::onMessage(websocketpp::connection_hdl hdl,
 			}
 		}
 
+		Utils::Tracing::End("obs_websocket_message_decode", decodeStart);
+
+		if (Utils::TrafficCapture::IsActive())
+			Utils::TrafficCapture::RecordMessage(session.get(), Utils::TrafficCapture::Inbound, incomingMessage);
+
 		blog_debug("[WebSocketServer::onMessage] Incoming message (decoded):\n%s", incomingMessage.dump(2).c_str());
 
 		ProcessResult ret;
@@ -432,7 +469,7 @@ void WebSocketServer::onMessage(websocketpp::connection_hdl hdl,
 			goto skipProcessing;
 		}
 
-		ProcessMessage(session, ret, incomingMessage["op"], incomingMessage["d"]);
+		ProcessMessage(hdl, session, ret, receivedAt, incomingMessage["op"], incomingMessage["d"]);
 
 	skipProcessing:
 		if (ret.closeCode != WebSocketCloseCode::DontClose) {
@@ -441,23 +478,90 @@ void WebSocketServer::onMessage(websocketpp::connection_hdl hdl,
 			return;
 		}
 
-		if (!ret.result.is_null()) {
-			websocketpp::lib::error_code errorCode;
-			if (sessionEncoding == WebSocketEncoding::Json) {
-				std::string helloMessageJson = ret.result.dump();
-				_server.send(hdl, helloMessageJson, websocketpp::frame::opcode::text, errorCode);
-			} else if (sessionEncoding == WebSocketEncoding::MsgPack) {
-				auto msgPackData = json::to_msgpack(ret.result);
-				std::string messageMsgPack(msgPackData.begin(), msgPackData.end());
-				_server.send(hdl, messageMsgPack, websocketpp::frame::opcode::binary, errorCode);
-			}
-			session->IncrementOutgoingMessages();
-
-			blog_debug("[WebSocketServer::onMessage] Outgoing message:\n%s", ret.result.dump(2).c_str());
+		if (ret.result.is_null())
+			return;
 
-			if (errorCode)
-				blog(LOG_WARNING, "[WebSocketServer::onMessage] Sending message to client failed: %s",
-				     errorCode.message().c_str());
+		// As late as possible, so that the processing of the Ping is not mistaken for network time. Sampled together, so
+		// that clients can map the monotonic timestamps of other messages to wall clock time.
+		if (ret.result["op"] == WebSocketOpCode::Pong) {
+			ret.result["d"]["sentAt"] = os_gettime_ns();
+			ret.result["d"]["wallClockMicros"] = std::chrono::duration_cast<std::chrono::microseconds>(
+								     std::chrono::system_clock::now().time_since_epoch())
+								     .count();
 		}
+
+		SendSessionMessage(hdl, session, ret.result);
 	}));
 }
+
+void WebSocketServer::onHttp(websocketpp::connection_hdl hdl)
+{
+	auto conn = _server.get_con_from_hdl(hdl);
+
+	// Plain HTTP requests are only used for scraping metrics, which must be enabled in the config
+	auto conf = GetConfig();
+	if (!conf || !conf->MetricsEndpointEnabled || conn->get_request().get_method() != "GET" ||
+	    conn->get_resource() != "/metrics") {
+		conn->set_status(websocketpp::http::status_code::not_found);
+		return;
+	}
+
+	// Scrapers authenticate with the server password as a bearer token
+	if (conf->AuthRequired &&
+	    !Utils::Crypto::ConstantTimeEquals(conn->get_request_header("Authorization"), "Bearer " + conf->ServerPassword)) {
+		conn->set_status(websocketpp::http::status_code::unauthorized);
+		conn->replace_header("WWW-Authenticate", "Bearer");
+		return;
+	}
+
+	conn->set_status(websocketpp::http::status_code::ok);
+	conn->replace_header("Content-Type", "text/plain; version=0.0.4");
+	conn->set_body(Utils::Metrics::ToPrometheusText());
+}
+
+void WebSocketServer::RecordSend(size_t messageSize, const websocketpp::lib::error_code &errorCode)
+{
+	auto &metrics = Utils::Metrics::GetRegistry();
+	if (errorCode) {
+		metrics.failedSends++;
+		return;
+	}
+
+	metrics.messagesSent++;
+	metrics.bytesSent += messageSize;
+}
+
+// Thread-safe. Encodes the message using the session's encoding.
+void WebSocketServer::SendSessionMessage(websocketpp::connection_hdl hdl, SessionPtr session, const json &message)
+{
+	websocketpp::lib::error_code errorCode;
+	size_t messageSize = 0;
+	uint8_t sessionEncoding = session->Encoding();
+	if (sessionEncoding == WebSocketEncoding::Json) {
+		uint64_t serializeStart = Utils::Tracing::Begin();
+		std::string messageJson = message.dump();
+		Utils::Tracing::End("obs_websocket_message_serialization", serializeStart);
+		messageSize = messageJson.size();
+		Utils::Tracing::Span span("obs_websocket_message_send");
+		_server.send(hdl, messageJson, websocketpp::frame::opcode::text, errorCode);
+	} else if (sessionEncoding == WebSocketEncoding::MsgPack) {
+		uint64_t serializeStart = Utils::Tracing::Begin();
+		auto msgPackData = json::to_msgpack(message);
+		std::string messageMsgPack(msgPackData.begin(), msgPackData.end());
+		Utils::Tracing::End("obs_websocket_message_serialization", serializeStart);
+		messageSize = messageMsgPack.size();
+		Utils::Tracing::Span span("obs_websocket_message_send");
+		_server.send(hdl, messageMsgPack, websocketpp::frame::opcode::binary, errorCode);
+	}
+	session->IncrementOutgoingMessages();
+	RecordSend(messageSize, errorCode);
+
+	if (!errorCode && Utils::TrafficCapture::IsActive())
+		Utils::TrafficCapture::RecordMessage(session.get(), Utils::TrafficCapture::Outbound, message);
+
+	blog_debug("[WebSocketServer::SendSessionMessage] Outgoing message:\n%s", message.dump(2).c_str());
+
+	if (errorCode)
+		blog(LOG_WARNING, "[WebSocketServer::SendSessionMessage] Sending message to client failed: %s",
+		     errorCode.message().c_str());
+}
@@ -30,6 +30,7 @@ with this program. If not, see <https://www.gnu.org/licenses/>
 #include "rpc/WebSocketSession.h"
 #include "types/WebSocketCloseCode.h"
 #include "types/WebSocketOpCode.h"
+#include "../requesthandler/RequestBatchScheduler.h"
 #include "../requesthandler/rpc/Request.h"
 #include "../utils/Json.h"
 #include "plugin-macros.generated.h"
@@ -61,6 +62,7 @@ public:
 	inline bool IsListening() { return _server.is_listening(); }
 	std::vector<WebSocketSessionState> GetWebSocketSessions();
 	inline QThreadPool *GetThreadPool() { return &_threadPool; }
+	inline RequestBatchScheduler &GetBatchScheduler() { return _batchScheduler; }
 
 	// Callback for when a client subscribes or unsubscribes. `true` for sub, `false` for unsub
 	typedef std::function<void(bool, uint64_t)> ClientSubscriptionCallback; // bool type, uint64_t eventSubscriptions
@@ -83,11 +85,17 @@ private:
 	void onOpen(websocketpp::connection_hdl hdl);
 	void onClose(websocketpp::connection_hdl hdl);
 	void onMessage(websocketpp::connection_hdl hdl, websocketpp::server<websocketpp::config::asio>::message_ptr message);
+	void onHttp(websocketpp::connection_hdl hdl);
+
+	void SendSessionMessage(websocketpp::connection_hdl hdl, SessionPtr session, const json &message);
+	static void RecordSend(size_t messageSize, const websocketpp::lib::error_code &errorCode);
 
 	static void SetSessionParameters(SessionPtr session, WebSocketServer::ProcessResult &ret, const json &payloadData);
-	void ProcessMessage(SessionPtr session, ProcessResult &ret, WebSocketOpCode::WebSocketOpCode opCode, json &payloadData);
+	void ProcessMessage(websocketpp::connection_hdl hdl, SessionPtr session, ProcessResult &ret, uint64_t receivedAt,
+			    WebSocketOpCode::WebSocketOpCode opCode, json &payloadData);
 
 	QThreadPool _threadPool;
+	RequestBatchScheduler _batchScheduler;
 
 	std::thread _serverThread;
 	websocketpp::server<websocketpp::config::asio> _server;
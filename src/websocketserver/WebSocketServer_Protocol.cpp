@@ -23,37 +23,23 @@ with this program. If not, see <https://www.gnu.org/licenses/>
 #include "WebSocketServer.h"
 #include "../requesthandler/RequestHandler.h"
 #include "../requesthandler/RequestBatchHandler.h"
+#include "../requesthandler/ControlStreamHandler.h"
+#include "../requesthandler/SlowRequestLog.h"
 #include "../obs-websocket.h"
 #include "../Config.h"
 #include "../utils/Crypto.h"
 #include "../utils/Platform.h"
 #include "../utils/Compat.h"
+#include "../utils/FlightRecorder.h"
+#include "../utils/Metrics.h"
+#include "../utils/Tracing.h"
+#include "../utils/TrafficCapture.h"
 
 static bool IsSupportedRpcVersion(uint8_t requestedVersion)
 {
 	return (requestedVersion == CURRENT_RPC_VERSION);
 }
 
-static json ConstructRequestResult(RequestResult requestResult, const json &requestJson)
-{
-	json ret;
-
-	ret["requestType"] = requestJson["requestType"];
-
-	if (requestJson.contains("requestId") && !requestJson["requestId"].is_null())
-		ret["requestId"] = requestJson["requestId"];
-
-	ret["requestStatus"] = {{"result", requestResult.StatusCode == RequestStatus::Success}, {"code", requestResult.StatusCode}};
-
-	if (!requestResult.Comment.empty())
-		ret["requestStatus"]["comment"] = requestResult.Comment;
-
-	if (requestResult.ResponseData.is_object())
-		ret["responseData"] = requestResult.ResponseData;
-
-	return ret;
-}
-
 void WebSocketServer::SetSessionParameters(SessionPtr session, ProcessResult &ret, const json &payloadData)
 {
 	if (payloadData.contains("eventSubscriptions")) {
@@ -64,10 +50,113 @@ void WebSocketServer::SetSessionParameters(SessionPtr session, ProcessResult &re
 		}
 		session->SetEventSubscriptions(payloadData["eventSubscriptions"]);
 	}
+
+	if (payloadData.contains("controlStream")) {
+		if (!payloadData["controlStream"].is_boolean()) {
+			ret.closeCode = WebSocketCloseCode::InvalidDataFieldType;
+			ret.closeReason = "Your `controlStream` is not a boolean.";
+			return;
+		}
+		session->SetControlStreamEnabled(payloadData["controlStream"]);
+	}
+
+	if (payloadData.contains("timing")) {
+		if (!payloadData["timing"].is_boolean()) {
+			ret.closeCode = WebSocketCloseCode::InvalidDataFieldType;
+			ret.closeReason = "Your `timing` is not a boolean.";
+			return;
+		}
+		session->SetTimingEnabled(payloadData["timing"]);
+	}
+}
+
+static bool ParseRequestBatchSchedule(const json &scheduleJson, RequestBatchHandler::Schedule &schedule,
+				      WebSocketCloseCode::WebSocketCloseCode &closeCode, std::string &closeReason)
+{
+	if (!scheduleJson.is_object()) {
+		closeCode = WebSocketCloseCode::InvalidDataFieldType;
+		closeReason = "Your `schedule` is not an object.";
+		return false;
+	}
+
+	size_t cueCount = 0;
+
+	if (scheduleJson.contains("frame")) {
+		if (!scheduleJson["frame"].is_number_unsigned()) {
+			closeCode = WebSocketCloseCode::InvalidDataFieldType;
+			closeReason = "Your `schedule.frame` is not a positive number.";
+			return false;
+		}
+
+		schedule.cue = RequestBatchHandler::Schedule::Frame;
+		schedule.frame = scheduleJson["frame"];
+		cueCount++;
+	}
+
+	if (scheduleJson.contains("timestamp")) {
+		if (!scheduleJson["timestamp"].is_number_integer()) {
+			closeCode = WebSocketCloseCode::InvalidDataFieldType;
+			closeReason = "Your `schedule.timestamp` is not an integer.";
+			return false;
+		}
+
+		schedule.cue = RequestBatchHandler::Schedule::Timestamp;
+		schedule.timestamp = scheduleJson["timestamp"];
+		cueCount++;
+	}
+
+	if (scheduleJson.contains("mediaCursor")) {
+		if (!scheduleJson["mediaCursor"].is_number_integer()) {
+			closeCode = WebSocketCloseCode::InvalidDataFieldType;
+			closeReason = "Your `schedule.mediaCursor` is not an integer.";
+			return false;
+		}
+
+		OBSSourceAutoRelease mediaInput;
+		if (scheduleJson.contains("mediaInputUuid") && scheduleJson["mediaInputUuid"].is_string()) {
+			std::string mediaInputUuid = scheduleJson["mediaInputUuid"];
+			mediaInput = obs_get_source_by_uuid(mediaInputUuid.c_str());
+		} else if (scheduleJson.contains("mediaInputName") && scheduleJson["mediaInputName"].is_string()) {
+			std::string mediaInputName = scheduleJson["mediaInputName"];
+			mediaInput = obs_get_source_by_name(mediaInputName.c_str());
+		}
+
+		if (!mediaInput || obs_source_get_type(mediaInput) != OBS_SOURCE_TYPE_INPUT) {
+			closeCode = WebSocketCloseCode::InvalidDataFieldValue;
+			closeReason = "The media input of your `schedule` was not found.";
+			return false;
+		}
+
+		schedule.cue = RequestBatchHandler::Schedule::MediaCursor;
+		schedule.mediaInput = obs_source_get_weak_source(mediaInput);
+		schedule.cursor = scheduleJson["mediaCursor"];
+		cueCount++;
+	}
+
+	if (scheduleJson.contains("transitionCursor")) {
+		if (!scheduleJson["transitionCursor"].is_number_integer()) {
+			closeCode = WebSocketCloseCode::InvalidDataFieldType;
+			closeReason = "Your `schedule.transitionCursor` is not an integer.";
+			return false;
+		}
+
+		schedule.cue = RequestBatchHandler::Schedule::TransitionCursor;
+		schedule.cursor = scheduleJson["transitionCursor"];
+		cueCount++;
+	}
+
+	if (cueCount != 1) {
+		closeCode = WebSocketCloseCode::InvalidDataFieldValue;
+		closeReason =
+			"Your `schedule` must contain exactly one of `frame`, `timestamp`, `mediaCursor` or `transitionCursor`.";
+		return false;
+	}
+
+	return true;
 }
 
-void WebSocketServer::ProcessMessage(SessionPtr session, WebSocketServer::ProcessResult &ret,
-				     WebSocketOpCode::WebSocketOpCode opCode, json &payloadData)
+void WebSocketServer::ProcessMessage(websocketpp::connection_hdl hdl, SessionPtr session, WebSocketServer::ProcessResult &ret,
+				     uint64_t receivedAt, WebSocketOpCode::WebSocketOpCode opCode, json &payloadData)
 {
 	if (!payloadData.is_object()) {
 		if (payloadData.is_null()) {
@@ -166,6 +255,10 @@ void WebSocketServer::ProcessMessage(SessionPtr session, WebSocketServer::Proces
 
 		ret.result["op"] = WebSocketOpCode::Identified;
 		ret.result["d"]["negotiatedRpcVersion"] = session->RpcVersion();
+		if (session->ControlStreamEnabled())
+			ret.result["d"]["controlStream"] = true;
+		if (session->TimingEnabled())
+			ret.result["d"]["timing"] = true;
 	}
 		return;
 	case WebSocketOpCode::Reidentify: { // Reidentify
@@ -185,6 +278,10 @@ void WebSocketServer::ProcessMessage(SessionPtr session, WebSocketServer::Proces
 
 		ret.result["op"] = WebSocketOpCode::Identified;
 		ret.result["d"]["negotiatedRpcVersion"] = session->RpcVersion();
+		if (session->ControlStreamEnabled())
+			ret.result["d"]["controlStream"] = true;
+		if (session->TimingEnabled())
+			ret.result["d"]["timing"] = true;
 	}
 		return;
 	case WebSocketOpCode::Request: { // Request
@@ -208,13 +305,44 @@ void WebSocketServer::ProcessMessage(SessionPtr session, WebSocketServer::Proces
 		}
 
 		std::string requestType = payloadData["requestType"];
+
+		if (Utils::FlightRecorder::IsActive()) {
+			json record = {{"remoteAddress", session->RemoteAddress()},
+				       {"requestType", requestType},
+				       {"requestId", payloadData["requestId"]},
+				       {"requestData", payloadData["requestData"]}};
+			Utils::Json::RedactSecrets(record);
+			Utils::FlightRecorder::Record(FlightRecorderFormat::Request, record);
+		}
+
 		RequestResult requestResult;
+		uint64_t startedAt = 0;
+		uint64_t finishedAt = 0;
 		if (_obsReady) {
 			json requestData = payloadData["requestData"];
 			Request request(requestType, requestData);
 
 			RequestHandler requestHandler(session);
+			json requestId = payloadData["requestId"];
+			auto sendResponseChunk = [&](size_t chunkIndex, const json &chunkData) {
+				json chunkMessage;
+				chunkMessage["op"] = WebSocketOpCode::RequestResponse;
+				chunkMessage["d"]["requestType"] = requestType;
+				chunkMessage["d"]["requestId"] = requestId;
+				// Only the final response reports the result of the request
+				chunkMessage["d"]["requestStatus"] = {{"result", false}, {"code", RequestStatus::ResponseChunk}};
+				chunkMessage["d"]["responseChunk"] = chunkIndex;
+				chunkMessage["d"]["responseData"] = chunkData;
+				SendSessionMessage(hdl, session, chunkMessage);
+			};
+			requestHandler.SetResponseChunkCallback(sendResponseChunk);
+
+			startedAt = os_gettime_ns();
+			uint32_t laggedFrames = obs_get_lagged_frames();
 			requestResult = requestHandler.ProcessRequest(request);
+			finishedAt = os_gettime_ns();
+			SlowRequestLog::Report(session, request, requestResult,
+					       {receivedAt, startedAt, finishedAt, obs_get_lagged_frames() - laggedFrames});
 		} else {
 			requestResult = RequestResult::Error(RequestStatus::NotReady, "OBS is not ready to perform the request.");
 		}
@@ -222,14 +350,28 @@ void WebSocketServer::ProcessMessage(SessionPtr session, WebSocketServer::Proces
 		json resultPayloadData;
 		resultPayloadData["requestType"] = requestType;
 		resultPayloadData["requestId"] = payloadData["requestId"];
-		resultPayloadData["requestStatus"] = {{"result", requestResult.StatusCode == RequestStatus::Success},
-						      {"code", requestResult.StatusCode}};
+		resultPayloadData["requestStatus"] = {{"result", requestResult.Succeeded()}, {"code", requestResult.StatusCode}};
 		if (!requestResult.Comment.empty())
 			resultPayloadData["requestStatus"]["comment"] = requestResult.Comment;
 		if (requestResult.ResponseData.is_object())
 			resultPayloadData["responseData"] = requestResult.ResponseData;
+		if (session->TimingEnabled()) {
+			resultPayloadData["timing"]["receivedAt"] = receivedAt;
+			if (startedAt) {
+				resultPayloadData["timing"]["startedAt"] = startedAt;
+				resultPayloadData["timing"]["finishedAt"] = finishedAt;
+			}
+		}
 		ret.result["op"] = WebSocketOpCode::RequestResponse;
 		ret.result["d"] = resultPayloadData;
+
+		// Response data can be large (screenshots), so only its status is recorded
+		if (Utils::FlightRecorder::IsActive())
+			Utils::FlightRecorder::Record(FlightRecorderFormat::RequestResponse,
+						      {{"remoteAddress", session->RemoteAddress()},
+						       {"requestType", requestType},
+						       {"requestId", resultPayloadData["requestId"]},
+						       {"requestStatus", resultPayloadData["requestStatus"]}});
 	}
 		return;
 	case WebSocketOpCode::RequestBatch: { // RequestBatch
@@ -256,14 +398,6 @@ void WebSocketServer::ProcessMessage(SessionPtr session, WebSocketServer::Proces
 				return;
 			}
 
-			// The thread pool must support 2 or more threads else parallel requests will deadlock.
-			if (requestedExecutionType == RequestBatchExecutionType::Parallel && _threadPool.maxThreadCount() < 2) {
-				ret.closeCode = WebSocketCloseCode::UnsupportedFeature;
-				ret.closeReason =
-					"Parallel request batch processing is not available on this system due to limited core count.";
-				return;
-			}
-
 			executionType = (RequestBatchExecutionType::RequestBatchExecutionType)requestedExecutionType;
 		}
 
@@ -292,6 +426,22 @@ void WebSocketServer::ProcessMessage(SessionPtr session, WebSocketServer::Proces
 			haltOnFailure = payloadData["haltOnFailure"];
 		}
 
+		bool streamResults = false;
+		if (payloadData.contains("streamResults") && !payloadData["streamResults"].is_null()) {
+			if (!payloadData["streamResults"].is_boolean()) {
+				ret.closeCode = WebSocketCloseCode::InvalidDataFieldType;
+				ret.closeReason = "Your `streamResults` is not a boolean.";
+				return;
+			}
+
+			streamResults = payloadData["streamResults"];
+		}
+
+		bool hasSchedule = payloadData.contains("schedule") && !payloadData["schedule"].is_null();
+		RequestBatchHandler::Schedule schedule;
+		if (hasSchedule && !ParseRequestBatchSchedule(payloadData["schedule"], schedule, ret.closeCode, ret.closeReason))
+			return;
+
 		if (!payloadData.contains("requests")) {
 			ret.closeCode = WebSocketCloseCode::MissingDataField;
 			ret.closeReason = "Your payload data is missing a `requests`.";
@@ -304,45 +454,158 @@ void WebSocketServer::ProcessMessage(SessionPtr session, WebSocketServer::Proces
 			return;
 		}
 
-		std::vector<json> requests = payloadData["requests"];
-		std::vector<RequestResult> resultsVector;
+		json requestId = payloadData["requestId"];
+
+		if (Utils::FlightRecorder::IsActive()) {
+			json batch = payloadData;
+			Utils::Json::RedactSecrets(batch);
+			Utils::FlightRecorder::Record(FlightRecorderFormat::RequestBatch,
+						      {{"remoteAddress", session->RemoteAddress()}, {"batch", batch}});
+		}
+
+		// Take over the requests instead of copying them. Only `requestType` and `requestId` remain for the results.
+		auto requests = std::make_shared<json>(std::move(payloadData["requests"]));
+		for (auto &requestJson : *requests) {
+			if (!requestJson["requestType"].is_string())
+				requestJson["requestType"] =
+					""; // Workaround for what would otherwise be extensive additional logic for a rare edge case
+		}
+
+		// The response is sent once the batch has finished, which may be long after this message has been processed
+		auto sendResults = [this, hdl, session, requestId, requests, streamResults, receivedAt](
+					   std::vector<RequestResult> &&resultsVector, size_t resultCount, json &&statistics,
+					   uint64_t startedAt) {
+			json response;
+			response["op"] = WebSocketOpCode::RequestBatchResponse;
+			response["d"]["requestId"] = requestId;
+			if (!streamResults || !resultsVector.empty()) {
+				json &results = response["d"]["results"] = json::array();
+				for (size_t i = 0; i < resultCount; i++)
+					results.push_back(RequestBatchHandler::ConstructRequestResult(std::move(resultsVector[i]),
+												      (*requests)[i]));
+			} else {
+				// Streamed results were already sent
+				response["d"]["resultCount"] = resultCount;
+			}
+			if (!statistics.is_null())
+				response["d"]["statistics"] = std::move(statistics);
+			if (session->TimingEnabled()) {
+				response["d"]["timing"]["receivedAt"] = receivedAt;
+				if (startedAt)
+					response["d"]["timing"]["startedAt"] = startedAt;
+				response["d"]["timing"]["finishedAt"] = os_gettime_ns();
+			}
+
+			if (Utils::FlightRecorder::IsActive()) {
+				json requestStatuses = json::array();
+				if (response["d"].contains("results")) {
+					for (auto &result : response["d"]["results"])
+						requestStatuses.push_back(result["requestStatus"]);
+				}
+				Utils::FlightRecorder::Record(FlightRecorderFormat::RequestBatchResponse,
+							      {{"remoteAddress", session->RemoteAddress()},
+							       {"requestId", requestId},
+							       {"requestStatuses", requestStatuses}});
+			}
+
+			SendSessionMessage(hdl, session, response);
+		};
+
+		RequestBatchHandler::ResultCallback sendResult;
+		if (streamResults) {
+			sendResult = [this, hdl, session, requestId, requests](size_t index, RequestResult &&requestResult) {
+				json message;
+				message["op"] = WebSocketOpCode::RequestBatchPartialResponse;
+				message["d"]["requestId"] = requestId;
+				message["d"]["index"] = index;
+				message["d"]["result"] =
+					RequestBatchHandler::ConstructRequestResult(std::move(requestResult), (*requests)[index]);
+				SendSessionMessage(hdl, session, message);
+			};
+		}
+
 		if (_obsReady) {
 			std::vector<RequestBatchRequest> requestsVector;
-			for (auto &requestJson : requests) {
-				if (!requestJson["requestType"].is_string())
-					requestJson["requestType"] =
-						""; // Workaround for what would otherwise be extensive additional logic for a rare edge case
-				std::string requestType = requestJson["requestType"];
-				json requestData = requestJson["requestData"];
-				json inputVariables = requestJson["inputVariables"];
-				json outputVariables = requestJson["outputVariables"];
-				requestsVector.emplace_back(requestType, requestData, executionType, inputVariables,
-							    outputVariables);
+			requestsVector.reserve(requests->size());
+			for (auto &requestJson : *requests) {
+				requestsVector.emplace_back(requestJson["requestType"].get<std::string>(),
+							    std::move(requestJson["requestData"]), executionType,
+							    std::move(requestJson["inputVariables"]),
+							    std::move(requestJson["outputVariables"]));
 			}
 
-			resultsVector = RequestBatchHandler::ProcessRequestBatch(
-				_threadPool, session, executionType, requestsVector, payloadData["variables"], haltOnFailure);
+			if (hasSchedule) {
+				// The request ID is the handle to cancel the batch with
+				std::string scheduledBatchId = requestId.is_string() ? requestId.get<std::string>()
+										     : requestId.dump();
+				RequestBatchHandler::ScheduleRequestBatch(
+					_batchScheduler, session, scheduledBatchId, std::move(schedule), executionType,
+					std::move(requestsVector), std::move(payloadData["variables"]), haltOnFailure,
+					std::move(sendResults), std::move(sendResult));
+			} else {
+				RequestBatchHandler::ProcessRequestBatch(_batchScheduler, session, executionType,
+									 std::move(requestsVector),
+									 std::move(payloadData["variables"]), haltOnFailure,
+									 std::move(sendResults), std::move(sendResult));
+			}
 		} else {
+			std::vector<RequestResult> resultsVector;
 			// I lowkey hate this, but whatever
 			if (haltOnFailure) {
 				resultsVector.emplace_back(RequestStatus::NotReady, "OBS is not ready to perform the request.");
 			} else {
-				for (size_t i = 0; i < requests.size(); i++)
+				for (size_t i = 0; i < requests->size(); i++)
 					resultsVector.emplace_back(RequestStatus::NotReady,
 								   "OBS is not ready to perform the request.");
 			}
+
+			size_t resultCount = resultsVector.size();
+			sendResults(std::move(resultsVector), resultCount, nullptr, 0);
+		}
+	}
+		return;
+	case WebSocketOpCode::ControlUpdate: { // ControlUpdate
+		if (!session->ControlStreamEnabled()) {
+			ret.closeCode = WebSocketCloseCode::UnsupportedFeature;
+			ret.closeReason = "You have not enabled the control stream with `controlStream`.";
+			return;
+		}
+
+		if (!payloadData.contains("requestType")) {
+			ret.closeCode = WebSocketCloseCode::MissingDataField;
+			ret.closeReason = "Your payload's data is missing an `requestType`.";
+			return;
+		}
+
+		if (!payloadData["requestType"].is_string()) {
+			ret.closeCode = WebSocketCloseCode::InvalidDataFieldType;
+			ret.closeReason = "Your `requestType` is not a string.";
+			return;
+		}
+
+		// Control updates never get a response, so they can only be counted if OBS is not ready
+		if (!_obsReady) {
+			session->ControlStreamStats.received++;
+			session->ControlStreamStats.dropped++;
+			return;
 		}
 
-		size_t i = 0;
-		std::vector<json> results;
-		for (auto &requestResult : resultsVector) {
-			results.push_back(ConstructRequestResult(requestResult, requests[i]));
-			i++;
+		ControlStreamHandler::SubmitControlUpdate(_batchScheduler, session, payloadData["requestType"].get<std::string>(),
+							  std::move(payloadData["requestData"]));
+	}
+		return;
+	case WebSocketOpCode::Ping: { // Ping
+		if (!session->TimingEnabled()) {
+			ret.closeCode = WebSocketCloseCode::UnsupportedFeature;
+			ret.closeReason = "You have not enabled timing with `timing`.";
+			return;
 		}
 
-		ret.result["op"] = WebSocketOpCode::RequestBatchResponse;
-		ret.result["d"]["requestId"] = payloadData["requestId"];
-		ret.result["d"]["results"] = results;
+		ret.result["op"] = WebSocketOpCode::Pong;
+		if (payloadData.contains("pingId"))
+			ret.result["d"]["pingId"] = payloadData["pingId"];
+		ret.result["d"]["receivedAt"] = receivedAt;
+		// `sentAt` is added right before the Pong is sent
 	}
 		return;
 	default:
@@ -359,7 +622,12 @@ void WebSocketServer::BroadcastEvent(uint64_t requiredIntent, const std::string
 	if (!_server.is_listening() || !_obsReady)
 		return;
 
+	auto broadcastStart = Utils::Metrics::Clock::now();
+	uint64_t emittedAt = os_gettime_ns();
+	uint32_t emittedFrame = obs_get_total_frames();
 	_threadPool.start(Utils::Compat::CreateFunctionRunnable([=]() {
+		Utils::Tracing::Span span("obs_websocket_event_broadcast", eventType);
+
 		// Populate message object
 		json eventMessage;
 		eventMessage["op"] = 5;
@@ -368,9 +636,14 @@ void WebSocketServer::BroadcastEvent(uint64_t requiredIntent, const std::string
 		if (eventData.is_object())
 			eventMessage["d"]["eventData"] = eventData;
 
+		// Sessions which enabled timing get a copy with the time and frame the event was emitted on
+		json timedEventMessage;
+
 		// Initialize objects. The broadcast process only dumps the data when its needed.
 		std::string messageJson;
 		std::string messageMsgPack;
+		std::string timedMessageJson;
+		std::string timedMessageMsgPack;
 
 		// Recurse connected sessions and send the event to suitable sessions.
 		std::unique_lock<std::mutex> lock(_sessionMutex);
@@ -380,31 +653,53 @@ void WebSocketServer::BroadcastEvent(uint64_t requiredIntent, const std::string
 			if (rpcVersion && it.second->RpcVersion() != rpcVersion)
 				continue;
 			if ((it.second->EventSubscriptions() & requiredIntent) != 0) {
+				bool timed = it.second->TimingEnabled();
+				if (timed && timedEventMessage.is_null()) {
+					timedEventMessage = eventMessage;
+					timedEventMessage["d"]["timing"] = {{"emittedAt", emittedAt}, {"frame", emittedFrame}};
+				}
+				const json &message = timed ? timedEventMessage : eventMessage;
+				std::string &encodedJson = timed ? timedMessageJson : messageJson;
+				std::string &encodedMsgPack = timed ? timedMessageMsgPack : messageMsgPack;
+
 				websocketpp::lib::error_code errorCode;
 				switch (it.second->Encoding()) {
 				case WebSocketEncoding::Json:
-					if (messageJson.empty())
-						messageJson = eventMessage.dump();
-					_server.send((websocketpp::connection_hdl)it.first, messageJson,
+					if (encodedJson.empty())
+						encodedJson = message.dump();
+					_server.send((websocketpp::connection_hdl)it.first, encodedJson,
 						     websocketpp::frame::opcode::text, errorCode);
 					it.second->IncrementOutgoingMessages();
+					RecordSend(encodedJson.size(), errorCode);
 					break;
 				case WebSocketEncoding::MsgPack:
-					if (messageMsgPack.empty()) {
-						auto msgPackData = json::to_msgpack(eventMessage);
-						messageMsgPack = std::string(msgPackData.begin(), msgPackData.end());
+					if (encodedMsgPack.empty()) {
+						auto msgPackData = json::to_msgpack(message);
+						encodedMsgPack = std::string(msgPackData.begin(), msgPackData.end());
 					}
-					_server.send((websocketpp::connection_hdl)it.first, messageMsgPack,
+					_server.send((websocketpp::connection_hdl)it.first, encodedMsgPack,
 						     websocketpp::frame::opcode::binary, errorCode);
 					it.second->IncrementOutgoingMessages();
+					RecordSend(encodedMsgPack.size(), errorCode);
 					break;
 				}
 				if (errorCode)
 					blog(LOG_ERROR, "[WebSocketServer::BroadcastEvent] Error sending event message: %s",
 					     errorCode.message().c_str());
+				else if (Utils::TrafficCapture::IsActive())
+					Utils::TrafficCapture::RecordMessage(it.second.get(), Utils::TrafficCapture::Outbound,
+									     message);
 			}
 		}
 		lock.unlock();
+
+		// From the event being emitted until it has been sent to all sessions
+		Utils::Metrics::GetRegistry().events.Get(eventType).Record(broadcastStart);
+
+		// High volume events would quickly overwrite everything else in the ring
+		if (Utils::FlightRecorder::IsActive() && (EventSubscription::All & requiredIntent) != 0)
+			Utils::FlightRecorder::Record(FlightRecorderFormat::Event, eventMessage["d"]);
+
 		if (IsDebugEnabled() && (EventSubscription::All & requiredIntent) != 0) // Don't log high volume events
 			blog(LOG_INFO, "[WebSocketServer::BroadcastEvent] Outgoing event:\n%s", eventMessage.dump(2).c_str());
 	}));
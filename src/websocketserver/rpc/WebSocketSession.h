@@ -19,17 +19,22 @@ with this program. If not, see <https://www.gnu.org/licenses/>
 
 #pragma once
 
+#include <list>
 #include <mutex>
 #include <string>
 #include <atomic>
 #include <memory>
+#include <unordered_map>
 
 #include "../../eventhandler/types/EventSubscription.h"
+#include "../../utils/Json.h"
 #include "plugin-macros.generated.h"
 
 class WebSocketSession;
 typedef std::shared_ptr<WebSocketSession> SessionPtr;
 
+struct PreparedRequestBatch;
+
 class WebSocketSession {
 public:
 	inline std::string RemoteAddress()
@@ -89,8 +94,42 @@ public:
 	inline uint64_t EventSubscriptions() { return _eventSubscriptions; }
 	inline void SetEventSubscriptions(uint64_t subscriptions) { _eventSubscriptions = subscriptions; }
 
+	inline bool ControlStreamEnabled() { return _controlStreamEnabled; }
+	inline void SetControlStreamEnabled(bool enabled) { _controlStreamEnabled = enabled; }
+
+	inline bool TimingEnabled() { return _timingEnabled; }
+	inline void SetTimingEnabled(bool enabled) { _timingEnabled = enabled; }
+
 	std::mutex OperationMutex;
 
+	// Cue IDs of the scheduled request batches of the session, by `requestId`
+	std::mutex ScheduledBatchesMutex;
+	std::unordered_map<std::string, uint64_t> ScheduledBatches;
+
+	// Request batches prepared by the session, by `preparedBatchId`
+	std::mutex PreparedBatchesMutex;
+	std::unordered_map<std::string, std::shared_ptr<const PreparedRequestBatch>> PreparedBatches;
+
+	// Latest control updates of the session which have not been applied yet, in order of arrival. Updates are indexed by
+	// control and target, and an update for a pending target is merged into it without losing its place.
+	struct ControlUpdate {
+		std::string key;
+		std::string requestType;
+		json requestData;
+	};
+	std::mutex ControlStreamMutex;
+	std::list<ControlUpdate> PendingControlUpdates;
+	std::unordered_map<std::string, std::list<ControlUpdate>::iterator> PendingControlUpdateIndex;
+	bool ControlStreamTaskScheduled = false;
+
+	struct ControlStreamStatistics {
+		std::atomic<uint64_t> received = 0;
+		std::atomic<uint64_t> applied = 0;
+		std::atomic<uint64_t> failed = 0;
+		std::atomic<uint64_t> superseded = 0; // Replaced by a newer update before being applied
+		std::atomic<uint64_t> dropped = 0;    // Not accepted at all
+	} ControlStreamStats;
+
 private:
 	std::mutex _remoteAddressMutex;
 	std::string _remoteAddress;
@@ -106,4 +145,6 @@ private:
 	std::atomic<uint8_t> _rpcVersion = OBS_WEBSOCKET_RPC_VERSION;
 	std::atomic<bool> _isIdentified = false;
 	std::atomic<uint64_t> _eventSubscriptions = EventSubscription::All;
+	std::atomic<bool> _controlStreamEnabled = false;
+	std::atomic<bool> _timingEnabled = false;
 };
@@ -120,10 +120,56 @@ namespace WebSocketOpCode {
 		* @api enums
 		*/
 		RequestBatchResponse = 9,
+		/**
+		* The message sent by obs-websocket for each finished request of a batch which streams its results.
+		*
+		* @enumIdentifier RequestBatchPartialResponse
+		* @enumValue 10
+		* @enumType WebSocketOpCode
+		* @rpcVersion -1
+		* @initialVersion 5.5.0
+		* @api enums
+		*/
+		RequestBatchPartialResponse = 10,
+		/**
+		* The message sent by a client to obs-websocket to update a control, like a fader, without a response. Only
+		* allowed once the control stream has been enabled with `controlStream` in `Identify` or `Reidentify`.
+		*
+		* @enumIdentifier ControlUpdate
+		* @enumValue 11
+		* @enumType WebSocketOpCode
+		* @rpcVersion -1
+		* @initialVersion 5.5.0
+		* @api enums
+		*/
+		ControlUpdate = 11,
+		/**
+		* The message sent by a client to obs-websocket to measure the round-trip latency and sync its clock with the
+		* server. Only allowed once timing has been enabled with `timing` in `Identify` or `Reidentify`.
+		*
+		* @enumIdentifier Ping
+		* @enumValue 12
+		* @enumType WebSocketOpCode
+		* @rpcVersion -1
+		* @initialVersion 5.5.0
+		* @api enums
+		*/
+		Ping = 12,
+		/**
+		* The response sent by obs-websocket to a `Ping`, containing the clocks of the server.
+		*
+		* @enumIdentifier Pong
+		* @enumValue 13
+		* @enumType WebSocketOpCode
+		* @rpcVersion -1
+		* @initialVersion 5.5.0
+		* @api enums
+		*/
+		Pong = 13,
 	};
 
 	inline bool IsValid(uint8_t opCode)
 	{
-		return opCode >= Hello && opCode <= RequestBatchResponse;
+		return opCode >= Hello && opCode <= Pong;
 	}
 }
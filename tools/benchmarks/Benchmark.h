@@ -0,0 +1,133 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <string>
+#include <vector>
+
+// A minimal harness in the style of Google Benchmark. Every benchmark is run with a growing number of iterations until
+// one run takes at least the minimum time, and that run is reported. The JSON output has the same layout as the
+// `--benchmark_format=json` output of Google Benchmark, so the same tooling can track both.
+namespace Benchmark {
+	class State {
+	public:
+		explicit State(uint64_t iterations) : _iterations(iterations) {}
+
+		// Starts the timer on the first call, and stops it once all iterations have run
+		bool KeepRunning()
+		{
+			if (_completed == 0 && !_started) {
+				_started = true;
+				StartTimer();
+			} else {
+				_completed++;
+			}
+
+			if (_completed < _iterations)
+				return true;
+
+			StopTimer();
+			return false;
+		}
+
+		// Excludes the setup of an iteration from the measured time
+		void PauseTiming() { StopTimer(); }
+		void ResumeTiming() { StartTimer(); }
+
+		// Totals over all iterations, reported as rates
+		void SetItemsProcessed(uint64_t items) { _itemsProcessed = items; }
+		void SetBytesProcessed(uint64_t bytes) { _bytesProcessed = bytes; }
+		void SkipWithError(const std::string &error) { _error = error; }
+
+		uint64_t Iterations() const { return _iterations; }
+		double RealTimeNs() const { return _realTimeNs; }
+		double CpuTimeNs() const { return _cpuTimeNs; }
+		uint64_t ItemsProcessed() const { return _itemsProcessed; }
+		uint64_t BytesProcessed() const { return _bytesProcessed; }
+		const std::string &Error() const { return _error; }
+
+	private:
+		// Like in Google Benchmark, only the CPU time of the benchmark thread. Work it hands to the thread pool or to the
+		// graphics thread of the mock is only reflected in the real time.
+		static double CpuNow()
+		{
+			struct timespec ts;
+			clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+			return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+		}
+
+		void StartTimer()
+		{
+			_realStart = std::chrono::steady_clock::now();
+			_cpuStart = CpuNow();
+		}
+
+		void StopTimer()
+		{
+			auto elapsed = std::chrono::steady_clock::now() - _realStart;
+			_realTimeNs += std::chrono::duration<double, std::nano>(elapsed).count();
+			_cpuTimeNs += CpuNow() - _cpuStart;
+		}
+
+		uint64_t _iterations;
+		uint64_t _completed = 0;
+		bool _started = false;
+		std::chrono::steady_clock::time_point _realStart;
+		double _cpuStart = 0;
+		double _realTimeNs = 0;
+		double _cpuTimeNs = 0;
+		uint64_t _itemsProcessed = 0;
+		uint64_t _bytesProcessed = 0;
+		std::string _error;
+	};
+
+	typedef std::function<void(State &)> Function;
+
+	struct Registration {
+		std::string name;
+		Function function;
+	};
+
+	inline std::vector<Registration> &GetRegistrations()
+	{
+		static std::vector<Registration> registrations;
+		return registrations;
+	}
+
+	inline bool Register(const std::string &name, Function function)
+	{
+		GetRegistrations().push_back({name, function});
+		return true;
+	}
+
+	// Keeps the compiler from optimizing away the computation of `value`
+	template<typename T> inline void DoNotOptimize(const T &value)
+	{
+		asm volatile("" : : "r,m"(value) : "memory");
+	}
+}
+
+#define BENCHMARK_CONCAT_INNER(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT_INNER(a, b)
+#define BENCHMARK(name, function) \
+	static bool BENCHMARK_CONCAT(_benchmarkRegistered, __LINE__) = Benchmark::Register(name, function)
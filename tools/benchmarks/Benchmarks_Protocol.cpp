@@ -0,0 +1,203 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include "Benchmark.h"
+#include "Fixtures.h"
+#include "../mock-obs/MockObs.h"
+#include "../../src/eventhandler/types/EventSubscription.h"
+#include "../../src/requesthandler/RequestHandler.h"
+#include "../../src/utils/Obs_VolumeMeter.h"
+#include "../../src/websocketserver/rpc/WebSocketSession.h"
+
+// The server encodes every message with `json::dump()` for JSON sessions, and with `json::to_msgpack()` copied into a string
+// for MessagePack sessions. See `WebSocketServer::SendSessionMessage()` and `WebSocketServer::BroadcastEvent()`.
+static void EncodeJson(Benchmark::State &state, const json &message)
+{
+	size_t size = 0;
+	while (state.KeepRunning()) {
+		std::string messageJson = message.dump();
+		size = messageJson.size();
+		Benchmark::DoNotOptimize(messageJson);
+	}
+	state.SetBytesProcessed(state.Iterations() * size);
+}
+
+static void EncodeMsgPack(Benchmark::State &state, const json &message)
+{
+	size_t size = 0;
+	while (state.KeepRunning()) {
+		auto msgPackData = json::to_msgpack(message);
+		std::string messageMsgPack(msgPackData.begin(), msgPackData.end());
+		size = messageMsgPack.size();
+		Benchmark::DoNotOptimize(messageMsgPack);
+	}
+	state.SetBytesProcessed(state.Iterations() * size);
+}
+
+// Request response (OpCode 7) of `GetSceneItemList` for the 500 item scene
+static const json &GetSceneItemListResponse()
+{
+	static const json message = []() {
+		RequestHandler requestHandler;
+		RequestResult requestResult =
+			requestHandler.ProcessRequest(Request("GetSceneItemList", json{{"sceneName", FIXTURE_SCENE_NAME}}));
+
+		json ret;
+		ret["op"] = 7;
+		ret["d"]["requestType"] = "GetSceneItemList";
+		ret["d"]["requestId"] = "f819dcf0-89cc-11eb-8f0e-382c4ac93b9c";
+		ret["d"]["requestStatus"] = {{"result", requestResult.Succeeded()}, {"code", requestResult.StatusCode}};
+		ret["d"]["responseData"] = requestResult.ResponseData;
+		return ret;
+	}();
+	return message;
+}
+
+// Event (OpCode 5) of `InputVolumeMeters` for 16 active 8 channel inputs
+static const json &InputVolumeMetersEvent()
+{
+	static const json message = []() {
+		obs_source_t *input = Fixtures::GetAudioInput();
+		Utils::Obs::VolumeMeter::Meter meter(input);
+		MockObs::SendInputAudio(input, &Fixtures::GetAudioData());
+
+		json inputs = json::array();
+		for (int i = 0; i < 16; i++)
+			inputs.push_back(meter.GetMeterData());
+
+		json ret;
+		ret["op"] = 5;
+		ret["d"]["eventType"] = "InputVolumeMeters";
+		ret["d"]["eventIntent"] = EventSubscription::InputVolumeMeters;
+		ret["d"]["eventData"]["inputs"] = inputs;
+		return ret;
+	}();
+	return message;
+}
+
+// Request (OpCode 6) as sent by a client, for decoding
+static const json &SetSceneItemTransformRequest()
+{
+	static const json message = {
+		{"op", 6},
+		{"d",
+		 {{"requestType", "SetSceneItemTransform"},
+		  {"requestId", "f819dcf0-89cc-11eb-8f0e-382c4ac93b9c"},
+		  {"requestData",
+		   {{"sceneName", FIXTURE_SCENE_NAME},
+		    {"sceneItemId", 250},
+		    {"sceneItemTransform",
+		     {{"positionX", 960.5}, {"positionY", 540.25}, {"rotation", 45.0}, {"scaleX", 0.5}, {"scaleY", 0.5}}}}}}},
+	};
+	return message;
+}
+
+BENCHMARK("Protocol/EncodeJson/GetSceneItemListResponse",
+	  [](Benchmark::State &state) { EncodeJson(state, GetSceneItemListResponse()); });
+BENCHMARK("Protocol/EncodeMsgPack/GetSceneItemListResponse",
+	  [](Benchmark::State &state) { EncodeMsgPack(state, GetSceneItemListResponse()); });
+BENCHMARK("Protocol/EncodeJson/InputVolumeMetersEvent",
+	  [](Benchmark::State &state) { EncodeJson(state, InputVolumeMetersEvent()); });
+BENCHMARK("Protocol/EncodeMsgPack/InputVolumeMetersEvent",
+	  [](Benchmark::State &state) { EncodeMsgPack(state, InputVolumeMetersEvent()); });
+
+BENCHMARK("Protocol/DecodeJson/SetSceneItemTransformRequest", [](Benchmark::State &state) {
+	std::string payload = SetSceneItemTransformRequest().dump();
+	while (state.KeepRunning()) {
+		json message = json::parse(payload);
+		Benchmark::DoNotOptimize(message);
+	}
+	state.SetBytesProcessed(state.Iterations() * payload.size());
+});
+
+BENCHMARK("Protocol/DecodeMsgPack/SetSceneItemTransformRequest", [](Benchmark::State &state) {
+	auto msgPackData = json::to_msgpack(SetSceneItemTransformRequest());
+	std::string payload(msgPackData.begin(), msgPackData.end());
+	while (state.KeepRunning()) {
+		json message = json::from_msgpack(payload);
+		Benchmark::DoNotOptimize(message);
+	}
+	state.SetBytesProcessed(state.Iterations() * payload.size());
+});
+
+// Requests which pass values along through batch variables, executed like a `SERIAL_REALTIME` batch
+static json VariableBatchRequests()
+{
+	return json::array({
+		{{"requestType", "GetCurrentProgramScene"}, {"outputVariables", {{"programSceneName", "sceneName"}}}},
+		{{"requestType", "GetSceneItemId"},
+		 {"requestData", {{"sceneName", FIXTURE_SCENE_NAME}}},
+		 {"inputVariables", {{"sourceName", "inputName"}}},
+		 {"outputVariables", {{"sceneItemId", "sceneItemId"}}}},
+		{{"requestType", "GetSceneItemTransform"},
+		 {"requestData", {{"sceneName", FIXTURE_SCENE_NAME}}},
+		 {"inputVariables", {{"sceneItemId", "sceneItemId"}}}},
+		{{"requestType", "GetInputSettings"}, {"inputVariables", {{"inputName", "inputName"}}}},
+	});
+}
+
+// The same requests with their values filled in, to tell the cost of the variables apart from the requests themselves
+static json LiteralBatchRequests()
+{
+	return json::array({
+		{{"requestType", "GetCurrentProgramScene"}},
+		{{"requestType", "GetSceneItemId"},
+		 {"requestData", {{"sceneName", FIXTURE_SCENE_NAME}, {"sourceName", "Benchmark Input 250"}}}},
+		{{"requestType", "GetSceneItemTransform"},
+		 {"requestData", {{"sceneName", FIXTURE_SCENE_NAME}, {"sceneItemId", 250}}}},
+		{{"requestType", "GetInputSettings"}, {"requestData", {{"inputName", "Benchmark Input 250"}}}},
+	});
+}
+
+static void ExecutePreparedBatch(Benchmark::State &state, const std::string &preparedBatchId, json requests, json parameters)
+{
+	Fixtures::GetScene();
+
+	// Prepared batches belong to the session which prepared them
+	RequestHandler requestHandler(std::make_shared<WebSocketSession>());
+	json parameterNames = json::array();
+	for (auto &[key, value] : parameters.items())
+		parameterNames.push_back(key);
+
+	json prepareRequestData = {{"preparedBatchId", preparedBatchId},
+				   {"requests", requests},
+				   {"parameters", parameterNames},
+				   {"haltOnFailure", true}};
+	RequestResult prepareResult = requestHandler.ProcessRequest(Request("PrepareRequestBatch", prepareRequestData));
+	if (!prepareResult.Succeeded()) {
+		state.SkipWithError("Failed to prepare the batch: " + prepareResult.Comment);
+		return;
+	}
+
+	json executeRequestData = {{"preparedBatchId", preparedBatchId}, {"parameters", parameters}};
+	Request executeRequest("ExecutePreparedBatch", executeRequestData);
+	while (state.KeepRunning()) {
+		RequestResult result = requestHandler.ProcessRequest(executeRequest);
+		Benchmark::DoNotOptimize(result.ResponseData);
+	}
+	state.SetItemsProcessed(state.Iterations() * requests.size());
+
+	requestHandler.ProcessRequest(Request("RemovePreparedBatch", json{{"preparedBatchId", preparedBatchId}}));
+}
+
+BENCHMARK("RequestBatch/ExecutePreparedBatch/Variables", [](Benchmark::State &state) {
+	ExecutePreparedBatch(state, "benchmark-variables", VariableBatchRequests(), {{"inputName", "Benchmark Input 250"}});
+});
+BENCHMARK("RequestBatch/ExecutePreparedBatch/Literals", [](Benchmark::State &state) {
+	ExecutePreparedBatch(state, "benchmark-literals", LiteralBatchRequests(), json::object());
+});
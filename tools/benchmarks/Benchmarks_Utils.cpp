@@ -0,0 +1,118 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include "Benchmark.h"
+#include "Fixtures.h"
+#include "../mock-obs/MockObs.h"
+#include "../../src/utils/Obs.h"
+#include "../../src/utils/Obs_VolumeMeter.h"
+#include "../../src/utils/Crypto.h"
+
+static void ObsDataToJson(Benchmark::State &state, const json &settings)
+{
+	OBSDataAutoRelease data = Utils::Json::JsonToObsData(settings);
+	while (state.KeepRunning()) {
+		json ret = Utils::Json::ObsDataToJson(data);
+		Benchmark::DoNotOptimize(ret);
+	}
+	state.SetBytesProcessed(state.Iterations() * settings.dump().size());
+}
+
+static void JsonToObsData(Benchmark::State &state, const json &settings)
+{
+	while (state.KeepRunning()) {
+		OBSDataAutoRelease data = Utils::Json::JsonToObsData(settings);
+		Benchmark::DoNotOptimize(data.Get());
+	}
+	state.SetBytesProcessed(state.Iterations() * settings.dump().size());
+}
+
+BENCHMARK("Json/ObsDataToJson/BrowserSourceSettings",
+	  [](Benchmark::State &state) { ObsDataToJson(state, Fixtures::GetBrowserSourceSettings()); });
+BENCHMARK("Json/ObsDataToJson/PlaylistSettings",
+	  [](Benchmark::State &state) { ObsDataToJson(state, Fixtures::GetPlaylistSettings()); });
+BENCHMARK("Json/JsonToObsData/BrowserSourceSettings",
+	  [](Benchmark::State &state) { JsonToObsData(state, Fixtures::GetBrowserSourceSettings()); });
+BENCHMARK("Json/JsonToObsData/PlaylistSettings",
+	  [](Benchmark::State &state) { JsonToObsData(state, Fixtures::GetPlaylistSettings()); });
+
+// Every item of the scene, like `GetSceneItemList` or a client polling all transforms
+BENCHMARK("ObjectHelper/GetSceneItemTransform/500Items", [](Benchmark::State &state) {
+	std::vector<obs_sceneitem_t *> items;
+	obs_scene_enum_items(
+		obs_scene_from_source(Fixtures::GetScene()),
+		[](obs_scene_t *, obs_sceneitem_t *item, void *param) {
+			static_cast<std::vector<obs_sceneitem_t *> *>(param)->push_back(item);
+			return true;
+		},
+		&items);
+
+	while (state.KeepRunning()) {
+		for (obs_sceneitem_t *item : items) {
+			json transform = Utils::Obs::ObjectHelper::GetSceneItemTransform(item);
+			Benchmark::DoNotOptimize(transform);
+		}
+	}
+	state.SetItemsProcessed(state.Iterations() * items.size());
+});
+
+BENCHMARK("ArrayHelper/GetSceneItemList/500Items", [](Benchmark::State &state) {
+	obs_scene_t *scene = obs_scene_from_source(Fixtures::GetScene());
+	while (state.KeepRunning()) {
+		std::vector<json> items = Utils::Obs::ArrayHelper::GetSceneItemList(scene);
+		Benchmark::DoNotOptimize(items);
+	}
+	state.SetItemsProcessed(state.Iterations() * FIXTURE_SCENE_ITEM_COUNT);
+});
+
+// The meter processes every audio block of its input on the audio thread
+BENCHMARK("VolumeMeter/ProcessAudio/8Channels1024Frames", [](Benchmark::State &state) {
+	obs_source_t *input = Fixtures::GetAudioInput();
+	const struct audio_data &data = Fixtures::GetAudioData();
+	Utils::Obs::VolumeMeter::Meter meter(input);
+
+	while (state.KeepRunning())
+		MockObs::SendInputAudio(input, &data);
+
+	state.SetItemsProcessed(state.Iterations() * FIXTURE_AUDIO_FRAMES);
+	state.SetBytesProcessed(state.Iterations() * FIXTURE_AUDIO_CHANNELS * FIXTURE_AUDIO_FRAMES * sizeof(float));
+});
+
+BENCHMARK("VolumeMeter/GetMeterData/8Channels", [](Benchmark::State &state) {
+	obs_source_t *input = Fixtures::GetAudioInput();
+	Utils::Obs::VolumeMeter::Meter meter(input);
+	MockObs::SendInputAudio(input, &Fixtures::GetAudioData());
+
+	while (state.KeepRunning()) {
+		json meterData = meter.GetMeterData();
+		Benchmark::DoNotOptimize(meterData);
+	}
+});
+
+// Done once for every client which identifies with authentication
+BENCHMARK("Crypto/CheckAuthenticationString", [](Benchmark::State &state) {
+	std::string salt = Utils::Crypto::GenerateSalt();
+	std::string challenge = Utils::Crypto::GenerateSalt();
+	std::string secret = Utils::Crypto::GenerateSecret("supersecretpassword", salt);
+	std::string authenticationString = Utils::Crypto::GenerateSecret(secret, challenge);
+
+	while (state.KeepRunning()) {
+		bool authenticated = Utils::Crypto::CheckAuthenticationString(secret, challenge, authenticationString);
+		Benchmark::DoNotOptimize(authenticated);
+	}
+});
@@ -0,0 +1,127 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <cmath>
+#include <string>
+
+#include "Fixtures.h"
+#include "../mock-obs/MockObs.h"
+
+static obs_source_t *scene = nullptr;
+static obs_source_t *audioInput = nullptr;
+
+const json &Fixtures::GetBrowserSourceSettings()
+{
+	static const json settings = []() {
+		std::string css = "body { background-color: rgba(0, 0, 0, 0); margin: 0px auto; overflow: hidden; }\n";
+		for (int i = 0; css.size() < 4096; i++)
+			css += ".alert-" + std::to_string(i) +
+			       " { color: #ffffff; font-family: 'Open Sans', sans-serif; text-shadow: 1px 1px 2px #000000; }\n";
+
+		return json{
+			{"is_local_file", false},
+			{"url", "https://streamlabs.com/alert-box/v3/0123456789ABCDEF0123456789ABCDEF"},
+			{"local_file", ""},
+			{"width", 1920},
+			{"height", 1080},
+			{"fps_custom", true},
+			{"fps", 60},
+			{"reroute_audio", true},
+			{"css", css},
+			{"shutdown", true},
+			{"restart_when_active", false},
+			{"webpage_control_level", 1},
+		};
+	}();
+	return settings;
+}
+
+const json &Fixtures::GetPlaylistSettings()
+{
+	static const json settings = []() {
+		json playlist = json::array();
+		for (int i = 0; i < 100; i++)
+			playlist.push_back({{"value", "/home/user/Videos/clip_" + std::to_string(i) + ".mp4"},
+					    {"hidden", false},
+					    {"selected", i == 0}});
+
+		return json{
+			{"playlist", playlist}, {"loop", true}, {"shuffle", false}, {"playback_behavior", "stop_restart"},
+			{"network_caching", 400}, {"track", 1}, {"subtitle_enable", false},
+		};
+	}();
+	return settings;
+}
+
+obs_source_t *Fixtures::GetScene()
+{
+	if (scene)
+		return scene;
+
+	scene = MockObs::CreateScene(FIXTURE_SCENE_NAME);
+	for (int i = 1; i <= FIXTURE_SCENE_ITEM_COUNT; i++) {
+		std::string inputName = "Benchmark Input " + std::to_string(i);
+		obs_source_t *input = MockObs::CreateInput(scene, inputName, "color_source_v3");
+		obs_source_release(input);
+	}
+
+	return scene;
+}
+
+obs_source_t *Fixtures::GetAudioInput()
+{
+	if (!audioInput)
+		audioInput = obs_source_create("pulse_input_capture", "Benchmark Audio Input", nullptr, nullptr);
+
+	return audioInput;
+}
+
+const struct audio_data &Fixtures::GetAudioData()
+{
+	static std::vector<float> samples;
+	static struct audio_data data = {};
+	if (!samples.empty())
+		return data;
+
+	// A different tone on every channel, so that every channel has different levels
+	samples.resize(FIXTURE_AUDIO_CHANNELS * FIXTURE_AUDIO_FRAMES);
+	for (int channel = 0; channel < FIXTURE_AUDIO_CHANNELS; channel++) {
+		float *plane = samples.data() + channel * FIXTURE_AUDIO_FRAMES;
+		for (int frame = 0; frame < FIXTURE_AUDIO_FRAMES; frame++)
+			plane[frame] = (float)(0.5 * sin(2.0 * M_PI * 220.0 * (channel + 1) * frame / 48000.0));
+		data.data[channel] = (uint8_t *)plane;
+	}
+	data.frames = FIXTURE_AUDIO_FRAMES;
+
+	return data;
+}
+
+void Fixtures::Release()
+{
+	if (scene) {
+		obs_source_remove(scene);
+		obs_source_release(scene);
+		scene = nullptr;
+	}
+
+	if (audioInput) {
+		obs_source_remove(audioInput);
+		obs_source_release(audioInput);
+		audioInput = nullptr;
+	}
+}
@@ -0,0 +1,48 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <vector>
+#include <obs.h>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+#define FIXTURE_SCENE_NAME "Benchmark Scene"
+#define FIXTURE_SCENE_ITEM_COUNT 500
+#define FIXTURE_AUDIO_CHANNELS 8
+#define FIXTURE_AUDIO_FRAMES 1024
+
+// Representative data for the benchmarks. Created on first use, once the mock OBS has been initialized
+namespace Fixtures {
+	// Settings of a browser source with a large custom CSS
+	const json &GetBrowserSourceSettings();
+	// Settings of a VLC source with a long playlist, for the array paths
+	const json &GetPlaylistSettings();
+
+	// Scene with FIXTURE_SCENE_ITEM_COUNT color inputs named `Benchmark Input <n>`, starting at 1
+	obs_source_t *GetScene();
+	// Audio input which is not in any scene
+	obs_source_t *GetAudioInput();
+	// Planar audio of FIXTURE_AUDIO_CHANNELS channels and FIXTURE_AUDIO_FRAMES frames, for `GetAudioInput()`
+	const struct audio_data &GetAudioData();
+
+	// Releases the sources, before the mock OBS is shut down
+	void Release();
+}
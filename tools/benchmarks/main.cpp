@@ -0,0 +1,195 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <regex>
+#include <thread>
+#include <QApplication>
+#include <QDateTime>
+#include <QSysInfo>
+#include <nlohmann/json.hpp>
+
+#include "Benchmark.h"
+#include "Fixtures.h"
+#include "../mock-obs/MockObs.h"
+#include "../mock-obs/HeadlessPlugin.h"
+#include "../../src/obs-websocket.h"
+
+using json = nlohmann::json;
+
+struct Options {
+	std::string filter = ".*";
+	double minTime = 0.5;
+	std::string jsonOutputPath;
+};
+
+static bool ParseOptions(int argc, char **argv, Options &options)
+{
+	for (int i = 1; i + 1 < argc; i += 2) {
+		std::string arg = argv[i];
+		std::string value = argv[i + 1];
+		if (arg == "--filter")
+			options.filter = value;
+		else if (arg == "--min-time")
+			options.minTime = std::atof(value.c_str());
+		else if (arg == "--json-output")
+			options.jsonOutputPath = value;
+		else
+			return false;
+	}
+
+	if (argc % 2 == 0)
+		return false;
+
+	return options.minTime > 0;
+}
+
+// Grows the iterations like Google Benchmark does, until a run takes at least the minimum time
+static Benchmark::State RunBenchmark(const Benchmark::Registration &registration, double minTime)
+{
+	uint64_t iterations = 1;
+	while (true) {
+		Benchmark::State state(iterations);
+		registration.function(state);
+
+		double seconds = state.RealTimeNs() / 1e9;
+		if (!state.Error().empty() || seconds >= minTime || iterations >= 1000000000)
+			return state;
+
+		double multiplier = minTime * 1.4 / std::max(seconds, 1e-9);
+		if (seconds / minTime <= 0.1)
+			multiplier = std::min(multiplier, 10.0);
+		iterations = std::max((uint64_t)(iterations * multiplier), iterations + 1);
+		iterations = std::min<uint64_t>(iterations, 1000000000);
+	}
+}
+
+static json GetResultJson(const std::string &name, const Benchmark::State &state)
+{
+	json ret;
+	ret["name"] = name;
+	ret["run_name"] = name;
+	ret["run_type"] = "iteration";
+	ret["repetitions"] = 1;
+	ret["repetition_index"] = 0;
+	ret["threads"] = 1;
+	if (!state.Error().empty()) {
+		ret["error_occurred"] = true;
+		ret["error_message"] = state.Error();
+		return ret;
+	}
+
+	ret["iterations"] = state.Iterations();
+	ret["real_time"] = state.RealTimeNs() / state.Iterations();
+	ret["cpu_time"] = state.CpuTimeNs() / state.Iterations();
+	ret["time_unit"] = "ns";
+	if (state.ItemsProcessed())
+		ret["items_per_second"] = state.ItemsProcessed() / (state.RealTimeNs() / 1e9);
+	if (state.BytesProcessed())
+		ret["bytes_per_second"] = state.BytesProcessed() / (state.RealTimeNs() / 1e9);
+	return ret;
+}
+
+static json GetContextJson(const char *executable)
+{
+	json ret;
+	ret["date"] = QDateTime::currentDateTime().toString(Qt::ISODate).toStdString();
+	ret["host_name"] = QSysInfo::machineHostName().toStdString();
+	ret["executable"] = executable;
+	ret["num_cpus"] = std::thread::hardware_concurrency();
+	ret["mhz_per_cpu"] = 0;
+#ifdef NDEBUG
+	ret["library_build_type"] = "release";
+#else
+	ret["library_build_type"] = "debug";
+#endif
+	ret["obs_websocket_version"] = OBS_WEBSOCKET_VERSION;
+	return ret;
+}
+
+int main(int argc, char **argv)
+{
+	Options options;
+	if (!ParseOptions(argc, argv, options)) {
+		std::cerr << "Invalid options. See tools/README.md for the usage." << std::endl;
+		return 1;
+	}
+
+	std::regex filter;
+	try {
+		filter = std::regex(options.filter);
+	} catch (const std::regex_error &) {
+		std::cerr << "Invalid filter." << std::endl;
+		return 1;
+	}
+
+	if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+		qputenv("QT_QPA_PLATFORM", "offscreen");
+	QApplication app(argc, argv);
+
+	// Only warnings, so that the log does not end up in the measurements
+	MockObs::Settings settings;
+	settings.configDirectory = "/tmp/obs-websocket-benchmarks";
+	settings.logLevel = LOG_WARNING;
+	MockObs::Initialize(settings);
+	if (!HeadlessPlugin::Load()) {
+		MockObs::Shutdown();
+		return 1;
+	}
+	MockObs::FinishLoading();
+
+	json results = json::array();
+	std::printf("%-60s %15s %15s %12s\n", "Benchmark", "Time (ns)", "CPU (ns)", "Iterations");
+	for (auto &registration : Benchmark::GetRegistrations()) {
+		if (!std::regex_search(registration.name, filter))
+			continue;
+
+		Benchmark::State state = RunBenchmark(registration, options.minTime);
+		if (!state.Error().empty())
+			std::printf("%-60s ERROR: %s\n", registration.name.c_str(), state.Error().c_str());
+		else
+			std::printf("%-60s %15.0f %15.0f %12llu\n", registration.name.c_str(),
+				    state.RealTimeNs() / state.Iterations(), state.CpuTimeNs() / state.Iterations(),
+				    (unsigned long long)state.Iterations());
+		std::fflush(stdout);
+
+		results.push_back(GetResultJson(registration.name, state));
+	}
+
+	Fixtures::Release();
+	HeadlessPlugin::Unload();
+	MockObs::Shutdown();
+
+	if (!options.jsonOutputPath.empty()) {
+		json output;
+		output["context"] = GetContextJson(argv[0]);
+		output["benchmarks"] = results;
+
+		std::ofstream file(options.jsonOutputPath);
+		file << output.dump(2) << std::endl;
+		if (!file) {
+			std::cerr << "Failed to write " << options.jsonOutputPath << std::endl;
+			return 1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,50 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <QByteArray>
+#include <QCryptographicHash>
+
+// Helpers shared by the tools which connect to obs-websocket as clients
+namespace ToolUtils {
+	// The `authentication` string of `Identify`, for the `salt` and `challenge` of `Hello`
+	inline std::string GenerateAuthenticationString(const std::string &password, const std::string &salt,
+							const std::string &challenge)
+	{
+		QByteArray secret = QCryptographicHash::hash(QByteArray::fromStdString(password + salt),
+							     QCryptographicHash::Algorithm::Sha256)
+					    .toBase64();
+		QByteArray secretAndChallenge = secret + QByteArray::fromStdString(challenge);
+		return QCryptographicHash::hash(secretAndChallenge, QCryptographicHash::Algorithm::Sha256).toBase64().toStdString();
+	}
+
+	// `values` must be sorted
+	inline double GetPercentile(const std::vector<double> &values, double percentile)
+	{
+		if (values.empty())
+			return 0;
+
+		size_t rank = (size_t)std::ceil(percentile / 100.0 * values.size());
+		return values[std::clamp<size_t>(rank, 1, values.size()) - 1];
+	}
+}
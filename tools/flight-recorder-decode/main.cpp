@@ -0,0 +1,129 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+// Converts a flight recorder ring file into JSON lines, oldest record first.
+//
+// Usage: obs-websocket-flight-recorder-decode <flight_recorder.bin>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "../../src/utils/FlightRecorderFormat.h"
+
+using json = nlohmann::json;
+using namespace FlightRecorderFormat;
+
+struct FoundRecord {
+	RecordHeader header;
+	uint64_t position;
+};
+
+// Copies from a ring position, wrapping around the end of the ring
+static void CopyFromRing(const std::vector<uint8_t> &ring, uint64_t position, void *data, size_t size)
+{
+	size_t firstPart = std::min<uint64_t>(size, ring.size() - position);
+	memcpy(data, ring.data() + position, firstPart);
+	memcpy((uint8_t *)data + firstPart, ring.data(), size - firstPart);
+}
+
+int main(int argc, char **argv)
+{
+	if (argc != 2) {
+		std::cerr << "Usage: " << argv[0] << " <flight_recorder.bin>" << std::endl;
+		return 1;
+	}
+
+	std::ifstream file(argv[1], std::ios::binary);
+	if (!file) {
+		std::cerr << "Unable to open " << argv[1] << std::endl;
+		return 1;
+	}
+
+	std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	FileHeader fileHeader;
+	if (data.size() < sizeof(fileHeader)) {
+		std::cerr << "The file is too small to be a flight recording." << std::endl;
+		return 1;
+	}
+
+	memcpy(&fileHeader, data.data(), sizeof(fileHeader));
+	if (memcmp(fileHeader.magic, FileMagic, sizeof(FileMagic)) != 0 || fileHeader.version != FileVersion ||
+	    !fileHeader.ringSize || data.size() < fileHeader.headerSize + fileHeader.ringSize) {
+		std::cerr << "The file is not a flight recording of a supported version." << std::endl;
+		return 1;
+	}
+
+	std::vector<uint8_t> ring(data.begin() + fileHeader.headerSize, data.begin() + fileHeader.headerSize + fileHeader.ringSize);
+	data.clear();
+	data.shrink_to_fit();
+
+	// Find every record whose offset matches its position, skipping ahead by aligned steps until the next one otherwise
+	std::vector<FoundRecord> records;
+	uint64_t streamEnd = 0;
+	for (uint64_t position = 0; position < ring.size();) {
+		RecordHeader header;
+		CopyFromRing(ring, position, &header, sizeof(header));
+
+		uint64_t recordSize = GetRecordSize(header.payloadSize);
+		if (header.magic != RecordMagic || header.offset % ring.size() != position || recordSize > ring.size() / 4) {
+			position += RecordAlignment;
+			continue;
+		}
+
+		records.push_back({header, position});
+		streamEnd = std::max(streamEnd, header.offset + recordSize);
+		position += recordSize;
+	}
+
+	// Records from before the latest lap around the ring have been overwritten
+	uint64_t streamStart = streamEnd > ring.size() ? streamEnd - ring.size() : 0;
+	records.erase(std::remove_if(records.begin(), records.end(),
+				     [streamStart](const FoundRecord &record) { return record.header.offset < streamStart; }),
+		      records.end());
+	std::sort(records.begin(), records.end(),
+		  [](const FoundRecord &a, const FoundRecord &b) { return a.header.offset < b.header.offset; });
+
+	size_t corruptRecords = 0;
+	std::vector<uint8_t> payload;
+	for (auto &record : records) {
+		payload.resize(record.header.payloadSize);
+		CopyFromRing(ring, (record.position + sizeof(RecordHeader)) % ring.size(), payload.data(), payload.size());
+
+		json line;
+		line["offset"] = record.header.offset;
+		line["timestamp"] = record.header.timestamp;
+		line["type"] = GetRecordTypeName(record.header.type);
+		try {
+			line["data"] = json::from_msgpack(payload);
+		} catch (const json::exception &) {
+			// Partly overwritten by a record which had not been completed when recording stopped
+			corruptRecords++;
+			continue;
+		}
+
+		std::cout << line.dump() << '\n';
+	}
+
+	std::cerr << "Decoded " << records.size() - corruptRecords << " records (" << corruptRecords << " corrupt)." << std::endl;
+	return 0;
+}
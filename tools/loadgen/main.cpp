@@ -0,0 +1,606 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+// Benchmarks an obs-websocket server with a configurable protocol load, then reports the throughput, latency percentiles and
+// the CPU and memory usage of OBS (from `GetStats`) and of the load generator itself.
+//
+// Usage: obs-websocket-loadgen [--url <url>] [--password <password>] [--sessions <count>] [--encoding <json|msgpack|mixed>]
+//        [--inflight <count>] [--duration <seconds>] [--warmup <seconds>] [--mix <type[:weight],...>] [--mix-file <file>]
+//        [--batch-ratio <0..1>] [--batch-size <count>] [--event-subscriptions <mask>] [--seed <seed>] [--json-output <file>]
+//
+// Every session keeps the given number of requests or request batches in flight, picking the next one from the mix once a
+// response arrives. Only messages sent and answered during the measurement are counted. See tools/README.md for details.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include <websocketpp/client.hpp>
+#include <websocketpp/config/asio_no_tls_client.hpp>
+
+#include "../common/ToolUtils.h"
+
+using json = nlohmann::json;
+typedef websocketpp::client<websocketpp::config::asio_client> Client;
+typedef std::chrono::steady_clock Clock;
+
+// Time given to outstanding responses after the measurement has ended
+static const long DrainTimeoutMillis = 10000;
+
+struct MixEntry {
+	std::string requestType;
+	json requestData;
+	double weight;
+};
+
+struct Options {
+	std::string url = "ws://127.0.0.1:4455";
+	std::string password;
+	size_t sessions = 8;
+	std::string encoding = "mixed";
+	size_t inflight = 1;
+	double duration = 10;
+	double warmup = 2;
+	std::vector<MixEntry> mix;
+	double batchRatio = 0;
+	size_t batchSize = 10;
+	uint64_t eventSubscriptions = 0;
+	uint32_t seed = 1;
+	std::string jsonOutputPath;
+};
+
+struct LoadSession {
+	size_t index;
+	bool msgPack;
+	websocketpp::connection_hdl hdl;
+	bool identified = false;
+	bool finished = false;
+	uint64_t nextRequestId = 0;
+	std::unordered_map<uint64_t, std::pair<Clock::time_point, bool>> pendingMessages; // requestId: sent at, is batch
+};
+
+typedef std::shared_ptr<LoadSession> LoadSessionPtr;
+
+class LoadGenerator {
+public:
+	LoadGenerator(const Options &options);
+	bool Run();
+
+private:
+	void Connect(LoadSessionPtr session);
+	void OnMessage(LoadSessionPtr session, const json &message);
+	void OnIdentified(LoadSessionPtr session);
+	void SendNext(LoadSessionPtr session);
+	void SendStatsRequest(LoadSessionPtr session, const std::string &requestId);
+	void Send(LoadSessionPtr session, const json &message);
+	void StartMeasurement();
+	void EndMeasurement();
+	void Finish(LoadSessionPtr session, bool failed);
+	void CloseAll();
+	const MixEntry &PickRequest();
+	json BuildResults();
+
+	Options _options;
+	std::vector<LoadSessionPtr> _sessions;
+	Client _client;
+	Client::timer_ptr _warmupTimer;
+	Client::timer_ptr _measurementTimer;
+	Client::timer_ptr _drainTimer;
+	std::mt19937 _random;
+	std::discrete_distribution<size_t> _mixDistribution;
+	std::bernoulli_distribution _batchDistribution;
+
+	size_t _identifiedSessions = 0;
+	size_t _finishedSessions = 0;
+	size_t _failedSessions = 0;
+	bool _measuring = false;
+	bool _ended = false;
+	Clock::time_point _measurementStartedAt;
+	Clock::time_point _measurementEndedAt;
+	std::clock_t _measurementStartedCpu = 0;
+	std::clock_t _measurementEndedCpu = 0;
+
+	json _serverStatsBefore;
+	json _serverStatsAfter;
+	size_t _failedRequests = 0;
+	size_t _receivedEvents = 0;
+	std::vector<double> _requestLatencies; // Milliseconds
+	std::vector<double> _batchLatencies;
+};
+
+LoadGenerator::LoadGenerator(const Options &options)
+	: _options(options),
+	  _random(options.seed),
+	  _batchDistribution(options.batchRatio)
+{
+	std::vector<double> weights;
+	for (auto &entry : _options.mix)
+		weights.push_back(entry.weight);
+	_mixDistribution = std::discrete_distribution<size_t>(weights.begin(), weights.end());
+
+	for (size_t i = 0; i < _options.sessions; i++) {
+		auto session = std::make_shared<LoadSession>();
+		session->index = i;
+		session->msgPack = _options.encoding == "msgpack" || (_options.encoding == "mixed" && i % 2);
+		_sessions.push_back(session);
+	}
+
+	_client.clear_access_channels(websocketpp::log::alevel::all);
+	_client.clear_error_channels(websocketpp::log::elevel::all);
+	_client.init_asio();
+}
+
+bool LoadGenerator::Run()
+{
+	for (auto &session : _sessions)
+		Connect(session);
+
+	_client.run();
+
+	if (_identifiedSessions != _sessions.size()) {
+		std::cerr << "Not all sessions could be identified." << std::endl;
+		return false;
+	}
+
+	json results = BuildResults();
+	std::cout << "Sessions:          " << _options.sessions << " (" << _failedSessions << " failed)" << std::endl;
+	std::cout << "Duration:          " << results["duration"] << " s" << std::endl;
+	std::cout << "Throughput:        " << results["requestsPerSecond"] << " requests/s, " << results["batchesPerSecond"]
+		  << " batches/s, " << results["eventsPerSecond"] << " events/s" << std::endl;
+	std::cout << "Failed requests:   " << _failedRequests << std::endl;
+	for (const char *kind : {"requestLatency", "batchLatency"}) {
+		const json &latency = results[kind];
+		std::cout << (kind == std::string("requestLatency") ? "Request latency:   " : "Batch latency:     ") << "p50 "
+			  << latency["p50"] << " ms, p99 " << latency["p99"] << " ms, p99.9 " << latency["p999"] << " ms, max "
+			  << latency["max"] << " ms" << std::endl;
+	}
+	std::cout << "OBS CPU usage:     " << results["server"]["cpuUsage"] << " %" << std::endl;
+	std::cout << "OBS memory usage:  " << results["server"]["memoryUsage"] << " MB" << std::endl;
+	std::cout << "Load generator:    " << results["client"]["cpuUsage"] << " % CPU" << std::endl;
+
+	if (!_options.jsonOutputPath.empty()) {
+		json output;
+		output["options"] = {{"sessions", _options.sessions},
+				     {"encoding", _options.encoding},
+				     {"inflight", _options.inflight},
+				     {"duration", _options.duration},
+				     {"warmup", _options.warmup},
+				     {"batchRatio", _options.batchRatio},
+				     {"batchSize", _options.batchSize},
+				     {"eventSubscriptions", _options.eventSubscriptions},
+				     {"seed", _options.seed}};
+		output["options"]["mix"] = json::array();
+		for (auto &entry : _options.mix)
+			output["options"]["mix"].push_back(
+				{{"requestType", entry.requestType}, {"requestData", entry.requestData}, {"weight", entry.weight}});
+		output["results"] = results;
+
+		std::ofstream file(_options.jsonOutputPath);
+		file << output.dump(2) << std::endl;
+	}
+
+	return !_failedSessions;
+}
+
+void LoadGenerator::Connect(LoadSessionPtr session)
+{
+	websocketpp::lib::error_code errorCode;
+	Client::connection_ptr connection = _client.get_connection(_options.url, errorCode);
+	if (errorCode) {
+		std::cerr << "Unable to connect to " << _options.url << ": " << errorCode.message() << std::endl;
+		Finish(session, true);
+		return;
+	}
+
+	connection->add_subprotocol(session->msgPack ? "obswebsocket.msgpack" : "obswebsocket.json");
+	connection->set_message_handler([this, session](websocketpp::connection_hdl, Client::message_ptr message) {
+		json messageJson;
+		if (session->msgPack)
+			messageJson = json::from_msgpack(message->get_payload(), true, false);
+		else
+			messageJson = json::parse(message->get_payload(), nullptr, false);
+		if (messageJson.is_object())
+			OnMessage(session, messageJson);
+	});
+	connection->set_fail_handler([this, session](websocketpp::connection_hdl hdl) {
+		auto connection = _client.get_con_from_hdl(hdl);
+		std::cerr << "Session " << session->index << " failed to connect: " << connection->get_ec().message() << std::endl;
+		Finish(session, true);
+	});
+	connection->set_close_handler([this, session](websocketpp::connection_hdl hdl) {
+		if (session->finished)
+			return;
+
+		auto connection = _client.get_con_from_hdl(hdl);
+		std::cerr << "Session " << session->index << " was closed by the server (" << connection->get_remote_close_code()
+			  << "): " << connection->get_remote_close_reason() << std::endl;
+		session->hdl.reset();
+		Finish(session, true);
+	});
+
+	session->hdl = connection->get_handle();
+	_client.connect(connection);
+}
+
+void LoadGenerator::OnMessage(LoadSessionPtr session, const json &message)
+{
+	int opCode = message.value("op", -1);
+	const json &data = message.contains("d") ? message["d"] : json::object();
+
+	switch (opCode) {
+	case 0: { // Hello
+		json identify;
+		identify["op"] = 1;
+		identify["d"]["rpcVersion"] = data.value("rpcVersion", 1);
+		identify["d"]["eventSubscriptions"] = _options.eventSubscriptions;
+		if (data.contains("authentication")) {
+			if (_options.password.empty()) {
+				std::cerr << "The server requires authentication, but no --password was given." << std::endl;
+				CloseAll();
+				return;
+			}
+
+			identify["d"]["authentication"] = ToolUtils::GenerateAuthenticationString(
+				_options.password, data["authentication"]["salt"], data["authentication"]["challenge"]);
+		}
+		Send(session, identify);
+		break;
+	}
+	case 2: // Identified
+		OnIdentified(session);
+		break;
+	case 5: // Event
+		if (_measuring)
+			_receivedEvents++;
+		break;
+	case 7:   // RequestResponse
+	case 9: { // RequestBatchResponse
+		if (!data.contains("requestId") || !data["requestId"].is_string())
+			break;
+
+		std::string requestId = data["requestId"];
+		if (requestId == "statsBefore" || requestId == "statsAfter") {
+			json &stats = requestId == "statsBefore" ? _serverStatsBefore : _serverStatsAfter;
+			stats = data.value("responseData", json::object());
+			if (requestId == "statsBefore")
+				StartMeasurement();
+			else
+				CloseAll();
+			break;
+		}
+
+		auto it = session->pendingMessages.find(std::strtoull(requestId.c_str(), nullptr, 10));
+		if (it == session->pendingMessages.end())
+			break;
+
+		auto [sentAt, isBatch] = it->second;
+		session->pendingMessages.erase(it);
+
+		// Only messages which were sent and answered while measuring count
+		if (_measuring && sentAt >= _measurementStartedAt) {
+			double latency = std::chrono::duration<double, std::milli>(Clock::now() - sentAt).count();
+			(isBatch ? _batchLatencies : _requestLatencies).push_back(latency);
+
+			if (opCode == 7 && !data["requestStatus"].value("result", false))
+				_failedRequests++;
+			if (opCode == 9) {
+				for (auto &result : data.value("results", json::array()))
+					if (!result["requestStatus"].value("result", false))
+						_failedRequests++;
+			}
+		}
+
+		if (!_ended)
+			SendNext(session);
+		else if (session == _sessions.front() && session->pendingMessages.empty())
+			SendStatsRequest(session, "statsAfter");
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+void LoadGenerator::OnIdentified(LoadSessionPtr session)
+{
+	session->identified = true;
+	if (++_identifiedSessions != _sessions.size())
+		return;
+
+	// Once all sessions are ready, the load starts with the warmup
+	for (auto &loadSession : _sessions)
+		for (size_t i = 0; i < _options.inflight; i++)
+			SendNext(loadSession);
+
+	_warmupTimer = _client.set_timer((long)(_options.warmup * 1000), [this](const websocketpp::lib::error_code &errorCode) {
+		if (!errorCode)
+			SendStatsRequest(_sessions.front(), "statsBefore");
+	});
+}
+
+void LoadGenerator::SendNext(LoadSessionPtr session)
+{
+	uint64_t requestId = session->nextRequestId++;
+	bool isBatch = _batchDistribution(_random);
+
+	json message;
+	if (isBatch) {
+		message["op"] = 8;
+		message["d"]["requestId"] = std::to_string(requestId);
+		json &requests = message["d"]["requests"] = json::array();
+		for (size_t i = 0; i < _options.batchSize; i++) {
+			const MixEntry &entry = PickRequest();
+			json request = {{"requestType", entry.requestType}};
+			if (!entry.requestData.is_null())
+				request["requestData"] = entry.requestData;
+			requests.push_back(request);
+		}
+	} else {
+		const MixEntry &entry = PickRequest();
+		message["op"] = 6;
+		message["d"]["requestType"] = entry.requestType;
+		message["d"]["requestId"] = std::to_string(requestId);
+		if (!entry.requestData.is_null())
+			message["d"]["requestData"] = entry.requestData;
+	}
+
+	session->pendingMessages[requestId] = {Clock::now(), isBatch};
+	Send(session, message);
+}
+
+// Stats are always requested on the first session. After the measurement, this waits until its other messages are answered.
+void LoadGenerator::SendStatsRequest(LoadSessionPtr session, const std::string &requestId)
+{
+	json message;
+	message["op"] = 6;
+	message["d"]["requestType"] = "GetStats";
+	message["d"]["requestId"] = requestId;
+	Send(session, message);
+}
+
+void LoadGenerator::Send(LoadSessionPtr session, const json &message)
+{
+	websocketpp::lib::error_code errorCode;
+	if (session->msgPack) {
+		std::vector<uint8_t> data = json::to_msgpack(message);
+		_client.send(session->hdl, std::string(data.begin(), data.end()), websocketpp::frame::opcode::binary, errorCode);
+	} else {
+		_client.send(session->hdl, message.dump(), websocketpp::frame::opcode::text, errorCode);
+	}
+
+	if (errorCode) {
+		std::cerr << "Session " << session->index << " failed to send: " << errorCode.message() << std::endl;
+		Finish(session, true);
+	}
+}
+
+void LoadGenerator::StartMeasurement()
+{
+	_measuring = true;
+	_measurementStartedAt = Clock::now();
+	_measurementStartedCpu = std::clock();
+
+	long durationMillis = (long)(_options.duration * 1000);
+	_measurementTimer = _client.set_timer(durationMillis, [this](const websocketpp::lib::error_code &errorCode) {
+		if (!errorCode)
+			EndMeasurement();
+	});
+}
+
+void LoadGenerator::EndMeasurement()
+{
+	_measurementEndedAt = Clock::now();
+	_measurementEndedCpu = std::clock();
+	_measuring = false;
+	_ended = true;
+
+	// Outstanding responses are drained before the stats are taken
+	auto &firstSession = _sessions.front();
+	if (firstSession->pendingMessages.empty())
+		SendStatsRequest(firstSession, "statsAfter");
+
+	_drainTimer = _client.set_timer(DrainTimeoutMillis, [this](const websocketpp::lib::error_code &errorCode) {
+		if (errorCode || _finishedSessions == _sessions.size())
+			return;
+
+		std::cerr << "Timed out waiting for responses." << std::endl;
+		CloseAll();
+	});
+}
+
+void LoadGenerator::Finish(LoadSessionPtr session, bool failed)
+{
+	if (session->finished)
+		return;
+
+	session->finished = true;
+	_finishedSessions++;
+	if (failed)
+		_failedSessions++;
+
+	if (!session->hdl.expired()) {
+		websocketpp::lib::error_code errorCode;
+		_client.close(session->hdl, websocketpp::close::status::normal, "Load generator finished.", errorCode);
+	}
+
+	// Without a measurement to finish, the remaining sessions are useless
+	if (failed && !_ended)
+		CloseAll();
+}
+
+void LoadGenerator::CloseAll()
+{
+	_ended = true;
+	for (auto &session : _sessions)
+		Finish(session, false);
+
+	// Pending timers would otherwise keep `run()` going
+	for (auto &timer : {_warmupTimer, _measurementTimer, _drainTimer})
+		if (timer)
+			timer->cancel();
+}
+
+const MixEntry &LoadGenerator::PickRequest()
+{
+	return _options.mix[_mixDistribution(_random)];
+}
+
+json LoadGenerator::BuildResults()
+{
+	std::sort(_requestLatencies.begin(), _requestLatencies.end());
+	std::sort(_batchLatencies.begin(), _batchLatencies.end());
+
+	double duration = std::chrono::duration<double>(_measurementEndedAt - _measurementStartedAt).count();
+	double cpuTime = (double)(_measurementEndedCpu - _measurementStartedCpu) / CLOCKS_PER_SEC;
+
+	auto latencyJson = [](const std::vector<double> &latencies) {
+		return json{{"count", latencies.size()},
+			    {"p50", ToolUtils::GetPercentile(latencies, 50)},
+			    {"p99", ToolUtils::GetPercentile(latencies, 99)},
+			    {"p999", ToolUtils::GetPercentile(latencies, 99.9)},
+			    {"max", latencies.empty() ? 0 : latencies.back()}};
+	};
+
+	json results;
+	results["duration"] = duration;
+	results["requestsPerSecond"] = duration > 0 ? _requestLatencies.size() / duration : 0;
+	results["batchesPerSecond"] = duration > 0 ? _batchLatencies.size() / duration : 0;
+	results["eventsPerSecond"] = duration > 0 ? _receivedEvents / duration : 0;
+	results["failedRequests"] = _failedRequests;
+	results["requestLatency"] = latencyJson(_requestLatencies);
+	results["batchLatency"] = latencyJson(_batchLatencies);
+	// `GetStats` reports the CPU usage of OBS since its previous query, so the second sample covers the measurement, unless
+	// something else (like another client or the flight recorder) queried it in between
+	results["server"]["cpuUsage"] = _serverStatsAfter.value("cpuUsage", 0.0);
+	results["server"]["memoryUsage"] = _serverStatsAfter.value("memoryUsage", 0.0);
+	results["server"]["memoryUsageBefore"] = _serverStatsBefore.value("memoryUsage", 0.0);
+	results["client"]["cpuUsage"] = duration > 0 ? cpuTime / duration * 100 : 0;
+
+	return results;
+}
+
+static bool ParseMix(const std::string &mix, std::vector<MixEntry> &entries)
+{
+	size_t start = 0;
+	while (start < mix.size()) {
+		size_t end = mix.find(',', start);
+		std::string item = mix.substr(start, end == std::string::npos ? std::string::npos : end - start);
+		size_t colon = item.find(':');
+		double weight = colon == std::string::npos ? 1 : std::atof(item.c_str() + colon + 1);
+		MixEntry entry{item.substr(0, colon), nullptr, weight};
+		if (entry.requestType.empty() || entry.weight <= 0)
+			return false;
+
+		entries.push_back(entry);
+		if (end == std::string::npos)
+			break;
+		start = end + 1;
+	}
+
+	return !entries.empty();
+}
+
+static bool LoadMixFile(const std::string &path, std::vector<MixEntry> &entries)
+{
+	std::ifstream file(path);
+	json mix = json::parse(file, nullptr, false);
+	if (!mix.is_array())
+		return false;
+
+	for (auto &item : mix) {
+		if (!item.is_object() || !item.contains("requestType") || !item["requestType"].is_string())
+			return false;
+
+		MixEntry entry{item["requestType"], item.value("requestData", json()), item.value("weight", 1.0)};
+		if (entry.weight <= 0)
+			return false;
+
+		entries.push_back(entry);
+	}
+
+	return !entries.empty();
+}
+
+static bool ParseOptions(int argc, char **argv, Options &options)
+{
+	for (int i = 1; i + 1 < argc; i += 2) {
+		std::string arg = argv[i];
+		std::string value = argv[i + 1];
+		if (arg == "--url")
+			options.url = value;
+		else if (arg == "--password")
+			options.password = value;
+		else if (arg == "--sessions")
+			options.sessions = std::strtoul(value.c_str(), nullptr, 10);
+		else if (arg == "--encoding")
+			options.encoding = value;
+		else if (arg == "--inflight")
+			options.inflight = std::strtoul(value.c_str(), nullptr, 10);
+		else if (arg == "--duration")
+			options.duration = std::atof(value.c_str());
+		else if (arg == "--warmup")
+			options.warmup = std::atof(value.c_str());
+		else if (arg == "--mix") {
+			if (!ParseMix(value, options.mix))
+				return false;
+		} else if (arg == "--mix-file") {
+			if (!LoadMixFile(value, options.mix))
+				return false;
+		} else if (arg == "--batch-ratio")
+			options.batchRatio = std::atof(value.c_str());
+		else if (arg == "--batch-size")
+			options.batchSize = std::strtoul(value.c_str(), nullptr, 10);
+		else if (arg == "--event-subscriptions")
+			options.eventSubscriptions = std::strtoull(value.c_str(), nullptr, 10);
+		else if (arg == "--seed")
+			options.seed = std::strtoul(value.c_str(), nullptr, 10);
+		else if (arg == "--json-output")
+			options.jsonOutputPath = value;
+		else
+			return false;
+	}
+
+	if (argc % 2 == 0)
+		return false;
+
+	if (options.mix.empty())
+		options.mix.push_back({"GetVersion", nullptr, 1});
+
+	return options.sessions && options.inflight && options.duration > 0 && options.warmup >= 0 && options.batchRatio >= 0 &&
+	       options.batchRatio <= 1 && options.batchSize &&
+	       (options.encoding == "json" || options.encoding == "msgpack" || options.encoding == "mixed");
+}
+
+int main(int argc, char **argv)
+{
+	Options options;
+	if (!ParseOptions(argc, argv, options)) {
+		std::cerr << "Invalid options. See tools/README.md for the usage." << std::endl;
+		return 1;
+	}
+
+	LoadGenerator loadGenerator(options);
+	return loadGenerator.Run() ? 0 : 1;
+}
@@ -0,0 +1,165 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <obs-module.h>
+
+#include "HeadlessPlugin.h"
+#include "../../src/obs-websocket.h"
+#include "../../src/Config.h"
+#include "../../src/WebSocketApi.h"
+#include "../../src/websocketserver/WebSocketServer.h"
+#include "../../src/eventhandler/EventHandler.h"
+#include "../../src/utils/FlightRecorder.h"
+#include "../../src/utils/TrafficCapture.h"
+
+OBS_DECLARE_MODULE()
+OBS_MODULE_USE_DEFAULT_LOCALE("obs-websocket", "en-US")
+
+static os_cpu_usage_info_t *_cpuUsageInfo = nullptr;
+static ConfigPtr _config;
+static EventHandlerPtr _eventHandler;
+static WebSocketApiPtr _webSocketApi;
+static WebSocketServerPtr _webSocketServer;
+
+static void OnWebSocketApiVendorEvent(std::string vendorName, std::string eventType, obs_data_t *obsEventData)
+{
+	json broadcastEventData;
+	broadcastEventData["vendorName"] = vendorName;
+	broadcastEventData["eventType"] = eventType;
+	broadcastEventData["eventData"] = Utils::Json::ObsDataToJson(obsEventData);
+
+	_webSocketServer->BroadcastEvent(EventSubscription::Vendors, "VendorEvent", broadcastEventData);
+}
+
+static void OnEvent(uint64_t requiredIntent, std::string eventType, json eventData, uint8_t rpcVersion)
+{
+	if (_webSocketServer)
+		_webSocketServer->BroadcastEvent(requiredIntent, eventType, eventData, rpcVersion);
+	if (_webSocketApi)
+		_webSocketApi->BroadcastEvent(requiredIntent, eventType, eventData, rpcVersion);
+}
+
+static void OnObsReady(bool ready)
+{
+	if (_webSocketServer)
+		_webSocketServer->SetObsReady(ready);
+	if (_webSocketApi)
+		_webSocketApi->SetObsReady(ready);
+}
+
+bool HeadlessPlugin::Load()
+{
+	blog(LOG_INFO, "[HeadlessPlugin::Load] Loading headless obs-websocket (Version: %s | RPC Version: %d)",
+	     OBS_WEBSOCKET_VERSION, OBS_WEBSOCKET_RPC_VERSION);
+
+	obs_module_set_locale("en-US");
+
+	_cpuUsageInfo = os_cpu_usage_info_start();
+
+	if (!MigratePersistentData()) {
+		os_cpu_usage_info_destroy(_cpuUsageInfo);
+		_cpuUsageInfo = nullptr;
+		return false;
+	}
+	json migratedConfig = MigrateGlobalConfigData();
+
+	_config = std::make_shared<Config>();
+	_config->Load(migratedConfig);
+
+	if (_config->FlightRecorderSizeMiB)
+		Utils::FlightRecorder::Start(Utils::Obs::StringHelper::GetModuleConfigPath("flight_recorder.bin"),
+					     (uint64_t)_config->FlightRecorderSizeMiB * 1024 * 1024);
+	if (!_config->CaptureFilePath.empty())
+		Utils::TrafficCapture::Start(_config->CaptureFilePath);
+
+	_eventHandler = std::make_shared<EventHandler>();
+	_eventHandler->SetEventCallback(OnEvent);
+	_eventHandler->SetObsReadyCallback(OnObsReady);
+
+	_webSocketApi = std::make_shared<WebSocketApi>();
+	_webSocketApi->SetVendorEventCallback(OnWebSocketApiVendorEvent);
+
+	_webSocketServer = std::make_shared<WebSocketServer>();
+	_webSocketServer->SetClientSubscriptionCallback(std::bind(&EventHandler::ProcessSubscriptionChange, _eventHandler.get(),
+								  std::placeholders::_1, std::placeholders::_2));
+
+	blog(LOG_INFO, "[HeadlessPlugin::Load] Module loaded.");
+	return true;
+}
+
+void HeadlessPlugin::Unload()
+{
+	if (!_config)
+		return;
+
+	blog(LOG_INFO, "[HeadlessPlugin::Unload] Shutting down...");
+
+	if (_webSocketServer->IsListening())
+		_webSocketServer->Stop();
+
+	_webSocketServer->SetClientSubscriptionCallback(nullptr);
+	_webSocketServer = nullptr;
+
+	_webSocketApi = nullptr;
+
+	_eventHandler->SetObsReadyCallback(nullptr);
+	_eventHandler->SetEventCallback(nullptr);
+	_eventHandler = nullptr;
+
+	Utils::FlightRecorder::Stop();
+	Utils::TrafficCapture::Stop();
+
+	_config = nullptr;
+
+	os_cpu_usage_info_destroy(_cpuUsageInfo);
+	_cpuUsageInfo = nullptr;
+
+	obs_module_free_locale();
+
+	blog(LOG_INFO, "[HeadlessPlugin::Unload] Finished shutting down.");
+}
+
+os_cpu_usage_info_t *GetCpuUsageInfo()
+{
+	return _cpuUsageInfo;
+}
+
+ConfigPtr GetConfig()
+{
+	return _config;
+}
+
+EventHandlerPtr GetEventHandler()
+{
+	return _eventHandler;
+}
+
+WebSocketApiPtr GetWebSocketApi()
+{
+	return _webSocketApi;
+}
+
+WebSocketServerPtr GetWebSocketServer()
+{
+	return _webSocketServer;
+}
+
+bool IsDebugEnabled()
+{
+	return !_config || _config->DebugEnabled;
+}
@@ -0,0 +1,27 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+// Loads the plugin without the OBS frontend UI, on top of the mock libobs. Mirrors `obs_module_load()` and
+// `obs_module_unload()` of obs-websocket.cpp, minus the settings dialog and tools menu entry
+namespace HeadlessPlugin {
+	// Requires `MockObs::Initialize()` and a QApplication. Does not start the WebSocket server
+	bool Load();
+	void Unload();
+}
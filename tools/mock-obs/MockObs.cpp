@@ -0,0 +1,616 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <obs-module.h>
+#include <util/platform.h>
+
+#include "MockObsInternal.h"
+
+#define AUDIO_SAMPLE_RATE 48000
+
+using namespace MockObs::Internal;
+
+struct video_output {
+	struct obs_video_info info;
+};
+
+struct gs_texture_render {
+	gs_texture_t *texture;
+};
+
+struct gs_stage_surface {
+	uint32_t width;
+	uint32_t height;
+};
+
+struct CoreState {
+	MockObs::Settings settings;
+	signal_handler_t *signals = nullptr;
+	proc_handler_t *procs = nullptr;
+	obs_data_t *privateData = nullptr;
+	std::unique_ptr<TaskQueue> uiQueue;
+	std::unique_ptr<TaskQueue> coreQueue;
+	video_output video = {};
+
+	std::vector<std::pair<void (*)(void *, float), void *>> tickCallbacks;
+	std::vector<std::unique_ptr<obs_hotkey>> hotkeys;
+	obs_hotkey_id nextHotkeyId = 1;
+
+	std::thread clockThread;
+	std::atomic<bool> clockRunning = false;
+	std::atomic<uint32_t> totalFrames = 0;
+	std::atomic<uint32_t> laggedFrames = 0;
+	std::atomic<uint64_t> averageFrameTimeNs = 0;
+	std::atomic<double> activeFps = 0.0;
+};
+
+static std::recursive_mutex mutex;
+static std::recursive_mutex graphicsMutex;
+static CoreState *core = nullptr;
+
+std::recursive_mutex &MockObs::Internal::GetMutex()
+{
+	return mutex;
+}
+
+const MockObs::Settings &MockObs::Internal::GetSettings()
+{
+	static const MockObs::Settings defaultSettings;
+	return core ? core->settings : defaultSettings;
+}
+
+signal_handler_t *MockObs::Internal::GetCoreSignalHandler()
+{
+	return core ? core->signals : nullptr;
+}
+
+MockObs::Internal::TaskQueue::TaskQueue() : _thread(&TaskQueue::Run, this) {}
+
+MockObs::Internal::TaskQueue::~TaskQueue()
+{
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_stopping = true;
+	}
+	_cv.notify_all();
+	_thread.join();
+}
+
+// Waiting from the queue's own thread runs the task inline, since it could never be reached otherwise
+void MockObs::Internal::TaskQueue::Push(std::function<void()> task, bool wait)
+{
+	if (wait && IsCurrentThread()) {
+		task();
+		return;
+	}
+
+	if (!wait) {
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_tasks.push_back(std::move(task));
+		}
+		_cv.notify_all();
+		return;
+	}
+
+	std::mutex doneMutex;
+	std::condition_variable doneCv;
+	bool done = false;
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_tasks.push_back([&]() {
+			task();
+			std::unique_lock<std::mutex> doneLock(doneMutex);
+			done = true;
+			doneCv.notify_all();
+		});
+	}
+	_cv.notify_all();
+
+	std::unique_lock<std::mutex> doneLock(doneMutex);
+	doneCv.wait(doneLock, [&]() { return done; });
+}
+
+bool MockObs::Internal::TaskQueue::IsCurrentThread() const
+{
+	return std::this_thread::get_id() == _thread.get_id();
+}
+
+// Drains all queued tasks before stopping
+void MockObs::Internal::TaskQueue::Run()
+{
+	while (true) {
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_cv.wait(lock, [this]() { return _stopping || !_tasks.empty(); });
+			if (_tasks.empty())
+				return;
+
+			task = std::move(_tasks.front());
+			_tasks.pop_front();
+		}
+
+		task();
+	}
+}
+
+TaskQueue &MockObs::Internal::GetUiQueue()
+{
+	return *core->uiQueue;
+}
+
+TaskQueue &MockObs::Internal::GetCoreQueue()
+{
+	return *core->coreQueue;
+}
+
+void MockObs::Internal::ResetVideo(uint32_t baseWidth, uint32_t baseHeight, uint32_t outputWidth, uint32_t outputHeight,
+				   uint32_t fpsNumerator, uint32_t fpsDenominator)
+{
+	std::lock_guard<std::recursive_mutex> lock(mutex);
+	struct obs_video_info &ovi = core->video.info;
+	ovi.graphics_module = "libobs-mock";
+	ovi.base_width = baseWidth;
+	ovi.base_height = baseHeight;
+	ovi.output_width = outputWidth;
+	ovi.output_height = outputHeight;
+	ovi.fps_num = fpsNumerator ? fpsNumerator : 30;
+	ovi.fps_den = fpsDenominator ? fpsDenominator : 1;
+	ovi.output_format = VIDEO_FORMAT_NV12;
+	ovi.adapter = 0;
+	ovi.gpu_conversion = true;
+	ovi.colorspace = VIDEO_CS_709;
+	ovi.range = VIDEO_RANGE_PARTIAL;
+	ovi.scale_type = OBS_SCALE_BICUBIC;
+}
+
+void MockObs::Internal::AddVideoFrame(uint64_t renderTimeNs)
+{
+	core->totalFrames++;
+
+	// Exponential moving average, smoothed over roughly a second of frames
+	uint64_t average = core->averageFrameTimeNs;
+	core->averageFrameTimeNs = average ? (average * 59 + renderTimeNs) / 60 : renderTimeNs;
+}
+
+// Stands in for the OBS graphics and audio threads: runs tick callbacks and counts a frame every frame interval, and
+// sends a block of synthetic audio every AUDIO_OUTPUT_FRAMES samples
+static void ClockThread()
+{
+	uint64_t startTime = os_gettime_ns();
+	uint64_t nextFrameTime = startTime;
+	uint64_t nextAudioTime = startTime;
+	uint64_t lastTickTime = startTime;
+	uint64_t fpsWindowStart = startTime;
+	uint32_t fpsWindowFrames = 0;
+	const uint64_t audioInterval = (uint64_t)AUDIO_OUTPUT_FRAMES * 1000000000 / AUDIO_SAMPLE_RATE;
+
+	while (core->clockRunning) {
+		uint64_t frameInterval = video_output_get_frame_time(obs_get_video());
+
+		std::this_thread::sleep_until(std::chrono::steady_clock::time_point(std::chrono::nanoseconds(nextFrameTime)));
+		uint64_t frameStart = os_gettime_ns();
+
+		std::vector<std::pair<void (*)(void *, float), void *>> tickCallbacks;
+		{
+			std::lock_guard<std::recursive_mutex> lock(mutex);
+			tickCallbacks = core->tickCallbacks;
+		}
+
+		float seconds = (float)(frameStart - lastTickTime) / 1000000000.0f;
+		lastTickTime = frameStart;
+		for (auto &callback : tickCallbacks)
+			callback.first(callback.second, seconds);
+
+		TickSources();
+
+		while (nextAudioTime <= frameStart) {
+			SendAudio(AUDIO_OUTPUT_FRAMES, nextAudioTime);
+			nextAudioTime += audioInterval;
+		}
+
+		uint64_t frameEnd = os_gettime_ns();
+		AddVideoFrame(frameEnd - frameStart);
+
+		fpsWindowFrames++;
+		if (frameEnd - fpsWindowStart >= 1000000000) {
+			core->activeFps = (double)fpsWindowFrames * 1000000000.0 / (double)(frameEnd - fpsWindowStart);
+			fpsWindowStart = frameEnd;
+			fpsWindowFrames = 0;
+		}
+
+		// Frames which could not be rendered in time are skipped, like lagged frames in OBS
+		nextFrameTime += frameInterval;
+		while (nextFrameTime + frameInterval <= frameEnd) {
+			nextFrameTime += frameInterval;
+			core->laggedFrames++;
+		}
+	}
+
+	core->activeFps = 0.0;
+}
+
+void MockObs::Initialize(const Settings &settings)
+{
+	if (core) {
+		blog(LOG_WARNING, "[MockObs::Initialize] Already initialized");
+		return;
+	}
+
+	core = new CoreState;
+	core->settings = settings;
+	core->signals = signal_handler_create();
+	core->procs = proc_handler_create();
+	core->privateData = obs_data_create();
+	core->uiQueue = std::make_unique<TaskQueue>();
+	core->coreQueue = std::make_unique<TaskQueue>();
+	ResetVideo(settings.baseWidth, settings.baseHeight, settings.baseWidth, settings.baseHeight, settings.fpsNumerator,
+		   settings.fpsDenominator);
+
+	InitializeSources();
+	InitializeFrontend();
+
+	// Let the frontend pick up its initial scene
+	RunOnUiThread([]() {});
+
+	blog(LOG_INFO, "[MockObs::Initialize] Mock OBS initialized (%ux%u at %u/%u fps)", settings.baseWidth, settings.baseHeight,
+	     settings.fpsNumerator, settings.fpsDenominator);
+}
+
+void MockObs::Shutdown()
+{
+	if (!core)
+		return;
+
+	StopClock();
+	ShutdownFrontend();
+	ShutdownSources();
+
+	// Destroying the queues drains them first
+	core->uiQueue.reset();
+	core->coreQueue.reset();
+
+	{
+		std::lock_guard<std::recursive_mutex> lock(mutex);
+		core->tickCallbacks.clear();
+		core->hotkeys.clear();
+	}
+
+	obs_data_release(core->privateData);
+	proc_handler_destroy(core->procs);
+	signal_handler_destroy(core->signals);
+
+	delete core;
+	core = nullptr;
+}
+
+void MockObs::StartClock()
+{
+	if (core->clockRunning.exchange(true))
+		return;
+
+	core->clockThread = std::thread(ClockThread);
+}
+
+void MockObs::StopClock()
+{
+	if (!core->clockRunning.exchange(false))
+		return;
+
+	core->clockThread.join();
+}
+
+void MockObs::RegisterHotkey(const std::string &name, const std::string &description, std::function<void(bool pressed)> callback)
+{
+	auto hotkey = std::make_unique<obs_hotkey>();
+	hotkey->name = name;
+	hotkey->description = description;
+	hotkey->callback = callback;
+
+	std::lock_guard<std::recursive_mutex> lock(mutex);
+	hotkey->id = core->nextHotkeyId++;
+	core->hotkeys.push_back(std::move(hotkey));
+}
+
+void MockObs::RunOnUiThread(std::function<void()> task)
+{
+	GetUiQueue().Push(task, true);
+}
+
+uint32_t obs_get_version(void)
+{
+	return (30 << 24) | (0 << 16) | 0;
+}
+
+const char *obs_get_version_string(void)
+{
+	return "30.0.0-mock";
+}
+
+signal_handler_t *obs_get_signal_handler(void)
+{
+	return core ? core->signals : nullptr;
+}
+
+proc_handler_t *obs_get_proc_handler(void)
+{
+	return core ? core->procs : nullptr;
+}
+
+video_t *obs_get_video(void)
+{
+	return core ? &core->video : nullptr;
+}
+
+bool obs_get_video_info(struct obs_video_info *ovi)
+{
+	if (!core || !ovi)
+		return false;
+
+	std::lock_guard<std::recursive_mutex> lock(mutex);
+	*ovi = core->video.info;
+	return true;
+}
+
+uint64_t video_output_get_frame_time(const video_t *video)
+{
+	if (!video)
+		return 0;
+
+	std::lock_guard<std::recursive_mutex> lock(mutex);
+	return (uint64_t)1000000000 * video->info.fps_den / video->info.fps_num;
+}
+
+uint32_t video_output_get_skipped_frames(const video_t *video)
+{
+	return video ? core->laggedFrames.load() : 0;
+}
+
+uint32_t video_output_get_total_frames(const video_t *video)
+{
+	return video ? core->totalFrames.load() : 0;
+}
+
+// Like libobs, video is active while an output uses it
+bool obs_video_active(void)
+{
+	bool active = false;
+	obs_enum_outputs(
+		[](void *param, obs_output_t *output) {
+			if (obs_output_active(output) && (obs_output_get_flags(output) & OBS_OUTPUT_VIDEO))
+				*static_cast<bool *>(param) = true;
+			return true;
+		},
+		&active);
+	return active;
+}
+
+double obs_get_active_fps(void)
+{
+	return core ? core->activeFps.load() : 0.0;
+}
+
+uint64_t obs_get_average_frame_time_ns(void)
+{
+	return core ? core->averageFrameTimeNs.load() : 0;
+}
+
+uint32_t obs_get_total_frames(void)
+{
+	return core ? core->totalFrames.load() : 0;
+}
+
+uint32_t obs_get_lagged_frames(void)
+{
+	return core ? core->laggedFrames.load() : 0;
+}
+
+bool obs_audio_monitoring_available(void)
+{
+	return true;
+}
+
+obs_data_t *obs_get_private_data(void)
+{
+	if (!core)
+		return nullptr;
+
+	obs_data_addref(core->privateData);
+	return core->privateData;
+}
+
+void obs_queue_task(enum obs_task_type type, obs_task_t task, void *param, bool wait)
+{
+	TaskQueue &queue = type == OBS_TASK_UI ? GetUiQueue() : GetCoreQueue();
+	queue.Push([task, param]() { task(param); }, wait);
+}
+
+void obs_add_tick_callback(void (*tick)(void *param, float seconds), void *param)
+{
+	std::lock_guard<std::recursive_mutex> lock(mutex);
+	core->tickCallbacks.emplace_back(tick, param);
+}
+
+void obs_remove_tick_callback(void (*tick)(void *param, float seconds), void *param)
+{
+	std::lock_guard<std::recursive_mutex> lock(mutex);
+	auto &callbacks = core->tickCallbacks;
+	auto it = std::find(callbacks.begin(), callbacks.end(), std::make_pair(tick, param));
+	if (it != callbacks.end())
+		callbacks.erase(it);
+}
+
+float obs_db_to_mul(float db)
+{
+	return std::isinf(db) && db < 0.0f ? 0.0f : powf(10.0f, db / 20.0f);
+}
+
+float obs_mul_to_db(float mul)
+{
+	return mul == 0.0f ? -INFINITY : 20.0f * log10f(mul);
+}
+
+void obs_enum_hotkeys(obs_hotkey_enum_func func, void *data)
+{
+	std::vector<obs_hotkey_t *> hotkeys;
+	{
+		std::lock_guard<std::recursive_mutex> lock(mutex);
+		for (auto &hotkey : core->hotkeys)
+			hotkeys.push_back(hotkey.get());
+	}
+
+	for (obs_hotkey_t *hotkey : hotkeys)
+		if (!func(data, hotkey->id, hotkey))
+			break;
+}
+
+obs_hotkey_id obs_hotkey_get_id(const obs_hotkey_t *key)
+{
+	return key ? key->id : 0;
+}
+
+const char *obs_hotkey_get_name(const obs_hotkey_t *key)
+{
+	return key ? key->name.c_str() : nullptr;
+}
+
+const char *obs_hotkey_get_description(const obs_hotkey_t *key)
+{
+	return key ? key->description.c_str() : nullptr;
+}
+
+// All mock hotkeys belong to the frontend
+enum obs_hotkey_registerer_type obs_hotkey_get_registerer_type(const obs_hotkey_t *)
+{
+	return OBS_HOTKEY_REGISTERER_FRONTEND;
+}
+
+void *obs_hotkey_get_registerer(const obs_hotkey_t *)
+{
+	return nullptr;
+}
+
+void obs_hotkey_trigger_routed_callback(obs_hotkey_id id, bool pressed)
+{
+	std::function<void(bool)> callback;
+	{
+		std::lock_guard<std::recursive_mutex> lock(mutex);
+		for (auto &hotkey : core->hotkeys)
+			if (hotkey->id == id)
+				callback = hotkey->callback;
+	}
+
+	if (callback)
+		callback(pressed);
+}
+
+// There are no key bindings in the mock, so injected key combinations never trigger anything
+void obs_hotkey_inject_event(obs_key_combination_t, bool) {}
+
+obs_key_t obs_key_from_name(const char *)
+{
+	return OBS_KEY_NONE;
+}
+
+void obs_enter_graphics(void)
+{
+	graphicsMutex.lock();
+}
+
+void obs_leave_graphics(void)
+{
+	graphicsMutex.unlock();
+}
+
+// Without a GPU nothing can be rendered, so texture renders never begin and screenshots fail cleanly
+gs_texrender_t *gs_texrender_create(enum gs_color_format, enum gs_zstencil_format)
+{
+	return new gs_texture_render{nullptr};
+}
+
+void gs_texrender_destroy(gs_texrender_t *texrender)
+{
+	delete texrender;
+}
+
+bool gs_texrender_begin(gs_texrender_t *, uint32_t, uint32_t)
+{
+	return false;
+}
+
+void gs_texrender_end(gs_texrender_t *) {}
+
+void gs_texrender_reset(gs_texrender_t *) {}
+
+gs_texture_t *gs_texrender_get_texture(const gs_texrender_t *texrender)
+{
+	return texrender ? texrender->texture : nullptr;
+}
+
+gs_stagesurf_t *gs_stagesurface_create(uint32_t width, uint32_t height, enum gs_color_format)
+{
+	return new gs_stage_surface{width, height};
+}
+
+void gs_stagesurface_destroy(gs_stagesurf_t *stagesurf)
+{
+	delete stagesurf;
+}
+
+bool gs_stagesurface_map(gs_stagesurf_t *, uint8_t **, uint32_t *)
+{
+	return false;
+}
+
+void gs_stagesurface_unmap(gs_stagesurf_t *) {}
+
+void gs_stage_texture(gs_stagesurf_t *, gs_texture_t *) {}
+
+void gs_clear(uint32_t, const struct vec4 *, float, uint8_t) {}
+
+void gs_ortho(float, float, float, float, float, float) {}
+
+void gs_blend_state_push(void) {}
+
+void gs_blend_state_pop(void) {}
+
+void gs_blend_function(enum gs_blend_type, enum gs_blend_type) {}
+
+// Module config files are kept in `<configDirectory>/plugin_config/<module>`, like OBS does
+char *obs_module_get_config_path(obs_module_t *, const char *file)
+{
+	std::string path = GetSettings().configDirectory + "/plugin_config/obs-websocket/" + (file ? file : "");
+	return bstrdup(path.c_str());
+}
+
+// No locale files are loaded, so lookups fall back to the untranslated key
+lookup_t *obs_module_load_locale(obs_module_t *, const char *, const char *)
+{
+	return nullptr;
+}
+
+void text_lookup_destroy(lookup_t *) {}
+
+bool text_lookup_getstr(lookup_t *lookup, const char *, const char **)
+{
+	return lookup != nullptr;
+}
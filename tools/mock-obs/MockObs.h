@@ -0,0 +1,70 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <obs.h>
+#include <obs-frontend-api.h>
+
+// Control interface of the mock libobs and frontend API in this directory, for driving obs-websocket without OBS.
+//
+// The mock implements the parts of libobs, obs-frontend-api and the signal/proc handlers which obs-websocket uses, backed by
+// in-memory sources, scenes, scene items, filters, transitions and outputs. Frontend calls which change state run on a mock
+// UI thread, and a clock thread ticks video frames and feeds synthetic audio to audio capture callbacks.
+namespace MockObs {
+	struct Settings {
+		std::string configDirectory = "/tmp/obs-websocket-mock";
+		uint32_t fpsNumerator = 60;
+		uint32_t fpsDenominator = 1;
+		uint32_t baseWidth = 1920;
+		uint32_t baseHeight = 1080;
+		int logLevel = LOG_INFO;
+	};
+
+	// Creates the core and frontend state, including the default transitions, outputs and audio devices
+	void Initialize(const Settings &settings = Settings());
+	// Releases everything. Sources still referenced by the caller are leaked
+	void Shutdown();
+
+	// Emits OBS_FRONTEND_EVENT_FINISHED_LOADING, like OBS does once the scene collection has been loaded
+	void FinishLoading();
+	// Emits a frontend event on the mock UI thread, then waits for all callbacks to return
+	void EmitFrontendEvent(enum obs_frontend_event event);
+
+	// Starts ticking video frames at the configured frame rate and sending synthetic audio of active inputs
+	void StartClock();
+	void StopClock();
+	// Passes `data` to the audio capture callbacks of `input` right away, whether or not it is active
+	void SendInputAudio(obs_source_t *input, const struct audio_data *data);
+
+	// Creates a scene and adds it to the frontend scene list. Returns a new reference
+	obs_source_t *CreateScene(const std::string &name);
+	// Creates an input and adds it to a scene. Returns a new reference
+	obs_source_t *CreateInput(obs_source_t *scene, const std::string &name, const std::string &kind);
+	// Creates `sceneCount` scenes with `inputsPerScene` inputs each (alternating between audio, video and media inputs) and
+	// `filtersPerInput` filters on every input, then makes the first scene the program scene
+	void CreateSceneCollection(size_t sceneCount, size_t inputsPerScene, size_t filtersPerInput);
+
+	// Registers a frontend hotkey, which calls `callback` when triggered
+	void RegisterHotkey(const std::string &name, const std::string &description, std::function<void(bool pressed)> callback);
+
+	// Runs `task` on the mock UI thread and waits for it
+	void RunOnUiThread(std::function<void()> task);
+}
@@ -0,0 +1,264 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <obs.h>
+#include <obs-frontend-api.h>
+
+#include "MockObs.h"
+
+namespace MockObs {
+	namespace Internal {
+		// Guards all sources, scenes, outputs and frontend state. Signals are emitted without holding it, like libobs does
+		std::recursive_mutex &GetMutex();
+		const Settings &GetSettings();
+		signal_handler_t *GetCoreSignalHandler();
+
+		template<typename T> struct WeakReference {
+			std::atomic<long> refs{1};
+			std::atomic<long> weakRefs{1};
+			T *object = nullptr;
+
+			bool GetRef()
+			{
+				long current = refs.load();
+				while (current > 0)
+					if (refs.compare_exchange_weak(current, current + 1))
+						return true;
+				return false;
+			}
+			void AddWeakRef() { weakRefs++; }
+		};
+
+		template<typename W> void ReleaseWeak(W *weak)
+		{
+			if (weak && weak->weakRefs.fetch_sub(1) == 1)
+				delete weak;
+		}
+
+		// Runs tasks in order on its own thread, standing in for the UI and graphics threads
+		class TaskQueue {
+		public:
+			TaskQueue();
+			~TaskQueue();
+			void Push(std::function<void()> task, bool wait);
+			bool IsCurrentThread() const;
+
+		private:
+			void Run();
+
+			std::mutex _mutex;
+			std::condition_variable _cv;
+			std::deque<std::function<void()>> _tasks;
+			bool _stopping = false;
+			std::thread _thread;
+		};
+
+		TaskQueue &GetUiQueue();
+		TaskQueue &GetCoreQueue();
+
+		struct PropertyInfo {
+			std::string name;
+			enum obs_property_type type;
+			enum obs_combo_format format;
+			std::vector<std::pair<std::string, std::string>> items; // Name, value
+		};
+
+		struct SourceKind {
+			std::string id;
+			std::string unversionedId;
+			enum obs_source_type type;
+			uint32_t outputFlags;
+			uint32_t width;
+			uint32_t height;
+			int64_t mediaDuration; // Milliseconds, for media inputs
+			std::string defaults;  // JSON
+			std::vector<PropertyInfo> properties;
+			bool fixedTransition;
+		};
+
+		const std::vector<SourceKind> &GetSourceKinds();
+		const SourceKind *GetSourceKind(const std::string &id);
+
+		// Sets the defaults of `data` from a JSON object
+		void SetDataDefaults(obs_data_t *data, const std::string &defaults);
+
+		// In-memory config files, for the frontend global and profile configs
+		config_t *CreateConfig();
+		void DestroyConfig(config_t *config);
+
+		// Owns a calldata_t for emitting a signal
+		class CallData {
+		public:
+			CallData() { calldata_init(&_data); }
+			~CallData() { calldata_free(&_data); }
+			operator calldata_t *() { return &_data; }
+
+		private:
+			calldata_t _data;
+		};
+
+		// Emits `signal` with only a `source` parameter on the source, and as `source_<signal>` on the core when `global`
+		void EmitSourceSignal(obs_source_t *source, const char *signal, bool global = false);
+
+		// Recomputes which sources are active (shown in program) and showing (in program, preview or shown manually), then
+		// emits activate/deactivate and show/hide for every change. Must not be called with the mutex held
+		void UpdateSourceStates();
+
+		// Ends media inputs which have played past their duration. Called for every video frame
+		void TickSources();
+
+		// Scene helpers for the source lifecycle. Implemented in MockObs_Scenes.cpp
+		void CreateSceneData(obs_source_t *source);
+		void DestroySceneData(obs_source_t *source);
+		void RemoveSourceFromScenes(obs_source_t *source);
+
+		// Frontend state read by the core. Require the mutex
+		obs_source_t *GetProgramScene();
+		obs_source_t *GetPreviewScene();
+		obs_source_t *GetCurrentTransition();
+
+		// Core state set up by `Initialize()` and torn down by `Shutdown()`, per area
+		void InitializeSources();
+		void ShutdownSources();
+		void InitializeFrontend();
+		void ShutdownFrontend();
+
+		// Changes the canvas size, output size and frame rate reported by `obs_get_video_info()`
+		void ResetVideo(uint32_t baseWidth, uint32_t baseHeight, uint32_t outputWidth, uint32_t outputHeight,
+				uint32_t fpsNumerator, uint32_t fpsDenominator);
+
+		// Sends a block of synthetic audio to the capture callbacks of all active audio inputs
+		void SendAudio(uint32_t frames, uint64_t timestamp);
+		// Records that a video frame has been rendered
+		void AddVideoFrame(uint64_t renderTimeNs);
+	}
+}
+
+struct obs_weak_source : MockObs::Internal::WeakReference<obs_source> {};
+
+struct obs_source {
+	obs_weak_source *control = nullptr;
+	const MockObs::Internal::SourceKind *kind = nullptr;
+	std::string name;
+	std::string uuid;
+	bool isPrivate = false;
+	bool removed = false;
+	obs_data_t *settings = nullptr;
+	obs_data_t *privateSettings = nullptr;
+	signal_handler_t *signals = nullptr;
+	proc_handler_t *procs = nullptr;
+
+	bool enabled = true;
+	bool muted = false;
+	float volume = 1.0f;
+	float balance = 0.5f;
+	int64_t syncOffset = 0;
+	uint32_t audioMixers = 0xFF;
+	enum obs_monitoring_type monitoringType = OBS_MONITORING_TYPE_NONE;
+	std::vector<std::pair<obs_source_audio_capture_t, void *>> audioCaptureCallbacks;
+	double audioPhase = 0.0;
+
+	bool active = false;
+	bool showing = false;
+	long manualShowing = 0;
+
+	std::vector<obs_source_t *> filters; // In the order the frontend shows them
+	obs_source_t *filterParent = nullptr;
+	obs_scene_t *scene = nullptr; // For scenes and groups
+
+	enum obs_media_state mediaState = OBS_MEDIA_STATE_NONE;
+	uint64_t mediaStartedAt = 0; // While playing, when the media would have been at 0
+	int64_t mediaTime = 0;       // While not playing
+};
+
+struct obs_scene {
+	obs_source_t *source = nullptr;
+	bool isGroup = false;
+	std::vector<obs_sceneitem_t *> items; // Bottom to top
+	int64_t nextItemId = 1;
+};
+
+struct obs_scene_item {
+	std::atomic<long> refs{1};
+	obs_scene_t *parent = nullptr;
+	obs_source_t *source = nullptr;
+	int64_t id = 0;
+	bool visible = true;
+	bool locked = false;
+	bool removed = false;
+	struct obs_transform_info info = {};
+	struct obs_sceneitem_crop crop = {};
+	enum obs_blending_type blendingMode = OBS_BLEND_NORMAL;
+	obs_data_t *privateSettings = nullptr;
+};
+
+struct obs_weak_output : MockObs::Internal::WeakReference<obs_output> {};
+
+struct obs_output {
+	obs_weak_output *control = nullptr;
+	std::string id;
+	std::string name;
+	uint32_t flags = 0;
+	obs_data_t *settings = nullptr;
+	signal_handler_t *signals = nullptr;
+	bool active = false;
+	bool paused = false;
+	uint64_t startedAt = 0;
+};
+
+struct obs_weak_encoder : MockObs::Internal::WeakReference<obs_encoder> {};
+
+struct obs_encoder {
+	obs_weak_encoder *control = nullptr;
+	std::string name;
+};
+
+struct obs_weak_service : MockObs::Internal::WeakReference<obs_service> {};
+
+struct obs_service {
+	obs_weak_service *control = nullptr;
+	std::string id;
+	std::string name;
+	obs_data_t *settings = nullptr;
+};
+
+struct obs_hotkey {
+	obs_hotkey_id id = 0;
+	std::string name;
+	std::string description;
+	std::function<void(bool)> callback;
+};
+
+struct obs_property {
+	MockObs::Internal::PropertyInfo info;
+};
+
+struct obs_properties {
+	std::vector<std::unique_ptr<obs_property>> properties;
+};
@@ -0,0 +1,255 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "MockObsInternal.h"
+
+// calldata_t keeps its parameters on a single stack: [name size][name][data size][data], one after the other
+
+struct CallDataEntry {
+	uint8_t *start;
+	uint8_t *data;
+	size_t dataSize;
+	size_t size;
+};
+
+static bool FindCallDataEntry(const calldata_t *cd, const char *name, CallDataEntry &entry)
+{
+	if (!cd || !cd->stack || !name)
+		return false;
+
+	uint8_t *pos = cd->stack;
+	uint8_t *end = cd->stack + cd->size;
+	while (pos < end) {
+		size_t nameSize, dataSize;
+		memcpy(&nameSize, pos, sizeof(size_t));
+		const char *entryName = (const char *)(pos + sizeof(size_t));
+		memcpy(&dataSize, pos + sizeof(size_t) + nameSize, sizeof(size_t));
+		uint8_t *data = pos + sizeof(size_t) * 2 + nameSize;
+
+		if (strcmp(entryName, name) == 0) {
+			entry = {pos, data, dataSize, (size_t)(data + dataSize - pos)};
+			return true;
+		}
+
+		pos = data + dataSize;
+	}
+
+	return false;
+}
+
+bool calldata_get_data(const calldata_t *data, const char *name, void *out, size_t size)
+{
+	CallDataEntry entry;
+	if (!FindCallDataEntry(data, name, entry) || entry.dataSize != size)
+		return false;
+
+	memcpy(out, entry.data, size);
+	return true;
+}
+
+void calldata_set_data(calldata_t *data, const char *name, const void *in, size_t new_size)
+{
+	if (!data || !name || !*name)
+		return;
+
+	CallDataEntry entry;
+	if (FindCallDataEntry(data, name, entry)) {
+		memmove(entry.start, entry.start + entry.size, data->size - (entry.start - data->stack) - entry.size);
+		data->size -= entry.size;
+	}
+
+	size_t nameSize = strlen(name) + 1;
+	size_t entrySize = sizeof(size_t) * 2 + nameSize + new_size;
+	if (data->size + entrySize > data->capacity) {
+		if (data->fixed) {
+			blog(LOG_ERROR, "[MockObs] calldata_set_data: Not enough room in fixed size stack for '%s'", name);
+			return;
+		}
+
+		data->capacity = std::max(data->capacity * 2, data->size + entrySize);
+		data->stack = (uint8_t *)brealloc(data->stack, data->capacity);
+	}
+
+	uint8_t *pos = data->stack + data->size;
+	memcpy(pos, &nameSize, sizeof(size_t));
+	memcpy(pos + sizeof(size_t), name, nameSize);
+	memcpy(pos + sizeof(size_t) + nameSize, &new_size, sizeof(size_t));
+	if (new_size)
+		memcpy(pos + sizeof(size_t) * 2 + nameSize, in, new_size);
+	data->size += entrySize;
+}
+
+bool calldata_get_string(const calldata_t *data, const char *name, const char **str)
+{
+	CallDataEntry entry;
+	if (!FindCallDataEntry(data, name, entry))
+		return false;
+
+	*str = entry.dataSize ? (const char *)entry.data : nullptr;
+	return true;
+}
+
+struct SignalCallback {
+	signal_callback_t callback;
+	void *data;
+
+	bool operator==(const SignalCallback &other) const { return callback == other.callback && data == other.data; }
+};
+
+struct SignalInfo {
+	std::recursive_mutex mutex;
+	std::vector<SignalCallback> callbacks;
+};
+
+struct signal_handler {
+	std::mutex mutex;
+	std::unordered_map<std::string, std::unique_ptr<SignalInfo>> signals;
+};
+
+// Unlike libobs, signals do not have to be declared before connecting to them
+static SignalInfo *GetSignalInfo(signal_handler_t *handler, const char *signal)
+{
+	std::lock_guard<std::mutex> lock(handler->mutex);
+	auto &info = handler->signals[signal];
+	if (!info)
+		info = std::make_unique<SignalInfo>();
+	return info.get();
+}
+
+signal_handler_t *signal_handler_create(void)
+{
+	return new signal_handler;
+}
+
+void signal_handler_destroy(signal_handler_t *handler)
+{
+	delete handler;
+}
+
+bool signal_handler_add(signal_handler_t *handler, const char *signal_decl)
+{
+	std::string decl = signal_decl;
+	size_t nameEnd = decl.find('(');
+	size_t nameStart = decl.rfind(' ', nameEnd);
+	if (nameEnd == std::string::npos || nameStart == std::string::npos)
+		return false;
+
+	GetSignalInfo(handler, decl.substr(nameStart + 1, nameEnd - nameStart - 1).c_str());
+	return true;
+}
+
+void signal_handler_connect(signal_handler_t *handler, const char *signal, signal_callback_t callback, void *data)
+{
+	if (!handler || !signal || !callback)
+		return;
+
+	SignalInfo *info = GetSignalInfo(handler, signal);
+	std::lock_guard<std::recursive_mutex> lock(info->mutex);
+	info->callbacks.push_back({callback, data});
+}
+
+void signal_handler_disconnect(signal_handler_t *handler, const char *signal, signal_callback_t callback, void *data)
+{
+	if (!handler || !signal || !callback)
+		return;
+
+	SignalInfo *info = GetSignalInfo(handler, signal);
+	std::lock_guard<std::recursive_mutex> lock(info->mutex);
+	auto it = std::find(info->callbacks.begin(), info->callbacks.end(), SignalCallback{callback, data});
+	if (it != info->callbacks.end())
+		info->callbacks.erase(it);
+}
+
+// Like libobs, the signal stays locked while its callbacks run, so a disconnect waits for running callbacks to return
+void signal_handler_signal(signal_handler_t *handler, const char *signal, calldata_t *params)
+{
+	if (!handler || !signal)
+		return;
+
+	SignalInfo *info = GetSignalInfo(handler, signal);
+	std::lock_guard<std::recursive_mutex> lock(info->mutex);
+	std::vector<SignalCallback> callbacks = info->callbacks;
+	for (auto &callback : callbacks) {
+		// Callbacks may disconnect other callbacks of the same signal
+		if (std::find(info->callbacks.begin(), info->callbacks.end(), callback) == info->callbacks.end())
+			continue;
+
+		callback.callback(callback.data, params);
+	}
+}
+
+struct ProcInfo {
+	proc_handler_proc_t proc;
+	void *data;
+};
+
+struct proc_handler {
+	std::mutex mutex;
+	std::unordered_map<std::string, ProcInfo> procs;
+};
+
+proc_handler_t *proc_handler_create(void)
+{
+	return new proc_handler;
+}
+
+void proc_handler_destroy(proc_handler_t *handler)
+{
+	delete handler;
+}
+
+void proc_handler_add(proc_handler_t *handler, const char *decl_string, proc_handler_proc_t proc, void *data)
+{
+	if (!handler || !decl_string || !proc)
+		return;
+
+	std::string decl = decl_string;
+	size_t nameEnd = decl.find('(');
+	size_t nameStart = decl.rfind(' ', nameEnd);
+	if (nameEnd == std::string::npos || nameStart == std::string::npos) {
+		blog(LOG_ERROR, "[MockObs] proc_handler_add: Invalid declaration: %s", decl_string);
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(handler->mutex);
+	handler->procs[decl.substr(nameStart + 1, nameEnd - nameStart - 1)] = {proc, data};
+}
+
+bool proc_handler_call(proc_handler_t *handler, const char *name, calldata_t *params)
+{
+	if (!handler || !name)
+		return false;
+
+	ProcInfo info;
+	{
+		std::lock_guard<std::mutex> lock(handler->mutex);
+		auto it = handler->procs.find(name);
+		if (it == handler->procs.end())
+			return false;
+		info = it->second;
+	}
+
+	info.proc(info.data, params);
+	return true;
+}
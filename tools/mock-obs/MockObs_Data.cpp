@@ -0,0 +1,615 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <nlohmann/json.hpp>
+
+#include "MockObsInternal.h"
+
+using json = nlohmann::json;
+
+// A user or default value of an obs_data_t item. Objects and arrays are referenced, not copied
+struct DataValue {
+	enum obs_data_type type = OBS_DATA_NULL;
+	enum obs_data_number_type numberType = OBS_DATA_NUM_INVALID;
+	long long intValue = 0;
+	double doubleValue = 0.0;
+	bool boolValue = false;
+	std::string stringValue;
+	obs_data_t *object = nullptr;
+	obs_data_array_t *array = nullptr;
+
+	DataValue() = default;
+	DataValue(const DataValue &other) { *this = other; }
+	DataValue &operator=(const DataValue &other);
+	~DataValue() { Clear(); }
+	void Clear();
+};
+
+struct obs_data_item {
+	obs_data_t *parent;
+	std::string name;
+	DataValue user;
+	DataValue defaults;
+
+	const DataValue &Value() const { return user.type != OBS_DATA_NULL ? user : defaults; }
+};
+
+struct obs_data {
+	std::atomic<long> refs{1};
+	std::vector<std::unique_ptr<obs_data_item>> items;
+	std::string json;
+};
+
+struct obs_data_array {
+	std::atomic<long> refs{1};
+	std::vector<obs_data_t *> objects;
+};
+
+DataValue &DataValue::operator=(const DataValue &other)
+{
+	if (this == &other)
+		return *this;
+
+	if (other.object)
+		obs_data_addref(other.object);
+	if (other.array)
+		obs_data_array_addref(other.array);
+	Clear();
+
+	type = other.type;
+	numberType = other.numberType;
+	intValue = other.intValue;
+	doubleValue = other.doubleValue;
+	boolValue = other.boolValue;
+	stringValue = other.stringValue;
+	object = other.object;
+	array = other.array;
+	return *this;
+}
+
+void DataValue::Clear()
+{
+	obs_data_release(object);
+	obs_data_array_release(array);
+	object = nullptr;
+	array = nullptr;
+	type = OBS_DATA_NULL;
+}
+
+static obs_data_item_t *FindItem(obs_data_t *data, const char *name)
+{
+	if (!data || !name)
+		return nullptr;
+
+	for (auto &item : data->items)
+		if (item->name == name)
+			return item.get();
+
+	return nullptr;
+}
+
+static obs_data_item_t *GetOrCreateItem(obs_data_t *data, const char *name)
+{
+	obs_data_item_t *item = FindItem(data, name);
+	if (item)
+		return item;
+
+	data->items.push_back(std::make_unique<obs_data_item>());
+	item = data->items.back().get();
+	item->parent = data;
+	item->name = name;
+	return item;
+}
+
+static void SetValue(obs_data_t *data, const char *name, const DataValue &value, bool isDefault)
+{
+	if (!data || !name)
+		return;
+
+	obs_data_item_t *item = GetOrCreateItem(data, name);
+	(isDefault ? item->defaults : item->user) = value;
+}
+
+static DataValue StringValue(const char *val)
+{
+	DataValue value;
+	value.type = OBS_DATA_STRING;
+	value.stringValue = val ? val : "";
+	return value;
+}
+
+static DataValue IntValue(long long val)
+{
+	DataValue value;
+	value.type = OBS_DATA_NUMBER;
+	value.numberType = OBS_DATA_NUM_INT;
+	value.intValue = val;
+	return value;
+}
+
+static DataValue DoubleValue(double val)
+{
+	DataValue value;
+	value.type = OBS_DATA_NUMBER;
+	value.numberType = OBS_DATA_NUM_DOUBLE;
+	value.doubleValue = val;
+	return value;
+}
+
+static DataValue BoolValue(bool val)
+{
+	DataValue value;
+	value.type = OBS_DATA_BOOLEAN;
+	value.boolValue = val;
+	return value;
+}
+
+static DataValue ObjectValue(obs_data_t *obj)
+{
+	DataValue value;
+	if (!obj)
+		return value;
+
+	obs_data_addref(obj);
+	value.type = OBS_DATA_OBJECT;
+	value.object = obj;
+	return value;
+}
+
+static DataValue ArrayValue(obs_data_array_t *array)
+{
+	DataValue value;
+	if (!array)
+		return value;
+
+	obs_data_array_addref(array);
+	value.type = OBS_DATA_ARRAY;
+	value.array = array;
+	return value;
+}
+
+static long long GetInt(const DataValue &value)
+{
+	if (value.type != OBS_DATA_NUMBER)
+		return 0;
+	return value.numberType == OBS_DATA_NUM_INT ? value.intValue : (long long)value.doubleValue;
+}
+
+static double GetDouble(const DataValue &value)
+{
+	if (value.type != OBS_DATA_NUMBER)
+		return 0.0;
+	return value.numberType == OBS_DATA_NUM_DOUBLE ? value.doubleValue : (double)value.intValue;
+}
+
+static json DataToJson(obs_data_t *data);
+
+static json ValueToJson(const DataValue &value)
+{
+	switch (value.type) {
+	case OBS_DATA_STRING:
+		return value.stringValue;
+	case OBS_DATA_NUMBER:
+		if (value.numberType == OBS_DATA_NUM_INT)
+			return value.intValue;
+		return value.doubleValue;
+	case OBS_DATA_BOOLEAN:
+		return value.boolValue;
+	case OBS_DATA_OBJECT:
+		return DataToJson(value.object);
+	case OBS_DATA_ARRAY: {
+		json ret = json::array();
+		for (obs_data_t *object : value.array->objects)
+			ret.push_back(DataToJson(object));
+		return ret;
+	}
+	default:
+		return nullptr;
+	}
+}
+
+// Like libobs, only user values are serialized
+static json DataToJson(obs_data_t *data)
+{
+	json ret = json::object();
+	for (auto &item : data->items)
+		if (item->user.type != OBS_DATA_NULL)
+			ret[item->name] = ValueToJson(item->user);
+	return ret;
+}
+
+static void SetFromJson(obs_data_t *data, const json &j, bool isDefault)
+{
+	for (auto &[key, value] : j.items()) {
+		DataValue dataValue;
+		if (value.is_string()) {
+			dataValue = StringValue(value.get<std::string>().c_str());
+		} else if (value.is_number_integer()) {
+			dataValue = IntValue(value.get<long long>());
+		} else if (value.is_number()) {
+			dataValue = DoubleValue(value.get<double>());
+		} else if (value.is_boolean()) {
+			dataValue = BoolValue(value.get<bool>());
+		} else if (value.is_object()) {
+			obs_data_t *object = obs_data_create();
+			SetFromJson(object, value, false);
+			dataValue = ObjectValue(object);
+			obs_data_release(object);
+		} else if (value.is_array()) {
+			obs_data_array_t *array = obs_data_array_create();
+			for (auto &element : value) {
+				if (!element.is_object())
+					continue;
+				obs_data_t *object = obs_data_create();
+				SetFromJson(object, element, false);
+				obs_data_array_push_back(array, object);
+				obs_data_release(object);
+			}
+			dataValue = ArrayValue(array);
+			obs_data_array_release(array);
+		} else {
+			continue;
+		}
+
+		SetValue(data, key.c_str(), dataValue, isDefault);
+	}
+}
+
+void MockObs::Internal::SetDataDefaults(obs_data_t *data, const std::string &defaults)
+{
+	json j = json::parse(defaults, nullptr, false);
+	if (j.is_object())
+		SetFromJson(data, j, true);
+}
+
+obs_data_t *obs_data_create(void)
+{
+	return new obs_data;
+}
+
+obs_data_t *obs_data_create_from_json(const char *json_string)
+{
+	json j = json::parse(json_string ? json_string : "", nullptr, false);
+	if (!j.is_object()) {
+		blog(LOG_ERROR, "[MockObs] obs_data_create_from_json: Failed reading json string");
+		return nullptr;
+	}
+
+	obs_data_t *data = obs_data_create();
+	SetFromJson(data, j, false);
+	return data;
+}
+
+void obs_data_addref(obs_data_t *data)
+{
+	if (data)
+		data->refs++;
+}
+
+void obs_data_release(obs_data_t *data)
+{
+	if (data && data->refs.fetch_sub(1) == 1)
+		delete data;
+}
+
+const char *obs_data_get_json(obs_data_t *data)
+{
+	if (!data)
+		return nullptr;
+
+	data->json = DataToJson(data).dump();
+	return data->json.c_str();
+}
+
+// Objects and arrays are shared with `apply_data` instead of merged
+void obs_data_apply(obs_data_t *target, obs_data_t *apply_data)
+{
+	if (!target || !apply_data || target == apply_data)
+		return;
+
+	for (auto &item : apply_data->items)
+		if (item->user.type != OBS_DATA_NULL)
+			SetValue(target, item->name.c_str(), item->user, false);
+}
+
+void obs_data_erase(obs_data_t *data, const char *name)
+{
+	if (!data || !name)
+		return;
+
+	for (auto it = data->items.begin(); it != data->items.end(); ++it) {
+		if ((*it)->name == name) {
+			data->items.erase(it);
+			return;
+		}
+	}
+}
+
+void obs_data_clear(obs_data_t *data)
+{
+	if (!data)
+		return;
+
+	for (auto &item : data->items)
+		item->user.Clear();
+}
+
+void obs_data_set_string(obs_data_t *data, const char *name, const char *val)
+{
+	SetValue(data, name, StringValue(val), false);
+}
+
+void obs_data_set_int(obs_data_t *data, const char *name, long long val)
+{
+	SetValue(data, name, IntValue(val), false);
+}
+
+void obs_data_set_double(obs_data_t *data, const char *name, double val)
+{
+	SetValue(data, name, DoubleValue(val), false);
+}
+
+void obs_data_set_bool(obs_data_t *data, const char *name, bool val)
+{
+	SetValue(data, name, BoolValue(val), false);
+}
+
+void obs_data_set_obj(obs_data_t *data, const char *name, obs_data_t *obj)
+{
+	SetValue(data, name, ObjectValue(obj), false);
+}
+
+void obs_data_set_array(obs_data_t *data, const char *name, obs_data_array_t *array)
+{
+	SetValue(data, name, ArrayValue(array), false);
+}
+
+void obs_data_set_default_string(obs_data_t *data, const char *name, const char *val)
+{
+	SetValue(data, name, StringValue(val), true);
+}
+
+void obs_data_set_default_int(obs_data_t *data, const char *name, long long val)
+{
+	SetValue(data, name, IntValue(val), true);
+}
+
+void obs_data_set_default_double(obs_data_t *data, const char *name, double val)
+{
+	SetValue(data, name, DoubleValue(val), true);
+}
+
+void obs_data_set_default_bool(obs_data_t *data, const char *name, bool val)
+{
+	SetValue(data, name, BoolValue(val), true);
+}
+
+void obs_data_set_default_obj(obs_data_t *data, const char *name, obs_data_t *obj)
+{
+	SetValue(data, name, ObjectValue(obj), true);
+}
+
+void obs_data_set_default_array(obs_data_t *data, const char *name, obs_data_array_t *arr)
+{
+	SetValue(data, name, ArrayValue(arr), true);
+}
+
+const char *obs_data_get_string(obs_data_t *data, const char *name)
+{
+	obs_data_item_t *item = FindItem(data, name);
+	return obs_data_item_get_string(item);
+}
+
+long long obs_data_get_int(obs_data_t *data, const char *name)
+{
+	obs_data_item_t *item = FindItem(data, name);
+	return obs_data_item_get_int(item);
+}
+
+double obs_data_get_double(obs_data_t *data, const char *name)
+{
+	obs_data_item_t *item = FindItem(data, name);
+	return obs_data_item_get_double(item);
+}
+
+bool obs_data_get_bool(obs_data_t *data, const char *name)
+{
+	obs_data_item_t *item = FindItem(data, name);
+	return obs_data_item_get_bool(item);
+}
+
+obs_data_t *obs_data_get_obj(obs_data_t *data, const char *name)
+{
+	obs_data_item_t *item = FindItem(data, name);
+	return obs_data_item_get_obj(item);
+}
+
+obs_data_array_t *obs_data_get_array(obs_data_t *data, const char *name)
+{
+	obs_data_item_t *item = FindItem(data, name);
+	return obs_data_item_get_array(item);
+}
+
+bool obs_data_has_user_value(obs_data_t *data, const char *name)
+{
+	obs_data_item_t *item = FindItem(data, name);
+	return obs_data_item_has_user_value(item);
+}
+
+bool obs_data_has_default_value(obs_data_t *data, const char *name)
+{
+	obs_data_item_t *item = FindItem(data, name);
+	return item && item->defaults.type != OBS_DATA_NULL;
+}
+
+obs_data_array_t *obs_data_array_create(void)
+{
+	return new obs_data_array;
+}
+
+void obs_data_array_addref(obs_data_array_t *array)
+{
+	if (array)
+		array->refs++;
+}
+
+void obs_data_array_release(obs_data_array_t *array)
+{
+	if (!array || array->refs.fetch_sub(1) != 1)
+		return;
+
+	for (obs_data_t *object : array->objects)
+		obs_data_release(object);
+	delete array;
+}
+
+size_t obs_data_array_count(obs_data_array_t *array)
+{
+	return array ? array->objects.size() : 0;
+}
+
+obs_data_t *obs_data_array_item(obs_data_array_t *array, size_t idx)
+{
+	if (!array || idx >= array->objects.size())
+		return nullptr;
+
+	obs_data_addref(array->objects[idx]);
+	return array->objects[idx];
+}
+
+size_t obs_data_array_push_back(obs_data_array_t *array, obs_data_t *obj)
+{
+	if (!array || !obj)
+		return 0;
+
+	obs_data_addref(obj);
+	array->objects.push_back(obj);
+	return array->objects.size() - 1;
+}
+
+// Items are owned by their obs_data_t, so releasing one only clears the pointer
+obs_data_item_t *obs_data_first(obs_data_t *data)
+{
+	if (!data || data->items.empty())
+		return nullptr;
+
+	return data->items.front().get();
+}
+
+obs_data_item_t *obs_data_item_byname(obs_data_t *data, const char *name)
+{
+	return FindItem(data, name);
+}
+
+bool obs_data_item_next(obs_data_item_t **item)
+{
+	if (!item || !*item)
+		return false;
+
+	auto &items = (*item)->parent->items;
+	for (size_t i = 0; i < items.size(); i++) {
+		if (items[i].get() != *item)
+			continue;
+
+		*item = i + 1 < items.size() ? items[i + 1].get() : nullptr;
+		return *item != nullptr;
+	}
+
+	*item = nullptr;
+	return false;
+}
+
+void obs_data_item_release(obs_data_item_t **item)
+{
+	if (item)
+		*item = nullptr;
+}
+
+void obs_data_item_remove(obs_data_item_t **item)
+{
+	if (!item || !*item)
+		return;
+
+	obs_data_erase((*item)->parent, (*item)->name.c_str());
+	*item = nullptr;
+}
+
+bool obs_data_item_has_user_value(obs_data_item_t *data)
+{
+	return data && data->user.type != OBS_DATA_NULL;
+}
+
+enum obs_data_type obs_data_item_gettype(obs_data_item_t *item)
+{
+	return item ? item->Value().type : OBS_DATA_NULL;
+}
+
+enum obs_data_number_type obs_data_item_numtype(obs_data_item_t *item)
+{
+	if (!item || item->Value().type != OBS_DATA_NUMBER)
+		return OBS_DATA_NUM_INVALID;
+	return item->Value().numberType;
+}
+
+const char *obs_data_item_get_name(obs_data_item_t *item)
+{
+	return item ? item->name.c_str() : nullptr;
+}
+
+const char *obs_data_item_get_string(obs_data_item_t *item)
+{
+	if (!item || item->Value().type != OBS_DATA_STRING)
+		return "";
+	return item->Value().stringValue.c_str();
+}
+
+long long obs_data_item_get_int(obs_data_item_t *item)
+{
+	return item ? GetInt(item->Value()) : 0;
+}
+
+double obs_data_item_get_double(obs_data_item_t *item)
+{
+	return item ? GetDouble(item->Value()) : 0.0;
+}
+
+bool obs_data_item_get_bool(obs_data_item_t *item)
+{
+	return item && item->Value().type == OBS_DATA_BOOLEAN && item->Value().boolValue;
+}
+
+obs_data_t *obs_data_item_get_obj(obs_data_item_t *item)
+{
+	if (!item || item->Value().type != OBS_DATA_OBJECT)
+		return nullptr;
+
+	obs_data_addref(item->Value().object);
+	return item->Value().object;
+}
+
+obs_data_array_t *obs_data_item_get_array(obs_data_item_t *item)
+{
+	if (!item || item->Value().type != OBS_DATA_ARRAY)
+		return nullptr;
+
+	obs_data_array_addref(item->Value().array);
+	return item->Value().array;
+}
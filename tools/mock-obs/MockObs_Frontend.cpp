@@ -0,0 +1,1091 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+#include "MockObsInternal.h"
+
+#define TBAR_MAX 1024
+
+using namespace MockObs::Internal;
+
+struct FrontendState {
+	std::vector<std::pair<obs_frontend_event_cb, void *>> eventCallbacks;
+	std::vector<obs_frontend_translate_ui_cb> translations;
+
+	std::vector<obs_source_t *> scenes; // In the order of the scene list
+	obs_source_t *programScene = nullptr;
+	obs_source_t *previewScene = nullptr;
+	bool studioMode = false;
+	int tbarPosition = 0;
+
+	std::vector<obs_source_t *> transitions;
+	obs_source_t *currentTransition = nullptr;
+	int transitionDuration = 300;
+
+	std::vector<std::string> sceneCollections = {"Untitled"};
+	std::string currentSceneCollection = "Untitled";
+	std::vector<std::string> profiles = {"Untitled"};
+	std::string currentProfile = "Untitled";
+	std::map<std::string, config_t *> profileConfigs;
+	config_t *globalConfig = nullptr;
+
+	obs_output_t *streamOutput = nullptr;
+	obs_output_t *recordOutput = nullptr;
+	obs_output_t *replayBufferOutput = nullptr;
+	obs_output_t *virtualcamOutput = nullptr;
+	obs_service_t *streamingService = nullptr;
+	std::string lastRecording;
+	std::string lastReplay;
+	std::string lastScreenshot;
+};
+
+static FrontendState *frontend = nullptr;
+
+obs_source_t *MockObs::Internal::GetProgramScene()
+{
+	return frontend ? frontend->programScene : nullptr;
+}
+
+obs_source_t *MockObs::Internal::GetPreviewScene()
+{
+	return frontend && frontend->studioMode ? frontend->previewScene : nullptr;
+}
+
+obs_source_t *MockObs::Internal::GetCurrentTransition()
+{
+	return frontend ? frontend->currentTransition : nullptr;
+}
+
+// Runs `task` on the UI thread and waits for it, like the frontend API does with blocking queued Qt invocations
+static void RunOnUi(std::function<void()> task)
+{
+	GetUiQueue().Push(task, true);
+}
+
+// Must be called on the UI thread, without the mutex held
+static void EmitEvent(enum obs_frontend_event event)
+{
+	std::vector<std::pair<obs_frontend_event_cb, void *>> callbacks;
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		if (!frontend)
+			return;
+		callbacks = frontend->eventCallbacks;
+	}
+
+	for (auto &callback : callbacks)
+		callback.first(event, callback.second);
+}
+
+static char **CopyStringList(const std::vector<std::string> &strings)
+{
+	// A single allocation, so that callers can free it with one bfree() like an OBS string list
+	size_t size = sizeof(char *) * (strings.size() + 1);
+	for (auto &string : strings)
+		size += string.size() + 1;
+
+	char **ret = (char **)bmalloc(size);
+	char *cursor = (char *)(ret + strings.size() + 1);
+	for (size_t i = 0; i < strings.size(); i++) {
+		ret[i] = cursor;
+		memcpy(cursor, strings[i].c_str(), strings[i].size() + 1);
+		cursor += strings[i].size() + 1;
+	}
+	ret[strings.size()] = nullptr;
+
+	return ret;
+}
+
+static void CopySourceList(const std::vector<obs_source_t *> &sources, struct obs_frontend_source_list *list)
+{
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	for (obs_source_t *source : sources) {
+		obs_source_t *ref = obs_source_get_ref(source);
+		if (ref)
+			da_push_back(list->sources, &ref);
+	}
+}
+
+// Mock transitions are instant, so the transition signals and events are emitted back to back. UI thread only
+static void TransitionToScene(obs_source_t *scene)
+{
+	obs_source_t *previousScene;
+	obs_source_t *transition;
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		if (!frontend || scene == frontend->programScene)
+			return;
+
+		previousScene = frontend->programScene;
+		frontend->programScene = obs_source_get_ref(scene);
+		transition = obs_source_get_ref(frontend->currentTransition);
+	}
+
+	if (transition)
+		EmitSourceSignal(transition, "transition_start");
+	UpdateSourceStates();
+	EmitEvent(OBS_FRONTEND_EVENT_SCENE_CHANGED);
+	if (transition) {
+		EmitSourceSignal(transition, "transition_video_stop");
+		EmitSourceSignal(transition, "transition_stop");
+	}
+	EmitEvent(OBS_FRONTEND_EVENT_TRANSITION_STOPPED);
+
+	obs_source_release(transition);
+	obs_source_release(previousScene);
+}
+
+// UI thread only
+static void SetPreviewScene(obs_source_t *scene)
+{
+	obs_source_t *previousScene;
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		if (!frontend || scene == frontend->previewScene)
+			return;
+
+		previousScene = frontend->previewScene;
+		frontend->previewScene = obs_source_get_ref(scene);
+	}
+
+	UpdateSourceStates();
+	EmitEvent(OBS_FRONTEND_EVENT_PREVIEW_SCENE_CHANGED);
+	obs_source_release(previousScene);
+}
+
+static bool IsListedScene(obs_source_t *source)
+{
+	return source && obs_source_get_type(source) == OBS_SOURCE_TYPE_SCENE && !obs_source_is_group(source);
+}
+
+// Like the OBS scene list, new scenes are added on creation. The first scene becomes the program scene
+static void SourceCreatedHandler(void *, calldata_t *cd)
+{
+	auto source = static_cast<obs_source_t *>(calldata_ptr(cd, "source"));
+	if (!IsListedScene(source))
+		return;
+
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		if (!frontend)
+			return;
+		frontend->scenes.push_back(obs_source_get_ref(source));
+	}
+
+	obs_weak_source_t *weakScene = obs_source_get_weak_source(source);
+	GetUiQueue().Push(
+		[weakScene]() {
+			obs_source_t *scene = obs_weak_source_get_source(weakScene);
+			obs_weak_source_release(weakScene);
+
+			bool hasProgramScene;
+			{
+				std::lock_guard<std::recursive_mutex> lock(GetMutex());
+				hasProgramScene = frontend && frontend->programScene;
+			}
+
+			EmitEvent(OBS_FRONTEND_EVENT_SCENE_LIST_CHANGED);
+			if (scene && !hasProgramScene)
+				TransitionToScene(scene);
+			obs_source_release(scene);
+		},
+		false);
+}
+
+// Removed scenes leave the scene list. If it was the program or preview scene, the first remaining scene replaces it
+static void SourceRemovedHandler(void *, calldata_t *cd)
+{
+	auto source = static_cast<obs_source_t *>(calldata_ptr(cd, "source"));
+	if (!IsListedScene(source))
+		return;
+
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		if (!frontend)
+			return;
+
+		auto &scenes = frontend->scenes;
+		auto it = std::find(scenes.begin(), scenes.end(), source);
+		if (it == scenes.end())
+			return;
+		scenes.erase(it);
+	}
+	// The remover holds a reference, so this never destroys the scene
+	obs_source_release(source);
+
+	obs_weak_source_t *weakScene = obs_source_get_weak_source(source);
+	GetUiQueue().Push(
+		[weakScene]() {
+			obs_source_t *replacement = nullptr;
+			bool wasProgram, wasPreview;
+			{
+				std::lock_guard<std::recursive_mutex> lock(GetMutex());
+				if (!frontend) {
+					obs_weak_source_release(weakScene);
+					return;
+				}
+
+				wasProgram = obs_weak_source_references_source(weakScene, frontend->programScene);
+				wasPreview = obs_weak_source_references_source(weakScene, frontend->previewScene);
+				if (!frontend->scenes.empty())
+					replacement = obs_source_get_ref(frontend->scenes.front());
+			}
+			obs_weak_source_release(weakScene);
+
+			EmitEvent(OBS_FRONTEND_EVENT_SCENE_LIST_CHANGED);
+			if (wasProgram)
+				TransitionToScene(replacement);
+			if (wasPreview)
+				SetPreviewScene(replacement);
+			obs_source_release(replacement);
+		},
+		false);
+}
+
+static config_t *CreateProfileConfig()
+{
+	auto &settings = GetSettings();
+	config_t *config = CreateConfig();
+	config_set_default_uint(config, "Video", "BaseCX", settings.baseWidth);
+	config_set_default_uint(config, "Video", "BaseCY", settings.baseHeight);
+	config_set_default_uint(config, "Video", "OutputCX", settings.baseWidth);
+	config_set_default_uint(config, "Video", "OutputCY", settings.baseHeight);
+	config_set_default_uint(config, "Video", "FPSType", 2);
+	config_set_default_uint(config, "Video", "FPSNum", settings.fpsNumerator);
+	config_set_default_uint(config, "Video", "FPSDen", settings.fpsDenominator);
+	config_set_default_string(config, "Output", "Mode", "Simple");
+	config_set_default_string(config, "SimpleOutput", "FilePath", settings.configDirectory.c_str());
+	config_set_default_string(config, "SimpleOutput", "RecFormat2", "mkv");
+	config_set_default_string(config, "AdvOut", "RecFilePath", settings.configDirectory.c_str());
+	return config;
+}
+
+static std::string GetRecordDirectory()
+{
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	config_t *config = frontend->profileConfigs[frontend->currentProfile];
+	const char *mode = config_get_string(config, "Output", "Mode");
+	bool advanced = mode && strcmp(mode, "Advanced") == 0;
+	const char *path = config_get_string(config, advanced ? "AdvOut" : "SimpleOutput",
+					     advanced ? "RecFilePath" : "FilePath");
+	return path ? path : "";
+}
+
+static std::string GetOutputFilePath(const char *prefix, const char *extension)
+{
+	static uint64_t counter = 0;
+	return GetRecordDirectory() + "/" + prefix + " " + std::to_string(++counter) + "." + extension;
+}
+
+void MockObs::Internal::InitializeFrontend()
+{
+	frontend = new FrontendState;
+	frontend->globalConfig = CreateConfig();
+	frontend->profileConfigs[frontend->currentProfile] = CreateProfileConfig();
+
+	frontend->transitions.push_back(obs_source_create_private("cut_transition", "Cut", nullptr));
+	frontend->transitions.push_back(obs_source_create_private("fade_transition", "Fade", nullptr));
+	frontend->currentTransition = obs_source_get_ref(frontend->transitions.back());
+	obs_set_output_source(0, frontend->currentTransition);
+
+	frontend->streamOutput = obs_output_create("rtmp_output", "simple_stream", nullptr, nullptr);
+	frontend->recordOutput = obs_output_create("ffmpeg_muxer", "simple_file_output", nullptr, nullptr);
+	frontend->replayBufferOutput = obs_output_create("replay_buffer", "Replay Buffer", nullptr, nullptr);
+	frontend->virtualcamOutput = obs_output_create("virtualcam_output", "virtualcam_output", nullptr, nullptr);
+
+	obs_data_t *serviceSettings = obs_data_create();
+	obs_data_set_string(serviceSettings, "service", "Twitch");
+	obs_data_set_string(serviceSettings, "server", "auto");
+	obs_data_set_string(serviceSettings, "key", "");
+	frontend->streamingService = obs_service_create("rtmp_common", "default_service", serviceSettings, nullptr);
+	obs_data_release(serviceSettings);
+
+	signal_handler_t *sh = GetCoreSignalHandler();
+	signal_handler_connect(sh, "source_create", SourceCreatedHandler, nullptr);
+	signal_handler_connect(sh, "source_remove", SourceRemovedHandler, nullptr);
+
+	MockObs::RegisterHotkey("OBSBasic.StartStreaming", "Start Streaming", [](bool pressed) {
+		if (pressed)
+			obs_frontend_streaming_start();
+	});
+	MockObs::RegisterHotkey("OBSBasic.StopStreaming", "Stop Streaming", [](bool pressed) {
+		if (pressed)
+			obs_frontend_streaming_stop();
+	});
+	MockObs::RegisterHotkey("OBSBasic.StartRecording", "Start Recording", [](bool pressed) {
+		if (pressed)
+			obs_frontend_recording_start();
+	});
+	MockObs::RegisterHotkey("OBSBasic.StopRecording", "Stop Recording", [](bool pressed) {
+		if (pressed)
+			obs_frontend_recording_stop();
+	});
+	MockObs::RegisterHotkey("OBSBasic.Screenshot", "Screenshot Output", [](bool pressed) {
+		if (pressed)
+			obs_frontend_take_screenshot();
+	});
+
+	// A fresh OBS install starts with a single empty scene
+	obs_scene_t *scene = obs_scene_create("Scene");
+	obs_scene_release(scene);
+}
+
+void MockObs::Internal::ShutdownFrontend()
+{
+	// Let queued scene list updates finish first
+	RunOnUi([]() {});
+
+	signal_handler_t *sh = GetCoreSignalHandler();
+	signal_handler_disconnect(sh, "source_create", SourceCreatedHandler, nullptr);
+	signal_handler_disconnect(sh, "source_remove", SourceRemovedHandler, nullptr);
+
+	FrontendState *state;
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		state = frontend;
+		frontend = nullptr;
+	}
+
+	obs_set_output_source(0, nullptr);
+	UpdateSourceStates();
+
+	obs_source_release(state->programScene);
+	obs_source_release(state->previewScene);
+	for (obs_source_t *scene : state->scenes)
+		obs_source_release(scene);
+	obs_source_release(state->currentTransition);
+	for (obs_source_t *transition : state->transitions)
+		obs_source_release(transition);
+
+	obs_output_release(state->streamOutput);
+	obs_output_release(state->recordOutput);
+	obs_output_release(state->replayBufferOutput);
+	obs_output_release(state->virtualcamOutput);
+	obs_service_release(state->streamingService);
+
+	DestroyConfig(state->globalConfig);
+	for (auto &profileConfig : state->profileConfigs)
+		DestroyConfig(profileConfig.second);
+
+	delete state;
+}
+
+void MockObs::FinishLoading()
+{
+	EmitFrontendEvent(OBS_FRONTEND_EVENT_FINISHED_LOADING);
+}
+
+void MockObs::EmitFrontendEvent(enum obs_frontend_event event)
+{
+	RunOnUi([event]() { EmitEvent(event); });
+}
+
+obs_source_t *MockObs::CreateScene(const std::string &name)
+{
+	obs_scene_t *scene = obs_scene_create(name.c_str());
+	return obs_scene_get_source(scene);
+}
+
+obs_source_t *MockObs::CreateInput(obs_source_t *scene, const std::string &name, const std::string &kind)
+{
+	obs_scene_t *sceneData = obs_scene_from_source(scene);
+	if (!sceneData)
+		sceneData = obs_group_from_source(scene);
+	if (!sceneData)
+		return nullptr;
+
+	obs_source_t *input = obs_source_create(kind.c_str(), name.c_str(), nullptr, nullptr);
+	if (input)
+		obs_scene_add(sceneData, input);
+
+	return input;
+}
+
+void MockObs::CreateSceneCollection(size_t sceneCount, size_t inputsPerScene, size_t filtersPerInput)
+{
+	static const char *inputKinds[] = {"pulse_input_capture", "color_source_v3", "ffmpeg_source"};
+
+	obs_source_t *firstScene = nullptr;
+	size_t inputNumber = 0;
+	for (size_t i = 0; i < sceneCount; i++) {
+		obs_source_t *scene = CreateScene("Scene " + std::to_string(i + 1));
+		if (!firstScene)
+			firstScene = obs_source_get_ref(scene);
+
+		for (size_t j = 0; j < inputsPerScene; j++, inputNumber++) {
+			const char *kind = inputKinds[inputNumber % 3];
+			obs_source_t *input = CreateInput(scene, "Input " + std::to_string(inputNumber + 1), kind);
+			if (!input)
+				continue;
+
+			bool audioOnly = !(obs_source_get_output_flags(input) & OBS_SOURCE_VIDEO);
+			for (size_t k = 0; k < filtersPerInput; k++) {
+				const char *filterKind = audioOnly ? (k % 2 ? "noise_suppress_filter_v2" : "gain_filter")
+								   : "color_filter_v2";
+				std::string filterName = "Filter " + std::to_string(k + 1);
+				obs_source_t *filter = obs_source_create_private(filterKind, filterName.c_str(), nullptr);
+				obs_source_filter_add(input, filter);
+				obs_source_release(filter);
+			}
+
+			obs_source_release(input);
+		}
+
+		obs_source_release(scene);
+	}
+
+	if (firstScene)
+		obs_frontend_set_current_scene(firstScene);
+	obs_source_release(firstScene);
+}
+
+void *obs_frontend_get_main_window(void)
+{
+	return nullptr;
+}
+
+void *obs_frontend_get_system_tray(void)
+{
+	return nullptr;
+}
+
+void *obs_frontend_add_tools_menu_qaction(const char *)
+{
+	return nullptr;
+}
+
+void obs_frontend_add_event_callback(obs_frontend_event_cb callback, void *private_data)
+{
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	if (frontend)
+		frontend->eventCallbacks.emplace_back(callback, private_data);
+}
+
+void obs_frontend_remove_event_callback(obs_frontend_event_cb callback, void *private_data)
+{
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	if (!frontend)
+		return;
+
+	auto &callbacks = frontend->eventCallbacks;
+	auto it = std::find(callbacks.begin(), callbacks.end(), std::make_pair(callback, private_data));
+	if (it != callbacks.end())
+		callbacks.erase(it);
+}
+
+char **obs_frontend_get_scene_names(void)
+{
+	std::vector<std::string> names;
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		for (obs_source_t *scene : frontend->scenes)
+			names.push_back(obs_source_get_name(scene));
+	}
+
+	return CopyStringList(names);
+}
+
+void obs_frontend_get_scenes(struct obs_frontend_source_list *sources)
+{
+	CopySourceList(frontend->scenes, sources);
+}
+
+obs_source_t *obs_frontend_get_current_scene(void)
+{
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	return obs_source_get_ref(frontend->programScene);
+}
+
+void obs_frontend_set_current_scene(obs_source_t *scene)
+{
+	RunOnUi([scene]() { TransitionToScene(scene); });
+}
+
+void obs_frontend_get_transitions(struct obs_frontend_source_list *sources)
+{
+	CopySourceList(frontend->transitions, sources);
+}
+
+obs_source_t *obs_frontend_get_current_transition(void)
+{
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	return obs_source_get_ref(frontend->currentTransition);
+}
+
+void obs_frontend_set_current_transition(obs_source_t *transition)
+{
+	RunOnUi([transition]() {
+		obs_source_t *previousTransition;
+		{
+			std::lock_guard<std::recursive_mutex> lock(GetMutex());
+			if (!transition || transition == frontend->currentTransition)
+				return;
+
+			previousTransition = frontend->currentTransition;
+			frontend->currentTransition = obs_source_get_ref(transition);
+		}
+
+		obs_set_output_source(0, transition);
+		EmitEvent(OBS_FRONTEND_EVENT_TRANSITION_CHANGED);
+		obs_source_release(previousTransition);
+	});
+}
+
+int obs_frontend_get_transition_duration(void)
+{
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	return frontend->transitionDuration;
+}
+
+void obs_frontend_set_transition_duration(int duration)
+{
+	RunOnUi([duration]() {
+		{
+			std::lock_guard<std::recursive_mutex> lock(GetMutex());
+			if (frontend->transitionDuration == duration)
+				return;
+			frontend->transitionDuration = duration;
+		}
+
+		EmitEvent(OBS_FRONTEND_EVENT_TRANSITION_DURATION_CHANGED);
+	});
+}
+
+// Releasing a T-Bar which has been moved completes the transition from preview to program, like OBS does
+void obs_frontend_release_tbar(void)
+{
+	RunOnUi([]() {
+		obs_source_t *previewScene;
+		{
+			std::lock_guard<std::recursive_mutex> lock(GetMutex());
+			if (!frontend->studioMode || !frontend->tbarPosition)
+				return;
+
+			frontend->tbarPosition = 0;
+			previewScene = obs_source_get_ref(frontend->previewScene);
+		}
+
+		TransitionToScene(previewScene);
+		obs_source_release(previewScene);
+		EmitEvent(OBS_FRONTEND_EVENT_TBAR_VALUE_CHANGED);
+	});
+}
+
+void obs_frontend_set_tbar_position(int position)
+{
+	RunOnUi([position]() {
+		{
+			std::lock_guard<std::recursive_mutex> lock(GetMutex());
+			if (!frontend->studioMode)
+				return;
+			frontend->tbarPosition = std::clamp(position, 0, TBAR_MAX);
+		}
+
+		EmitEvent(OBS_FRONTEND_EVENT_TBAR_VALUE_CHANGED);
+	});
+}
+
+int obs_frontend_get_tbar_position(void)
+{
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	return frontend->tbarPosition;
+}
+
+char **obs_frontend_get_scene_collections(void)
+{
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	return CopyStringList(frontend->sceneCollections);
+}
+
+char *obs_frontend_get_current_scene_collection(void)
+{
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	return bstrdup(frontend->currentSceneCollection.c_str());
+}
+
+// Scene collections are not persisted, so switching to one removes all scenes and starts over with an empty scene
+void obs_frontend_set_current_scene_collection(const char *collection)
+{
+	if (!collection)
+		return;
+
+	std::string name = collection;
+	RunOnUi([name]() {
+		std::vector<obs_source_t *> scenes;
+		{
+			std::lock_guard<std::recursive_mutex> lock(GetMutex());
+			auto &collections = frontend->sceneCollections;
+			if (name == frontend->currentSceneCollection ||
+			    std::find(collections.begin(), collections.end(), name) == collections.end())
+				return;
+
+			for (obs_source_t *scene : frontend->scenes)
+				scenes.push_back(obs_source_get_ref(scene));
+		}
+
+		EmitEvent(OBS_FRONTEND_EVENT_SCENE_COLLECTION_CHANGING);
+		EmitEvent(OBS_FRONTEND_EVENT_SCENE_COLLECTION_CLEANUP);
+
+		for (obs_source_t *scene : scenes) {
+			obs_source_remove(scene);
+			obs_source_release(scene);
+		}
+
+		{
+			std::lock_guard<std::recursive_mutex> lock(GetMutex());
+			frontend->currentSceneCollection = name;
+		}
+
+		obs_scene_t *scene = obs_scene_create("Scene");
+		TransitionToScene(obs_scene_get_source(scene));
+		obs_scene_release(scene);
+
+		EmitEvent(OBS_FRONTEND_EVENT_SCENE_COLLECTION_CHANGED);
+	});
+}
+
+bool obs_frontend_add_scene_collection(const char *name)
+{
+	if (!name)
+		return false;
+
+	bool success = false;
+	std::string collection = name;
+	RunOnUi([&]() {
+		{
+			std::lock_guard<std::recursive_mutex> lock(GetMutex());
+			auto &collections = frontend->sceneCollections;
+			if (std::find(collections.begin(), collections.end(), collection) != collections.end())
+				return;
+			collections.push_back(collection);
+		}
+
+		EmitEvent(OBS_FRONTEND_EVENT_SCENE_COLLECTION_LIST_CHANGED);
+		obs_frontend_set_current_scene_collection(collection.c_str());
+		success = true;
+	});
+
+	return success;
+}
+
+char **obs_frontend_get_profiles(void)
+{
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	return CopyStringList(frontend->profiles);
+}
+
+char *obs_frontend_get_current_profile(void)
+{
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	return bstrdup(frontend->currentProfile.c_str());
+}
+
+char *obs_frontend_get_current_profile_path(void)
+{
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	std::string path = GetSettings().configDirectory + "/basic/profiles/" + frontend->currentProfile;
+	return bstrdup(path.c_str());
+}
+
+void obs_frontend_set_current_profile(const char *profile)
+{
+	if (!profile)
+		return;
+
+	std::string name = profile;
+	RunOnUi([name]() {
+		{
+			std::lock_guard<std::recursive_mutex> lock(GetMutex());
+			auto &profiles = frontend->profiles;
+			if (name == frontend->currentProfile || std::find(profiles.begin(), profiles.end(), name) == profiles.end())
+				return;
+		}
+
+		EmitEvent(OBS_FRONTEND_EVENT_PROFILE_CHANGING);
+		{
+			std::lock_guard<std::recursive_mutex> lock(GetMutex());
+			frontend->currentProfile = name;
+		}
+		EmitEvent(OBS_FRONTEND_EVENT_PROFILE_CHANGED);
+	});
+}
+
+void obs_frontend_create_profile(const char *name)
+{
+	if (!name)
+		return;
+
+	std::string profile = name;
+	RunOnUi([profile]() {
+		{
+			std::lock_guard<std::recursive_mutex> lock(GetMutex());
+			auto &profiles = frontend->profiles;
+			if (std::find(profiles.begin(), profiles.end(), profile) != profiles.end())
+				return;
+
+			profiles.push_back(profile);
+			frontend->profileConfigs[profile] = CreateProfileConfig();
+		}
+
+		EmitEvent(OBS_FRONTEND_EVENT_PROFILE_LIST_CHANGED);
+		obs_frontend_set_current_profile(profile.c_str());
+	});
+}
+
+void obs_frontend_delete_profile(const char *profile)
+{
+	if (!profile)
+		return;
+
+	std::string name = profile;
+	RunOnUi([name]() {
+		config_t *config;
+		{
+			std::lock_guard<std::recursive_mutex> lock(GetMutex());
+			auto &profiles = frontend->profiles;
+			auto it = std::find(profiles.begin(), profiles.end(), name);
+			if (it == profiles.end() || name == frontend->currentProfile)
+				return;
+
+			profiles.erase(it);
+			config = frontend->profileConfigs[name];
+			frontend->profileConfigs.erase(name);
+		}
+
+		DestroyConfig(config);
+		EmitEvent(OBS_FRONTEND_EVENT_PROFILE_LIST_CHANGED);
+	});
+}
+
+// Starts or stops `output` with the frontend events around it. UI thread only
+static void SetOutputActive(obs_output_t *output, bool active, enum obs_frontend_event startingOrStopping,
+			    enum obs_frontend_event startedOrStopped)
+{
+	if (obs_output_active(output) == active)
+		return;
+
+	if (startingOrStopping != startedOrStopped)
+		EmitEvent(startingOrStopping);
+
+	if (active)
+		obs_output_start(output);
+	else
+		obs_output_stop(output);
+
+	EmitEvent(startedOrStopped);
+}
+
+void obs_frontend_streaming_start(void)
+{
+	RunOnUi([]() {
+		SetOutputActive(frontend->streamOutput, true, OBS_FRONTEND_EVENT_STREAMING_STARTING,
+				OBS_FRONTEND_EVENT_STREAMING_STARTED);
+	});
+}
+
+void obs_frontend_streaming_stop(void)
+{
+	RunOnUi([]() {
+		SetOutputActive(frontend->streamOutput, false, OBS_FRONTEND_EVENT_STREAMING_STOPPING,
+				OBS_FRONTEND_EVENT_STREAMING_STOPPED);
+	});
+}
+
+bool obs_frontend_streaming_active(void)
+{
+	return obs_output_active(frontend->streamOutput);
+}
+
+void obs_frontend_recording_start(void)
+{
+	RunOnUi([]() {
+		SetOutputActive(frontend->recordOutput, true, OBS_FRONTEND_EVENT_RECORDING_STARTING,
+				OBS_FRONTEND_EVENT_RECORDING_STARTED);
+	});
+}
+
+void obs_frontend_recording_stop(void)
+{
+	RunOnUi([]() {
+		if (!obs_output_active(frontend->recordOutput))
+			return;
+
+		std::string path = GetOutputFilePath("Recording", "mkv");
+		{
+			std::lock_guard<std::recursive_mutex> lock(GetMutex());
+			frontend->lastRecording = path;
+		}
+
+		SetOutputActive(frontend->recordOutput, false, OBS_FRONTEND_EVENT_RECORDING_STOPPING,
+				OBS_FRONTEND_EVENT_RECORDING_STOPPED);
+	});
+}
+
+bool obs_frontend_recording_active(void)
+{
+	return obs_output_active(frontend->recordOutput);
+}
+
+void obs_frontend_recording_pause(bool pause)
+{
+	RunOnUi([pause]() {
+		if (obs_output_paused(frontend->recordOutput) == pause)
+			return;
+
+		if (obs_output_pause(frontend->recordOutput, pause))
+			EmitEvent(pause ? OBS_FRONTEND_EVENT_RECORDING_PAUSED : OBS_FRONTEND_EVENT_RECORDING_UNPAUSED);
+	});
+}
+
+bool obs_frontend_recording_paused(void)
+{
+	return obs_output_paused(frontend->recordOutput);
+}
+
+void obs_frontend_replay_buffer_start(void)
+{
+	RunOnUi([]() {
+		SetOutputActive(frontend->replayBufferOutput, true, OBS_FRONTEND_EVENT_REPLAY_BUFFER_STARTING,
+				OBS_FRONTEND_EVENT_REPLAY_BUFFER_STARTED);
+	});
+}
+
+void obs_frontend_replay_buffer_save(void)
+{
+	RunOnUi([]() {
+		if (!obs_output_active(frontend->replayBufferOutput))
+			return;
+
+		std::string path = GetOutputFilePath("Replay", "mkv");
+		{
+			std::lock_guard<std::recursive_mutex> lock(GetMutex());
+			frontend->lastReplay = path;
+		}
+
+		EmitEvent(OBS_FRONTEND_EVENT_REPLAY_BUFFER_SAVED);
+	});
+}
+
+void obs_frontend_replay_buffer_stop(void)
+{
+	RunOnUi([]() {
+		SetOutputActive(frontend->replayBufferOutput, false, OBS_FRONTEND_EVENT_REPLAY_BUFFER_STOPPING,
+				OBS_FRONTEND_EVENT_REPLAY_BUFFER_STOPPED);
+	});
+}
+
+bool obs_frontend_replay_buffer_active(void)
+{
+	return obs_output_active(frontend->replayBufferOutput);
+}
+
+obs_output_t *obs_frontend_get_streaming_output(void)
+{
+	return obs_output_get_ref(frontend->streamOutput);
+}
+
+obs_output_t *obs_frontend_get_recording_output(void)
+{
+	return obs_output_get_ref(frontend->recordOutput);
+}
+
+obs_output_t *obs_frontend_get_replay_buffer_output(void)
+{
+	return obs_output_get_ref(frontend->replayBufferOutput);
+}
+
+obs_output_t *obs_frontend_get_virtualcam_output(void)
+{
+	return obs_output_get_ref(frontend->virtualcamOutput);
+}
+
+config_t *obs_frontend_get_profile_config(void)
+{
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	return frontend->profileConfigs[frontend->currentProfile];
+}
+
+config_t *obs_frontend_get_global_config(void)
+{
+	return frontend->globalConfig;
+}
+
+void obs_frontend_open_projector(const char *type, int monitor, const char *, const char *name)
+{
+	blog(LOG_DEBUG, "[MockObs] Projector of type '%s' for '%s' requested on monitor %d", type ? type : "",
+	     name ? name : "", monitor);
+}
+
+void obs_frontend_save(void) {}
+
+void obs_frontend_push_ui_translation(obs_frontend_translate_ui_cb translate)
+{
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	frontend->translations.push_back(translate);
+}
+
+void obs_frontend_pop_ui_translation(void)
+{
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	if (!frontend->translations.empty())
+		frontend->translations.pop_back();
+}
+
+void obs_frontend_set_streaming_service(obs_service_t *service)
+{
+	obs_service_t *previousService;
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		previousService = frontend->streamingService;
+		frontend->streamingService = obs_service_get_ref(service);
+	}
+
+	obs_service_release(previousService);
+}
+
+// Like OBS, the service is returned without a new reference
+obs_service_t *obs_frontend_get_streaming_service(void)
+{
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	return frontend->streamingService;
+}
+
+void obs_frontend_save_streaming_service(void) {}
+
+bool obs_frontend_preview_program_mode_active(void)
+{
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	return frontend->studioMode;
+}
+
+void obs_frontend_set_preview_program_mode(bool enable)
+{
+	RunOnUi([enable]() {
+		obs_source_t *previewScene;
+		{
+			std::lock_guard<std::recursive_mutex> lock(GetMutex());
+			if (frontend->studioMode == enable)
+				return;
+
+			frontend->studioMode = enable;
+			previewScene = frontend->previewScene;
+			frontend->previewScene = enable ? obs_source_get_ref(frontend->programScene) : nullptr;
+		}
+
+		UpdateSourceStates();
+		obs_source_release(previewScene);
+		EmitEvent(enable ? OBS_FRONTEND_EVENT_STUDIO_MODE_ENABLED : OBS_FRONTEND_EVENT_STUDIO_MODE_DISABLED);
+	});
+}
+
+obs_source_t *obs_frontend_get_current_preview_scene(void)
+{
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	return frontend->studioMode ? obs_source_get_ref(frontend->previewScene) : nullptr;
+}
+
+void obs_frontend_set_current_preview_scene(obs_source_t *scene)
+{
+	RunOnUi([scene]() {
+		{
+			std::lock_guard<std::recursive_mutex> lock(GetMutex());
+			if (!frontend->studioMode)
+				return;
+		}
+
+		SetPreviewScene(scene);
+	});
+}
+
+void obs_frontend_take_screenshot(void)
+{
+	RunOnUi([]() {
+		std::string path = GetOutputFilePath("Screenshot", "png");
+		{
+			std::lock_guard<std::recursive_mutex> lock(GetMutex());
+			frontend->lastScreenshot = path;
+		}
+
+		EmitEvent(OBS_FRONTEND_EVENT_SCREENSHOT_TAKEN);
+	});
+}
+
+void obs_frontend_start_virtualcam(void)
+{
+	RunOnUi([]() {
+		SetOutputActive(frontend->virtualcamOutput, true, OBS_FRONTEND_EVENT_VIRTUALCAM_STARTED,
+				OBS_FRONTEND_EVENT_VIRTUALCAM_STARTED);
+	});
+}
+
+void obs_frontend_stop_virtualcam(void)
+{
+	RunOnUi([]() {
+		SetOutputActive(frontend->virtualcamOutput, false, OBS_FRONTEND_EVENT_VIRTUALCAM_STOPPED,
+				OBS_FRONTEND_EVENT_VIRTUALCAM_STOPPED);
+	});
+}
+
+bool obs_frontend_virtualcam_active(void)
+{
+	return obs_output_active(frontend->virtualcamOutput);
+}
+
+// Applies the video settings of the current profile, like OBS does after the video settings changed
+void obs_frontend_reset_video(void)
+{
+	config_t *config = obs_frontend_get_profile_config();
+	ResetVideo((uint32_t)config_get_uint(config, "Video", "BaseCX"), (uint32_t)config_get_uint(config, "Video", "BaseCY"),
+		   (uint32_t)config_get_uint(config, "Video", "OutputCX"), (uint32_t)config_get_uint(config, "Video", "OutputCY"),
+		   (uint32_t)config_get_uint(config, "Video", "FPSNum"), (uint32_t)config_get_uint(config, "Video", "FPSDen"));
+}
+
+void obs_frontend_open_source_properties(obs_source_t *) {}
+
+void obs_frontend_open_source_filters(obs_source_t *) {}
+
+void obs_frontend_open_source_interaction(obs_source_t *) {}
+
+char *obs_frontend_get_current_record_output_path(void)
+{
+	return bstrdup(GetRecordDirectory().c_str());
+}
+
+static char *CopyPath(const std::string &path)
+{
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	return path.empty() ? nullptr : bstrdup(path.c_str());
+}
+
+char *obs_frontend_get_last_recording(void)
+{
+	return CopyPath(frontend->lastRecording);
+}
+
+char *obs_frontend_get_last_replay(void)
+{
+	return CopyPath(frontend->lastReplay);
+}
+
+char *obs_frontend_get_last_screenshot(void)
+{
+	return CopyPath(frontend->lastScreenshot);
+}
@@ -0,0 +1,481 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <algorithm>
+#include <util/platform.h>
+
+#include "MockObsInternal.h"
+
+// Bitrate used to derive the byte counts of active outputs
+#define OUTPUT_BITRATE_KBPS 6000
+
+using namespace MockObs::Internal;
+
+// All outputs which have not been destroyed, in creation order
+static std::vector<obs_output_t *> outputs;
+
+static uint32_t GetOutputFlags(const std::string &id)
+{
+	if (id == "rtmp_output")
+		return OBS_OUTPUT_AV | OBS_OUTPUT_ENCODED | OBS_OUTPUT_SERVICE | OBS_OUTPUT_MULTI_TRACK;
+	if (id == "ffmpeg_muxer" || id == "replay_buffer")
+		return OBS_OUTPUT_AV | OBS_OUTPUT_ENCODED | OBS_OUTPUT_MULTI_TRACK;
+	if (id == "virtualcam_output")
+		return OBS_OUTPUT_VIDEO;
+
+	return OBS_OUTPUT_AV;
+}
+
+static void EmitOutputSignal(obs_output_t *output, const char *signal, bool withCode = false)
+{
+	CallData cd;
+	calldata_set_ptr(cd, "output", output);
+	if (withCode)
+		calldata_set_int(cd, "code", OBS_OUTPUT_SUCCESS);
+	signal_handler_signal(output->signals, signal, cd);
+}
+
+// Seconds the output has been active for, or 0
+static double GetActiveSeconds(const obs_output_t *output)
+{
+	if (!output || !output->active)
+		return 0.0;
+
+	return (double)(os_gettime_ns() - output->startedAt) / 1000000000.0;
+}
+
+obs_output_t *obs_output_create(const char *id, const char *name, obs_data_t *settings, obs_data_t *)
+{
+	if (!id || !name)
+		return nullptr;
+
+	auto output = new obs_output;
+	output->control = new obs_weak_output;
+	output->control->object = output;
+	output->id = id;
+	output->name = name;
+	output->flags = GetOutputFlags(output->id);
+	output->settings = obs_data_create();
+	obs_data_apply(output->settings, settings);
+	output->signals = signal_handler_create();
+
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	outputs.push_back(output);
+
+	return output;
+}
+
+obs_output_t *obs_output_get_ref(obs_output_t *output)
+{
+	if (!output || !output->control->GetRef())
+		return nullptr;
+
+	return output;
+}
+
+void obs_output_release(obs_output_t *output)
+{
+	if (!output || output->control->refs.fetch_sub(1) != 1)
+		return;
+
+	if (output->active)
+		obs_output_stop(output);
+
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		outputs.erase(std::find(outputs.begin(), outputs.end(), output));
+	}
+
+	obs_data_release(output->settings);
+	signal_handler_destroy(output->signals);
+	output->control->object = nullptr;
+	ReleaseWeak(output->control);
+	delete output;
+}
+
+void obs_weak_output_addref(obs_weak_output_t *weak)
+{
+	if (weak)
+		weak->AddWeakRef();
+}
+
+void obs_weak_output_release(obs_weak_output_t *weak)
+{
+	ReleaseWeak(weak);
+}
+
+obs_weak_output_t *obs_output_get_weak_output(obs_output_t *output)
+{
+	if (!output)
+		return nullptr;
+
+	output->control->AddWeakRef();
+	return output->control;
+}
+
+obs_output_t *obs_weak_output_get_output(obs_weak_output_t *weak)
+{
+	if (!weak || !weak->GetRef())
+		return nullptr;
+
+	return weak->object;
+}
+
+void obs_enum_outputs(bool (*enum_proc)(void *, obs_output_t *), void *param)
+{
+	std::vector<obs_output_t *> snapshot;
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		for (obs_output_t *output : outputs)
+			if (obs_output_get_ref(output))
+				snapshot.push_back(output);
+	}
+
+	size_t i = 0;
+	for (; i < snapshot.size(); i++) {
+		bool keepGoing = enum_proc(param, snapshot[i]);
+		obs_output_release(snapshot[i]);
+		if (!keepGoing)
+			break;
+	}
+
+	for (i++; i < snapshot.size(); i++)
+		obs_output_release(snapshot[i]);
+}
+
+obs_output_t *obs_get_output_by_name(const char *name)
+{
+	if (!name)
+		return nullptr;
+
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	for (obs_output_t *output : outputs)
+		if (output->name == name)
+			return obs_output_get_ref(output);
+
+	return nullptr;
+}
+
+const char *obs_output_get_name(const obs_output_t *output)
+{
+	return output ? output->name.c_str() : nullptr;
+}
+
+const char *obs_output_get_id(const obs_output_t *output)
+{
+	return output ? output->id.c_str() : nullptr;
+}
+
+bool obs_output_start(obs_output_t *output)
+{
+	if (!output)
+		return false;
+
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		if (output->active)
+			return false;
+
+		output->active = true;
+		output->paused = false;
+		output->startedAt = os_gettime_ns();
+	}
+
+	EmitOutputSignal(output, "activate");
+	EmitOutputSignal(output, "start");
+	return true;
+}
+
+void obs_output_stop(obs_output_t *output)
+{
+	if (!output)
+		return;
+
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		if (!output->active)
+			return;
+
+		output->active = false;
+		output->paused = false;
+	}
+
+	EmitOutputSignal(output, "stopping");
+	EmitOutputSignal(output, "stop", true);
+	EmitOutputSignal(output, "deactivate");
+}
+
+bool obs_output_active(const obs_output_t *output)
+{
+	return output && output->active;
+}
+
+bool obs_output_paused(const obs_output_t *output)
+{
+	return output && output->paused;
+}
+
+bool obs_output_pause(obs_output_t *output, bool pause)
+{
+	if (!output)
+		return false;
+
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		if (!output->active || output->id == "rtmp_output")
+			return false;
+		if (output->paused == pause)
+			return true;
+
+		output->paused = pause;
+	}
+
+	EmitOutputSignal(output, pause ? "pause" : "unpause");
+	return true;
+}
+
+bool obs_output_reconnecting(const obs_output_t *)
+{
+	return false;
+}
+
+uint32_t obs_output_get_flags(const obs_output_t *output)
+{
+	return output ? output->flags : 0;
+}
+
+obs_data_t *obs_output_get_settings(const obs_output_t *output)
+{
+	if (!output)
+		return nullptr;
+
+	obs_data_addref(output->settings);
+	return output->settings;
+}
+
+void obs_output_update(obs_output_t *output, obs_data_t *settings)
+{
+	if (!output)
+		return;
+
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	obs_data_apply(output->settings, settings);
+}
+
+float obs_output_get_congestion(obs_output_t *)
+{
+	return 0.0f;
+}
+
+int obs_output_get_frames_dropped(const obs_output_t *)
+{
+	return 0;
+}
+
+int obs_output_get_total_frames(const obs_output_t *output)
+{
+	struct obs_video_info ovi;
+	obs_get_video_info(&ovi);
+	return (int)(GetActiveSeconds(output) * ovi.fps_num / ovi.fps_den);
+}
+
+uint64_t obs_output_get_total_bytes(const obs_output_t *output)
+{
+	return (uint64_t)(GetActiveSeconds(output) * OUTPUT_BITRATE_KBPS * 1000 / 8);
+}
+
+uint32_t obs_output_get_width(const obs_output_t *output)
+{
+	if (!output || !(output->flags & OBS_OUTPUT_VIDEO))
+		return 0;
+
+	struct obs_video_info ovi;
+	obs_get_video_info(&ovi);
+	return ovi.output_width;
+}
+
+uint32_t obs_output_get_height(const obs_output_t *output)
+{
+	if (!output || !(output->flags & OBS_OUTPUT_VIDEO))
+		return 0;
+
+	struct obs_video_info ovi;
+	obs_get_video_info(&ovi);
+	return ovi.output_height;
+}
+
+signal_handler_t *obs_output_get_signal_handler(const obs_output_t *output)
+{
+	return output ? output->signals : nullptr;
+}
+
+video_t *obs_output_video(const obs_output_t *output)
+{
+	return output ? obs_get_video() : nullptr;
+}
+
+void obs_output_output_caption_text2(obs_output_t *output, const char *text, double display_duration)
+{
+	if (!output || !text)
+		return;
+
+	blog(LOG_DEBUG, "[MockObs] Output '%s' caption (%.1fs): %s", output->name.c_str(), display_duration, text);
+}
+
+// No encoders exist in the mock, but the plugin resolves hotkey registerers through these
+obs_encoder_t *obs_encoder_get_ref(obs_encoder_t *encoder)
+{
+	if (!encoder || !encoder->control->GetRef())
+		return nullptr;
+
+	return encoder;
+}
+
+void obs_encoder_release(obs_encoder_t *encoder)
+{
+	if (!encoder || encoder->control->refs.fetch_sub(1) != 1)
+		return;
+
+	encoder->control->object = nullptr;
+	ReleaseWeak(encoder->control);
+	delete encoder;
+}
+
+void obs_weak_encoder_addref(obs_weak_encoder_t *weak)
+{
+	if (weak)
+		weak->AddWeakRef();
+}
+
+void obs_weak_encoder_release(obs_weak_encoder_t *weak)
+{
+	ReleaseWeak(weak);
+}
+
+obs_weak_encoder_t *obs_encoder_get_weak_encoder(obs_encoder_t *encoder)
+{
+	if (!encoder)
+		return nullptr;
+
+	encoder->control->AddWeakRef();
+	return encoder->control;
+}
+
+obs_encoder_t *obs_weak_encoder_get_encoder(obs_weak_encoder_t *weak)
+{
+	if (!weak || !weak->GetRef())
+		return nullptr;
+
+	return weak->object;
+}
+
+const char *obs_encoder_get_name(const obs_encoder_t *encoder)
+{
+	return encoder ? encoder->name.c_str() : nullptr;
+}
+
+obs_service_t *obs_service_create(const char *id, const char *name, obs_data_t *settings, obs_data_t *)
+{
+	if (!id || !name)
+		return nullptr;
+
+	auto service = new obs_service;
+	service->control = new obs_weak_service;
+	service->control->object = service;
+	service->id = id;
+	service->name = name;
+	service->settings = obs_data_create();
+	obs_data_apply(service->settings, settings);
+
+	return service;
+}
+
+obs_service_t *obs_service_get_ref(obs_service_t *service)
+{
+	if (!service || !service->control->GetRef())
+		return nullptr;
+
+	return service;
+}
+
+void obs_service_release(obs_service_t *service)
+{
+	if (!service || service->control->refs.fetch_sub(1) != 1)
+		return;
+
+	obs_data_release(service->settings);
+	service->control->object = nullptr;
+	ReleaseWeak(service->control);
+	delete service;
+}
+
+void obs_weak_service_addref(obs_weak_service_t *weak)
+{
+	if (weak)
+		weak->AddWeakRef();
+}
+
+void obs_weak_service_release(obs_weak_service_t *weak)
+{
+	ReleaseWeak(weak);
+}
+
+obs_weak_service_t *obs_service_get_weak_service(obs_service_t *service)
+{
+	if (!service)
+		return nullptr;
+
+	service->control->AddWeakRef();
+	return service->control;
+}
+
+obs_service_t *obs_weak_service_get_service(obs_weak_service_t *weak)
+{
+	if (!weak || !weak->GetRef())
+		return nullptr;
+
+	return weak->object;
+}
+
+const char *obs_service_get_name(const obs_service_t *service)
+{
+	return service ? service->name.c_str() : nullptr;
+}
+
+const char *obs_service_get_type(const obs_service_t *service)
+{
+	return service ? service->id.c_str() : nullptr;
+}
+
+obs_data_t *obs_service_get_settings(const obs_service_t *service)
+{
+	if (!service)
+		return nullptr;
+
+	obs_data_addref(service->settings);
+	return service->settings;
+}
+
+void obs_service_update(obs_service_t *service, obs_data_t *settings)
+{
+	if (!service)
+		return;
+
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	obs_data_apply(service->settings, settings);
+}
@@ -0,0 +1,353 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <string>
+#include <sys/statvfs.h>
+#include <unistd.h>
+#include <util/platform.h>
+#include <util/config-file.h>
+
+#include "MockObsInternal.h"
+
+static std::atomic<long> numAllocs = 0;
+
+void *bmalloc(size_t size)
+{
+	void *ptr = malloc(size ? size : 1);
+	if (!ptr) {
+		fprintf(stderr, "[MockObs] bmalloc: Out of memory while trying to allocate %zu bytes\n", size);
+		abort();
+	}
+
+	numAllocs++;
+	return ptr;
+}
+
+void *brealloc(void *ptr, size_t size)
+{
+	if (!ptr)
+		return bmalloc(size);
+
+	ptr = realloc(ptr, size ? size : 1);
+	if (!ptr) {
+		fprintf(stderr, "[MockObs] brealloc: Out of memory while trying to allocate %zu bytes\n", size);
+		abort();
+	}
+
+	return ptr;
+}
+
+void bfree(void *ptr)
+{
+	if (!ptr)
+		return;
+
+	numAllocs--;
+	free(ptr);
+}
+
+long bnum_allocs(void)
+{
+	return numAllocs;
+}
+
+void blogva(int log_level, const char *format, va_list args)
+{
+	if (log_level > MockObs::Internal::GetSettings().logLevel)
+		return;
+
+	const char *levelName = "debug";
+	switch (log_level) {
+	case LOG_ERROR:
+		levelName = "error";
+		break;
+	case LOG_WARNING:
+		levelName = "warning";
+		break;
+	case LOG_INFO:
+		levelName = "info";
+		break;
+	}
+
+	char message[4096];
+	vsnprintf(message, sizeof(message), format, args);
+	fprintf(stderr, "%s: %s\n", levelName, message);
+}
+
+void blog(int log_level, const char *format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	blogva(log_level, format, args);
+	va_end(args);
+}
+
+uint64_t os_gettime_ns(void)
+{
+	auto now = std::chrono::steady_clock::now().time_since_epoch();
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
+
+struct os_cpu_usage_info {
+	uint64_t lastTime;
+	uint64_t lastCpuTime;
+	long coreCount;
+};
+
+static uint64_t GetProcessCpuTimeNs()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+os_cpu_usage_info_t *os_cpu_usage_info_start(void)
+{
+	auto info = new os_cpu_usage_info;
+	info->lastTime = os_gettime_ns();
+	info->lastCpuTime = GetProcessCpuTimeNs();
+	info->coreCount = sysconf(_SC_NPROCESSORS_ONLN);
+	if (info->coreCount < 1)
+		info->coreCount = 1;
+	return info;
+}
+
+// Percentage of the total CPU time of all cores used by this process since the previous query, like libobs
+double os_cpu_usage_info_query(os_cpu_usage_info_t *info)
+{
+	if (!info)
+		return 0.0;
+
+	uint64_t time = os_gettime_ns();
+	uint64_t cpuTime = GetProcessCpuTimeNs();
+	uint64_t elapsed = time - info->lastTime;
+	uint64_t cpuElapsed = cpuTime - info->lastCpuTime;
+	info->lastTime = time;
+	info->lastCpuTime = cpuTime;
+
+	if (!elapsed)
+		return 0.0;
+
+	return (double)cpuElapsed / (double)elapsed / (double)info->coreCount * 100.0;
+}
+
+void os_cpu_usage_info_destroy(os_cpu_usage_info_t *info)
+{
+	delete info;
+}
+
+uint64_t os_get_free_disk_space(const char *dir)
+{
+	struct statvfs info;
+	if (!dir || statvfs(dir, &info) != 0)
+		return 0;
+
+	return (uint64_t)info.f_frsize * (uint64_t)info.f_bavail;
+}
+
+uint64_t os_get_proc_resident_size(void)
+{
+	FILE *file = fopen("/proc/self/statm", "r");
+	if (!file)
+		return 0;
+
+	unsigned long size = 0, resident = 0;
+	int ret = fscanf(file, "%lu %lu", &size, &resident);
+	fclose(file);
+	if (ret != 2)
+		return 0;
+
+	return (uint64_t)resident * (uint64_t)sysconf(_SC_PAGESIZE);
+}
+
+void profile_start(const char *) {}
+
+void profile_end(const char *) {}
+
+// In-memory config_t. Nothing is ever written to disk
+struct config_data {
+	std::map<std::pair<std::string, std::string>, std::string> values;
+	std::map<std::pair<std::string, std::string>, std::string> defaults;
+};
+
+namespace MockObs {
+	namespace Internal {
+		config_t *CreateConfig()
+		{
+			return new config_data;
+		}
+
+		void DestroyConfig(config_t *config)
+		{
+			delete config;
+		}
+	}
+}
+
+static const std::string *GetConfigValue(config_t *config, const char *section, const char *name)
+{
+	if (!config || !section || !name)
+		return nullptr;
+
+	std::lock_guard<std::recursive_mutex> lock(MockObs::Internal::GetMutex());
+	auto key = std::make_pair(std::string(section), std::string(name));
+	auto it = config->values.find(key);
+	if (it != config->values.end())
+		return &it->second;
+
+	it = config->defaults.find(key);
+	if (it != config->defaults.end())
+		return &it->second;
+
+	return nullptr;
+}
+
+static void SetConfigValue(config_t *config, const char *section, const char *name, const std::string &value, bool isDefault)
+{
+	if (!config || !section || !name)
+		return;
+
+	std::lock_guard<std::recursive_mutex> lock(MockObs::Internal::GetMutex());
+	auto &values = isDefault ? config->defaults : config->values;
+	values[std::make_pair(std::string(section), std::string(name))] = value;
+}
+
+int config_save(config_t *)
+{
+	return CONFIG_SUCCESS;
+}
+
+int config_save_safe(config_t *, const char *, const char *)
+{
+	return CONFIG_SUCCESS;
+}
+
+void config_set_string(config_t *config, const char *section, const char *name, const char *value)
+{
+	SetConfigValue(config, section, name, value ? value : "", false);
+}
+
+void config_set_int(config_t *config, const char *section, const char *name, int64_t value)
+{
+	SetConfigValue(config, section, name, std::to_string(value), false);
+}
+
+void config_set_uint(config_t *config, const char *section, const char *name, uint64_t value)
+{
+	SetConfigValue(config, section, name, std::to_string(value), false);
+}
+
+void config_set_bool(config_t *config, const char *section, const char *name, bool value)
+{
+	SetConfigValue(config, section, name, value ? "true" : "false", false);
+}
+
+void config_set_double(config_t *config, const char *section, const char *name, double value)
+{
+	SetConfigValue(config, section, name, std::to_string(value), false);
+}
+
+// Like libobs, the returned pointer is valid until the value changes
+const char *config_get_string(config_t *config, const char *section, const char *name)
+{
+	const std::string *value = GetConfigValue(config, section, name);
+	return value ? value->c_str() : nullptr;
+}
+
+int64_t config_get_int(config_t *config, const char *section, const char *name)
+{
+	const std::string *value = GetConfigValue(config, section, name);
+	return value ? strtoll(value->c_str(), nullptr, 10) : 0;
+}
+
+uint64_t config_get_uint(config_t *config, const char *section, const char *name)
+{
+	const std::string *value = GetConfigValue(config, section, name);
+	return value ? strtoull(value->c_str(), nullptr, 10) : 0;
+}
+
+bool config_get_bool(config_t *config, const char *section, const char *name)
+{
+	const std::string *value = GetConfigValue(config, section, name);
+	return value && (*value == "true" || strtoll(value->c_str(), nullptr, 10) != 0);
+}
+
+double config_get_double(config_t *config, const char *section, const char *name)
+{
+	const std::string *value = GetConfigValue(config, section, name);
+	return value ? strtod(value->c_str(), nullptr) : 0.0;
+}
+
+bool config_remove_value(config_t *config, const char *section, const char *name)
+{
+	if (!config || !section || !name)
+		return false;
+
+	std::lock_guard<std::recursive_mutex> lock(MockObs::Internal::GetMutex());
+	return config->values.erase(std::make_pair(std::string(section), std::string(name))) > 0;
+}
+
+void config_set_default_string(config_t *config, const char *section, const char *name, const char *value)
+{
+	SetConfigValue(config, section, name, value ? value : "", true);
+}
+
+void config_set_default_uint(config_t *config, const char *section, const char *name, uint64_t value)
+{
+	SetConfigValue(config, section, name, std::to_string(value), true);
+}
+
+void config_set_default_bool(config_t *config, const char *section, const char *name, bool value)
+{
+	SetConfigValue(config, section, name, value ? "true" : "false", true);
+}
+
+const char *config_get_default_string(config_t *config, const char *section, const char *name)
+{
+	if (!config || !section || !name)
+		return nullptr;
+
+	std::lock_guard<std::recursive_mutex> lock(MockObs::Internal::GetMutex());
+	auto it = config->defaults.find(std::make_pair(std::string(section), std::string(name)));
+	return it != config->defaults.end() ? it->second.c_str() : nullptr;
+}
+
+bool config_has_user_value(config_t *config, const char *section, const char *name)
+{
+	if (!config || !section || !name)
+		return false;
+
+	std::lock_guard<std::recursive_mutex> lock(MockObs::Internal::GetMutex());
+	return config->values.count(std::make_pair(std::string(section), std::string(name))) > 0;
+}
+
+bool config_has_default_value(config_t *config, const char *section, const char *name)
+{
+	if (!config || !section || !name)
+		return false;
+
+	std::lock_guard<std::recursive_mutex> lock(MockObs::Internal::GetMutex());
+	return config->defaults.count(std::make_pair(std::string(section), std::string(name))) > 0;
+}
@@ -0,0 +1,434 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <algorithm>
+#include <set>
+
+#include "MockObsInternal.h"
+
+using namespace MockObs::Internal;
+
+static std::set<obs_scene_t *> scenes;
+
+void MockObs::Internal::CreateSceneData(obs_source_t *source)
+{
+	auto scene = new obs_scene;
+	scene->source = source;
+	scene->isGroup = obs_source_is_group(source);
+	source->scene = scene;
+
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	scenes.insert(scene);
+}
+
+static void DestroySceneItem(obs_sceneitem_t *item)
+{
+	obs_source_release(item->source);
+	obs_data_release(item->privateSettings);
+	delete item;
+}
+
+void MockObs::Internal::DestroySceneData(obs_source_t *source)
+{
+	obs_scene_t *scene = source->scene;
+	std::vector<obs_sceneitem_t *> items;
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		scenes.erase(scene);
+		items.swap(scene->items);
+		for (obs_sceneitem_t *item : items) {
+			item->removed = true;
+			item->parent = nullptr;
+		}
+	}
+
+	for (obs_sceneitem_t *item : items)
+		obs_sceneitem_release(item);
+
+	source->scene = nullptr;
+	delete scene;
+}
+
+void MockObs::Internal::RemoveSourceFromScenes(obs_source_t *source)
+{
+	std::vector<obs_sceneitem_t *> items;
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		for (obs_scene_t *scene : scenes) {
+			for (obs_sceneitem_t *item : scene->items) {
+				if (item->source == source) {
+					obs_sceneitem_addref(item);
+					items.push_back(item);
+				}
+			}
+		}
+	}
+
+	for (obs_sceneitem_t *item : items) {
+		obs_sceneitem_remove(item);
+		obs_sceneitem_release(item);
+	}
+}
+
+static void EmitItemSignal(obs_sceneitem_t *item, obs_scene_t *scene, const char *signal, const char *name = nullptr,
+			   bool value = false)
+{
+	CallData cd;
+	calldata_set_ptr(cd, "scene", scene);
+	calldata_set_ptr(cd, "item", item);
+	if (name)
+		calldata_set_bool(cd, name, value);
+	signal_handler_signal(scene->source->signals, signal, cd);
+}
+
+static void EmitReorder(obs_scene_t *scene)
+{
+	CallData cd;
+	calldata_set_ptr(cd, "scene", scene);
+	signal_handler_signal(scene->source->signals, "reorder", cd);
+}
+
+obs_scene_t *obs_scene_create(const char *name)
+{
+	obs_source_t *source = obs_source_create("scene", name, nullptr, nullptr);
+	return source ? source->scene : nullptr;
+}
+
+obs_scene_t *obs_scene_get_ref(obs_scene_t *scene)
+{
+	if (!scene || !obs_source_get_ref(scene->source))
+		return nullptr;
+
+	return scene;
+}
+
+void obs_scene_release(obs_scene_t *scene)
+{
+	if (scene)
+		obs_source_release(scene->source);
+}
+
+obs_source_t *obs_scene_get_source(const obs_scene_t *scene)
+{
+	return scene ? scene->source : nullptr;
+}
+
+obs_scene_t *obs_scene_from_source(const obs_source_t *source)
+{
+	if (!source || !source->scene || source->scene->isGroup)
+		return nullptr;
+
+	return source->scene;
+}
+
+obs_scene_t *obs_group_from_source(const obs_source_t *source)
+{
+	if (!source || !source->scene || !source->scene->isGroup)
+		return nullptr;
+
+	return source->scene;
+}
+
+obs_sceneitem_t *obs_scene_find_sceneitem_by_id(obs_scene_t *scene, int64_t id)
+{
+	if (!scene)
+		return nullptr;
+
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	for (obs_sceneitem_t *item : scene->items)
+		if (item->id == id)
+			return item;
+
+	return nullptr;
+}
+
+void obs_scene_enum_items(obs_scene_t *scene, bool (*callback)(obs_scene_t *, obs_sceneitem_t *, void *), void *param)
+{
+	if (!scene || !callback)
+		return;
+
+	std::vector<obs_sceneitem_t *> items;
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		items = scene->items;
+		for (obs_sceneitem_t *item : items)
+			obs_sceneitem_addref(item);
+	}
+
+	size_t i = 0;
+	for (; i < items.size(); i++) {
+		bool keepGoing = callback(scene, items[i], param);
+		obs_sceneitem_release(items[i]);
+		if (!keepGoing)
+			break;
+	}
+
+	for (i++; i < items.size(); i++)
+		obs_sceneitem_release(items[i]);
+}
+
+// Requires the mutex
+static bool SceneContainsSource(obs_scene_t *scene, obs_source_t *source)
+{
+	if (scene->source == source)
+		return true;
+
+	for (obs_sceneitem_t *item : scene->items)
+		if (item->source->scene && SceneContainsSource(item->source->scene, source))
+			return true;
+
+	return false;
+}
+
+obs_sceneitem_t *obs_scene_add(obs_scene_t *scene, obs_source_t *source)
+{
+	if (!scene || !source)
+		return nullptr;
+
+	auto item = new obs_scene_item;
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		if (source->removed || (source->scene && SceneContainsSource(source->scene, scene->source))) {
+			blog(LOG_WARNING, "[MockObs] Adding source '%s' to scene '%s' would be recursive, or it is removed",
+			     source->name.c_str(), scene->source->name.c_str());
+			delete item;
+			return nullptr;
+		}
+
+		item->parent = scene;
+		item->source = obs_source_get_ref(source);
+		item->id = scene->nextItemId++;
+		item->info.scale = {1.0f, 1.0f};
+		item->info.alignment = OBS_ALIGN_LEFT | OBS_ALIGN_TOP;
+		item->info.bounds_alignment = OBS_ALIGN_CENTER;
+		item->privateSettings = obs_data_create();
+		scene->items.push_back(item);
+	}
+
+	EmitItemSignal(item, scene, "item_add");
+	UpdateSourceStates();
+
+	return item;
+}
+
+// Nothing renders in the mock, so an atomic update only needs to keep the scene alive
+void obs_scene_atomic_update(obs_scene_t *scene, obs_scene_atomic_update_func func, void *data)
+{
+	obs_scene_t *ref = obs_scene_get_ref(scene);
+	if (!ref)
+		return;
+
+	func(data, ref);
+	obs_scene_release(ref);
+}
+
+void obs_sceneitem_addref(obs_sceneitem_t *item)
+{
+	if (item)
+		item->refs++;
+}
+
+void obs_sceneitem_release(obs_sceneitem_t *item)
+{
+	if (item && item->refs.fetch_sub(1) == 1)
+		DestroySceneItem(item);
+}
+
+void obs_sceneitem_remove(obs_sceneitem_t *item)
+{
+	if (!item)
+		return;
+
+	obs_scene_t *scene;
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		if (item->removed || !item->parent)
+			return;
+
+		item->removed = true;
+		scene = item->parent;
+		auto &items = scene->items;
+		items.erase(std::find(items.begin(), items.end(), item));
+	}
+
+	obs_source_t *sceneSource = obs_source_get_ref(scene->source);
+	if (sceneSource)
+		EmitItemSignal(item, scene, "item_remove");
+
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		item->parent = nullptr;
+	}
+
+	UpdateSourceStates();
+	obs_source_release(sceneSource);
+	obs_sceneitem_release(item);
+}
+
+obs_scene_t *obs_sceneitem_get_scene(const obs_sceneitem_t *item)
+{
+	return item ? item->parent : nullptr;
+}
+
+obs_source_t *obs_sceneitem_get_source(const obs_sceneitem_t *item)
+{
+	return item ? item->source : nullptr;
+}
+
+int64_t obs_sceneitem_get_id(const obs_sceneitem_t *item)
+{
+	return item ? item->id : 0;
+}
+
+bool obs_sceneitem_visible(const obs_sceneitem_t *item)
+{
+	return item && item->visible;
+}
+
+bool obs_sceneitem_set_visible(obs_sceneitem_t *item, bool visible)
+{
+	obs_scene_t *scene;
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		if (!item || !item->parent || item->visible == visible)
+			return false;
+
+		item->visible = visible;
+		scene = item->parent;
+	}
+
+	EmitItemSignal(item, scene, "item_visible", "visible", visible);
+	UpdateSourceStates();
+	return true;
+}
+
+bool obs_sceneitem_locked(const obs_sceneitem_t *item)
+{
+	return item && item->locked;
+}
+
+bool obs_sceneitem_set_locked(obs_sceneitem_t *item, bool lock)
+{
+	obs_scene_t *scene;
+	{
+		std::lock_guard<std::recursive_mutex> guard(GetMutex());
+		if (!item || !item->parent || item->locked == lock)
+			return false;
+
+		item->locked = lock;
+		scene = item->parent;
+	}
+
+	EmitItemSignal(item, scene, "item_locked", "locked", lock);
+	return true;
+}
+
+int obs_sceneitem_get_order_position(obs_sceneitem_t *item)
+{
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	if (!item || !item->parent)
+		return -1;
+
+	auto &items = item->parent->items;
+	return (int)(std::find(items.begin(), items.end(), item) - items.begin());
+}
+
+void obs_sceneitem_set_order_position(obs_sceneitem_t *item, int position)
+{
+	obs_scene_t *scene;
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		if (!item || !item->parent)
+			return;
+
+		scene = item->parent;
+		auto &items = scene->items;
+		items.erase(std::find(items.begin(), items.end(), item));
+		position = std::clamp(position, 0, (int)items.size());
+		items.insert(items.begin() + position, item);
+	}
+
+	EmitReorder(scene);
+}
+
+void obs_sceneitem_get_info2(const obs_sceneitem_t *item, struct obs_transform_info *info)
+{
+	if (item && info)
+		*info = item->info;
+}
+
+void obs_sceneitem_set_info2(obs_sceneitem_t *item, const struct obs_transform_info *info)
+{
+	obs_scene_t *scene;
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		if (!item || !info || !item->parent)
+			return;
+
+		item->info = *info;
+		scene = item->parent;
+	}
+
+	EmitItemSignal(item, scene, "item_transform");
+}
+
+void obs_sceneitem_get_crop(const obs_sceneitem_t *item, struct obs_sceneitem_crop *crop)
+{
+	if (item && crop)
+		*crop = item->crop;
+}
+
+void obs_sceneitem_set_crop(obs_sceneitem_t *item, const struct obs_sceneitem_crop *crop)
+{
+	obs_scene_t *scene;
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		if (!item || !crop || !item->parent)
+			return;
+
+		item->crop = *crop;
+		scene = item->parent;
+	}
+
+	EmitItemSignal(item, scene, "item_transform");
+}
+
+enum obs_blending_type obs_sceneitem_get_blending_mode(obs_sceneitem_t *item)
+{
+	return item ? item->blendingMode : OBS_BLEND_NORMAL;
+}
+
+void obs_sceneitem_set_blending_mode(obs_sceneitem_t *item, enum obs_blending_type type)
+{
+	if (item)
+		item->blendingMode = type;
+}
+
+bool obs_sceneitem_is_group(obs_sceneitem_t *item)
+{
+	return item && obs_source_is_group(item->source);
+}
+
+obs_data_t *obs_sceneitem_get_private_settings(obs_sceneitem_t *item)
+{
+	if (!item)
+		return nullptr;
+
+	obs_data_addref(item->privateSettings);
+	return item->privateSettings;
+}
@@ -0,0 +1,1367 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <set>
+#include <unordered_map>
+#include <util/platform.h>
+
+#include "MockObsInternal.h"
+
+#define MAX_CHANNELS 64
+#define SAMPLE_RATE 48000
+#define TONE_FREQUENCY 440.0
+
+using namespace MockObs::Internal;
+
+static const uint32_t InputAudioFlags = OBS_SOURCE_AUDIO | OBS_SOURCE_DO_NOT_DUPLICATE;
+static const uint32_t MediaFlags = OBS_SOURCE_ASYNC_VIDEO | OBS_SOURCE_AUDIO | OBS_SOURCE_DO_NOT_DUPLICATE |
+				   OBS_SOURCE_CONTROLLABLE_MEDIA;
+static const uint32_t SceneFlags = OBS_SOURCE_VIDEO | OBS_SOURCE_CUSTOM_DRAW | OBS_SOURCE_COMPOSITE;
+
+// clang-format off
+static const std::vector<SourceKind> sourceKinds = {
+	{"color_source_v3", "color_source", OBS_SOURCE_TYPE_INPUT, OBS_SOURCE_VIDEO | OBS_SOURCE_CUSTOM_DRAW, 1920, 1080, 0,
+	 R"({"color": 4291940817, "width": 1920, "height": 1080})",
+	 {{"color", OBS_PROPERTY_COLOR, OBS_COMBO_FORMAT_INVALID, {}},
+	  {"width", OBS_PROPERTY_INT, OBS_COMBO_FORMAT_INVALID, {}},
+	  {"height", OBS_PROPERTY_INT, OBS_COMBO_FORMAT_INVALID, {}}}, false},
+	{"image_source", "image_source", OBS_SOURCE_TYPE_INPUT, OBS_SOURCE_VIDEO, 0, 0, 0,
+	 R"({"file": "", "unload": false})",
+	 {{"file", OBS_PROPERTY_PATH, OBS_COMBO_FORMAT_INVALID, {}},
+	  {"unload", OBS_PROPERTY_BOOL, OBS_COMBO_FORMAT_INVALID, {}}}, false},
+	{"ffmpeg_source", "ffmpeg_source", OBS_SOURCE_TYPE_INPUT, MediaFlags, 1280, 720, 60000,
+	 R"({"is_local_file": true, "local_file": "", "looping": false, "restart_on_activate": true, "speed_percent": 100})",
+	 {{"is_local_file", OBS_PROPERTY_BOOL, OBS_COMBO_FORMAT_INVALID, {}},
+	  {"local_file", OBS_PROPERTY_PATH, OBS_COMBO_FORMAT_INVALID, {}},
+	  {"looping", OBS_PROPERTY_BOOL, OBS_COMBO_FORMAT_INVALID, {}},
+	  {"restart_on_activate", OBS_PROPERTY_BOOL, OBS_COMBO_FORMAT_INVALID, {}},
+	  {"speed_percent", OBS_PROPERTY_INT, OBS_COMBO_FORMAT_INVALID, {}}}, false},
+	{"pulse_input_capture", "pulse_input_capture", OBS_SOURCE_TYPE_INPUT, InputAudioFlags, 0, 0, 0,
+	 R"({"device_id": "default"})",
+	 {{"device_id", OBS_PROPERTY_LIST, OBS_COMBO_FORMAT_STRING, {{"Default", "default"}, {"Mock Microphone", "mock_input"}}}},
+	 false},
+	{"pulse_output_capture", "pulse_output_capture", OBS_SOURCE_TYPE_INPUT, InputAudioFlags | OBS_SOURCE_DO_NOT_SELF_MONITOR, 0,
+	 0, 0, R"({"device_id": "default"})",
+	 {{"device_id", OBS_PROPERTY_LIST, OBS_COMBO_FORMAT_STRING, {{"Default", "default"}, {"Mock Speakers", "mock_output"}}}},
+	 false},
+	{"color_filter_v2", "color_filter", OBS_SOURCE_TYPE_FILTER, OBS_SOURCE_VIDEO, 0, 0, 0,
+	 R"({"gamma": 0.0, "contrast": 0.0, "brightness": 0.0, "saturation": 0.0, "hue_shift": 0.0, "opacity": 1.0})",
+	 {{"gamma", OBS_PROPERTY_FLOAT, OBS_COMBO_FORMAT_INVALID, {}},
+	  {"contrast", OBS_PROPERTY_FLOAT, OBS_COMBO_FORMAT_INVALID, {}},
+	  {"brightness", OBS_PROPERTY_FLOAT, OBS_COMBO_FORMAT_INVALID, {}},
+	  {"saturation", OBS_PROPERTY_FLOAT, OBS_COMBO_FORMAT_INVALID, {}},
+	  {"hue_shift", OBS_PROPERTY_FLOAT, OBS_COMBO_FORMAT_INVALID, {}},
+	  {"opacity", OBS_PROPERTY_FLOAT, OBS_COMBO_FORMAT_INVALID, {}}}, false},
+	{"gain_filter", "gain_filter", OBS_SOURCE_TYPE_FILTER, OBS_SOURCE_AUDIO, 0, 0, 0,
+	 R"({"db": 0.0})",
+	 {{"db", OBS_PROPERTY_FLOAT, OBS_COMBO_FORMAT_INVALID, {}}}, false},
+	{"noise_suppress_filter_v2", "noise_suppress_filter", OBS_SOURCE_TYPE_FILTER, OBS_SOURCE_AUDIO, 0, 0, 0,
+	 R"({"method": "speex", "suppress_level": -30})",
+	 {{"method", OBS_PROPERTY_LIST, OBS_COMBO_FORMAT_STRING, {{"Speex", "speex"}, {"RNNoise", "rnnoise"}}},
+	  {"suppress_level", OBS_PROPERTY_INT, OBS_COMBO_FORMAT_INVALID, {}}}, false},
+	{"cut_transition", "cut_transition", OBS_SOURCE_TYPE_TRANSITION, OBS_SOURCE_VIDEO, 0, 0, 0, "{}", {}, true},
+	{"fade_transition", "fade_transition", OBS_SOURCE_TYPE_TRANSITION, OBS_SOURCE_VIDEO, 0, 0, 0,
+	 R"({"switch_point": 50})",
+	 {{"switch_point", OBS_PROPERTY_INT, OBS_COMBO_FORMAT_INVALID, {}}}, false},
+	{"scene", "scene", OBS_SOURCE_TYPE_SCENE, SceneFlags, 0, 0, 0, "{}", {}, false},
+	{"group", "group", OBS_SOURCE_TYPE_SCENE, SceneFlags, 0, 0, 0, "{}", {}, false},
+};
+// clang-format on
+
+// All sources which have not been destroyed, in creation order
+static std::vector<obs_source_t *> sources;
+// Public sources which have not been removed
+static std::unordered_map<std::string, obs_source_t *> sourcesByName;
+static std::unordered_map<std::string, obs_source_t *> sourcesByUuid;
+static obs_source_t *outputChannels[MAX_CHANNELS] = {};
+
+const std::vector<SourceKind> &MockObs::Internal::GetSourceKinds()
+{
+	return sourceKinds;
+}
+
+const SourceKind *MockObs::Internal::GetSourceKind(const std::string &id)
+{
+	for (auto &kind : sourceKinds)
+		if (kind.id == id)
+			return &kind;
+
+	return nullptr;
+}
+
+static std::string GenerateUuid()
+{
+	static std::mt19937_64 generator{std::random_device{}()};
+	static std::uniform_int_distribution<int> distribution(0, 15);
+
+	std::string ret = "xxxxxxxx-xxxx-4xxx-yxxx-xxxxxxxxxxxx";
+	for (char &c : ret) {
+		if (c != 'x' && c != 'y')
+			continue;
+
+		int value = distribution(generator);
+		if (c == 'y')
+			value = (value & 0x3) | 0x8;
+		c = "0123456789abcdef"[value];
+	}
+
+	return ret;
+}
+
+// Requires the mutex
+static void ForgetSourceName(obs_source_t *source)
+{
+	auto it = sourcesByName.find(source->name);
+	if (it == sourcesByName.end() || it->second != source)
+		return;
+
+	sourcesByName.erase(it);
+
+	// Fall back to another public source with the same name, like a lookup in libobs would
+	for (obs_source_t *other : sources) {
+		if (other != source && !other->isPrivate && !other->removed && other->name == source->name) {
+			sourcesByName[other->name] = other;
+			break;
+		}
+	}
+}
+
+void MockObs::Internal::EmitSourceSignal(obs_source_t *source, const char *signal, bool global)
+{
+	CallData cd;
+	calldata_set_ptr(cd, "source", source);
+
+	if (global && !source->isPrivate) {
+		std::string globalSignal = std::string("source_") + signal;
+		signal_handler_signal(GetCoreSignalHandler(), globalSignal.c_str(), cd);
+	}
+	signal_handler_signal(source->signals, signal, cd);
+}
+
+static obs_source_t *CreateSource(const char *id, const char *name, obs_data_t *settings, bool isPrivate)
+{
+	const SourceKind *kind = id ? GetSourceKind(id) : nullptr;
+	if (!kind) {
+		blog(LOG_WARNING, "[MockObs] Source ID '%s' not found", id ? id : "");
+		return nullptr;
+	}
+
+	auto source = new obs_source;
+	source->control = new obs_weak_source;
+	source->control->object = source;
+	source->kind = kind;
+	source->name = name ? name : "";
+	source->uuid = GenerateUuid();
+	source->isPrivate = isPrivate;
+	source->settings = obs_data_create();
+	SetDataDefaults(source->settings, kind->defaults);
+	obs_data_apply(source->settings, settings);
+	source->privateSettings = obs_data_create();
+	source->signals = signal_handler_create();
+	source->procs = proc_handler_create();
+
+	if (kind->type == OBS_SOURCE_TYPE_SCENE)
+		CreateSceneData(source);
+
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		sources.push_back(source);
+		if (!isPrivate) {
+			sourcesByName.emplace(source->name, source);
+			sourcesByUuid[source->uuid] = source;
+		}
+	}
+
+	blog(LOG_DEBUG, "[MockObs] Source '%s' (%s) created", source->name.c_str(), kind->id.c_str());
+
+	EmitSourceSignal(source, "create", true);
+
+	return source;
+}
+
+static void DestroySource(obs_source_t *source)
+{
+	blog(LOG_DEBUG, "[MockObs] Source '%s' destroyed", source->name.c_str());
+
+	EmitSourceSignal(source, "destroy", true);
+
+	std::vector<obs_source_t *> filters;
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		sources.erase(std::find(sources.begin(), sources.end(), source));
+		if (!source->isPrivate && !source->removed) {
+			ForgetSourceName(source);
+			sourcesByUuid.erase(source->uuid);
+		}
+
+		filters.swap(source->filters);
+		for (obs_source_t *filter : filters)
+			filter->filterParent = nullptr;
+	}
+
+	for (obs_source_t *filter : filters)
+		obs_source_release(filter);
+
+	if (source->scene)
+		DestroySceneData(source);
+
+	obs_data_release(source->settings);
+	obs_data_release(source->privateSettings);
+	signal_handler_destroy(source->signals);
+	proc_handler_destroy(source->procs);
+
+	source->control->object = nullptr;
+	ReleaseWeak(source->control);
+	delete source;
+}
+
+obs_source_t *obs_source_create(const char *id, const char *name, obs_data_t *settings, obs_data_t *)
+{
+	return CreateSource(id, name, settings, false);
+}
+
+obs_source_t *obs_source_create_private(const char *id, const char *name, obs_data_t *settings)
+{
+	return CreateSource(id, name, settings, true);
+}
+
+obs_source_t *obs_source_get_ref(obs_source_t *source)
+{
+	if (!source || !source->control->GetRef())
+		return nullptr;
+
+	return source;
+}
+
+void obs_source_release(obs_source_t *source)
+{
+	if (source && source->control->refs.fetch_sub(1) == 1)
+		DestroySource(source);
+}
+
+void obs_source_remove(obs_source_t *source)
+{
+	if (!source)
+		return;
+
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		if (source->removed)
+			return;
+
+		source->removed = true;
+		if (!source->isPrivate) {
+			ForgetSourceName(source);
+			sourcesByUuid.erase(source->uuid);
+		}
+	}
+
+	obs_source_t *ref = obs_source_get_ref(source);
+	if (!ref)
+		return;
+
+	EmitSourceSignal(source, "remove", true);
+	RemoveSourceFromScenes(source);
+	UpdateSourceStates();
+	obs_source_release(ref);
+}
+
+bool obs_source_removed(const obs_source_t *source)
+{
+	return source ? source->removed : true;
+}
+
+void obs_weak_source_addref(obs_weak_source_t *weak)
+{
+	if (weak)
+		weak->AddWeakRef();
+}
+
+void obs_weak_source_release(obs_weak_source_t *weak)
+{
+	ReleaseWeak(weak);
+}
+
+obs_weak_source_t *obs_source_get_weak_source(obs_source_t *source)
+{
+	if (!source)
+		return nullptr;
+
+	source->control->AddWeakRef();
+	return source->control;
+}
+
+obs_source_t *obs_weak_source_get_source(obs_weak_source_t *weak)
+{
+	if (!weak || !weak->GetRef())
+		return nullptr;
+
+	return weak->object;
+}
+
+bool obs_weak_source_expired(obs_weak_source_t *weak)
+{
+	return !weak || weak->refs == 0;
+}
+
+bool obs_weak_source_references_source(obs_weak_source_t *weak, obs_source_t *source)
+{
+	return weak && source && source->control == weak;
+}
+
+static obs_source_t *GetSourceRef(std::unordered_map<std::string, obs_source_t *> &map, const char *key)
+{
+	if (!key)
+		return nullptr;
+
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	auto it = map.find(key);
+	if (it == map.end())
+		return nullptr;
+
+	return obs_source_get_ref(it->second);
+}
+
+obs_source_t *obs_get_source_by_name(const char *name)
+{
+	return GetSourceRef(sourcesByName, name);
+}
+
+obs_source_t *obs_get_source_by_uuid(const char *uuid)
+{
+	return GetSourceRef(sourcesByUuid, uuid);
+}
+
+// Like libobs, enumeration works on a snapshot, so that the callback may create or remove sources
+static void EnumSources(bool (*enum_proc)(void *, obs_source_t *), void *param, bool (*filter)(obs_source_t *))
+{
+	std::vector<obs_source_t *> snapshot;
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		for (obs_source_t *source : sources)
+			if (!source->isPrivate && !source->removed && filter(source) && obs_source_get_ref(source))
+				snapshot.push_back(source);
+	}
+
+	size_t i = 0;
+	for (; i < snapshot.size(); i++) {
+		bool keepGoing = enum_proc(param, snapshot[i]);
+		obs_source_release(snapshot[i]);
+		if (!keepGoing)
+			break;
+	}
+
+	for (i++; i < snapshot.size(); i++)
+		obs_source_release(snapshot[i]);
+}
+
+void obs_enum_sources(bool (*enum_proc)(void *, obs_source_t *), void *param)
+{
+	EnumSources(enum_proc, param, [](obs_source_t *source) {
+		return source->kind->type == OBS_SOURCE_TYPE_INPUT || obs_source_is_group(source);
+	});
+}
+
+void obs_enum_scenes(bool (*enum_proc)(void *, obs_source_t *), void *param)
+{
+	EnumSources(enum_proc, param, [](obs_source_t *source) { return source->kind->type == OBS_SOURCE_TYPE_SCENE; });
+}
+
+template<typename T> static bool EnumKinds(enum obs_source_type type, size_t idx, T callback)
+{
+	for (auto &kind : sourceKinds) {
+		if (kind.type != type)
+			continue;
+
+		if (idx-- == 0) {
+			callback(kind);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool obs_enum_input_types2(size_t idx, const char **id, const char **unversioned_id)
+{
+	return EnumKinds(OBS_SOURCE_TYPE_INPUT, idx, [=](const SourceKind &kind) {
+		if (id)
+			*id = kind.id.c_str();
+		if (unversioned_id)
+			*unversioned_id = kind.unversionedId.c_str();
+	});
+}
+
+bool obs_enum_filter_types(size_t idx, const char **id)
+{
+	return EnumKinds(OBS_SOURCE_TYPE_FILTER, idx, [=](const SourceKind &kind) { *id = kind.id.c_str(); });
+}
+
+bool obs_enum_transition_types(size_t idx, const char **id)
+{
+	return EnumKinds(OBS_SOURCE_TYPE_TRANSITION, idx, [=](const SourceKind &kind) { *id = kind.id.c_str(); });
+}
+
+uint32_t obs_get_source_output_flags(const char *id)
+{
+	const SourceKind *kind = id ? GetSourceKind(id) : nullptr;
+	return kind ? kind->outputFlags : 0;
+}
+
+obs_data_t *obs_get_source_defaults(const char *id)
+{
+	const SourceKind *kind = id ? GetSourceKind(id) : nullptr;
+	if (!kind)
+		return nullptr;
+
+	obs_data_t *ret = obs_data_create();
+	SetDataDefaults(ret, kind->defaults);
+	return ret;
+}
+
+obs_source_t *obs_get_output_source(uint32_t channel)
+{
+	if (channel >= MAX_CHANNELS)
+		return nullptr;
+
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	return obs_source_get_ref(outputChannels[channel]);
+}
+
+void obs_set_output_source(uint32_t channel, obs_source_t *source)
+{
+	if (channel >= MAX_CHANNELS)
+		return;
+
+	obs_source_t *previous;
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		previous = outputChannels[channel];
+		outputChannels[channel] = obs_source_get_ref(source);
+	}
+
+	UpdateSourceStates();
+	obs_source_release(previous);
+}
+
+const char *obs_source_get_name(const obs_source_t *source)
+{
+	return source ? source->name.c_str() : nullptr;
+}
+
+void obs_source_set_name(obs_source_t *source, const char *name)
+{
+	if (!source || !name)
+		return;
+
+	std::string previousName;
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		if (source->name == name)
+			return;
+
+		bool tracked = !source->isPrivate && !source->removed;
+		if (tracked)
+			ForgetSourceName(source);
+
+		previousName = source->name;
+		source->name = name;
+
+		if (tracked)
+			sourcesByName.emplace(source->name, source);
+	}
+
+	CallData cd;
+	calldata_set_ptr(cd, "source", source);
+	calldata_set_string(cd, "new_name", name);
+	calldata_set_string(cd, "prev_name", previousName.c_str());
+	if (!source->isPrivate)
+		signal_handler_signal(GetCoreSignalHandler(), "source_rename", cd);
+	signal_handler_signal(source->signals, "rename", cd);
+}
+
+const char *obs_source_get_uuid(const obs_source_t *source)
+{
+	return source ? source->uuid.c_str() : nullptr;
+}
+
+enum obs_source_type obs_source_get_type(const obs_source_t *source)
+{
+	return source ? source->kind->type : OBS_SOURCE_TYPE_INPUT;
+}
+
+const char *obs_source_get_id(const obs_source_t *source)
+{
+	return source ? source->kind->id.c_str() : nullptr;
+}
+
+const char *obs_source_get_unversioned_id(const obs_source_t *source)
+{
+	return source ? source->kind->unversionedId.c_str() : nullptr;
+}
+
+uint32_t obs_source_get_output_flags(const obs_source_t *source)
+{
+	return source ? source->kind->outputFlags : 0;
+}
+
+obs_data_t *obs_source_get_settings(const obs_source_t *source)
+{
+	if (!source)
+		return nullptr;
+
+	obs_data_addref(source->settings);
+	return source->settings;
+}
+
+obs_data_t *obs_source_get_private_settings(obs_source_t *source)
+{
+	if (!source)
+		return nullptr;
+
+	obs_data_addref(source->privateSettings);
+	return source->privateSettings;
+}
+
+void obs_source_update(obs_source_t *source, obs_data_t *settings)
+{
+	if (!source)
+		return;
+
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		obs_data_apply(source->settings, settings);
+	}
+
+	EmitSourceSignal(source, "update", true);
+}
+
+void obs_source_reset_settings(obs_source_t *source, obs_data_t *settings)
+{
+	if (!source)
+		return;
+
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		obs_data_clear(source->settings);
+	}
+
+	obs_source_update(source, settings);
+}
+
+obs_properties_t *obs_source_properties(const obs_source_t *source)
+{
+	if (!source)
+		return nullptr;
+
+	auto ret = new obs_properties;
+	for (auto &info : source->kind->properties) {
+		ret->properties.push_back(std::make_unique<obs_property>());
+		ret->properties.back()->info = info;
+	}
+
+	return ret;
+}
+
+bool obs_source_configurable(const obs_source_t *source)
+{
+	return source && !source->kind->properties.empty();
+}
+
+void obs_source_update_properties(obs_source_t *source)
+{
+	if (!source)
+		return;
+
+	EmitSourceSignal(source, "update_properties");
+}
+
+void obs_properties_destroy(obs_properties_t *props)
+{
+	delete props;
+}
+
+obs_property_t *obs_properties_get(obs_properties_t *props, const char *property)
+{
+	if (!props || !property)
+		return nullptr;
+
+	for (auto &prop : props->properties)
+		if (prop->info.name == property)
+			return prop.get();
+
+	return nullptr;
+}
+
+enum obs_property_type obs_property_get_type(obs_property_t *p)
+{
+	return p ? p->info.type : OBS_PROPERTY_INVALID;
+}
+
+bool obs_property_enabled(obs_property_t *p)
+{
+	return p != nullptr;
+}
+
+bool obs_property_button_clicked(obs_property_t *, void *)
+{
+	return false;
+}
+
+enum obs_combo_format obs_property_list_format(obs_property_t *p)
+{
+	return p ? p->info.format : OBS_COMBO_FORMAT_INVALID;
+}
+
+size_t obs_property_list_item_count(obs_property_t *p)
+{
+	return p ? p->info.items.size() : 0;
+}
+
+bool obs_property_list_item_disabled(obs_property_t *, size_t)
+{
+	return false;
+}
+
+static const std::pair<std::string, std::string> *GetListItem(obs_property_t *p, size_t idx)
+{
+	if (!p || idx >= p->info.items.size())
+		return nullptr;
+
+	return &p->info.items[idx];
+}
+
+const char *obs_property_list_item_name(obs_property_t *p, size_t idx)
+{
+	auto item = GetListItem(p, idx);
+	return item ? item->first.c_str() : nullptr;
+}
+
+const char *obs_property_list_item_string(obs_property_t *p, size_t idx)
+{
+	auto item = GetListItem(p, idx);
+	return item ? item->second.c_str() : nullptr;
+}
+
+long long obs_property_list_item_int(obs_property_t *p, size_t idx)
+{
+	auto item = GetListItem(p, idx);
+	return item ? strtoll(item->second.c_str(), nullptr, 10) : 0;
+}
+
+double obs_property_list_item_float(obs_property_t *p, size_t idx)
+{
+	auto item = GetListItem(p, idx);
+	return item ? strtod(item->second.c_str(), nullptr) : 0.0;
+}
+
+// Scenes and transitions are canvas sized, and inputs with `width` and `height` settings (like color sources) use those
+static uint32_t GetSourceSize(obs_source_t *source, bool height)
+{
+	if (!source)
+		return 0;
+
+	if (source->kind->type == OBS_SOURCE_TYPE_SCENE || source->kind->type == OBS_SOURCE_TYPE_TRANSITION) {
+		struct obs_video_info ovi;
+		obs_get_video_info(&ovi);
+		return height ? ovi.base_height : ovi.base_width;
+	}
+
+	const char *settingName = height ? "height" : "width";
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	if (obs_data_has_user_value(source->settings, settingName) || obs_data_has_default_value(source->settings, settingName))
+		return (uint32_t)obs_data_get_int(source->settings, settingName);
+
+	return height ? source->kind->height : source->kind->width;
+}
+
+uint32_t obs_source_get_width(obs_source_t *source)
+{
+	return GetSourceSize(source, false);
+}
+
+uint32_t obs_source_get_height(obs_source_t *source)
+{
+	return GetSourceSize(source, true);
+}
+
+bool obs_source_active(const obs_source_t *source)
+{
+	return source && source->active;
+}
+
+bool obs_source_showing(const obs_source_t *source)
+{
+	return source && source->showing;
+}
+
+void obs_source_inc_showing(obs_source_t *source)
+{
+	if (!source)
+		return;
+
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		source->manualShowing++;
+	}
+
+	UpdateSourceStates();
+}
+
+void obs_source_dec_showing(obs_source_t *source)
+{
+	if (!source)
+		return;
+
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		if (source->manualShowing > 0)
+			source->manualShowing--;
+	}
+
+	UpdateSourceStates();
+}
+
+bool obs_source_enabled(const obs_source_t *source)
+{
+	return source && source->enabled;
+}
+
+void obs_source_set_enabled(obs_source_t *source, bool enabled)
+{
+	if (!source)
+		return;
+
+	source->enabled = enabled;
+
+	CallData cd;
+	calldata_set_ptr(cd, "source", source);
+	calldata_set_bool(cd, "enabled", enabled);
+	signal_handler_signal(source->signals, "enable", cd);
+}
+
+bool obs_source_muted(const obs_source_t *source)
+{
+	return source && source->muted;
+}
+
+void obs_source_set_muted(obs_source_t *source, bool muted)
+{
+	if (!source)
+		return;
+
+	source->muted = muted;
+
+	CallData cd;
+	calldata_set_ptr(cd, "source", source);
+	calldata_set_bool(cd, "muted", muted);
+	signal_handler_signal(source->signals, "mute", cd);
+}
+
+float obs_source_get_volume(const obs_source_t *source)
+{
+	return source ? source->volume : 0.0f;
+}
+
+// Like libobs, signal handlers may change the new volume and balance before they are applied
+void obs_source_set_volume(obs_source_t *source, float volume)
+{
+	if (!source)
+		return;
+
+	CallData cd;
+	calldata_set_ptr(cd, "source", source);
+	calldata_set_float(cd, "volume", volume);
+	signal_handler_signal(source->signals, "volume", cd);
+
+	source->volume = (float)calldata_float(cd, "volume");
+}
+
+float obs_source_get_balance_value(const obs_source_t *source)
+{
+	return source ? source->balance : 0.5f;
+}
+
+void obs_source_set_balance_value(obs_source_t *source, float balance)
+{
+	if (!source)
+		return;
+
+	CallData cd;
+	calldata_set_ptr(cd, "source", source);
+	calldata_set_float(cd, "balance", balance);
+	signal_handler_signal(source->signals, "audio_balance", cd);
+
+	source->balance = (float)calldata_float(cd, "balance");
+}
+
+int64_t obs_source_get_sync_offset(const obs_source_t *source)
+{
+	return source ? source->syncOffset : 0;
+}
+
+void obs_source_set_sync_offset(obs_source_t *source, int64_t offset)
+{
+	if (!source)
+		return;
+
+	source->syncOffset = offset;
+
+	CallData cd;
+	calldata_set_ptr(cd, "source", source);
+	calldata_set_int(cd, "offset", offset);
+	signal_handler_signal(source->signals, "audio_sync", cd);
+}
+
+uint32_t obs_source_get_audio_mixers(const obs_source_t *source)
+{
+	if (!source || !(source->kind->outputFlags & OBS_SOURCE_AUDIO))
+		return 0;
+
+	return source->audioMixers;
+}
+
+void obs_source_set_audio_mixers(obs_source_t *source, uint32_t mixers)
+{
+	if (!source || !(source->kind->outputFlags & OBS_SOURCE_AUDIO) || source->audioMixers == mixers)
+		return;
+
+	CallData cd;
+	calldata_set_ptr(cd, "source", source);
+	calldata_set_int(cd, "mixers", mixers);
+	signal_handler_signal(source->signals, "audio_mixers", cd);
+
+	source->audioMixers = (uint32_t)calldata_int(cd, "mixers");
+}
+
+enum obs_monitoring_type obs_source_get_monitoring_type(const obs_source_t *source)
+{
+	return source ? source->monitoringType : OBS_MONITORING_TYPE_NONE;
+}
+
+void obs_source_set_monitoring_type(obs_source_t *source, enum obs_monitoring_type type)
+{
+	if (!source || source->monitoringType == type)
+		return;
+
+	source->monitoringType = type;
+
+	CallData cd;
+	calldata_set_ptr(cd, "source", source);
+	calldata_set_int(cd, "type", type);
+	signal_handler_signal(source->signals, "audio_monitoring", cd);
+}
+
+signal_handler_t *obs_source_get_signal_handler(const obs_source_t *source)
+{
+	return source ? source->signals : nullptr;
+}
+
+proc_handler_t *obs_source_get_proc_handler(const obs_source_t *source)
+{
+	return source ? source->procs : nullptr;
+}
+
+void obs_source_add_audio_capture_callback(obs_source_t *source, obs_source_audio_capture_t callback, void *param)
+{
+	if (!source)
+		return;
+
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	source->audioCaptureCallbacks.emplace_back(callback, param);
+}
+
+void obs_source_remove_audio_capture_callback(obs_source_t *source, obs_source_audio_capture_t callback, void *param)
+{
+	if (!source)
+		return;
+
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	auto &callbacks = source->audioCaptureCallbacks;
+	auto it = std::find(callbacks.begin(), callbacks.end(), std::make_pair(callback, param));
+	if (it != callbacks.end())
+		callbacks.erase(it);
+}
+
+void obs_source_filter_add(obs_source_t *source, obs_source_t *filter)
+{
+	if (!source || !filter)
+		return;
+
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		if (filter->filterParent) {
+			blog(LOG_WARNING, "[MockObs] Tried to add filter '%s' which is already on a source", filter->name.c_str());
+			return;
+		}
+
+		filter->filterParent = source;
+		source->filters.push_back(obs_source_get_ref(filter));
+	}
+
+	CallData cd;
+	calldata_set_ptr(cd, "source", source);
+	calldata_set_ptr(cd, "filter", filter);
+	signal_handler_signal(source->signals, "filter_add", cd);
+
+	UpdateSourceStates();
+}
+
+void obs_source_filter_remove(obs_source_t *source, obs_source_t *filter)
+{
+	if (!source || !filter)
+		return;
+
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		auto it = std::find(source->filters.begin(), source->filters.end(), filter);
+		if (it == source->filters.end())
+			return;
+
+		source->filters.erase(it);
+		filter->filterParent = nullptr;
+	}
+
+	CallData cd;
+	calldata_set_ptr(cd, "source", source);
+	calldata_set_ptr(cd, "filter", filter);
+	signal_handler_signal(source->signals, "filter_remove", cd);
+
+	UpdateSourceStates();
+	obs_source_release(filter);
+}
+
+void obs_source_filter_set_order(obs_source_t *source, obs_source_t *filter, enum obs_order_movement movement)
+{
+	if (!source || !filter)
+		return;
+
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		auto &filters = source->filters;
+		auto it = std::find(filters.begin(), filters.end(), filter);
+		if (it == filters.end())
+			return;
+
+		size_t index = it - filters.begin();
+		size_t newIndex = index;
+		switch (movement) {
+		case OBS_ORDER_MOVE_UP:
+			newIndex = index > 0 ? index - 1 : 0;
+			break;
+		case OBS_ORDER_MOVE_DOWN:
+			newIndex = index + 1 < filters.size() ? index + 1 : index;
+			break;
+		case OBS_ORDER_MOVE_TOP:
+			newIndex = 0;
+			break;
+		case OBS_ORDER_MOVE_BOTTOM:
+			newIndex = filters.size() - 1;
+			break;
+		}
+
+		if (newIndex == index)
+			return;
+
+		filters.erase(it);
+		filters.insert(filters.begin() + newIndex, filter);
+	}
+
+	EmitSourceSignal(source, "reorder_filters");
+}
+
+obs_source_t *obs_source_get_filter_by_name(obs_source_t *source, const char *name)
+{
+	if (!source || !name)
+		return nullptr;
+
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	for (obs_source_t *filter : source->filters)
+		if (filter->name == name)
+			return obs_source_get_ref(filter);
+
+	return nullptr;
+}
+
+void obs_source_enum_filters(obs_source_t *source, obs_source_enum_proc_t callback, void *param)
+{
+	if (!source)
+		return;
+
+	std::vector<obs_source_t *> filters;
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		for (obs_source_t *filter : source->filters)
+			if (obs_source_get_ref(filter))
+				filters.push_back(filter);
+	}
+
+	for (obs_source_t *filter : filters) {
+		callback(source, filter, param);
+		obs_source_release(filter);
+	}
+}
+
+obs_source_t *obs_filter_get_parent(const obs_source_t *filter)
+{
+	return filter ? filter->filterParent : nullptr;
+}
+
+static bool IsMedia(const obs_source_t *source)
+{
+	return source && (source->kind->outputFlags & OBS_SOURCE_CONTROLLABLE_MEDIA);
+}
+
+// Requires the mutex
+static int64_t GetMediaTime(obs_source_t *source)
+{
+	if (source->mediaState != OBS_MEDIA_STATE_PLAYING)
+		return source->mediaTime;
+
+	int64_t time = (int64_t)((os_gettime_ns() - source->mediaStartedAt) / 1000000);
+	return std::min(time, source->kind->mediaDuration);
+}
+
+// Requires the mutex
+static void SetMediaPlaying(obs_source_t *source, int64_t time)
+{
+	source->mediaState = OBS_MEDIA_STATE_PLAYING;
+	source->mediaStartedAt = os_gettime_ns() - (uint64_t)time * 1000000;
+}
+
+void obs_source_media_play_pause(obs_source_t *source, bool pause)
+{
+	if (!IsMedia(source))
+		return;
+
+	bool started = false;
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		if (pause && source->mediaState == OBS_MEDIA_STATE_PLAYING) {
+			source->mediaTime = GetMediaTime(source);
+			source->mediaState = OBS_MEDIA_STATE_PAUSED;
+		} else if (!pause && source->mediaState != OBS_MEDIA_STATE_PLAYING) {
+			started = source->mediaState != OBS_MEDIA_STATE_PAUSED;
+			SetMediaPlaying(source, started ? 0 : source->mediaTime);
+		}
+	}
+
+	EmitSourceSignal(source, pause ? "media_pause" : "media_play");
+	if (started)
+		EmitSourceSignal(source, "media_started");
+}
+
+void obs_source_media_restart(obs_source_t *source)
+{
+	if (!IsMedia(source))
+		return;
+
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		SetMediaPlaying(source, 0);
+	}
+
+	EmitSourceSignal(source, "media_restart");
+	EmitSourceSignal(source, "media_started");
+}
+
+void obs_source_media_stop(obs_source_t *source)
+{
+	if (!IsMedia(source))
+		return;
+
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		source->mediaState = OBS_MEDIA_STATE_STOPPED;
+		source->mediaTime = 0;
+	}
+
+	EmitSourceSignal(source, "media_stopped");
+}
+
+// Mock media inputs play a single item, so next and previous restart it
+static void MediaSkip(obs_source_t *source, const char *signal)
+{
+	if (!IsMedia(source))
+		return;
+
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		if (source->mediaState == OBS_MEDIA_STATE_PLAYING)
+			SetMediaPlaying(source, 0);
+		else
+			source->mediaTime = 0;
+	}
+
+	EmitSourceSignal(source, signal);
+}
+
+void obs_source_media_next(obs_source_t *source)
+{
+	MediaSkip(source, "media_next");
+}
+
+void obs_source_media_previous(obs_source_t *source)
+{
+	MediaSkip(source, "media_previous");
+}
+
+int64_t obs_source_media_get_duration(obs_source_t *source)
+{
+	return IsMedia(source) ? source->kind->mediaDuration : 0;
+}
+
+int64_t obs_source_media_get_time(obs_source_t *source)
+{
+	if (!IsMedia(source))
+		return 0;
+
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	return GetMediaTime(source);
+}
+
+void obs_source_media_set_time(obs_source_t *source, int64_t ms)
+{
+	if (!IsMedia(source))
+		return;
+
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	ms = std::clamp<int64_t>(ms, 0, source->kind->mediaDuration);
+	if (source->mediaState == OBS_MEDIA_STATE_PLAYING)
+		SetMediaPlaying(source, ms);
+	else
+		source->mediaTime = ms;
+}
+
+enum obs_media_state obs_source_media_get_state(obs_source_t *source)
+{
+	return IsMedia(source) ? source->mediaState : OBS_MEDIA_STATE_NONE;
+}
+
+void MockObs::Internal::TickSources()
+{
+	std::vector<obs_source_t *> ended;
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		for (obs_source_t *source : sources) {
+			if (!IsMedia(source) || source->mediaState != OBS_MEDIA_STATE_PLAYING)
+				continue;
+
+			if (GetMediaTime(source) < source->kind->mediaDuration)
+				continue;
+
+			if (obs_data_get_bool(source->settings, "looping")) {
+				SetMediaPlaying(source, 0);
+				continue;
+			}
+
+			source->mediaState = OBS_MEDIA_STATE_ENDED;
+			source->mediaTime = source->kind->mediaDuration;
+			if (obs_source_get_ref(source))
+				ended.push_back(source);
+		}
+	}
+
+	for (obs_source_t *source : ended) {
+		EmitSourceSignal(source, "media_ended");
+		obs_source_release(source);
+	}
+}
+
+void obs_source_video_render(obs_source_t *) {}
+
+bool obs_source_is_group(const obs_source_t *source)
+{
+	return source && source->kind->id == "group";
+}
+
+bool obs_transition_fixed(obs_source_t *transition)
+{
+	return transition && transition->kind->fixedTransition;
+}
+
+// Mock transitions complete instantly
+float obs_transition_get_time(obs_source_t *)
+{
+	return 1.0f;
+}
+
+// Requires the mutex
+static void CollectVisibleSources(obs_source_t *source, std::set<obs_source_t *> &out)
+{
+	if (!source || !out.insert(source).second)
+		return;
+
+	for (obs_source_t *filter : source->filters)
+		if (filter->enabled)
+			out.insert(filter);
+
+	if (!source->scene)
+		return;
+
+	for (obs_sceneitem_t *item : source->scene->items)
+		if (item->visible && !item->removed)
+			CollectVisibleSources(item->source, out);
+}
+
+void MockObs::Internal::UpdateSourceStates()
+{
+	struct StateChange {
+		obs_source_t *source;
+		const char *signal;
+		bool mediaStarted;
+	};
+	std::vector<StateChange> changes;
+
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+
+		std::set<obs_source_t *> active;
+		CollectVisibleSources(GetProgramScene(), active);
+		for (obs_source_t *source : outputChannels)
+			CollectVisibleSources(source, active);
+
+		std::set<obs_source_t *> showing = active;
+		CollectVisibleSources(GetPreviewScene(), showing);
+		for (obs_source_t *source : sources)
+			if (source->manualShowing > 0)
+				CollectVisibleSources(source, showing);
+
+		for (obs_source_t *source : sources) {
+			bool isActive = active.count(source) > 0;
+			bool isShowing = showing.count(source) > 0;
+			if (isActive == source->active && isShowing == source->showing)
+				continue;
+
+			if (!obs_source_get_ref(source))
+				continue;
+			// Each change holds its own reference
+			if (isActive != source->active && isShowing != source->showing)
+				obs_source_get_ref(source);
+
+			bool mediaStarted = false;
+			if (isActive != source->active) {
+				source->active = isActive;
+				if (isActive && IsMedia(source) && source->mediaState != OBS_MEDIA_STATE_PLAYING &&
+				    source->mediaState != OBS_MEDIA_STATE_PAUSED) {
+					SetMediaPlaying(source, 0);
+					mediaStarted = true;
+				}
+				changes.push_back({source, isActive ? "activate" : "deactivate", mediaStarted});
+			}
+			if (isShowing != source->showing) {
+				source->showing = isShowing;
+				changes.push_back({source, isShowing ? "show" : "hide", false});
+			}
+		}
+	}
+
+	for (auto &change : changes) {
+		EmitSourceSignal(change.source, change.signal, true);
+		if (change.mediaStarted)
+			EmitSourceSignal(change.source, "media_started");
+		obs_source_release(change.source);
+	}
+}
+
+void MockObs::Internal::SendAudio(uint32_t frames, uint64_t timestamp)
+{
+	struct AudioBlock {
+		obs_source_t *source;
+		std::vector<std::pair<obs_source_audio_capture_t, void *>> callbacks;
+		std::vector<float> samples;
+		bool muted;
+	};
+	std::vector<AudioBlock> blocks;
+
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		for (obs_source_t *source : sources) {
+			if (source->kind->type != OBS_SOURCE_TYPE_INPUT || !(source->kind->outputFlags & OBS_SOURCE_AUDIO))
+				continue;
+			if (!source->active || !source->enabled || source->audioCaptureCallbacks.empty())
+				continue;
+			if (!obs_source_get_ref(source))
+				continue;
+
+			// Planar stereo sine wave, continuous across blocks
+			AudioBlock block{source, source->audioCaptureCallbacks, std::vector<float>(frames * 2), source->muted};
+			double step = 2.0 * M_PI * TONE_FREQUENCY / SAMPLE_RATE;
+			for (uint32_t i = 0; i < frames; i++) {
+				float sample = (float)(0.5 * source->volume * sin(source->audioPhase));
+				block.samples[i] = sample * std::min(1.0f, 2.0f * (1.0f - source->balance));
+				block.samples[frames + i] = sample * std::min(1.0f, 2.0f * source->balance);
+				source->audioPhase = fmod(source->audioPhase + step, 2.0 * M_PI);
+			}
+
+			blocks.push_back(std::move(block));
+		}
+	}
+
+	for (auto &block : blocks) {
+		struct audio_data data = {};
+		data.data[0] = (uint8_t *)block.samples.data();
+		data.data[1] = (uint8_t *)(block.samples.data() + frames);
+		data.frames = frames;
+		data.timestamp = timestamp;
+
+		for (auto &callback : block.callbacks)
+			callback.first(callback.second, block.source, &data, block.muted);
+
+		obs_source_release(block.source);
+	}
+}
+
+void MockObs::SendInputAudio(obs_source_t *input, const struct audio_data *data)
+{
+	std::vector<std::pair<obs_source_audio_capture_t, void *>> callbacks;
+	bool muted;
+	{
+		std::lock_guard<std::recursive_mutex> lock(GetMutex());
+		callbacks = input->audioCaptureCallbacks;
+		muted = input->muted;
+	}
+
+	for (auto &callback : callbacks)
+		callback.first(callback.second, input, data, muted);
+}
+
+void MockObs::Internal::InitializeSources()
+{
+	obs_source_t *desktopAudio = obs_source_create("pulse_output_capture", "Desktop Audio", nullptr, nullptr);
+	obs_set_output_source(1, desktopAudio);
+	obs_source_release(desktopAudio);
+
+	obs_source_t *micAudio = obs_source_create("pulse_input_capture", "Mic/Aux", nullptr, nullptr);
+	obs_set_output_source(3, micAudio);
+	obs_source_release(micAudio);
+}
+
+void MockObs::Internal::ShutdownSources()
+{
+	for (uint32_t channel = 0; channel < MAX_CHANNELS; channel++)
+		obs_set_output_source(channel, nullptr);
+
+	std::lock_guard<std::recursive_mutex> lock(GetMutex());
+	if (!sources.empty())
+		blog(LOG_WARNING, "[MockObs] %zu sources are still referenced at shutdown", sources.size());
+}
@@ -0,0 +1,122 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <atomic>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <QApplication>
+#include <QTimer>
+
+#include "../mock-obs/MockObs.h"
+#include "../mock-obs/HeadlessPlugin.h"
+#include "../../src/websocketserver/WebSocketServer.h"
+
+struct Options {
+	std::string configDirectory = "/tmp/obs-websocket-mock";
+	size_t scenes = 10;
+	size_t inputsPerScene = 10;
+	size_t filtersPerInput = 1;
+	bool clock = true;
+};
+
+static std::atomic<bool> interrupted = false;
+
+// Options of the plugin (`--websocket_port`, `--websocket_password`, ...) are left to the plugin, which reads them from
+// QCoreApplication::arguments() like in OBS
+static bool ParseOptions(int argc, char **argv, Options &options)
+{
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg.rfind("--websocket_", 0) == 0) {
+			if (i + 1 < argc && std::string(argv[i + 1]).rfind("--", 0) != 0)
+				i++;
+			continue;
+		}
+
+		if (arg == "--no-clock") {
+			options.clock = false;
+			continue;
+		}
+
+		if (i + 1 >= argc)
+			return false;
+
+		std::string value = argv[++i];
+		if (arg == "--config-dir")
+			options.configDirectory = value;
+		else if (arg == "--scenes")
+			options.scenes = std::strtoul(value.c_str(), nullptr, 10);
+		else if (arg == "--inputs")
+			options.inputsPerScene = std::strtoul(value.c_str(), nullptr, 10);
+		else if (arg == "--filters")
+			options.filtersPerInput = std::strtoul(value.c_str(), nullptr, 10);
+		else
+			return false;
+	}
+
+	return !options.configDirectory.empty();
+}
+
+int main(int argc, char **argv)
+{
+	Options options;
+	if (!ParseOptions(argc, argv, options)) {
+		std::cerr << "Invalid options. See tools/README.md for the usage." << std::endl;
+		return 1;
+	}
+
+	// There is no display to show anything on
+	if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+		qputenv("QT_QPA_PLATFORM", "offscreen");
+	QApplication app(argc, argv);
+
+	MockObs::Settings settings;
+	settings.configDirectory = options.configDirectory;
+	MockObs::Initialize(settings);
+
+	if (!HeadlessPlugin::Load()) {
+		MockObs::Shutdown();
+		return 1;
+	}
+
+	MockObs::CreateSceneCollection(options.scenes, options.inputsPerScene, options.filtersPerInput);
+	if (options.clock)
+		MockObs::StartClock();
+
+	GetWebSocketServer()->Start();
+	MockObs::FinishLoading();
+
+	std::signal(SIGINT, [](int) { interrupted = true; });
+	std::signal(SIGTERM, [](int) { interrupted = true; });
+	QTimer interruptTimer;
+	QObject::connect(&interruptTimer, &QTimer::timeout, [&app]() {
+		if (interrupted)
+			app.quit();
+	});
+	interruptTimer.start(100);
+
+	int ret = app.exec();
+
+	MockObs::EmitFrontendEvent(OBS_FRONTEND_EVENT_EXIT);
+	HeadlessPlugin::Unload();
+	MockObs::Shutdown();
+
+	return ret;
+}
@@ -0,0 +1,438 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+// Replays the sessions of a traffic capture (made with `--websocket_capture`) against an obs-websocket server, then reports
+// the latency of the requests and the throughput.
+//
+// Usage: obs-websocket-replay <capture.jsonl> [--url ws://127.0.0.1:4455] [--password <password>] [--speed <factor>]
+//
+// Every captured session is replayed as its own connection, with the inbound messages at their captured times divided by
+// the speed factor. A speed of 0 sends every message as soon as possible. Sessions identify with the `Identify` data of the
+// capture, authenticating with the given password. Messages are always sent as JSON.
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include <websocketpp/client.hpp>
+#include <websocketpp/config/asio_no_tls_client.hpp>
+
+#include "../common/ToolUtils.h"
+
+using json = nlohmann::json;
+typedef websocketpp::client<websocketpp::config::asio_client> Client;
+typedef std::chrono::steady_clock Clock;
+
+// Time given to outstanding responses after the last message has been sent
+static const auto ResponseTimeout = std::chrono::seconds(30);
+
+struct Options {
+	std::string capturePath;
+	std::string url = "ws://127.0.0.1:4455";
+	std::string password;
+	double speed = 1.0;
+};
+
+struct CapturedMessage {
+	uint64_t time; // Microseconds since the capture was started
+	json message;
+};
+
+struct ReplaySession {
+	uint64_t id;
+	json identifyData = json::object();
+	std::vector<CapturedMessage> messages;
+	size_t nextMessage = 0;
+
+	websocketpp::connection_hdl hdl;
+	bool finished = false;
+	std::unordered_map<std::string, Clock::time_point> pendingRequests; // By dumped `requestId`
+};
+
+typedef std::shared_ptr<ReplaySession> ReplaySessionPtr;
+
+class Replay {
+public:
+	Replay(const Options &options, std::vector<ReplaySessionPtr> &&sessions);
+	bool Run();
+
+private:
+	void Connect(ReplaySessionPtr session);
+	void OnMessage(ReplaySessionPtr session, const json &message);
+	void ScheduleNext(ReplaySessionPtr session);
+	void Send(ReplaySessionPtr session, const json &message);
+	void CheckFinished(ReplaySessionPtr session);
+	void Finish(ReplaySessionPtr session, bool failed);
+	Clock::time_point GetDueTime(const CapturedMessage &message);
+	void PrintReport();
+
+	Options _options;
+	std::vector<ReplaySessionPtr> _sessions;
+	Client _client;
+	Client::timer_ptr _timeoutTimer;
+
+	uint64_t _firstMessageTime = 0;
+	uint64_t _lastMessageTime = 0;
+	Clock::time_point _startedAt;
+	Clock::time_point _lastResponseAt;
+
+	size_t _finishedSessions = 0;
+	size_t _failedSessions = 0;
+	size_t _sentMessages = 0;
+	size_t _failedRequests = 0;
+	size_t _unansweredRequests = 0;
+	std::vector<double> _latencies; // Milliseconds
+};
+
+static bool IsSuccessfulResult(const json &result)
+{
+	return result.contains("requestStatus") && result["requestStatus"].value("result", false);
+}
+
+static bool LoadCapture(const std::string &capturePath, std::vector<ReplaySessionPtr> &sessions)
+{
+	std::ifstream file(capturePath);
+	if (!file) {
+		std::cerr << "Unable to open " << capturePath << std::endl;
+		return false;
+	}
+
+	std::map<uint64_t, ReplaySessionPtr> sessionsById;
+	std::string line;
+	size_t lineNumber = 0;
+	while (std::getline(file, line)) {
+		lineNumber++;
+		json entry = json::parse(line, nullptr, false);
+		if (!entry.is_object()) {
+			std::cerr << "Skipping line " << lineNumber << ", which is not a JSON object." << std::endl;
+			continue;
+		}
+
+		if (entry.contains("captureVersion")) {
+			if (entry["captureVersion"] != 1) {
+				std::cerr << "Unsupported capture version " << entry["captureVersion"] << std::endl;
+				return false;
+			}
+			continue;
+		}
+
+		if (entry.value("kind", "") != "inbound" || !entry["message"].is_object())
+			continue;
+
+		uint64_t sessionId = entry["session"];
+		auto &session = sessionsById[sessionId];
+		if (!session) {
+			session = std::make_shared<ReplaySession>();
+			session->id = sessionId;
+		}
+
+		// Identification is redone against the server being replayed to
+		const json &message = entry["message"];
+		if (message.value("op", -1) == 1) {
+			if (message["d"].is_object())
+				session->identifyData = message["d"];
+			continue;
+		}
+
+		session->messages.push_back({entry["time"].get<uint64_t>(), message});
+	}
+
+	for (auto &it : sessionsById)
+		sessions.push_back(it.second);
+
+	return true;
+}
+
+Replay::Replay(const Options &options, std::vector<ReplaySessionPtr> &&sessions)
+	: _options(options),
+	  _sessions(std::move(sessions))
+{
+	bool first = true;
+	for (auto &session : _sessions) {
+		if (session->messages.empty())
+			continue;
+
+		uint64_t sessionFirst = session->messages.front().time;
+		uint64_t sessionLast = session->messages.back().time;
+		_firstMessageTime = first ? sessionFirst : std::min(_firstMessageTime, sessionFirst);
+		_lastMessageTime = std::max(_lastMessageTime, sessionLast);
+		first = false;
+	}
+
+	_client.clear_access_channels(websocketpp::log::alevel::all);
+	_client.clear_error_channels(websocketpp::log::elevel::all);
+	_client.init_asio();
+}
+
+bool Replay::Run()
+{
+	_startedAt = _lastResponseAt = Clock::now();
+	for (auto &session : _sessions)
+		Connect(session);
+
+	auto replayDuration = GetDueTime({_lastMessageTime, nullptr}) - _startedAt + ResponseTimeout;
+	_timeoutTimer = _client.set_timer((long)std::chrono::duration_cast<std::chrono::milliseconds>(replayDuration).count(),
+					  [this](const websocketpp::lib::error_code &errorCode) {
+						  if (errorCode)
+							  return;
+
+						  std::cerr << "Timed out waiting for responses." << std::endl;
+						  for (auto &session : _sessions) {
+							  _unansweredRequests += session->pendingRequests.size();
+							  if (!session->finished)
+								  Finish(session, true);
+						  }
+					  });
+
+	_client.run();
+
+	PrintReport();
+	return !_failedSessions;
+}
+
+void Replay::Connect(ReplaySessionPtr session)
+{
+	websocketpp::lib::error_code errorCode;
+	Client::connection_ptr connection = _client.get_connection(_options.url, errorCode);
+	if (errorCode) {
+		std::cerr << "Unable to connect to " << _options.url << ": " << errorCode.message() << std::endl;
+		Finish(session, true);
+		return;
+	}
+
+	connection->add_subprotocol("obswebsocket.json");
+	connection->set_message_handler([this, session](websocketpp::connection_hdl, Client::message_ptr message) {
+		json messageJson = json::parse(message->get_payload(), nullptr, false);
+		if (messageJson.is_object())
+			OnMessage(session, messageJson);
+	});
+	connection->set_fail_handler([this, session](websocketpp::connection_hdl hdl) {
+		auto connection = _client.get_con_from_hdl(hdl);
+		std::cerr << "Session " << session->id << " failed to connect: " << connection->get_ec().message() << std::endl;
+		Finish(session, true);
+	});
+	connection->set_close_handler([this, session](websocketpp::connection_hdl hdl) {
+		if (session->finished)
+			return;
+
+		auto connection = _client.get_con_from_hdl(hdl);
+		std::cerr << "Session " << session->id << " was closed by the server (" << connection->get_remote_close_code()
+			  << "): " << connection->get_remote_close_reason() << std::endl;
+		session->hdl.reset();
+		Finish(session, true);
+	});
+
+	session->hdl = connection->get_handle();
+	_client.connect(connection);
+}
+
+void Replay::OnMessage(ReplaySessionPtr session, const json &message)
+{
+	int opCode = message.value("op", -1);
+	const json &data = message.contains("d") ? message["d"] : json::object();
+
+	switch (opCode) {
+	case 0: { // Hello
+		json identify;
+		identify["op"] = 1;
+		identify["d"] = session->identifyData;
+		identify["d"]["rpcVersion"] = data.value("rpcVersion", 1);
+		if (data.contains("authentication")) {
+			if (_options.password.empty()) {
+				std::cerr << "The server requires authentication, but no --password was given." << std::endl;
+				Finish(session, true);
+				return;
+			}
+
+			identify["d"]["authentication"] = ToolUtils::GenerateAuthenticationString(
+				_options.password, data["authentication"]["salt"], data["authentication"]["challenge"]);
+		}
+		Send(session, identify);
+		break;
+	}
+	case 2: // Identified
+		ScheduleNext(session);
+		break;
+	case 7:   // RequestResponse
+	case 9: { // RequestBatchResponse
+		// Only the final part of a streamed response counts
+		if (data.contains("responseChunk") || !data.contains("requestId"))
+			break;
+
+		auto it = session->pendingRequests.find(data["requestId"].dump());
+		if (it == session->pendingRequests.end())
+			break;
+
+		_lastResponseAt = Clock::now();
+		_latencies.push_back(std::chrono::duration<double, std::milli>(_lastResponseAt - it->second).count());
+		session->pendingRequests.erase(it);
+
+		if (opCode == 7 && !IsSuccessfulResult(data))
+			_failedRequests++;
+		if (opCode == 9 && data.contains("results")) {
+			for (auto &result : data["results"])
+				if (!IsSuccessfulResult(result))
+					_failedRequests++;
+		}
+
+		CheckFinished(session);
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+void Replay::ScheduleNext(ReplaySessionPtr session)
+{
+	// Sends every message which is due, then waits for the next one
+	while (!session->finished && session->nextMessage < session->messages.size()) {
+		auto dueTime = GetDueTime(session->messages[session->nextMessage]);
+		auto now = Clock::now();
+		if (dueTime > now) {
+			auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(dueTime - now).count();
+			_client.set_timer((long)delay, [this, session](const websocketpp::lib::error_code &errorCode) {
+				if (!errorCode)
+					ScheduleNext(session);
+			});
+			return;
+		}
+
+		Send(session, session->messages[session->nextMessage++].message);
+	}
+
+	CheckFinished(session);
+}
+
+void Replay::Send(ReplaySessionPtr session, const json &message)
+{
+	int opCode = message.value("op", -1);
+	if ((opCode == 6 || opCode == 8) && message["d"].is_object() && message["d"].contains("requestId"))
+		session->pendingRequests[message["d"]["requestId"].dump()] = Clock::now();
+
+	websocketpp::lib::error_code errorCode;
+	_client.send(session->hdl, message.dump(), websocketpp::frame::opcode::text, errorCode);
+	if (errorCode) {
+		std::cerr << "Session " << session->id << " failed to send: " << errorCode.message() << std::endl;
+		Finish(session, true);
+		return;
+	}
+
+	if (opCode != 1)
+		_sentMessages++;
+}
+
+void Replay::CheckFinished(ReplaySessionPtr session)
+{
+	if (!session->finished && session->nextMessage == session->messages.size() && session->pendingRequests.empty())
+		Finish(session, false);
+}
+
+void Replay::Finish(ReplaySessionPtr session, bool failed)
+{
+	if (session->finished)
+		return;
+
+	session->finished = true;
+	_finishedSessions++;
+	if (failed)
+		_failedSessions++;
+
+	if (!session->hdl.expired()) {
+		websocketpp::lib::error_code errorCode;
+		_client.close(session->hdl, websocketpp::close::status::normal, "Replay finished.", errorCode);
+	}
+
+	// Lets `run()` return once the connections are closed
+	if (_finishedSessions == _sessions.size() && _timeoutTimer)
+		_timeoutTimer->cancel();
+}
+
+Clock::time_point Replay::GetDueTime(const CapturedMessage &message)
+{
+	if (_options.speed <= 0)
+		return _startedAt;
+
+	auto offset = std::chrono::microseconds((int64_t)((message.time - _firstMessageTime) / _options.speed));
+	return _startedAt + offset;
+}
+
+void Replay::PrintReport()
+{
+	std::sort(_latencies.begin(), _latencies.end());
+	double elapsed = std::chrono::duration<double>(_lastResponseAt - _startedAt).count();
+
+	std::cout << "Sessions:             " << _sessions.size() << " (" << _failedSessions << " failed)" << std::endl;
+	std::cout << "Messages sent:        " << _sentMessages << std::endl;
+	std::cout << "Responses:            " << _latencies.size() << " (" << _failedRequests << " failed requests, "
+		  << _unansweredRequests << " unanswered)" << std::endl;
+	std::cout << "Duration:             " << elapsed << " s" << std::endl;
+	std::cout << "Throughput:           " << (elapsed > 0 ? _latencies.size() / elapsed : 0) << " responses/s" << std::endl;
+	std::cout << "Latency p50:          " << ToolUtils::GetPercentile(_latencies, 50) << " ms" << std::endl;
+	std::cout << "Latency p90:          " << ToolUtils::GetPercentile(_latencies, 90) << " ms" << std::endl;
+	std::cout << "Latency p99:          " << ToolUtils::GetPercentile(_latencies, 99) << " ms" << std::endl;
+	std::cout << "Latency p99.9:        " << ToolUtils::GetPercentile(_latencies, 99.9) << " ms" << std::endl;
+	std::cout << "Latency max:          " << (_latencies.empty() ? 0 : _latencies.back()) << " ms" << std::endl;
+}
+
+static bool ParseOptions(int argc, char **argv, Options &options)
+{
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--url" && hasValue)
+			options.url = argv[++i];
+		else if (arg == "--password" && hasValue)
+			options.password = argv[++i];
+		else if (arg == "--speed" && hasValue)
+			options.speed = std::atof(argv[++i]);
+		else if (options.capturePath.empty() && arg.rfind("--", 0) != 0)
+			options.capturePath = arg;
+		else
+			return false;
+	}
+
+	return !options.capturePath.empty() && options.speed >= 0;
+}
+
+int main(int argc, char **argv)
+{
+	Options options;
+	if (!ParseOptions(argc, argv, options)) {
+		std::cerr << "Usage: " << argv[0]
+			  << " <capture.jsonl> [--url ws://127.0.0.1:4455] [--password <password>] [--speed <factor>]" << std::endl;
+		return 1;
+	}
+
+	std::vector<ReplaySessionPtr> sessions;
+	if (!LoadCapture(options.capturePath, sessions))
+		return 1;
+
+	if (sessions.empty()) {
+		std::cerr << "The capture does not contain any sessions." << std::endl;
+		return 1;
+	}
+
+	Replay replay(options, std::move(sessions));
+	return replay.Run() ? 0 : 1;
+}
@@ -0,0 +1,68 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+// A minimal test harness for behavior which needs the plugin running on top of the mock OBS. A failed check is reported
+// and fails the test, but does not stop it.
+namespace Test {
+	class Context {
+	public:
+		bool Check(bool condition, const char *expression, const char *file, int line)
+		{
+			if (!condition)
+				_failures.push_back(std::string(file) + ":" + std::to_string(line) + ": " + expression);
+			return condition;
+		}
+
+		bool Failed() const { return !_failures.empty(); }
+		const std::vector<std::string> &Failures() const { return _failures; }
+
+	private:
+		std::vector<std::string> _failures;
+	};
+
+	typedef std::function<void(Context &)> Function;
+
+	struct Registration {
+		std::string name;
+		Function function;
+	};
+
+	inline std::vector<Registration> &GetRegistrations()
+	{
+		static std::vector<Registration> registrations;
+		return registrations;
+	}
+
+	inline bool Register(const std::string &name, Function function)
+	{
+		GetRegistrations().push_back({name, function});
+		return true;
+	}
+}
+
+#define TEST_CONCAT_INNER(a, b) a##b
+#define TEST_CONCAT(a, b) TEST_CONCAT_INNER(a, b)
+// Variadic, so that braced initializers with commas can be used in the test function
+#define TEST(name, ...) static bool TEST_CONCAT(_testRegistered, __LINE__) = Test::Register(name, __VA_ARGS__)
+#define CHECK(context, condition) (context).Check((condition), #condition, __FILE__, __LINE__)
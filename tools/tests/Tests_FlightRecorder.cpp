@@ -0,0 +1,53 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <fstream>
+#include <sstream>
+
+#include "Test.h"
+#include "../../src/utils/FlightRecorder.h"
+
+#define TEST_STREAM_KEY "obs-websocket-test-stream-key"
+#define TEST_RECORDING_PATH "/tmp/obs-websocket-tests/flight_recorder.bin"
+
+// A `PrepareRequestBatch` request record, as `WebSocketServer` writes it. Strings are stored as they are in MessagePack,
+// so a stream key which was written can be found in the raw file.
+TEST("FlightRecorder/RedactsPrepareRequestBatch", [](Test::Context &context) {
+	CHECK(context, Utils::FlightRecorder::Start(TEST_RECORDING_PATH, 1024 * 1024));
+
+	json requests = json::array({
+		{{"requestType", "SetStreamServiceSettings"},
+		 {"requestData",
+		  {{"streamServiceType", "rtmp_custom"},
+		   {"streamServiceSettings", {{"server", "rtmp://127.0.0.1/live"}, {"key", TEST_STREAM_KEY}}}}}},
+	});
+	json record = {{"remoteAddress", "127.0.0.1:0"},
+		       {"requestType", "PrepareRequestBatch"},
+		       {"requestId", "prepare"},
+		       {"requestData", {{"preparedBatchId", "redaction"}, {"requests", requests}}}};
+	Utils::Json::RedactSecrets(record);
+	Utils::FlightRecorder::Record(FlightRecorderFormat::Request, record);
+
+	Utils::FlightRecorder::Stop();
+
+	std::ifstream file(TEST_RECORDING_PATH, std::ios::binary);
+	std::stringstream content;
+	content << file.rdbuf();
+	CHECK(context, content.str().find("PrepareRequestBatch") != std::string::npos);
+	CHECK(context, content.str().find(TEST_STREAM_KEY) == std::string::npos);
+});
@@ -0,0 +1,142 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <chrono>
+#include <future>
+
+#include "Test.h"
+#include "../mock-obs/MockObs.h"
+#include "../../src/obs-websocket.h"
+#include "../../src/requesthandler/RequestBatchHandler.h"
+#include "../../src/requesthandler/RequestHandler.h"
+#include "../../src/websocketserver/WebSocketServer.h"
+
+#define TEST_SCENE_NAME "Test Scene"
+#define TEST_INPUT_NAME "Test Input"
+
+struct BatchResponse {
+	std::vector<RequestResult> results;
+	json statistics;
+};
+
+// Runs a batch like `WebSocketServer` does, and waits for its response
+static bool RunRequestBatch(RequestBatchExecutionType::RequestBatchExecutionType executionType, const json &requests,
+			    BatchResponse &response)
+{
+	std::vector<RequestBatchRequest> requestsVector;
+	for (auto &requestJson : requests)
+		requestsVector.emplace_back(requestJson["requestType"], requestJson.value("requestData", json()), executionType);
+
+	std::promise<BatchResponse> finished;
+	RequestBatchHandler::ProcessRequestBatch(GetWebSocketServer()->GetBatchScheduler(), nullptr, executionType,
+						 std::move(requestsVector), nullptr, false,
+						 [&finished](std::vector<RequestResult> &&results, size_t, json &&statistics,
+							     uint64_t) { finished.set_value({std::move(results), std::move(statistics)}); });
+
+	auto future = finished.get_future();
+	if (future.wait_for(std::chrono::seconds(5)) != std::future_status::ready)
+		return false;
+
+	response = future.get();
+	return true;
+}
+
+// A failed request discards the changes of the whole batch, so the requests before it may not report success either
+TEST("RequestBatch/FrameAtomicFailureAppliesNothing", [](Test::Context &context) {
+	OBSSourceAutoRelease scene = MockObs::CreateScene(TEST_SCENE_NAME);
+	OBSSourceAutoRelease input = MockObs::CreateInput(scene, TEST_INPUT_NAME, "color_source_v3");
+
+	RequestHandler requestHandler;
+	RequestResult idResult = requestHandler.ProcessRequest(
+		Request("GetSceneItemId", json{{"sceneName", TEST_SCENE_NAME}, {"sourceName", TEST_INPUT_NAME}}));
+	if (!CHECK(context, idResult.Succeeded()))
+		return;
+	int64_t sceneItemId = idResult.ResponseData["sceneItemId"];
+
+	json requests = json::array({
+		{{"requestType", "SetSceneItemEnabled"},
+		 {"requestData", {{"sceneName", TEST_SCENE_NAME}, {"sceneItemId", sceneItemId}, {"sceneItemEnabled", false}}}},
+		{{"requestType", "SetSceneItemEnabled"},
+		 {"requestData", {{"sceneName", TEST_SCENE_NAME}, {"sceneItemId", -1}, {"sceneItemEnabled", false}}}},
+	});
+
+	BatchResponse response;
+	if (!CHECK(context, RunRequestBatch(RequestBatchExecutionType::FrameAtomic, requests, response)))
+		return;
+
+	CHECK(context, response.results.size() == 2);
+	CHECK(context, response.statistics["applied"] == false);
+	for (auto &result : response.results)
+		CHECK(context, !result.Succeeded());
+	if (response.results.size() == 2) {
+		CHECK(context, response.results[0].StatusCode == RequestStatus::CannotAct);
+		CHECK(context, response.results[0].Comment.find("index 1") != std::string::npos);
+	}
+
+	RequestResult enabledResult = requestHandler.ProcessRequest(
+		Request("GetSceneItemEnabled", json{{"sceneName", TEST_SCENE_NAME}, {"sceneItemId", sceneItemId}}));
+	CHECK(context, enabledResult.Succeeded() && enabledResult.ResponseData["sceneItemEnabled"] == true);
+
+	requestHandler.ProcessRequest(Request("RemoveScene", json{{"sceneName", TEST_SCENE_NAME}}));
+});
+
+// The changes of a scheduled `FrameAtomic` batch are applied within the tick of its cue
+TEST("RequestBatch/ScheduledFrameAtomicAppliesOnCue", [](Test::Context &context) {
+	OBSSourceAutoRelease scene = MockObs::CreateScene(TEST_SCENE_NAME);
+	OBSSourceAutoRelease input = MockObs::CreateInput(scene, TEST_INPUT_NAME, "color_source_v3");
+
+	RequestHandler requestHandler;
+	RequestResult idResult = requestHandler.ProcessRequest(
+		Request("GetSceneItemId", json{{"sceneName", TEST_SCENE_NAME}, {"sourceName", TEST_INPUT_NAME}}));
+	if (!CHECK(context, idResult.Succeeded()))
+		return;
+	int64_t sceneItemId = idResult.ResponseData["sceneItemId"];
+
+	std::vector<RequestBatchRequest> requests;
+	requests.emplace_back("SetSceneItemEnabled",
+			      json{{"sceneName", TEST_SCENE_NAME}, {"sceneItemId", sceneItemId}, {"sceneItemEnabled", false}},
+			      RequestBatchExecutionType::FrameAtomic);
+
+	RequestBatchHandler::Schedule schedule;
+	schedule.cue = RequestBatchHandler::Schedule::Frame;
+	schedule.frame = obs_get_total_frames() + 2;
+
+	std::promise<BatchResponse> finished;
+	auto callback = [&finished](std::vector<RequestResult> &&results, size_t, json &&statistics, uint64_t) {
+		finished.set_value({std::move(results), std::move(statistics)});
+	};
+	RequestBatchHandler::ScheduleRequestBatch(GetWebSocketServer()->GetBatchScheduler(), std::make_shared<WebSocketSession>(),
+						  "scheduled", std::move(schedule), RequestBatchExecutionType::FrameAtomic,
+						  std::move(requests), nullptr, false, callback);
+
+	auto future = finished.get_future();
+	if (!CHECK(context, future.wait_for(std::chrono::seconds(5)) == std::future_status::ready))
+		return;
+
+	BatchResponse response = future.get();
+	CHECK(context, response.results.size() == 1 && response.results[0].Succeeded());
+	CHECK(context, response.statistics["applied"] == true);
+	CHECK(context, response.statistics["cancelled"] == false);
+	CHECK(context, response.statistics["appliedFrame"] == response.statistics["frame"]);
+
+	RequestResult enabledResult = requestHandler.ProcessRequest(
+		Request("GetSceneItemEnabled", json{{"sceneName", TEST_SCENE_NAME}, {"sceneItemId", sceneItemId}}));
+	CHECK(context, enabledResult.Succeeded() && enabledResult.ResponseData["sceneItemEnabled"] == false);
+
+	requestHandler.ProcessRequest(Request("RemoveScene", json{{"sceneName", TEST_SCENE_NAME}}));
+});
@@ -0,0 +1,33 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include "Test.h"
+#include "../../src/requesthandler/RequestHandler.h"
+
+// A misspelled field would otherwise silently be left out of every item
+TEST("RequestHandler/FieldSelectorRejectsUnknownField", [](Test::Context &context) {
+	RequestHandler requestHandler;
+
+	RequestResult result = requestHandler.ProcessRequest(
+		Request("GetSceneList", json{{"fields", json::array({"sceneIndex", "sceneIdx"})}}));
+	CHECK(context, result.StatusCode == RequestStatus::InvalidRequestField);
+	CHECK(context, result.Comment.find("`sceneIdx`") != std::string::npos);
+
+	result = requestHandler.ProcessRequest(Request("GetSceneList", json{{"fields", json::array({"sceneIndex"})}}));
+	CHECK(context, result.Succeeded());
+});
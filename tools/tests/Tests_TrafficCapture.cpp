@@ -0,0 +1,137 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <chrono>
+#include <fstream>
+#include <future>
+#include <sstream>
+
+#include "Test.h"
+#include "../../src/obs-websocket.h"
+#include "../../src/requesthandler/RequestBatchHandler.h"
+#include "../../src/requesthandler/RequestHandler.h"
+#include "../../src/utils/TrafficCapture.h"
+#include "../../src/websocketserver/WebSocketServer.h"
+#include "../../src/websocketserver/types/WebSocketOpCode.h"
+
+#define TEST_STREAM_KEY "obs-websocket-test-stream-key"
+#define TEST_CAPTURE_PATH "/tmp/obs-websocket-tests/capture.jsonl"
+
+static json StreamServiceRequests()
+{
+	return json::array({
+		{{"requestType", "SetStreamServiceSettings"},
+		 {"requestData",
+		  {{"streamServiceType", "rtmp_custom"},
+		   {"streamServiceSettings", {{"server", "rtmp://127.0.0.1/live"}, {"key", TEST_STREAM_KEY}}}}}},
+		{{"requestType", "GetStreamServiceSettings"}},
+	});
+}
+
+static std::string ReadCapture()
+{
+	std::ifstream file(TEST_CAPTURE_PATH);
+	std::stringstream content;
+	content << file.rdbuf();
+	return content.str();
+}
+
+// Streamed results (OpCode 10) carry the result of every request in `result`, like `WebSocketServer` sends them
+TEST("TrafficCapture/RedactsStreamedBatch", [](Test::Context &context) {
+	const int session = 0; // Only identifies the session in the capture
+	bool streamKeyStreamed = false;
+	CHECK(context, Utils::TrafficCapture::Start(TEST_CAPTURE_PATH));
+	Utils::TrafficCapture::RecordOpen(&session, "127.0.0.1:0");
+
+	json requests = StreamServiceRequests();
+	Utils::TrafficCapture::RecordMessage(
+		&session, Utils::TrafficCapture::Inbound,
+		{{"op", WebSocketOpCode::RequestBatch}, {"d", {{"requestId", "streamed"}, {"requests", requests}}}});
+
+	std::vector<RequestBatchRequest> requestsVector;
+	for (auto &requestJson : requests)
+		requestsVector.emplace_back(requestJson["requestType"], requestJson.value("requestData", json()),
+					    RequestBatchExecutionType::SerialRealtime);
+
+	std::promise<void> finished;
+	RequestBatchHandler::ProcessRequestBatch(
+		GetWebSocketServer()->GetBatchScheduler(), nullptr, RequestBatchExecutionType::SerialRealtime,
+		std::move(requestsVector), nullptr, false,
+		[&finished](std::vector<RequestResult> &&, size_t, json &&, uint64_t) { finished.set_value(); },
+		[&session, &requests, &streamKeyStreamed](size_t index, RequestResult &&requestResult) {
+			json message;
+			message["op"] = WebSocketOpCode::RequestBatchPartialResponse;
+			message["d"]["requestId"] = "streamed";
+			message["d"]["index"] = index;
+			message["d"]["result"] =
+				RequestBatchHandler::ConstructRequestResult(std::move(requestResult), requests[index]);
+			streamKeyStreamed |= message.dump().find(TEST_STREAM_KEY) != std::string::npos;
+			Utils::TrafficCapture::RecordMessage(&session, Utils::TrafficCapture::Outbound, message);
+		});
+	CHECK(context, finished.get_future().wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+
+	Utils::TrafficCapture::RecordClose(&session);
+	Utils::TrafficCapture::Stop();
+
+	std::string capture = ReadCapture();
+	// The stream key has to be in a streamed result for the test to mean anything
+	CHECK(context, streamKeyStreamed);
+	CHECK(context, capture.find("\"result\"") != std::string::npos);
+	CHECK(context, capture.find(TEST_STREAM_KEY) == std::string::npos);
+});
+
+// Prepared batches carry their requests in the request data of `PrepareRequestBatch`, and their results in the response
+// data of `ExecutePreparedBatch`
+TEST("TrafficCapture/RedactsPreparedBatch", [](Test::Context &context) {
+	SessionPtr session = std::make_shared<WebSocketSession>();
+	RequestHandler requestHandler(session);
+	CHECK(context, Utils::TrafficCapture::Start(TEST_CAPTURE_PATH));
+	Utils::TrafficCapture::RecordOpen(session.get(), "127.0.0.1:0");
+
+	json prepareRequestData = {{"preparedBatchId", "redaction"}, {"requests", StreamServiceRequests()}};
+	Utils::TrafficCapture::RecordMessage(session.get(), Utils::TrafficCapture::Inbound,
+					     {{"op", WebSocketOpCode::Request},
+					      {"d",
+					       {{"requestType", "PrepareRequestBatch"},
+						{"requestId", "prepare"},
+						{"requestData", prepareRequestData}}}});
+	RequestResult prepareResult = requestHandler.ProcessRequest(Request("PrepareRequestBatch", prepareRequestData));
+	CHECK(context, prepareResult.Succeeded());
+
+	RequestResult executeResult =
+		requestHandler.ProcessRequest(Request("ExecutePreparedBatch", json{{"preparedBatchId", "redaction"}}));
+	CHECK(context, executeResult.Succeeded());
+	// The stream key has to be in the response for the test to mean anything
+	CHECK(context, executeResult.ResponseData.dump().find(TEST_STREAM_KEY) != std::string::npos);
+	Utils::TrafficCapture::RecordMessage(session.get(), Utils::TrafficCapture::Outbound,
+					     {{"op", WebSocketOpCode::RequestResponse},
+					      {"d",
+					       {{"requestType", "ExecutePreparedBatch"},
+						{"requestId", "execute"},
+						{"requestStatus", {{"result", true}, {"code", RequestStatus::Success}}},
+						{"responseData", executeResult.ResponseData}}}});
+
+	Utils::TrafficCapture::RecordClose(session.get());
+	Utils::TrafficCapture::Stop();
+
+	requestHandler.ProcessRequest(Request("RemovePreparedBatch", json{{"preparedBatchId", "redaction"}}));
+
+	std::string capture = ReadCapture();
+	CHECK(context, capture.find("PrepareRequestBatch") != std::string::npos);
+	CHECK(context, capture.find(TEST_STREAM_KEY) == std::string::npos);
+});
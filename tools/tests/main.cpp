@@ -0,0 +1,102 @@
+/*
+obs-websocket
+Copyright (C) 2020-2021 Kyle Manning <tt2468@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include <cstdio>
+#include <iostream>
+#include <regex>
+#include <QApplication>
+
+#include "Test.h"
+#include "../mock-obs/MockObs.h"
+#include "../mock-obs/HeadlessPlugin.h"
+
+struct Options {
+	std::string filter = ".*";
+};
+
+static bool ParseOptions(int argc, char **argv, Options &options)
+{
+	for (int i = 1; i + 1 < argc; i += 2) {
+		std::string arg = argv[i];
+		std::string value = argv[i + 1];
+		if (arg == "--filter")
+			options.filter = value;
+		else
+			return false;
+	}
+
+	return argc % 2 == 1;
+}
+
+int main(int argc, char **argv)
+{
+	Options options;
+	if (!ParseOptions(argc, argv, options)) {
+		std::cerr << "Invalid options. See tools/README.md for the usage." << std::endl;
+		return 1;
+	}
+
+	std::regex filter;
+	try {
+		filter = std::regex(options.filter);
+	} catch (const std::regex_error &) {
+		std::cerr << "Invalid filter." << std::endl;
+		return 1;
+	}
+
+	if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+		qputenv("QT_QPA_PLATFORM", "offscreen");
+	QApplication app(argc, argv);
+
+	MockObs::Settings settings;
+	settings.configDirectory = "/tmp/obs-websocket-tests";
+	settings.logLevel = LOG_WARNING;
+	MockObs::Initialize(settings);
+	if (!HeadlessPlugin::Load()) {
+		MockObs::Shutdown();
+		return 1;
+	}
+	MockObs::FinishLoading();
+	// Frame based batches only progress while video frames are ticking
+	MockObs::StartClock();
+
+	size_t failedCount = 0;
+	for (auto &registration : Test::GetRegistrations()) {
+		if (!std::regex_search(registration.name, filter))
+			continue;
+
+		Test::Context context;
+		registration.function(context);
+		std::printf("%-6s %s\n", context.Failed() ? "FAIL" : "OK", registration.name.c_str());
+		for (auto &failure : context.Failures())
+			std::printf("       %s\n", failure.c_str());
+		std::fflush(stdout);
+
+		if (context.Failed())
+			failedCount++;
+	}
+
+	MockObs::StopClock();
+	HeadlessPlugin::Unload();
+	MockObs::Shutdown();
+
+	if (failedCount)
+		std::printf("%zu test(s) failed.\n", failedCount);
+
+	return failedCount ? 1 : 0;
+}